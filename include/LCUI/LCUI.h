@@ -191,6 +191,7 @@ struct LCUI_Graph_ {
 	float opacity;			/**< 全局不透明度，取值范围为 0~1.0 */
 	size_t mem_size;		/**< 像素数据缓冲区大小 */
 	uchar_t *palette;		/**< 调色板 */
+	unsigned long generation;	/**< 像素数据的代数，每次重新创建时更新 */
 };
 
 /** 样式值枚举，用于代替使用字符串 */
@@ -300,6 +301,7 @@ typedef struct LCUI_PaintContextRec_ {
 	LCUI_Rect rect;			/**< 需要绘制的区域 */
 	LCUI_Graph canvas;		/**< 绘制后的位图缓存（可称为：画布） */
 	LCUI_BOOL with_alpha;		/**< 绘制时是否需要处理 alpha 通道 */
+	struct LCUI_ArenaRec_ *arena;	/**< 临时位图的分配器，为 NULL 时使用 malloc() */
 } LCUI_PaintContextRec, *LCUI_PaintContext;
 
 typedef void (*FuncPtr)(void *);
@@ -99,6 +99,14 @@ typedef struct LCUI_DisplayDriverRec_ {
 	int			(*bindEvent)(int,LCUI_EventFunc,void*,void(*)(void*));
 } LCUI_DisplayDriverRec, *LCUI_DisplayDriver;
 
+/** 绘制用的临时内存的统计信息 */
+typedef struct LCUI_PaintArenaStatsRec_ {
+	size_t peak_bytes;		/**< 各个渲染线程近期单帧用量峰值之和 */
+	size_t capacity;		/**< 当前保留的总容量 */
+	unsigned long allocs;		/**< 累计分配次数 */
+	unsigned long blocks;		/**< 累计向系统申请内存块的次数 */
+} LCUI_PaintArenaStatsRec, *LCUI_PaintArenaStats;
+
 /** 一秒内的最大画面帧数 */
 #define MAX_FRAMES_PER_SEC 100
 
@@ -134,6 +142,44 @@ LCUI_API int LCUIDisplay_BindEvent( int event_id, LCUI_EventFunc func, void *arg
 /** 获取当前的屏幕内容每秒更新的帧数 */
 LCUI_API int LCUIDisplay_GetFPS(void);
 
+/** 获取显示线程中各帧的耗时统计 */
+LCUI_API void LCUIDisplay_GetFrameStats( LCUI_FrameStats stats );
+
+/**
+ * 请求更新画面
+ * 显示线程在没有需要更新的内容时会一直等待，在其它线程中修改了界面后
+ * 需要调用它来唤醒显示线程，更新的频率仍然受最大帧率的限制
+ */
+LCUI_API void LCUIDisplay_RequestUpdate( void );
+
+/**
+ * 新建绘制上下文
+ * 在渲染线程中调用时，从该线程的临时内存中分配，在当前帧绘制完后统一回收，
+ * 否则使用 malloc() 分配。供显示驱动在 beginPaint() 中使用。
+ */
+LCUI_API LCUI_PaintContext LCUIDisplay_NewPaintContext( LCUI_Rect *rect );
+
+/** 释放由 LCUIDisplay_NewPaintContext() 创建的绘制上下文 */
+LCUI_API void LCUIDisplay_FreePaintContext( LCUI_PaintContext paint );
+
+/**
+ * 开始绘制帧缓存中的一块区域
+ * 各个块互不重叠，多个渲染线程可以同时绘制，所以只以共享方式锁定 lock，
+ * 直到 LCUIDisplay_EndPaintBuffer() 被调用。显示驱动在释放或重新分配帧缓存
+ * 前需要以独占方式锁定 lock，等待正在进行的绘制结束。
+ */
+LCUI_API LCUI_PaintContext LCUIDisplay_BeginPaintBuffer( LCUI_RWLock *lock,
+							 LCUI_Graph *fb,
+							 LCUI_Rect *rect );
+
+/** 结束绘制，在 mutex 的保护下将绘制过的区域并入 rects，然后解除对帧缓存的锁定 */
+LCUI_API void LCUIDisplay_EndPaintBuffer( LCUI_RWLock *lock, LCUI_Mutex *mutex,
+					  LCUI_Region rects,
+					  LCUI_PaintContext paint );
+
+/** 获取绘制用的临时内存的统计信息 */
+LCUI_API void LCUIDisplay_GetPaintArenaStats( LCUI_PaintArenaStats stats );
+
 /** 初始化图形输出模块 */
 LCUI_API int LCUI_InitDisplay( LCUI_DisplayDriver driver );
 
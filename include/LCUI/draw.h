@@ -90,6 +90,17 @@ LCUI_API int GaussianSmooth( LCUI_Graph *src, LCUI_Graph *des, double sigma );
 /* 对图像进行模糊处理 */
 LCUI_API int Graph_Smooth( LCUI_Graph *src, LCUI_Graph *des, double sigma );
 
+/**
+ * 对图像进行模糊处理
+ * 用三次盒式模糊近似高斯模糊，耗时与模糊半径无关，仅支持 ARGB 格式的图像
+ * @param[in] src 源图像，可以是引用
+ * @param[out] des 用于存放模糊后的图像
+ * @param[in] sigma 高斯模糊的标准差
+ * @param[in] n_threads 参与处理的线程数量，图像会按行分给各个线程
+ */
+LCUI_API int Graph_SmoothEx( LCUI_Graph *src, LCUI_Graph *des,
+			     double sigma, int n_threads );
+
 LCUI_END_HEADER
 
 #endif
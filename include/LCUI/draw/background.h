@@ -42,6 +42,15 @@
 
 LCUI_BEGIN_HEADER
 
+/** 背景图像缩放缓存的统计信息 */
+typedef struct LCUI_BackgroundCacheStatsRec_ {
+	unsigned long hits;	/**< 命中次数 */
+	unsigned long misses;	/**< 未命中次数，需要重新缩放图像 */
+	size_t used_bytes;	/**< 缩放后的图像占用的内存 */
+	size_t max_bytes;	/**< 内存预算 */
+	int count;		/**< 已缓存的图像数量 */
+} LCUI_BackgroundCacheStatsRec, *LCUI_BackgroundCacheStats;
+
 /** 初始化背景绘制参数 */
 LCUI_API void Background_Init( LCUI_Background *bg );
 
@@ -55,6 +64,23 @@ LCUI_API void Graph_DrawBackground( LCUI_PaintContext paint,
 				    const LCUI_Rect *box,
 				    LCUI_Background *bg );
 
+/** 设置背景图像缩放缓存的内存预算，超出预算时淘汰最久未使用的图像 */
+LCUI_API void Background_SetCacheSize( size_t max_bytes );
+
+/** 获取背景图像缩放缓存的统计信息 */
+LCUI_API void Background_GetCacheStats( LCUI_BackgroundCacheStats stats );
+
+/**
+ * 释放由该图像缩放得到的缓存
+ * 缓存以源图像的像素数据的地址和代数为索引，重新创建的图像不会命中旧的缓存。
+ * 直接修改背景图像的像素后需要调用它，释放背景图像前调用它可以及早回收内存。
+ */
+LCUI_API void Background_ReleaseImageCache( const LCUI_Graph *image );
+
+void LCUI_InitBackground( void );
+
+void LCUI_ExitBackground( void );
+
 LCUI_END_HEADER
 
 #endif
\ No newline at end of file
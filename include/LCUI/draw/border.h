@@ -42,6 +42,15 @@
 
 LCUI_BEGIN_HEADER
 
+/** 圆角边框遮罩缓存的统计信息 */
+typedef struct LCUI_BorderCacheStatsRec_ {
+	unsigned long hits;	/**< 命中次数 */
+	unsigned long misses;	/**< 未命中次数，需要重新生成遮罩 */
+	size_t used_bytes;	/**< 遮罩占用的内存 */
+	size_t max_bytes;	/**< 内存预算 */
+	int count;		/**< 已缓存的遮罩数量 */
+} LCUI_BorderCacheStatsRec, *LCUI_BorderCacheStats;
+
 LCUI_API void Border_Init( LCUI_Border *border );
 /* 初始化边框数据 */
 
@@ -54,6 +63,33 @@ LCUI_API void Border_Radius( LCUI_Border *border, unsigned int radius );
 /** 绘制边框 */
 LCUI_API int Graph_DrawBorder( LCUI_PaintContext paint, LCUI_Rect *box, LCUI_Border *border );
 
+/**
+ * 按圆角边框裁剪画布中的内容
+ * 圆角处的像素按其被边框覆盖的比例减小透明度，画布需为 ARGB 格式。
+ * @param[in] paint 绘制上下文，其 rect 与 box 使用相同的坐标系
+ * @param[in] box 边框所在的区域
+ * @param[in] border 边框样式
+ * @param[in] inner 为 TRUE 时按边框的内边缘裁剪，用于子部件的内容，否则
+ *  按外边缘裁剪，用于背景
+ */
+LCUI_API void Graph_ClipByBorder( LCUI_PaintContext paint, const LCUI_Rect *box,
+				  const LCUI_Border *border, LCUI_BOOL inner );
+
+/** 判断区域是否与圆角所在的区域重叠 */
+LCUI_API LCUI_BOOL Border_IsCoverCorner( const LCUI_Rect *box,
+					 const LCUI_Border *border,
+					 const LCUI_Rect *rect );
+
+/** 设置圆角边框遮罩缓存的内存预算 */
+LCUI_API void Border_SetCacheSize( size_t max_bytes );
+
+/** 获取圆角边框遮罩缓存的统计信息 */
+LCUI_API void Border_GetCacheStats( LCUI_BorderCacheStats stats );
+
+void LCUI_InitBorder( void );
+
+void LCUI_ExitBorder( void );
+
 LCUI_END_HEADER
 
 #endif
@@ -40,6 +40,15 @@
 #ifndef LCUI_DRAW_BOXSHADOW_H
 #define LCUI_DRAW_BOXSHADOW_H
 
+/** 阴影遮罩缓存的统计信息 */
+typedef struct LCUI_BoxShadowCacheStatsRec_ {
+	unsigned long hits;	/**< 命中次数 */
+	unsigned long misses;	/**< 未命中次数，需要重新生成遮罩 */
+	size_t used_bytes;	/**< 遮罩占用的内存 */
+	size_t max_bytes;	/**< 内存预算 */
+	int count;		/**< 已缓存的遮罩数量 */
+} LCUI_BoxShadowCacheStatsRec, *LCUI_BoxShadowCacheStats;
+
 LCUI_API LCUI_BoxShadow BoxShadow( int x, int y, int blur, LCUI_Color color );
 
 LCUI_API int BoxShadow_GetBoxWidth( LCUI_BoxShadow *shadow, int w );
@@ -65,7 +74,24 @@ LCUI_API void BoxShadow_Init( LCUI_BoxShadow *shadow );
 LCUI_API void Graph_ClearShadowArea( LCUI_PaintContext paint, LCUI_Rect *box,
 				     LCUI_BoxShadow *shadow );
 
+/**
+ * 绘制矩形阴影
+ * 阴影的模糊边缘和四个角用预先计算好的遮罩绘制，遮罩按模糊宽度缓存。
+ * @param[in] paint 绘制上下文，画布需为 ARGB 格式
+ * @param[in] box 阴影所在的矩形，包括阴影占用的区域
+ * @param[in] shadow 阴影参数
+ */
 LCUI_API int Graph_DrawBoxShadow( LCUI_PaintContext paint, LCUI_Rect *box,
 				  LCUI_BoxShadow *shadow );
 
+/** 设置阴影遮罩缓存的内存预算，超出预算时淘汰最久未使用的遮罩 */
+LCUI_API void BoxShadow_SetCacheSize( size_t max_bytes );
+
+/** 获取阴影遮罩缓存的统计信息 */
+LCUI_API void BoxShadow_GetCacheStats( LCUI_BoxShadowCacheStats stats );
+
+void LCUI_InitBoxShadow( void );
+
+void LCUI_ExitBoxShadow( void );
+
 #endif
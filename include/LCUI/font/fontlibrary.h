@@ -72,6 +72,17 @@ struct LCUI_FontEngine {
 	void (*close)(void*);
 };
 
+/** 字体位图缓存的统计信息 */
+typedef struct LCUI_FontCacheStatsRec_ {
+	unsigned long hits;		/**< 命中次数 */
+	unsigned long misses;		/**< 未命中次数，需要载入字体位图 */
+	unsigned long evictions;	/**< 因超出内存预算而被淘汰的位图数量 */
+	size_t used_bytes;		/**< 位图数据占用的内存 */
+	size_t max_bytes;		/**< 内存预算 */
+	int count;			/**< 已载入位图数据的字形数量 */
+	int entries;			/**< 缓存项的数量，包括位图数据已被淘汰的 */
+} LCUI_FontCacheStatsRec, *LCUI_FontCacheStats;
+
 
 int LCUIFont_InitInCoreFont( LCUI_FontEngine *engine );
 
@@ -107,6 +118,16 @@ LCUI_API int FontBitmap_Print( LCUI_FontBitmap *fontbmp );
 LCUI_API int FontBitmap_Mix( LCUI_Graph *graph, LCUI_Pos pos,
 			     const LCUI_FontBitmap *bmp, LCUI_Color color );
 
+/**
+ * 将一组使用相同颜色的字体位图绘制到目标图像上
+ * 与逐个调用 FontBitmap_Mix() 相比，只需计算一次图像的有效区域
+ * @param[in] bmps 字体位图列表
+ * @param[in] pos 各个字体位图在图像中的坐标
+ * @param[in] n 字体位图的数量
+ */
+LCUI_API int FontBitmap_MixRun( LCUI_Graph *graph, const LCUI_FontBitmap **bmps,
+				const LCUI_Pos *pos, int n, LCUI_Color color );
+
 /** 载入字体位图 */
 LCUI_API int FontBitmap_Load( LCUI_FontBitmap *buff, wchar_t ch,
 			   int font_id, int pixel_size );
@@ -138,7 +159,8 @@ LCUI_API void LCUIFont_SetDefault( int id );
  * @param[in] size 字体大小（单位为像素）
  * @param[out] bmp 要添加的字体位图
  * @warning 此函数仅仅是将 bmp 复制进缓存中，并未重新分配新的空间储存位图数
- * 据，因此，请勿在调用此函数后手动释放 bmp。
+ * 据，因此，请勿在调用此函数后手动释放 bmp。返回的字体位图没有被引用，需要
+ * 长期持有时应改用 LCUIFont_GetBitmap() 获取。
  */
 LCUI_API LCUI_FontBitmap* LCUIFont_AddBitmap( wchar_t ch, int font_id,
 				int size, const LCUI_FontBitmap *bmp );
@@ -150,11 +172,36 @@ LCUI_API LCUI_FontBitmap* LCUIFont_AddBitmap( wchar_t ch, int font_id,
  * @param[in] size 字体大小（单位为像素）
  * @param[out] bmp 输出的字体位图的引用
  * @warning 请勿释放 bmp，bmp 仅仅是引用缓存中的字体位图，并未建分配新
- * 空间存储字体位图的拷贝。
+ * 空间存储字体位图的拷贝。不再使用时需调用 LCUIFont_ReleaseBitmap()。
  */
 LCUI_API int LCUIFont_GetBitmap( wchar_t ch, int font_id, int size,
 				 const LCUI_FontBitmap **bmp );
 
+/**
+ * 确保缓存中的字体位图的数据可用
+ * 字体位图的数据被缓存淘汰后会在这里重新载入，绘制字体位图前应调用此函数
+ * @param[in] bmp 由 LCUIFont_GetBitmap() 获取的字体位图
+ */
+LCUI_API int LCUIFont_UseBitmap( const LCUI_FontBitmap *bmp );
+
+/** 释放由 LCUIFont_GetBitmap() 获取的字体位图的引用 */
+LCUI_API void LCUIFont_ReleaseBitmap( const LCUI_FontBitmap *bmp );
+
+/**
+ * 设置字体位图缓存的内存预算
+ * 超出预算时，会在下一帧开始前淘汰最久未使用的字体位图的数据
+ */
+LCUI_API void LCUIFont_SetCacheSize( size_t max_bytes );
+
+/** 获取字体位图缓存的统计信息 */
+LCUI_API void LCUIFont_GetCacheStats( LCUI_FontCacheStats stats );
+
+/** 重置字体位图缓存的命中、未命中和淘汰次数 */
+LCUI_API void LCUIFont_ResetCacheStats( void );
+
+/** 淘汰超出内存预算的字体位图数据，应在各帧开始绘制前调用 */
+LCUI_API void LCUIFont_TrimCache( void );
+
 /** 载入字体至数据库中 */
 LCUI_API int LCUIFont_LoadFile( const char *filepath );
 
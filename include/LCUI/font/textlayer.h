@@ -62,7 +62,8 @@ typedef struct TextRowRec_ {
         int height;			/**< 高度 */
 	int text_height;		/**< 当前行中最大字体的高度 */
         int length;			/**< 该行文本长度 */
-        TextChar *string;		/**< 该行文本的数据 */
+	int capacity;			/**< 文本数据的容量 */
+        TextCharRec *string;		/**< 该行文本的数据，字符数据是连续存储的 */
 	EOLChar eol;			/**< 行尾结束类型 */
 } TextRowRec, *TextRow;
 
@@ -70,6 +71,10 @@ typedef struct TextRowRec_ {
 typedef struct TextRowListRec_ {
         int length;		/**< 当前总行数 */
         TextRow *rows;		/**< 每一行文本的数据 */
+	int max_length;		/**< 文本行列表的容量 */
+	int *offsets;		/**< 文本行偏移量索引，记录每一行之前的文本总高度 */
+	int n_offsets;		/**< 索引中有效的记录数量 */
+	int max_offsets;	/**< 索引的容量 */
 } TextRowListRec, *TextRowList;
 
 typedef struct LCUI_TextLayerRec_  {
@@ -99,6 +104,7 @@ typedef struct LCUI_TextLayerRec_  {
 		LCUI_BOOL update_bitmap;	/**< 更新文本的字体位图 */
 		LCUI_BOOL update_typeset;	/**< 重新对文本进行排版 */
 		int typeset_start_row;		/**< 排版处理的起始行 */	
+		int typeset_end_row;		/**< 被修改过的最后一行，-1 表示全部 */
 		LCUI_BOOL redraw_all;		/**< 重绘所有字体位图 */
 	} task;				/**< 待处理的任务 */
         LCUI_Graph graph;		/**< 文本位图缓存 */
@@ -113,7 +119,10 @@ LCUI_API int TextLayer_GetRowHeight( LCUI_TextLayer layer, int row );
 /** 获取指定文本行的文本长度 */
 LCUI_API int TextLayer_GetRowTextLength( LCUI_TextLayer layer, int row );
 
-/** 添加 更新文本排版 的任务 */
+/**
+ * 添加 更新文本排版 的任务
+ * 排版会从 start_row 行开始，一直处理到最后一行
+ */
 LCUI_API void TextLayer_AddUpdateTypeset( LCUI_TextLayer layer, int start_row );
 
 /** 设置文本对齐方式 */
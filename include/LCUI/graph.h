@@ -61,6 +61,14 @@ enum GraphColorType {
 #define COLOR_TYPE_RGB COLOR_TYPE_RGB888
 #define COLOR_TYPE_ARGB COLOR_TYPE_ARGB8888
 
+/** 图像缩放时使用的采样算法 */
+enum LCUI_ZoomFilter {
+	ZOOM_FILTER_AUTO,	/**< 放大时用双线性插值，缩小时用区域平均 */
+	ZOOM_FILTER_NEAREST,	/**< 最近邻插值，速度最快 */
+	ZOOM_FILTER_BILINEAR,	/**< 双线性插值，适合放大 */
+	ZOOM_FILTER_BOX		/**< 区域平均，缩小时不会丢失细节 */
+};
+
 /* 将两个像素点的颜色值进行alpha混合 */
 #define _ALPHA_BLEND(__back__ , __fore__, __alpha__)	\
     ((((__fore__-__back__)*(__alpha__))>>8)+__back__)
@@ -139,7 +147,12 @@ LCUI_API void PixelsFormat( const uchar_t *in_pixels, int in_color_type,
 		   	    uchar_t *out_pixels, int out_color_type,
 		   	    size_t pixel_count );
 
-/** 改变色彩类型 */
+/**
+ * 改变色彩类型
+ * 支持除 COLOR_TYPE_INDEX8 以外的所有色彩类型
+ * @returns 成功返回 0，色彩类型相同返回 -1，不支持的色彩类型返回 -2，
+ * 内存分配失败返回 -3
+ */
 LCUI_API int Graph_SetColorType( LCUI_Graph *graph, int color_type );
 
 LCUI_API int Graph_Create( LCUI_Graph *graph, int w, int h );
@@ -183,6 +196,20 @@ LCUI_API int Graph_SetBlueBits( LCUI_Graph *graph, uchar_t *b, size_t size );
 LCUI_API int Graph_Zoom( const LCUI_Graph *graph, LCUI_Graph *buff,
 			 LCUI_BOOL keep_scale, int width, int height );
 
+/**
+ * 按指定的采样算法缩放图像
+ * 采样坐标用 16.16 定点数计算，Graph_Zoom() 相当于使用最近邻插值的版本
+ * @param[in] graph 源图像，可以是引用
+ * @param[out] buff 缩放后的图像
+ * @param[in] keep_scale 是否保持宽高比
+ * @param[in] width 目标宽度，小于等于 0 时按高度的缩放比例计算
+ * @param[in] height 目标高度，小于等于 0 时按宽度的缩放比例计算
+ * @param[in] filter 采样算法，取值为 LCUI_ZoomFilter 中的值
+ */
+LCUI_API int Graph_ZoomEx( const LCUI_Graph *graph, LCUI_Graph *buff,
+			   LCUI_BOOL keep_scale, int width, int height,
+			   int filter );
+
 LCUI_API int Graph_Cut( const LCUI_Graph *graph, LCUI_Rect rect,
 		        LCUI_Graph *buff );
 
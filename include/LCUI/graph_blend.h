@@ -0,0 +1,98 @@
+/* ***************************************************************************
+ * graph_blend.h -- pixel compositing kernels for the graph module
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * graph_blend.h -- 图像模块的像素混合内核
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#ifndef LCUI_GRAPH_BLEND_H
+#define LCUI_GRAPH_BLEND_H
+
+LCUI_BEGIN_HEADER
+
+/** 像素混合内核的类型 */
+enum LCUI_BlendKernelType {
+	BLEND_KERNEL_AUTO,		/**< 自动选择当前 CPU 支持的最快实现 */
+	BLEND_KERNEL_REFERENCE,		/**< 参考实现，逐像素的定点运算 */
+	BLEND_KERNEL_SSE2,		/**< SSE2 实现，每次处理 4 个像素 */
+	BLEND_KERNEL_AVX2,		/**< AVX2 实现，每次处理 8 个像素 */
+	BLEND_KERNEL_TOTAL_NUM
+};
+
+/**
+ * 像素混合内核
+ * 每个函数处理一行连续的像素，opacity 为 0~255 的整数，255 表示不透明。
+ * 除参考实现外，其它实现的输出结果都必须与参考实现完全一致。
+ */
+typedef struct LCUI_BlendKernelRec_ {
+	int type;
+	const char *name;
+	/** 将前景像素合成至背景像素上，并计算合成后的 alpha 值 */
+	void (*mix)(LCUI_ARGB*, const LCUI_ARGB*, int, int);
+	/** 按前景像素的 alpha 值混合颜色，保留背景的 alpha 值 */
+	void (*blend)(LCUI_ARGB*, const LCUI_ARGB*, int, int);
+	/** 将 ARGB 前景像素混合到 RGB888 背景像素上 */
+	void (*blend_rgb)(uchar_t*, const LCUI_ARGB*, int, int);
+	/** 复制像素，并将不透明度应用到 alpha 通道上 */
+	void (*copy)(LCUI_ARGB*, const LCUI_ARGB*, int, int);
+	/** 用颜色填充像素，若不处理 alpha 通道则保留原有的 alpha 值 */
+	void (*fill)(LCUI_ARGB*, LCUI_ARGB, int, LCUI_BOOL);
+	/**
+	 * 对两行字节按 0~256 的权重做线性插值，用于图像缩放：
+	 * dst = (a * (256 - weight) + b * weight + 128) / 256，n 为字节数
+	 */
+	void (*lerp)(uchar_t*, const uchar_t*, const uchar_t*, int, int);
+} LCUI_BlendKernelRec, *LCUI_BlendKernel;
+
+/** 将 0~1.0 的不透明度转换为混合内核使用的 0~255 的整数 */
+#define BLEND_OPACITY(F) ((F) >= 1.0 ? 255 : (F) <= 0 ? 0 : (int)((F) * 255 + 0.5))
+
+/**
+ * 获取指定类型的混合内核
+ * @param[in] type 内核类型，为 BLEND_KERNEL_AUTO 时返回当前正在使用的内核
+ * @returns 若当前 CPU 不支持该类型的内核，则返回 NULL
+ */
+LCUI_API LCUI_BlendKernel Graph_GetBlendKernel( int type );
+
+/**
+ * 设置 Graph_Mix()、Graph_Replace() 和 Graph_FillRect() 使用的混合内核
+ * @param[in] type 内核类型，为 BLEND_KERNEL_AUTO 时自动选择最快的实现
+ * @returns 设置成功返回 0，当前 CPU 不支持该类型的内核则返回 -1
+ */
+LCUI_API int Graph_SetBlendKernel( int type );
+
+LCUI_END_HEADER
+
+#endif
@@ -0,0 +1,122 @@
+/* ***************************************************************************
+ * graph_convert.h -- pixel format conversion for the graph module
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * graph_convert.h -- 图像模块的像素格式转换
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+
+#ifndef LCUI_GRAPH_CONVERT_H
+#define LCUI_GRAPH_CONVERT_H
+
+LCUI_BEGIN_HEADER
+
+/**
+ * 像素格式转换内核
+ * 负责 ARGB8888 与其它常用格式之间的批量转换，其它格式之间的转换以 ARGB8888
+ * 为中转。内核的类型沿用 BLEND_KERNEL_* 的定义，除参考实现外，其它实现的输出
+ * 结果都必须与参考实现完全一致。
+ * bias 为 4 个像素的抖动偏移量，按 B、G、R、A 的顺序排列，每 4 个像素重复一次，
+ * 为 NULL 时不做抖动。
+ */
+typedef struct LCUI_ConvertKernelRec_ {
+	int type;
+	const char *name;
+	/** 将 ARGB 像素转换为 RGB565 像素 */
+	void (*to_rgb565)(uchar_t*, const LCUI_ARGB*, int, const uchar_t*);
+	/** 将 ARGB 像素转换为 RGB555 像素 */
+	void (*to_rgb555)(uchar_t*, const LCUI_ARGB*, int, const uchar_t*);
+	/** 将 ARGB 像素转换为 RGB888 像素 */
+	void (*to_rgb888)(uchar_t*, const LCUI_ARGB*, int);
+	/** 将 RGB565 像素转换为 ARGB 像素 */
+	void (*from_rgb565)(LCUI_ARGB*, const uchar_t*, int);
+	/** 将 RGB555 像素转换为 ARGB 像素 */
+	void (*from_rgb555)(LCUI_ARGB*, const uchar_t*, int);
+	/** 将 RGB888 像素转换为 ARGB 像素 */
+	void (*from_rgb888)(LCUI_ARGB*, const uchar_t*, int);
+	/** 交换 32 位像素的红色和蓝色通道，用于 RGBA 与 BGRA 之间的转换 */
+	void (*swap_rb)(uchar_t*, const uchar_t*, int);
+} LCUI_ConvertKernelRec, *LCUI_ConvertKernel;
+
+/**
+ * 获取指定类型的像素格式转换内核
+ * @param[in] type 内核类型，为 BLEND_KERNEL_AUTO 时返回当前正在使用的内核
+ * @returns 若当前 CPU 不支持或没有该类型的内核，则返回 NULL
+ */
+LCUI_API LCUI_ConvertKernel Graph_GetConvertKernel( int type );
+
+/**
+ * 设置像素格式转换使用的内核
+ * @param[in] type 内核类型，为 BLEND_KERNEL_AUTO 时自动选择最快的实现
+ * @returns 设置成功返回 0，不支持该类型的内核则返回 -1
+ */
+LCUI_API int Graph_SetConvertKernel( int type );
+
+/**
+ * 转换一行像素的格式
+ * 支持除 COLOR_TYPE_INDEX8 以外的所有色彩类型，输入和输出不能重叠
+ * @param[out] out_pixels 输出的像素数据
+ * @param[in] out_color_type 输出的色彩类型
+ * @param[in] in_pixels 输入的像素数据
+ * @param[in] in_color_type 输入的色彩类型
+ * @param[in] n 像素数量
+ * @returns 转换成功返回 0，不支持的色彩类型返回 -1
+ */
+LCUI_API int Pixels_Convert( uchar_t *out_pixels, int out_color_type,
+			     const uchar_t *in_pixels, int in_color_type,
+			     int n );
+
+/**
+ * 转换一行像素的格式，并对低位深的输出格式做有序抖动
+ * 抖动能减少 16 位等低位深的屏幕上渐变色的色带，它使用 4x4 的 Bayer 矩阵，
+ * 所以需要知道这行像素在图像中的位置，以使相邻的行和块能衔接起来。
+ * @param[in] x 第一个像素在图像中的横坐标
+ * @param[in] y 这行像素在图像中的纵坐标
+ */
+LCUI_API int Pixels_ConvertDither( uchar_t *out_pixels, int out_color_type,
+				   const uchar_t *in_pixels, int in_color_type,
+				   int n, int x, int y );
+
+/**
+ * 交换像素的红色和蓝色通道
+ * 用于在 LCUI 的 BGR 字节序与图像库常用的 RGB 字节序之间转换，仅支持
+ * COLOR_TYPE_RGB888 和 COLOR_TYPE_ARGB8888，输入和输出可以是同一块内存
+ */
+LCUI_API int Pixels_SwapRB( uchar_t *out_pixels, const uchar_t *in_pixels,
+			    int color_type, int n );
+
+LCUI_END_HEADER
+
+#endif
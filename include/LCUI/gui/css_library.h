@@ -151,6 +151,7 @@ enum LCUI_StyleKeyName {
 typedef struct LCUI_StyleSheetRec_ {
 	LCUI_Style sheet;
 	int length;
+	int refs;	/**< 引用次数，被共享的样式表不能再修改 */
 } LCUI_StyleSheetRec, *LCUI_StyleSheet;
 
 /** 选择器结点结构 */
@@ -192,6 +193,9 @@ LCUI_API void StyleSheet_Clear( LCUI_StyleSheet ss );
 
 LCUI_API void StyleSheet_Delete( LCUI_StyleSheet ss );
 
+/** 增加样式表的引用次数，引用次数降为 0 时 StyleSheet_Delete() 才会释放它 */
+LCUI_API LCUI_StyleSheet StyleSheet_Ref( LCUI_StyleSheet ss );
+
 LCUI_API int StyleSheet_Merge( LCUI_StyleSheet dest, LCUI_StyleSheet src );
 
 LCUI_API int StyleSheet_Replace( LCUI_StyleSheet dest, LCUI_StyleSheet src );
@@ -202,6 +206,9 @@ LCUI_API void Selector_Update( LCUI_Selector s );
 
 LCUI_API void Selector_Delete( LCUI_Selector s );
 
+/** 判断两个选择器是否相等 */
+LCUI_API LCUI_BOOL Selector_Compare( LCUI_Selector s1, LCUI_Selector s2 );
+
 LCUI_API int SelectorNode_GetNames( LCUI_SelectorNode sn, LinkedList *names );
 
 LCUI_API int SelectorNode_Update( LCUI_SelectorNode node );
@@ -230,6 +237,34 @@ LCUI_API int LCUI_FindStyleSheetFromGroup( int group, const char *name,
 
 LCUI_API void LCUI_GetStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss );
 
+/**
+ * 更新与选择器匹配的样式表
+ * 样式库会缓存每个选择器匹配到的样式表，并为每份缓存分配一个唯一的指纹。当
+ * 样式规则有变化时，只有受影响的缓存会被删除。
+ * @param[in,out] fingerprint 上次获取到的样式表的指纹，如果与缓存的一致，
+ *  则说明样式表没有变化，out_ss 不会被修改
+ * @returns 样式表有变化时返回 TRUE
+ */
+LCUI_API LCUI_BOOL LCUI_UpdateStyleSheet( LCUI_Selector s,
+					  LCUI_StyleSheet out_ss,
+					  unsigned int *fingerprint );
+
+/**
+ * 获取选择器匹配到的样式表的共享引用
+ * 返回的是样式库缓存的样式表，选择器相同的部件会得到同一份样式表，因此不能
+ * 修改它，用完后需调用 StyleSheet_Delete() 释放引用。
+ * @param[out] fingerprint 样式表的指纹
+ */
+LCUI_API LCUI_StyleSheet LCUI_GetSharedStyleSheet( LCUI_Selector s,
+						   unsigned int *fingerprint );
+
+/**
+ * 检查样式表的指纹是否有效
+ * 可在生成选择器之前，用选择器的哈希值判断上次获取到的样式表是否还能用
+ */
+LCUI_API LCUI_BOOL LCUI_CheckStyleSheet( unsigned int hash,
+					 unsigned int fingerprint );
+
 LCUI_API int LCUI_SetStyleName( int key, const char *name );
 
 LCUI_API int LCUI_AddStyleName( const char *name );
@@ -103,6 +103,21 @@ typedef struct LCUI_WidgetTaskBoxRec_ {
 	LCUI_BOOL buffer[WTT_TOTAL_NUM];	/**< 记录缓存 */
 } LCUI_WidgetTaskBoxRec;
 
+/** 部件图层的缓存模式 */
+enum LCUI_WidgetLayerMode {
+	WLM_NONE,	/**< 不缓存图层 */
+	WLM_SELF,	/**< 只缓存部件自身的背景、边框、阴影和内容 */
+	WLM_TREE	/**< 缓存部件与子级部件合成后的整个图层 */
+};
+
+/** 部件图层缓存的记录 */
+typedef struct LCUI_WidgetLayerRec_ {
+	int mode;			/**< 缓存模式 */
+	unsigned int last_used;		/**< 最近一次使用时的帧序号 */
+	LCUI_RegionRec dirty_rects;	/**< 图层中需要重绘的区域 */
+	LinkedListNode node;		/**< 在图层缓存列表中的结点 */
+} LCUI_WidgetLayerRec;
+
 /** 部件状态 */
 enum LCUI_WidgetState {
 	WSTATE_CREATED = 0,
@@ -165,18 +180,20 @@ typedef struct LCUI_WidgetRec_ {
 	LCUI_StyleSheet		style;			/**< 当前完整样式表 */
 	LCUI_StyleSheet		custom_style;		/**< 自定义样式表 */
 	LCUI_StyleSheet		inherited_style;	/**< 通过继承得到的样式表 */
+	unsigned int		style_fingerprint;	/**< 继承得到的样式表的指纹 */
+	int			shared_styles;		/**< 已计入统计的共享样式表引用数 */
 	LCUI_WidgetStyle	computed_style;		/**< 已经计算的样式数据 */
 	LCUI_Widget		parent;			/**< 父部件 */
 	LinkedList		children;		/**< 子部件 */
 	LinkedList		children_show;		/**< 子部件的堆叠顺序记录，由顶到底 */
 	LCUI_WidgetData		data;			/**< 私有数据 */
 	LCUI_WidgetPrototypeC	proto;			/**< 原型 */
-	LCUI_BOOL		enable_graph;		/**< 是否启用位图缓存 */
+	LCUI_WidgetLayerRec	layer;			/**< 图层缓存记录 */
 	LCUI_Graph		graph;			/**< 位图缓存 */
 	LCUI_Mutex		mutex;			/**< 互斥锁 */
 	LCUI_EventTrigger	trigger;		/**< 事件触发器 */
 	LCUI_WidgetTaskBoxRec	task;			/**< 任务记录 */
-	LinkedList		dirty_rects;		/**< 记录无效区域（脏矩形） */
+	LCUI_RegionRec		dirty_rects;		/**< 记录无效区域（脏矩形） */
 	LCUI_BOOL		has_dirty_child;	/**< 子级部件是否有无效区域 */
 	LCUI_BOOL		layout_locked;		/**< 子级部件布局是否已锁定 */
 	LCUI_BOOL		event_blocked;		/**< 是否阻止自己和子级部件的事件处理 */
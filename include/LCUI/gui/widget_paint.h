@@ -43,6 +43,16 @@
 
 LCUI_BEGIN_HEADER
 
+/** 部件图层缓存的统计信息 */
+typedef struct LCUI_WidgetLayerStatsRec_ {
+	unsigned long hits;		/**< 命中次数，直接使用了缓存的图层 */
+	unsigned long misses;		/**< 未命中次数，图层需要重绘或无法缓存 */
+	unsigned long evictions;	/**< 因超出内存预算而被释放的图层数量 */
+	size_t used_bytes;		/**< 图层占用的内存 */
+	size_t max_bytes;		/**< 内存预算 */
+	int count;			/**< 已缓存的图层数量 */
+} LCUI_WidgetLayerStatsRec, *LCUI_WidgetLayerStats;
+
 /** 
  * 标记部件内的一个区域为无效的，以使其重绘
  * @param[in] w		目标部件
@@ -78,9 +88,9 @@ LCUI_API void Widget_ValidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type );
 /**
  * 处理部件及其子级部件中的脏矩形，并合并至一个记录中
  * @param[in]	w	目标部件
- * @param[out]	rlist	合并后的脏矩形记录
+ * @param[out]	region	合并后的脏矩形记录
  */
-LCUI_API int Widget_ProcInvalidArea( LCUI_Widget w, LinkedList *rlist );
+LCUI_API int Widget_ProcInvalidArea( LCUI_Widget w, LCUI_Region region );
 
 /** 
  * 将部件中的矩形区域转换成指定范围框内有效的矩形区域
@@ -99,6 +109,44 @@ LCUI_API int Widget_ConvertArea( LCUI_Widget w, LCUI_Rect *in_rect,
  */
 LCUI_API void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint );
 
+/**
+ * 设置部件图层的缓存模式
+ * 启用后，部件渲染出的图层会保留在 w->graph 中，只有在部件或子级部件中有区域被
+ * 标记为无效时才重绘相应的部分，父级部件重绘时只需混合一次图层。
+ * @param[in] w		部件
+ * @param[in] mode	缓存模式，WLM_NONE、WLM_SELF 或 WLM_TREE
+ */
+LCUI_API void Widget_SetLayerMode( LCUI_Widget w, int mode );
+
+/**
+ * 设置图层缓存的内存预算
+ * 超出预算时，会在下一帧开始前释放最久未使用的图层
+ */
+LCUI_API void LCUIWidget_SetLayerCacheSize( size_t max_bytes );
+
+/** 获取图层缓存的统计信息 */
+LCUI_API void LCUIWidget_GetLayerStats( LCUI_WidgetLayerStats stats );
+
+/** 重置图层缓存的命中、未命中和释放次数 */
+LCUI_API void LCUIWidget_ResetLayerStats( void );
+
+/**
+ * 设置是否启用遮挡剔除
+ * 启用后，渲染时会从顶到底分析子部件的遮挡关系，被上层不透明的子部件完全覆盖
+ * 的部件及其子级部件不会被绘制，默认启用
+ */
+LCUI_API void LCUIWidget_SetOcclusionCulling( LCUI_BOOL enable );
+
+/** 获取因被完全遮挡而跳过的绘制次数 */
+LCUI_API unsigned long LCUIWidget_GetCulledCount( void );
+
+/** 重置被跳过的绘制次数 */
+LCUI_API void LCUIWidget_ResetCulledCount( void );
+
+void LCUIWidget_InitPaint( void );
+
+void LCUIWidget_ExitPaint( void );
+
 LCUI_END_HEADER
 
 #endif
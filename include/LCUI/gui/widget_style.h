@@ -41,6 +41,12 @@
 #ifndef LCUI_WIDGET_STYLE_LIBRARY_H
 #define LCUI_WIDGET_STYLE_LIBRARY_H
 
+/** 部件样式表的共享情况统计 */
+typedef struct LCUI_WidgetStyleStatsRec_ {
+	size_t saved_bytes;	/**< 因共享样式表而节省的内存 */
+	int shared;		/**< 引用共享样式表的次数 */
+} LCUI_WidgetStyleStatsRec, *LCUI_WidgetStyleStats;
+
 /** 初始化 */
 void LCUIWidget_InitStyle( void );
 
@@ -99,6 +105,12 @@ LCUI_API void Widget_UpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all );
 /** 直接更新当前部件的样式 */
 LCUI_API void Widget_ExecUpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all );
 
+/** 释放部件的样式表 */
+void Widget_DestroyStyle( LCUI_Widget w );
+
+/** 获取部件样式表的共享情况统计 */
+LCUI_API void LCUIWidget_GetStyleStats( LCUI_WidgetStyleStats stats );
+
 /** 查找作用于当前部件的样式表 */
 LCUI_API int Widget_FindStyles( LCUI_Widget w, LinkedList *list );
 
@@ -68,6 +68,9 @@ void LCUIWidget_ExitTask( void );
 /** 处理一次当前积累的部件任务 */
 void LCUIWidget_StepTask( void );
 
+/** 获取上次处理部件任务时用于计算布局的时间（单位：纳秒） */
+int64_t LCUIWidget_GetLayoutTime( void );
+
 LCUI_END_HEADER
 
 #endif
@@ -125,6 +125,7 @@ typedef void(*LCUI_SysEventFunc)(LCUI_SysEvent, void*);
 typedef struct LCUI_AppDriverRec_ {
 	void( *DispatchEvent )(void);
 	LCUI_BOOL( *WaitEvent )(void);
+	/** 通知事件循环有新的任务，任务已在队列中，参数仅供参考，可能为 NULL */
 	LCUI_BOOL( *PostTask )(LCUI_AppTask);
 	int( *BindSysEvent )(int, LCUI_EventFunc, void*, void( *)(void*));
 	int( *UnbindSysEvent )(int, LCUI_EventFunc);
@@ -132,6 +133,18 @@ typedef struct LCUI_AppDriverRec_ {
 	void*(*GetData)(void);
 } LCUI_AppDriverRec, *LCUI_AppDriver;
 
+/** 任务队列的统计信息，时间的单位都是纳秒 */
+typedef struct LCUI_TaskQueueStatsRec_ {
+	size_t capacity;		/**< 环形缓冲区的容量 */
+	size_t depth;			/**< 当前排队中的任务数量 */
+	size_t max_depth;		/**< 分发任务时观察到的最大排队数量 */
+	unsigned long posted;		/**< 已添加的任务数量 */
+	unsigned long dispatched;	/**< 已执行的任务数量 */
+	unsigned long overflows;	/**< 因缓冲区已满而暂存到溢出列表的任务数量 */
+	int64_t total_latency;		/**< 任务从添加到执行的累计等待时间 */
+	int64_t max_latency;		/**< 任务从添加到执行的最大等待时间 */
+} LCUI_TaskQueueStatsRec, *LCUI_TaskQueueStats;
+
 typedef struct LCUI_MainLoopRec_ {
 	int state;		/**< 主循环的状态 */
 	unsigned long int tid;	/**< 当前运行该主循环的线程的ID */
@@ -166,6 +179,9 @@ LCUI_API LCUI_BOOL LCUI_PostTask( LCUI_AppTask task );
 /** 销毁任务 */
 LCUI_API void LCUI_DeleteTask( LCUI_AppTask task );
 
+/** 获取任务队列的统计信息 */
+LCUI_API void LCUI_GetTaskQueueStats( LCUI_TaskQueueStats stats );
+
 /* 运行任务 */
 LCUI_API int LCUI_RunTask( LCUI_AppTask task );
 
@@ -0,0 +1,90 @@
+/* ***************************************************************************
+ * headless_display.h -- offscreen surface support without a window system.
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * headless_display.h -- 无窗口系统的图形显示功能支持，在内存中绘制。
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+//#define DEBUG
+
+#ifndef LCUI_HEADLESS_DISPLAY_H
+#define LCUI_HEADLESS_DISPLAY_H
+
+/** 无窗口模式下的默认屏幕尺寸 */
+#define HEADLESS_DEFAULT_WIDTH	1280
+#define HEADLESS_DEFAULT_HEIGHT	720
+
+/** 无窗口显示驱动的呈现操作统计信息 */
+typedef struct LCUI_HeadlessDisplayStatsRec_ {
+	unsigned long presents;	/**< 呈现次数，即已完成的帧数 */
+	unsigned long rects;	/**< 呈现的矩形数量 */
+	unsigned long pixels;	/**< 呈现的像素数量 */
+	unsigned long dumps;	/**< 保存为 PNG 文件的帧数 */
+} LCUI_HeadlessDisplayStatsRec, *LCUI_HeadlessDisplayStats;
+
+/**
+ * 创建无窗口显示驱动
+ * surface 的内容只绘制在内存中，可用于在没有窗口系统的服务器上运行性能测试
+ * 和渲染测试。设置了环境变量 LCUI_HEADLESS_DUMP 时，每一帧都会保存到它指定
+ * 的目录中。
+ * @param[in] width 屏幕宽度
+ * @param[in] height 屏幕高度
+ */
+LCUI_API LCUI_DisplayDriver LCUI_CreateHeadlessDisplay( int width, int height );
+
+LCUI_API void LCUI_DestroyHeadlessDisplay( LCUI_DisplayDriver driver );
+
+/**
+ * 设置保存帧图像的目录
+ * 每次呈现 surface 后都会将它的内容保存为 <目录>/<帧序号>-<surface 序号>.png
+ * @param[in] dir 目录路径，为 NULL 时不保存
+ */
+LCUI_API void LCUI_SetHeadlessDisplayDumpDir( const char *dir );
+
+/**
+ * 复制 surface 当前已呈现的内容
+ * @param[in] surface 由无窗口显示驱动创建的 surface
+ * @param[out] buff 用于存放内容的图像，需要先用 Graph_Init() 初始化
+ */
+LCUI_API int LCUI_ReadHeadlessSurface( LCUI_Surface surface, LCUI_Graph *buff );
+
+/** 将 surface 当前已呈现的内容保存为 PNG 文件 */
+LCUI_API int LCUI_WriteHeadlessSurfacePNG( LCUI_Surface surface,
+					   const char *filename );
+
+/** 获取无窗口显示驱动的呈现操作统计信息 */
+LCUI_API void LCUI_GetHeadlessDisplayStats( LCUI_HeadlessDisplayStats stats );
+
+#endif
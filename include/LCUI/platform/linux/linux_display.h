@@ -1,11 +1,14 @@
 #ifndef LCUI_LINUX_DISPLAY_H
 #define LCUI_LINUX_DISPLAY_H
 
+#include <LCUI/platform/headless_display.h>
 #include <LCUI/platform/linux/linux_fbdisplay.h>
+#ifdef LCUI_VIDEO_DRIVER_X11
 #include <LCUI/platform/linux/linux_x11display.h>
+#endif
 
-int LCUI_InitLinuxDisplay( LCUI_DisplayDriver driver );
+LCUI_DisplayDriver LCUI_CreateLinuxDisplay( void );
 
-int LCUI_ExitLinuxDisplay( void );
+void LCUI_DestroyLinuxDisplay( LCUI_DisplayDriver driver );
 
 #endif
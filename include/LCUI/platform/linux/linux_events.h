@@ -40,8 +40,24 @@
 #ifndef LCUI_LINUX_EVENTS_H
 #define LCUI_LINUX_EVENTS_H
 
+#ifdef LCUI_VIDEO_DRIVER_X11
 #include <LCUI/platform/linux/linux_x11events.h>
+#endif
+
+/** 应用程序的运行模式，它决定了使用哪种显示、输入驱动 */
+enum LCUI_LinuxAppMode {
+	LCUI_APP_MODE_FRAMEBUFFER,	/**< 直接在帧缓存上绘制，没有窗口系统 */
+	LCUI_APP_MODE_X11,		/**< 以 X11 窗口的形式运行 */
+	LCUI_APP_MODE_HEADLESS		/**< 只在内存中绘制，不显示 */
+};
+
+/** 获取应用程序的运行模式 */
+int LCUI_GetLinuxAppMode( void );
+
+void LCUI_PreInitLinuxApp( void *data );
+
+LCUI_AppDriver LCUI_CreateLinuxAppDriver( void );
 
-int LCUI_InitLinuxApp( LCUI_AppDriver app );
+void LCUI_DestroyLinuxAppDriver( LCUI_AppDriver app );
 
 #endif
@@ -37,3 +37,54 @@
  * 没有，请查看：<http://www.gnu.org/licenses/>.
  * ****************************************************************************/
 
+
+#ifndef LCUI_LINUX_FB_DISPLAY_H
+#define LCUI_LINUX_FB_DISPLAY_H
+
+/** 默认的帧缓存设备 */
+#define LINUX_FBDEV_DEFAULT	"/dev/fb0"
+
+/** 帧缓存的信息 */
+typedef struct LCUI_FrameBufferInfoRec_ {
+	int width;		/**< 屏幕宽度 */
+	int height;		/**< 屏幕高度 */
+	int bits_per_pixel;	/**< 每个像素的位数，支持 16、24 和 32 */
+	int line_length;	/**< 每行像素占用的字节数 */
+	int xoffset;		/**< 可见区域在虚拟屏幕中的横坐标 */
+	int yoffset;		/**< 可见区域在虚拟屏幕中的纵坐标 */
+	int red_offset;		/**< 红色分量在像素中的位偏移 */
+	int green_offset;	/**< 绿色分量在像素中的位偏移 */
+	int blue_offset;	/**< 蓝色分量在像素中的位偏移 */
+} LCUI_FrameBufferInfoRec, *LCUI_FrameBufferInfo;
+
+/** 帧缓存显示驱动的呈现操作统计信息 */
+typedef struct LCUI_FBDisplayStatsRec_ {
+	unsigned long presents;	/**< 呈现次数 */
+	unsigned long rects;	/**< 复制到帧缓存的矩形数量 */
+	unsigned long pixels;	/**< 复制到帧缓存的像素数量 */
+} LCUI_FBDisplayStatsRec, *LCUI_FBDisplayStats;
+
+/**
+ * 创建帧缓存显示驱动
+ * 帧缓存设备的路径由环境变量 LCUI_FBDEV 指定，默认为 /dev/fb0
+ * 设置环境变量 LCUI_FB_DITHER=1 后，16 位的帧缓存会使用有序抖动
+ */
+LCUI_DisplayDriver LCUI_CreateLinuxFBDisplay( void );
+
+/**
+ * 用已打开的文件作为帧缓存，创建帧缓存显示驱动
+ * 文件可以是普通文件或 memfd，便于在没有帧缓存设备的环境中测试
+ * 颜色分量的位偏移全为 0 时，按 LCUI 默认的 RGB 顺序处理
+ * @param[in] fd 文件描述符，大小至少为
+ *  info->line_length * (info->yoffset + info->height)
+ * @param[in] info 帧缓存的信息
+ */
+LCUI_DisplayDriver LCUI_CreateLinuxFBDisplayByFile( int fd,
+				const LCUI_FrameBufferInfoRec *info );
+
+/** 获取帧缓存显示驱动的呈现操作统计信息 */
+void LCUI_GetLinuxFBDisplayStats( LCUI_FBDisplayStats stats );
+
+void LCUI_DestroyLinuxFBDisplay( LCUI_DisplayDriver driver );
+
+#endif
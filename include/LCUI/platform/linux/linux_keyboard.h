@@ -1,7 +1,9 @@
 #ifndef LCUI_LINUX_KEYBOARD_H
 #define LCUI_LINUX_KEYBOARD_H
 
+#ifdef LCUI_VIDEO_DRIVER_X11
 #include <LCUI/platform/linux/linux_x11keyboard.h>
+#endif
 
 void LCUI_InitLinuxKeyboard( void );
 
@@ -40,7 +40,9 @@
 #ifndef LCUI_LINUX_MOUSE_H
 #define LCUI_LINUX_MOUSE_H
 
+#ifdef LCUI_VIDEO_DRIVER_X11
 #include <LCUI/platform/linux/linux_x11mouse.h>
+#endif
 
 void LCUI_InitLinuxMouse( void );
 
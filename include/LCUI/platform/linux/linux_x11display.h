@@ -40,8 +40,20 @@
 #ifndef LCUI_LINUX_X11_DISPLAY_H
 #define LCUI_LINUX_X11_DISPLAY_H
 
-int LCUI_InitLinuxX11Display( LCUI_DisplayDriver driver );
+/** X11 显示驱动的呈现操作统计信息 */
+typedef struct LCUI_X11DisplayStatsRec_ {
+	LCUI_BOOL use_shm;	/**< 是否在通过 MIT-SHM 扩展上传帧缓存 */
+	unsigned long presents;	/**< 呈现次数 */
+	unsigned long rects;	/**< 上传的矩形数量 */
+	unsigned long pixels;	/**< 上传的像素数量 */
+	unsigned long waits;	/**< 绘制前等待 X 服务器读取完帧缓存的次数 */
+} LCUI_X11DisplayStatsRec, *LCUI_X11DisplayStats;
 
-int LCUI_ExitLinuxX11Display( void );
+LCUI_DisplayDriver LCUI_CreateLinuxX11Display( void );
+
+void LCUI_DestroyLinuxX11Display( LCUI_DisplayDriver driver );
+
+/** 获取 X11 显示驱动的呈现操作统计信息 */
+void LCUI_GetLinuxX11DisplayStats( LCUI_X11DisplayStats stats );
 
 #endif
\ No newline at end of file
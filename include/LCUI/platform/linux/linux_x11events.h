@@ -52,6 +52,7 @@ typedef struct LCUI_X11AppDriverRec_ {
 	Window win_main;
 	Colormap cmap;
 	Atom wm_lcui;
+	int wakeup_fd[2];	/**< 用于唤醒事件循环的文件描述符，[0] 读，[1] 写 */
 	LCUI_EventTrigger trigger;
 } LCUI_X11AppDriverRec, *LCUI_X11AppDriver;
 
@@ -59,6 +60,8 @@ void LCUI_SetLinuxX11MainWindow( Window win );
 
 void LCUI_PreInitLinuxX11App( void *data );
 
-int LCUI_InitLinuxX11App( LCUI_AppDriver app );
+LCUI_AppDriver LCUI_CreateLinuxX11AppDriver( void );
+
+void LCUI_DestroyLinuxX11AppDriver( LCUI_AppDriver app );
 
 #endif
@@ -47,11 +47,13 @@
 typedef pthread_t LCUI_Thread;
 typedef pthread_mutex_t LCUI_Mutex;
 typedef pthread_cond_t LCUI_Cond;
+typedef pthread_rwlock_t LCUI_RWLock;
 #else
 #ifdef LCUI_THREAD_WIN32
 #include <windows.h>
 typedef HANDLE LCUI_Mutex;
 typedef HANDLE LCUI_Cond;
+typedef SRWLOCK LCUI_RWLock;
 typedef unsigned int LCUI_Thread;
 #else
 #error 'Need thread implementation for this platform'
@@ -79,6 +81,28 @@ LCUI_API int LCUIMutex_Unlock( LCUI_Mutex *mutex );
 
 /*------------------------------- Mutex <END> -------------------------------*/
 
+/*----------------------------- RWLock <START> ------------------------------*/
+
+/** 初始化一个读写锁 */
+LCUI_API int LCUIRWLock_Init( LCUI_RWLock *lock );
+
+/** 销毁一个读写锁 */
+LCUI_API void LCUIRWLock_Destroy( LCUI_RWLock *lock );
+
+/** 以共享方式锁定，允许多个线程同时持有 */
+LCUI_API int LCUIRWLock_ReadLock( LCUI_RWLock *lock );
+
+/** 解除共享方式的锁定 */
+LCUI_API int LCUIRWLock_ReadUnlock( LCUI_RWLock *lock );
+
+/** 以独占方式锁定，会等待所有共享锁定被解除 */
+LCUI_API int LCUIRWLock_WriteLock( LCUI_RWLock *lock );
+
+/** 解除独占方式的锁定 */
+LCUI_API int LCUIRWLock_WriteUnlock( LCUI_RWLock *lock );
+
+/*------------------------------ RWLock <END> -------------------------------*/
+
 /*------------------------------ Cond <START> -------------------------------*/
 
 /** 初始化一个条件变量 */
@@ -90,7 +114,10 @@ LCUI_API int LCUICond_Destroy( LCUI_Cond *cond );
 /** 阻塞当前线程，等待条件成立 */
 LCUI_API int LCUICond_Wait( LCUI_Cond *cond, LCUI_Mutex *mutex );
 
-/** 计时阻塞当前线程，等待条件成立 */
+/**
+ * 计时阻塞当前线程，等待条件成立
+ * 超时时间按单调时钟计算，不受系统时间被修改的影响
+ */
 LCUI_API int LCUICond_TimedWait( LCUI_Cond *cond, LCUI_Mutex *mutex, unsigned int ms );
 
 /** 唤醒一个阻塞等待条件成立的线程 */
@@ -45,6 +45,9 @@
 #include <LCUI/util/linkedlist.h>
 #include <LCUI/util/dict.h>
 #include <LCUI/util/rect.h>
+#include <LCUI/util/region.h>
+#include <LCUI/util/arena.h>
+#include <LCUI/util/lrucache.h>
 #include <LCUI/util/framectrl.h>
 #include <LCUI/util/string.h>
 #include <LCUI/util/parse.h>
@@ -0,0 +1,98 @@
+/* ***************************************************************************
+ * arena.h -- bump allocator for short-lived memory
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * arena.h -- 用于短期内存的线性分配器
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+
+#ifndef LCUI_UTIL_ARENA_H
+#define LCUI_UTIL_ARENA_H
+
+LCUI_BEGIN_HEADER
+
+/** 回收周期的帧数，即检查一次是否需要缩小容量所间隔的重置次数 */
+#define ARENA_TRIM_FRAMES	60
+
+typedef struct LCUI_ArenaBlockRec_ LCUI_ArenaBlockRec, *LCUI_ArenaBlock;
+
+/**
+ * 线性分配器
+ * 从预先分配的内存块中按顺序划出内存，不能单独释放，只能一次性全部重置，适合
+ * 存放在一帧内用完即弃的数据。重置时会将多个内存块合并成一个足够大的块，之后
+ * 用量相近的帧就不需要再调用 malloc()。每隔 ARENA_TRIM_FRAMES 次重置，如果
+ * 这段时间内的用量峰值不到容量的一半，则将容量缩小到峰值，避免偶尔一帧的大量
+ * 分配使内存一直被占用。
+ */
+typedef struct LCUI_ArenaRec_ {
+	LCUI_ArenaBlock blocks;		/**< 内存块链表，表头是正在使用的块 */
+	size_t block_size;		/**< 新内存块的最小容量 */
+	size_t used;			/**< 已分配的字节数 */
+	size_t peak;			/**< 本回收周期内已分配的字节数的峰值 */
+	size_t capacity;		/**< 所有内存块的总容量 */
+	unsigned frames;		/**< 本回收周期内已重置的次数 */
+	unsigned long allocs;		/**< 分配次数 */
+	unsigned long blocks_created;	/**< 创建内存块的次数 */
+	unsigned long trims;		/**< 缩小容量的次数 */
+} LCUI_ArenaRec, *LCUI_Arena;
+
+/**
+ * 初始化分配器
+ * @param[in] block_size 内存块的最小容量，为 0 时使用默认值
+ */
+LCUI_API void Arena_Init( LCUI_Arena arena, size_t block_size );
+
+/** 销毁分配器，释放所有内存块 */
+LCUI_API void Arena_Destroy( LCUI_Arena arena );
+
+/**
+ * 分配内存
+ * 分配的内存按 16 字节对齐，内容未初始化
+ * @returns 分配失败时返回 NULL
+ */
+LCUI_API void *Arena_Alloc( LCUI_Arena arena, size_t size );
+
+/**
+ * 重置分配器，之前分配的内存全部失效
+ * 每次重置视为一帧结束，回收周期结束时会按需缩小容量，并清零峰值
+ */
+LCUI_API void Arena_Reset( LCUI_Arena arena );
+
+/** 判断内存是否由该分配器分配 */
+LCUI_API LCUI_BOOL Arena_Contains( LCUI_Arena arena, const void *ptr );
+
+LCUI_END_HEADER
+
+#endif
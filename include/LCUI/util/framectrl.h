@@ -49,6 +49,27 @@ typedef struct FrameControlRec_* FrameControl;
 typedef void* FrameControl;
 #endif
 
+/** 一帧中的各个处理阶段 */
+typedef enum LCUI_FrameStage {
+	FRAME_STAGE_UPDATE,	/**< 处理部件任务，不含布局 */
+	FRAME_STAGE_LAYOUT,	/**< 计算部件布局 */
+	FRAME_STAGE_RENDER,	/**< 重绘无效区域 */
+	FRAME_STAGE_PRESENT,	/**< 将绘制结果呈现到屏幕上 */
+	FRAME_STAGE_TOTAL_NUM
+} LCUI_FrameStage;
+
+/** 帧的耗时统计，时间的单位都是纳秒 */
+typedef struct LCUI_FrameStatsRec_ {
+	unsigned long frames;			/**< 已统计的帧数 */
+	unsigned long missed_frames;		/**< 未能在预定时间内完成的帧数 */
+	int64_t frame_time;			/**< 上一帧的时长 */
+	int64_t last[FRAME_STAGE_TOTAL_NUM];	/**< 上一帧中各阶段的耗时 */
+	int64_t total[FRAME_STAGE_TOTAL_NUM];	/**< 各阶段的累计耗时 */
+	int64_t max[FRAME_STAGE_TOTAL_NUM];	/**< 各阶段在单帧中的最大耗时 */
+	int64_t idle_time;			/**< 累计的空闲时长 */
+	unsigned int idle_percent;		/**< 最近一秒内空闲时间所占的百分比 */
+} LCUI_FrameStatsRec, *LCUI_FrameStats;
+
 /** 新建帧数控制实例 */
 LCUI_API FrameControl FrameControl_Create( void );
 
@@ -68,6 +89,28 @@ LCUI_API void FrameControl_Remain( FrameControl ctx );
 /** 暂停数据帧的更新 */
 LCUI_API void FrameControl_Pause( FrameControl ctx, LCUI_BOOL need_pause );
 
+/**
+ * 设置是否按需更新
+ * 启用后，如果在上一帧开始后没有调用过 FrameControl_Request()，
+ * FrameControl_Remain() 会一直等待，直到有新的请求为止
+ */
+LCUI_API void FrameControl_SetOnDemand( FrameControl ctx, LCUI_BOOL enabled );
+
+/** 请求开始下一帧，可以在任意线程中调用 */
+LCUI_API void FrameControl_Request( FrameControl ctx );
+
+/**
+ * 累加当前帧中某个阶段的耗时
+ * 在调用 FrameControl_Remain() 结束当前帧时计入统计
+ * @param[in] stage 处理阶段
+ * @param[in] ns 耗时，单位为纳秒
+ */
+LCUI_API void FrameControl_AddStageTime( FrameControl ctx,
+					 LCUI_FrameStage stage, int64_t ns );
+
+/** 获取帧的耗时统计 */
+LCUI_API void FrameControl_GetStats( FrameControl ctx, LCUI_FrameStats stats );
+
 LCUI_END_HEADER
 
 #endif
@@ -0,0 +1,123 @@
+/* ***************************************************************************
+ * lrucache.h -- reference-counted LRU cache
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * lrucache.h -- 带引用计数的最近最少使用缓存
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#ifndef LCUI_UTIL_LRUCACHE_H
+#define LCUI_UTIL_LRUCACHE_H
+
+LCUI_BEGIN_HEADER
+
+#ifdef LCUI_UTIL_LRUCACHE_C
+typedef struct LRUCacheRec_* LRUCache;
+#else
+typedef void* LRUCache;
+#endif
+
+/**
+ * 缓存项
+ * 嵌入在被缓存的对象中，创建者在调用 LRUCache_Add() 前设置 data、key 和 size，
+ * 其余成员由缓存维护
+ */
+typedef struct LCUI_LRUCacheEntryRec_ {
+	void *data;		/**< 被缓存的对象 */
+	const void *key;	/**< 索引，通常指向对象中的成员 */
+	size_t size;		/**< 对象占用的内存 */
+	int refs;		/**< 正在使用该对象的操作数量 */
+	LCUI_BOOL is_cached;	/**< 是否在缓存中，不在缓存中的对象用完后销毁 */
+	LinkedListNode node;	/**< 在最近使用列表中的结点 */
+} LCUI_LRUCacheEntryRec, *LCUI_LRUCacheEntry;
+
+/** 缓存的统计信息 */
+typedef struct LCUI_LRUCacheStatsRec_ {
+	unsigned long hits;	/**< 命中次数 */
+	unsigned long misses;	/**< 未命中次数 */
+	size_t used_bytes;	/**< 缓存中的对象占用的内存 */
+	size_t max_bytes;	/**< 内存预算 */
+	int count;		/**< 缓存中的对象数量 */
+} LCUI_LRUCacheStatsRec, *LCUI_LRUCacheStats;
+
+/**
+ * 新建缓存
+ * 超出内存预算时淘汰最久未使用且未被引用的对象，所有操作都是线程安全的
+ * @param[in] key_size 索引的字节数，索引按字节比较，其中的填充字节需要清零
+ * @param[in] max_bytes 内存预算
+ * @param[in] destroy 销毁对象的函数
+ */
+LCUI_API LRUCache LRUCache_Create( size_t key_size, size_t max_bytes,
+				   void (*destroy)(void*) );
+
+/** 销毁缓存，缓存中的对象也会被销毁 */
+LCUI_API void LRUCache_Destroy( LRUCache cache );
+
+/**
+ * 查找对象
+ * 找到时增加对象的引用计数，用完后需调用 LRUCache_Release() 释放
+ * @returns 找到时返回对象，否则返回 NULL
+ */
+LCUI_API void *LRUCache_Get( LRUCache cache, const void *key );
+
+/**
+ * 添加对象
+ * 添加后对象的引用计数为 1，用完后需调用 LRUCache_Release() 释放。如果其它线程
+ * 已经添加了索引相同的对象，则销毁新对象，改为返回已有的对象；超出内存预算的
+ * 对象不会被缓存，释放后即被销毁。
+ * @returns 可以使用的对象
+ */
+LCUI_API void *LRUCache_Add( LRUCache cache, LCUI_LRUCacheEntry entry );
+
+/** 释放对象，不在缓存中的对象在引用计数归零时销毁 */
+LCUI_API void LRUCache_Release( LRUCache cache, LCUI_LRUCacheEntry entry );
+
+/**
+ * 移除满足条件的对象，正在使用的对象会在释放后销毁
+ * @param[in] match 判断对象是否需要移除的函数
+ * @param[in] arg 传给 match 的参数
+ */
+LCUI_API void LRUCache_RemoveIf( LRUCache cache,
+				 LCUI_BOOL (*match)(void*, const void*),
+				 const void *arg );
+
+/** 设置内存预算，并淘汰超出预算的对象 */
+LCUI_API void LRUCache_SetMaxBytes( LRUCache cache, size_t max_bytes );
+
+/** 获取缓存的统计信息 */
+LCUI_API void LRUCache_GetStats( LRUCache cache, LCUI_LRUCacheStats stats );
+
+LCUI_END_HEADER
+
+#endif
@@ -0,0 +1,92 @@
+/* ***************************************************************************
+ * region.h -- banded rectangle region for dirty area tracking
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * region.h -- 用于记录无效区域的带状矩形区域
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+
+#ifndef LCUI_UTIL_REGION_H
+#define LCUI_UTIL_REGION_H
+
+LCUI_BEGIN_HEADER
+
+/**
+ * 区域
+ * 区域由互不重叠的矩形组成，矩形按 y、x 坐标排序，并被划分成若干个水平带，同一
+ * 带中的矩形有相同的 y 坐标和高度。矩形存放在一块连续的内存中，清空区域时不会
+ * 释放这块内存，以便下次复用。
+ */
+typedef struct LCUI_RegionRec_ {
+	LCUI_Rect *rects;	/**< 矩形数组 */
+	int length;		/**< 矩形数量 */
+	int capacity;		/**< 矩形数组的容量 */
+	LCUI_Rect *buffer;	/**< 运算时使用的临时矩形数组 */
+	int buffer_capacity;	/**< 临时矩形数组的容量 */
+} LCUI_RegionRec, *LCUI_Region;
+
+#define Region_IsEmpty(R) ((R)->length <= 0)
+
+/** 初始化区域 */
+LCUI_API void Region_Init( LCUI_Region region );
+
+/** 清空区域，保留已分配的内存 */
+LCUI_API void Region_Clear( LCUI_Region region );
+
+/** 销毁区域，释放已分配的内存 */
+LCUI_API void Region_Destroy( LCUI_Region region );
+
+/** 将矩形合并到区域中 */
+LCUI_API int Region_Union( LCUI_Region region, const LCUI_Rect *rect );
+
+/** 从区域中减去矩形 */
+LCUI_API int Region_Subtract( LCUI_Region region, const LCUI_Rect *rect );
+
+/**
+ * 向区域添加一个无效区域
+ * 如果用矩形及与它相邻的矩形的外接矩形代替它们所浪费的面积较小，则直接添加这
+ * 个外接矩形，以减少区域中的矩形数量。
+ */
+LCUI_API int Region_AddRect( LCUI_Region region, const LCUI_Rect *rect );
+
+/** 计算区域在矩形内的面积 */
+LCUI_API int Region_GetAreaIn( LCUI_Region region, const LCUI_Rect *rect );
+
+/** 获取区域的外接矩形 */
+LCUI_API void Region_GetExtents( LCUI_Region region, LCUI_Rect *extents );
+
+LCUI_END_HEADER
+
+#endif
@@ -44,10 +44,17 @@ LCUI_BEGIN_HEADER
 
 LCUI_API void LCUITime_Init( void );
 
+/** 获取单调递增的时间（单位：毫秒），不受系统时间被修改的影响 */
 LCUI_API int64_t LCUI_GetTime( void );
 
 LCUI_API int64_t LCUI_GetTimeDelta( int64_t start );
 
+/** 获取单调递增的高精度时间（单位：纳秒），只适合用于计算时间间隔 */
+LCUI_API int64_t LCUI_GetTimeNS( void );
+
+/** 获取从 start 到现在经过的时间（单位：纳秒） */
+LCUI_API int64_t LCUI_GetTimeDeltaNS( int64_t start );
+
 LCUI_API void LCUI_Sleep( unsigned int s );
 
 LCUI_API void LCUI_MSleep( unsigned int ms );
@@ -38,10 +38,12 @@
  * ***************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
+#include <LCUI/graph_convert.h>
 
 /* 这个结构体用于存储bmp文件的文件头的信息 */
 typedef struct bmp_head {
@@ -60,7 +62,8 @@ int Graph_LoadBMP( const char *filepath, LCUI_Graph *out )
 {
 	bmp_head bmp;
 	uchar_t *bytep;
-	int  x, y, tempi, pocz, omin;
+	uchar_t *row;
+	int y, tempi, pocz, omin, row_size, color_type;
 	FILE *fp = fopen( filepath, "rb" );
 	if( !fp ) {
 		return ENOENT;
@@ -86,42 +89,27 @@ int Graph_LoadBMP( const char *filepath, LCUI_Graph *out )
 	omin = omin - pocz;
 	omin = omin - ((out->w*out->h)*(bmp.depth / 8));
 	omin = omin / (out->h);
+	if( omin < 0 ) {
+		omin = 0;
+	}
+	/* 每次读取一整行，包括行尾的填充字符 */
+	row_size = out->w * (bmp.depth / 8) + omin;
+	row = malloc( row_size );
+	if( !row ) {
+		fclose( fp );
+		return 1;
+	}
+	color_type = bmp.depth == 32 ? COLOR_TYPE_ARGB : COLOR_TYPE_RGB;
 	fseek( fp, pocz, SEEK_SET );
-	switch( bmp.depth ) {
-	case 32:
-		for( y = 0; y < out->h; ++y ) {
-			/* 从最后一行开始写入像素数据 */
-			bytep = out->bytes + ((out->h - y - 1)*out->w) * 3;
-			for( x = 0; x < out->w; ++x ) {
-				*bytep++ = fgetc( fp );
-				*bytep++ = fgetc( fp );
-				*bytep++ = fgetc( fp );
-				tempi = fgetc( fp );
-			}
-			/* 略过填充字符 */
-			if( omin > 0 ) {
-				for( tempi = 0; tempi < omin; tempi++ ) {
-					fgetc( fp );
-				}
-			}
-		}
-		break;
-	case 24:
-		for( y = 0; y < out->h; ++y ) {
-			bytep = out->bytes + ((out->h - y - 1)*out->w) * 3;
-			for( x = 0; x < out->w; ++x ) {
-				*bytep++ = fgetc( fp );
-				*bytep++ = fgetc( fp );
-				*bytep++ = fgetc( fp );
-			}
-			if( omin > 0 ) {
-				for( tempi = 0; tempi < omin; tempi++ ) {
-					fgetc( fp );
-				}
-			}
+	for( y = 0; y < out->h; ++y ) {
+		if( fread( row, 1, row_size, fp ) < (size_t)row_size ) {
+			break;
 		}
-		break;
+		/* 从最后一行开始写入像素数据 */
+		bytep = out->bytes + (out->h - y - 1) * out->bytes_per_row;
+		Pixels_Convert( bytep, COLOR_TYPE_RGB, row, color_type, out->w );
 	}
+	free( row );
 	fclose( fp );
 	return 0;
 }
@@ -43,6 +43,7 @@
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
+#include <LCUI/graph_convert.h>
 
 #ifdef USE_LIBJPEG
 /* *********************************************************************
@@ -82,7 +83,7 @@ int Graph_LoadJPEG( const char *filepath, LCUI_Graph *buf )
 	JSAMPARRAY buffer;
 	struct my_error_mgr jerr;
 	struct jpeg_decompress_struct cinfo;
-	int x, y, n, k, row_stride, jaka;
+	int y, n, row_stride, jaka;
 
 	fp = fopen( filepath, "rb" );
 	if( !fp ) {
@@ -118,19 +119,12 @@ int Graph_LoadJPEG( const char *filepath, LCUI_Graph *buf )
 	for( y = 0; cinfo.output_scanline < cinfo.output_height; ++y ) {
 		(void)jpeg_read_scanlines( &cinfo, buffer, 1 );
 		if( jaka == 3 ) {
-			for( x = 0; x < buf->w; x++ ) {
-				k = x * 3;
-				*bytep++ = buffer[0][k + 2];
-				*bytep++ = buffer[0][k + 1];
-				*bytep++ = buffer[0][k];
-			}
+			Pixels_SwapRB( bytep, buffer[0], COLOR_TYPE_RGB, buf->w );
 		} else {
-			for( x = 0; x < buf->w; x++ ) {
-				*bytep++ = buffer[0][x];
-				*bytep++ = buffer[0][x];
-				*bytep++ = buffer[0][x];
-			}
+			Pixels_Convert( bytep, COLOR_TYPE_RGB, buffer[0],
+					COLOR_TYPE_GRAY8, buf->w );
 		}
+		bytep += buf->bytes_per_row;
 	}
 	(void)jpeg_finish_decompress( &cinfo );
 	jpeg_destroy_decompress( &cinfo );
@@ -43,6 +43,7 @@
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
+#include <LCUI/graph_convert.h>
 
 #ifdef USE_LIBPNG
 #include <png.h>
@@ -59,7 +60,7 @@ int Graph_LoadPNG( const char *filepath, LCUI_Graph *graph )
 	png_infop info_ptr;
 	png_bytep* row_pointers;
 	char buf[PNG_BYTES_TO_CHECK];
-	int w, h, x, y, ret = 0, temp, color_type;
+	int w, h, y, ret = 0, temp, color_type;
 
 	fp = fopen( filepath, "rb" );
 	if( fp == NULL ) {
@@ -109,17 +110,14 @@ int Graph_LoadPNG( const char *filepath, LCUI_Graph *graph )
 			break;
 		}
 		pixel_ptr = graph->bytes;
+		/*
+		 * Graph的像素数据存储格式是BGRA，而PNG库
+		 * 提供像素数据的是RGBA格式的，因此需要交换红色和蓝色
+		 */
 		for( y = 0; y < h; ++y ) {
-			/*
-			 * Graph的像素数据存储格式是BGRA，而PNG库
-			 * 提供像素数据的是RGBA格式的，因此需要调整写入顺序
-			 */
-			for( x = 0; x < w * 4; x += 4 ) {
-				*pixel_ptr++ = row_pointers[y][x + 2];
-				*pixel_ptr++ = row_pointers[y][x + 1];
-				*pixel_ptr++ = row_pointers[y][x];
-				*pixel_ptr++ = row_pointers[y][x + 3];
-			}
+			Pixels_SwapRB( pixel_ptr, row_pointers[y],
+				       COLOR_TYPE_ARGB, w );
+			pixel_ptr += graph->bytes_per_row;
 		}
 		break;
 
@@ -132,11 +130,24 @@ int Graph_LoadPNG( const char *filepath, LCUI_Graph *graph )
 		}
 		pixel_ptr = graph->bytes;
 		for( y = 0; y < h; ++y ) {
-			for( x = 0; x < w * 3; x += 3 ) {
-				*pixel_ptr++ = row_pointers[y][x + 2];
-				*pixel_ptr++ = row_pointers[y][x + 1];
-				*pixel_ptr++ = row_pointers[y][x];
-			}
+			Pixels_SwapRB( pixel_ptr, row_pointers[y],
+				       COLOR_TYPE_RGB, w );
+			pixel_ptr += graph->bytes_per_row;
+		}
+		break;
+
+	case PNG_COLOR_TYPE_GRAY:
+		graph->color_type = COLOR_TYPE_RGB;
+		temp = Graph_Create( graph, w, h );
+		if( temp != 0 ) {
+			ret = -ENOMEM;
+			break;
+		}
+		pixel_ptr = graph->bytes;
+		for( y = 0; y < h; ++y ) {
+			Pixels_Convert( pixel_ptr, COLOR_TYPE_RGB,
+					row_pointers[y], COLOR_TYPE_GRAY8, w );
+			pixel_ptr += graph->bytes_per_row;
 		}
 		break;
 		/* 其它色彩类型的图像就读了 */
@@ -200,7 +211,7 @@ int Graph_WritePNG( const char *file_name, const LCUI_Graph *graph )
 	png_structp png_ptr;
 	png_infop info_ptr;
 	png_bytep *row_pointers;
-	int x, y, row_size;
+	int y, row_size;
 
 	if( !Graph_IsValid( graph ) ) {
 		_DEBUG_MSG( "graph is not valid\n" );
@@ -249,24 +260,19 @@ int Graph_WritePNG( const char *file_name, const LCUI_Graph *graph )
 	Graph_GetValidRect( graph, &rect );
 	graph = Graph_GetQuote( graph );
 	if( graph->color_type == COLOR_TYPE_ARGB ) {
-		LCUI_ARGB *px_ptr, *px_row_ptr;
+		LCUI_ARGB *px_row_ptr;
 
 		row_size = png_get_rowbytes( png_ptr, info_ptr );
 		px_row_ptr = graph->argb + rect.top * graph->width + rect.left;
 		row_pointers = (png_bytep*)malloc( rect.height*sizeof( png_bytep ) );
 		for( y = 0; y < rect.height; ++y ) {
 			row_pointers[y] = png_malloc( png_ptr, row_size );
-			px_ptr = px_row_ptr;
-			for( x = 0; x < row_size; ++px_ptr ) {
-				row_pointers[y][x++] = px_ptr->red;
-				row_pointers[y][x++] = px_ptr->green;
-				row_pointers[y][x++] = px_ptr->blue;
-				row_pointers[y][x++] = px_ptr->alpha;
-			}
+			Pixels_SwapRB( row_pointers[y], (uchar_t*)px_row_ptr,
+				       COLOR_TYPE_ARGB, rect.width );
 			px_row_ptr += graph->w;
 		}
 	} else {
-		uchar_t *px_ptr, *px_row_ptr;
+		uchar_t *px_row_ptr;
 
 		row_size = png_get_rowbytes( png_ptr, info_ptr );
 		px_row_ptr = graph->bytes + rect.top * graph->bytes_per_row;
@@ -274,12 +280,8 @@ int Graph_WritePNG( const char *file_name, const LCUI_Graph *graph )
 		row_pointers = (png_bytep*)malloc( rect.height*sizeof( png_bytep ) );
 		for( y = 0; y < rect.height; ++y ) {
 			row_pointers[y] = (png_bytep)malloc( row_size );
-			px_ptr = px_row_ptr;
-			for( x = 0; x < row_size; x += 3 ) {
-				row_pointers[y][x + 2] = *px_ptr++; // blue
-				row_pointers[y][x + 1] = *px_ptr++; // green
-				row_pointers[y][x] = *px_ptr++;   // red
-			}
+			Pixels_SwapRB( row_pointers[y], px_row_ptr,
+				       COLOR_TYPE_RGB, rect.width );
 			px_row_ptr += graph->bytes_per_row;
 		}
 	}
@@ -106,6 +106,8 @@ static void OnMouseMoveEvent( LCUI_SysEvent e, void *arg )
 {
 	cursor.new_pos.x += e->motion.xrel;
 	cursor.new_pos.y += e->motion.yrel;
+	/* 游标的位置由显示线程更新 */
+	LCUIDisplay_RequestUpdate();
 	_DEBUG_MSG("x: %d, y: %d\n", cursor.new_pos.x, cursor.new_pos.y);
 }
 
@@ -185,6 +187,7 @@ void LCUICursor_UpdatePos( void )
 void LCUICursor_SetPos( LCUI_Pos pos )
 {
 	cursor.new_pos = pos;
+	LCUIDisplay_RequestUpdate();
 }
 
 /** 设置游标的图形 */
@@ -42,10 +42,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <LCUI_Build.h>
+#ifdef LCUI_BUILD_IN_LINUX
+#include <unistd.h>
+#endif
 #include <LCUI/LCUI.h>
 #include <LCUI/input.h>
 #include <LCUI/timer.h>
 #include <LCUI/cursor.h>
+#include <LCUI/font.h>
 #include <LCUI/thread.h>
 #include <LCUI/display.h>
 #include <LCUI/platform.h>
@@ -54,6 +58,11 @@
 #define DEFAULT_WIDTH	800
 #define DEFAULT_HEIGHT	600
 
+/** 渲染线程的最大数量（不含显示线程） */
+#define MAX_RENDER_THREADS	7
+/** 渲染块的边长，无效区域会被切分成不大于该尺寸的块 */
+#define RENDER_TILE_SIZE	128
+
 /** surface 记录 */
 typedef struct SurfaceRecord {
 	LCUI_Surface surface;		/**< surface */
@@ -68,16 +77,148 @@ static struct DisplayContext {
 	FrameControl fc_ctx;		/**< 上下文句柄，用于画面更新时的帧数控制 */
 	LCUI_Thread thread;		/**< 线程，负责画面更新工作 */
 	LinkedList surfaces;		/**< surface 列表 */
+	LCUI_RegionRec rects;		/**< 无效区域，每一帧都复用它的内存 */
 	LCUI_Mutex mutex;
 	LCUI_DisplayDriver driver;
 } display = { LCDM_DEFAULT, FALSE, FALSE, NULL };
 
+/**
+ * 渲染线程池
+ * 显示线程将无效区域切分成互不重叠的块，由各个渲染线程与显示线程一起领取
+ * 并渲染，每个块各自引用 surface 帧缓存中的一块区域，因此无需额外加锁。
+ */
+static struct RenderPool {
+	int n_threads;			/**< 渲染线程数量 */
+	LCUI_BOOL is_running;		/**< 标志，指示渲染线程是否继续运行 */
+	LCUI_Thread threads[MAX_RENDER_THREADS];
+	LCUI_Mutex mutex;		/**< 互斥锁，保护以下的任务状态 */
+	LCUI_Cond cond_task;		/**< 条件变量，有新的块需要渲染 */
+	LCUI_Cond cond_done;		/**< 条件变量，所有块已经渲染完 */
+	LCUI_Surface surface;		/**< 当前渲染的 surface */
+	LCUI_Widget widget;		/**< 当前渲染的 widget */
+	LCUI_Rect *tiles;		/**< 待渲染的块 */
+	int n_tiles;			/**< 块的数量 */
+	int max_tiles;			/**< tiles 数组的容量 */
+	int next_tile;			/**< 下一个待领取的块 */
+	int n_done;			/**< 已渲染完的块的数量 */
+	/** 各个线程的临时内存，最后一个属于显示线程，每一帧结束时重置 */
+	LCUI_ArenaRec arenas[MAX_RENDER_THREADS + 1];
+} render;
+
 /** 获取当前的屏幕内容每秒更新的帧数 */
 int LCUIDisplay_GetFPS(void)
 {
 	return FrameControl_GetFPS( display.fc_ctx );
 }
 
+void LCUIDisplay_GetFrameStats( LCUI_FrameStats stats )
+{
+	FrameControl_GetStats( display.fc_ctx, stats );
+}
+
+void LCUIDisplay_RequestUpdate( void )
+{
+	if( !display.is_working ) {
+		return;
+	}
+	/* 显示线程在处理当前帧时产生的变化会在本帧内完成更新 */
+	if( LCUIThread_SelfID() == display.thread ) {
+		return;
+	}
+	FrameControl_Request( display.fc_ctx );
+}
+
+/** 获取当前线程的临时内存，不是渲染线程时返回 NULL */
+static LCUI_Arena RenderPool_GetArena( void )
+{
+	int i;
+	LCUI_Thread tid;
+	if( !render.is_running ) {
+		return NULL;
+	}
+	tid = LCUIThread_SelfID();
+	if( tid == display.thread ) {
+		return &render.arenas[MAX_RENDER_THREADS];
+	}
+	for( i = 0; i < render.n_threads; ++i ) {
+		if( tid == render.threads[i] ) {
+			return &render.arenas[i];
+		}
+	}
+	return NULL;
+}
+
+LCUI_PaintContext LCUIDisplay_NewPaintContext( LCUI_Rect *rect )
+{
+	LCUI_PaintContext paint = NULL;
+	LCUI_Arena arena = RenderPool_GetArena();
+	if( arena ) {
+		paint = Arena_Alloc( arena, sizeof( LCUI_PaintContextRec ) );
+	}
+	if( !paint ) {
+		arena = NULL;
+		paint = malloc( sizeof( LCUI_PaintContextRec ) );
+		if( !paint ) {
+			return NULL;
+		}
+	}
+	paint->rect = *rect;
+	paint->with_alpha = FALSE;
+	paint->arena = arena;
+	Graph_Init( &paint->canvas );
+	return paint;
+}
+
+void LCUIDisplay_FreePaintContext( LCUI_PaintContext paint )
+{
+	/* 临时内存中的上下文会在当前帧结束时统一回收 */
+	if( !paint->arena || !Arena_Contains( paint->arena, paint ) ) {
+		free( paint );
+	}
+}
+
+LCUI_PaintContext LCUIDisplay_BeginPaintBuffer( LCUI_RWLock *lock,
+						LCUI_Graph *fb,
+						LCUI_Rect *rect )
+{
+	LCUI_PaintContext paint;
+	paint = LCUIDisplay_NewPaintContext( rect );
+	if( !paint ) {
+		return NULL;
+	}
+	LCUIRWLock_ReadLock( lock );
+	LCUIRect_ValidateArea( &paint->rect, fb->w, fb->h );
+	Graph_Quote( &paint->canvas, fb, &paint->rect );
+	Graph_FillRect( &paint->canvas, RGB( 255, 255, 255 ), NULL, TRUE );
+	return paint;
+}
+
+void LCUIDisplay_EndPaintBuffer( LCUI_RWLock *lock, LCUI_Mutex *mutex,
+				 LCUI_Region rects, LCUI_PaintContext paint )
+{
+	LCUIMutex_Lock( mutex );
+	Region_Union( rects, &paint->rect );
+	LCUIMutex_Unlock( mutex );
+	LCUIRWLock_ReadUnlock( lock );
+	LCUIDisplay_FreePaintContext( paint );
+}
+
+void LCUIDisplay_GetPaintArenaStats( LCUI_PaintArenaStats stats )
+{
+	int i;
+	stats->peak_bytes = 0;
+	stats->capacity = 0;
+	stats->allocs = 0;
+	stats->blocks = 0;
+	for( i = 0; i <= MAX_RENDER_THREADS; ++i ) {
+		LCUI_Arena arena = &render.arenas[i];
+		stats->peak_bytes += arena->peak;
+		stats->capacity += arena->capacity;
+		stats->allocs += arena->allocs;
+		stats->blocks += arena->blocks_created;
+	}
+}
+
 static void DrawBorder( LCUI_PaintContext paint )
 {
 	LCUI_Pos pos;
@@ -95,14 +236,221 @@ static void DrawBorder( LCUI_PaintContext paint )
 	Graph_DrawHorizLine( &paint->canvas, color, 1, pos, end_x );
 }
 
+/** 渲染 surface 中的一块区域 */
+static void RenderTile( LCUI_Surface surface, LCUI_Widget widget,
+			LCUI_Rect *rect )
+{
+	LCUI_PaintContext paint;
+	paint = Surface_BeginPaint( surface, rect );
+	if( !paint ) {
+		return;
+	}
+	DEBUG_MSG( "[%s]: render rect: (%d,%d,%d,%d)\n", widget->type,
+		   paint->rect.left, paint->rect.top,
+		   paint->rect.w, paint->rect.h );
+	Widget_Render( widget, paint );
+	if( display.show_rect_border ) {
+		DrawBorder( paint );
+	}
+	Surface_EndPaint( surface, paint );
+}
+
+/**
+ * 领取并渲染块，直到没有剩余的块
+ * 调用前需锁定 render.mutex，返回时仍保持锁定
+ */
+static void RenderPool_TakeTiles( void )
+{
+	int i;
+	while( render.next_tile < render.n_tiles ) {
+		i = render.next_tile++;
+		LCUIMutex_Unlock( &render.mutex );
+		RenderTile( render.surface, render.widget, &render.tiles[i] );
+		LCUIMutex_Lock( &render.mutex );
+		if( ++render.n_done >= render.n_tiles ) {
+			LCUICond_Signal( &render.cond_done );
+		}
+	}
+}
+
+/** 渲染线程 */
+static void RenderPool_Thread( void *arg )
+{
+	LCUIMutex_Lock( &render.mutex );
+	while( render.is_running ) {
+		if( render.next_tile >= render.n_tiles ) {
+			LCUICond_Wait( &render.cond_task, &render.mutex );
+			continue;
+		}
+		RenderPool_TakeTiles();
+	}
+	LCUIMutex_Unlock( &render.mutex );
+	LCUIThread_Exit( NULL );
+}
+
+/** 添加一个待渲染的块，调用前需锁定 render.mutex */
+static int RenderPool_AddTile( LCUI_Rect *rect )
+{
+	LCUI_Rect *tiles;
+	if( render.n_tiles >= render.max_tiles ) {
+		int max_tiles = render.max_tiles * 2 + 16;
+		tiles = realloc( render.tiles, sizeof(LCUI_Rect)*max_tiles );
+		if( !tiles ) {
+			return -1;
+		}
+		render.tiles = tiles;
+		render.max_tiles = max_tiles;
+	}
+	render.tiles[render.n_tiles++] = *rect;
+	return 0;
+}
+
+/**
+ * 将无效区域切分成块
+ * 区域中的矩形互不重叠，所以切分出的块也不会重叠。调用前需锁定
+ * render.mutex，否则被提前唤醒的渲染线程会领取到未切分完的块
+ */
+static int RenderPool_SplitRects( LCUI_Region region )
+{
+	LCUI_Rect tile, *rect;
+	int i, x, y, right, bottom, n_tiles = 0;
+	for( i = 0; i < region->length; ++i ) {
+		rect = &region->rects[i];
+		right = rect->x + rect->width;
+		bottom = rect->y + rect->height;
+		for( y = rect->y; y < bottom; y += RENDER_TILE_SIZE ) {
+			tile.y = y;
+			tile.height = bottom - y;
+			if( tile.height > RENDER_TILE_SIZE ) {
+				tile.height = RENDER_TILE_SIZE;
+			}
+			for( x = rect->x; x < right; x += RENDER_TILE_SIZE ) {
+				tile.x = x;
+				tile.width = right - x;
+				if( tile.width > RENDER_TILE_SIZE ) {
+					tile.width = RENDER_TILE_SIZE;
+				}
+				if( RenderPool_AddTile( &tile ) != 0 ) {
+					return -1;
+				}
+				++n_tiles;
+			}
+		}
+	}
+	return n_tiles;
+}
+
+/** 渲染 surface 上的所有无效区域 */
+static void RenderPool_Render( LCUI_Surface surface, LCUI_Widget widget,
+			       LCUI_Region region )
+{
+	int i;
+	/* 块和当前帧的状态需要在同一次加锁中一起发布 */
+	LCUIMutex_Lock( &render.mutex );
+	/* 没有渲染线程或只有一个区域时，直接在当前线程中渲染 */
+	if( render.n_threads < 1 || RenderPool_SplitRects( region ) <= 1 ) {
+		render.n_tiles = 0;
+		render.next_tile = 0;
+		LCUIMutex_Unlock( &render.mutex );
+		for( i = 0; i < region->length; ++i ) {
+			RenderTile( surface, widget, &region->rects[i] );
+		}
+		return;
+	}
+	render.surface = surface;
+	render.widget = widget;
+	render.next_tile = 0;
+	render.n_done = 0;
+	LCUICond_Broadcast( &render.cond_task );
+	/* 显示线程也参与渲染，然后等待其它线程渲染完剩余的块 */
+	RenderPool_TakeTiles();
+	while( render.n_done < render.n_tiles ) {
+		LCUICond_Wait( &render.cond_done, &render.mutex );
+	}
+	render.n_tiles = 0;
+	render.next_tile = 0;
+	LCUIMutex_Unlock( &render.mutex );
+}
+
+/** 获取处理器核心数量 */
+static int GetNumberOfProcessors( void )
+{
+#ifdef LCUI_BUILD_IN_WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	return (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf( _SC_NPROCESSORS_ONLN );
+	return n > 0 ? (int)n : 1;
+#else
+	return 1;
+#endif
+}
+
+/** 初始化渲染线程池 */
+static void RenderPool_Init( void )
+{
+	int i, n;
+	render.tiles = NULL;
+	render.n_tiles = 0;
+	render.max_tiles = 0;
+	render.next_tile = 0;
+	render.n_done = 0;
+	render.n_threads = 0;
+	render.is_running = TRUE;
+	for( i = 0; i <= MAX_RENDER_THREADS; ++i ) {
+		Arena_Init( &render.arenas[i], 0 );
+	}
+	LCUIMutex_Init( &render.mutex );
+	LCUICond_Init( &render.cond_task );
+	LCUICond_Init( &render.cond_done );
+	/* 显示线程自身也会参与渲染，所以少创建一个线程 */
+	n = GetNumberOfProcessors() - 1;
+	if( n > MAX_RENDER_THREADS ) {
+		n = MAX_RENDER_THREADS;
+	}
+	for( i = 0; i < n; ++i ) {
+		if( LCUIThread_Create( &render.threads[i],
+				       RenderPool_Thread, NULL ) != 0 ) {
+			break;
+		}
+		++render.n_threads;
+	}
+	LOG( "[display] render threads: %d\n", render.n_threads );
+}
+
+/** 停止渲染线程池 */
+static void RenderPool_Exit( void )
+{
+	int i;
+	LCUIMutex_Lock( &render.mutex );
+	render.is_running = FALSE;
+	LCUICond_Broadcast( &render.cond_task );
+	LCUIMutex_Unlock( &render.mutex );
+	for( i = 0; i < render.n_threads; ++i ) {
+		LCUIThread_Join( render.threads[i], NULL );
+	}
+	render.n_threads = 0;
+	LCUICond_Destroy( &render.cond_task );
+	LCUICond_Destroy( &render.cond_done );
+	LCUIMutex_Destroy( &render.mutex );
+	free( render.tiles );
+	render.tiles = NULL;
+	render.max_tiles = 0;
+	for( i = 0; i <= MAX_RENDER_THREADS; ++i ) {
+		Arena_Destroy( &render.arenas[i] );
+	}
+}
+
 /** 更新各种图形元素的显示 */
 static void LCUIDisplay_Update(void)
 {
-	LinkedList rlist;
+	int i;
+	int64_t t;
 	SurfaceRecord *p_sr;
-	LinkedListNode *sn, *rn;
-	LCUI_PaintContext paint;
-	LinkedList_Init( &rlist );
+	LinkedListNode *sn;
+	/* 在绘制前淘汰超出预算的字体位图，此时没有线程在使用它们 */
+	LCUIFont_TrimCache();
 	/* 遍历当前的 surface 记录列表 */
 	for( LinkedList_Each( sn, &display.surfaces ) ) {
 		p_sr = sn->data;
@@ -112,28 +460,27 @@ static void LCUIDisplay_Update(void)
 		}
 		Surface_Update( p_sr->surface );
 		/* 收集无效区域记录 */
-		Widget_ProcInvalidArea( p_sr->widget, &rlist );
-		/* 在 surface 上逐个重绘无效区域 */
-		for( LinkedList_Each( rn, &rlist ) ) {
-			paint = Surface_BeginPaint( p_sr->surface, rn->data );
-			if( !paint ) {
-				continue;
-			}
-			DEBUG_MSG( "[%s]: render rect: (%d,%d,%d,%d)\n",
-				p_sr->widget->type, paint->rect.left,
-				paint->rect.top, paint->rect.w, paint->rect.h );
-			Widget_Render( p_sr->widget, paint );
-			if( display.show_rect_border ) {
-				DrawBorder( paint );
-			}
-			Surface_EndPaint( p_sr->surface, paint );
-		}
-		if( rlist.length > 0 ) {
+		Widget_ProcInvalidArea( p_sr->widget, &display.rects );
+		/* 将无效区域切分成块，并行重绘到 surface 上 */
+		if( !Region_IsEmpty( &display.rects ) ) {
+			t = LCUI_GetTimeNS();
+			RenderPool_Render( p_sr->surface, p_sr->widget,
+					   &display.rects );
+			FrameControl_AddStageTime( display.fc_ctx,
+						   FRAME_STAGE_RENDER,
+						   LCUI_GetTimeDeltaNS( t ) );
+			t = LCUI_GetTimeNS();
 			Surface_Present( p_sr->surface );
+			FrameControl_AddStageTime( display.fc_ctx,
+						   FRAME_STAGE_PRESENT,
+						   LCUI_GetTimeDeltaNS( t ) );
 		}
-		RectList_Clear( &rlist );
+		Region_Clear( &display.rects );
+	}
+	/* 所有的块都已渲染完，回收这一帧用过的临时内存 */
+	for( i = 0; i <= MAX_RENDER_THREADS; ++i ) {
+		Arena_Reset( &render.arenas[i] );
 	}
-	RectList_Clear( &rlist );
 }
 
 void LCUIDisplay_InvalidateArea( LCUI_Rect *rect )
@@ -265,7 +612,10 @@ static int LCUIDisplay_FullScreen( void )
 		return 0;
 	}
 	display.mode = LCDM_FULLSCREEN;
-	LCUIDisplay_SetSize( LCUIDisplay_GetWidth(), LCUIDisplay_GetHeight() );
+	/* 全屏模式下 LCUIDisplay_GetWidth() 返回的是根部件的尺寸，所以直接
+	 * 从驱动获取屏幕尺寸 */
+	LCUIDisplay_SetSize( display.driver->getWidth(),
+			     display.driver->getHeight() );
 	return 0;
 }
 
@@ -309,6 +659,7 @@ int LCUIDisplay_SetMode( int mode )
 		break;
 	}
 	LCUIMutex_Unlock( &display.mutex );
+	LCUIDisplay_RequestUpdate();
 	return ret;
 }
 
@@ -373,13 +724,28 @@ int LCUIDisplay_GetHeight( void )
 /** LCUI的图形显示处理线程 */
 static void LCUIDisplay_Thread( void *unused )
 {
+	int64_t t, layout_time;
+	LCUI_Widget root;
 	while( LCUI_IsActive() && display.is_working ) {
+		t = LCUI_GetTimeNS();
 		LCUICursor_UpdatePos();		/* 更新鼠标位置 */
 		LCUIWidget_StepTask();		/* 处理所有部件任务 */
+		/* 超时后剩下的任务需要留到下一帧处理 */
+		root = LCUIWidget_GetRoot();
+		if( root->task.for_self || root->task.for_children ) {
+			FrameControl_Request( display.fc_ctx );
+		}
+		/* 布局是在处理部件任务时计算的，需要从中分离出来 */
+		layout_time = LCUIWidget_GetLayoutTime();
+		t = LCUI_GetTimeDeltaNS( t ) - layout_time;
+		FrameControl_AddStageTime( display.fc_ctx,
+					   FRAME_STAGE_UPDATE, t );
+		FrameControl_AddStageTime( display.fc_ctx,
+					   FRAME_STAGE_LAYOUT, layout_time );
 		LCUIMutex_Lock( &display.mutex );
 		LCUIDisplay_Update();
 		LCUIMutex_Unlock( &display.mutex );
-		/* 让本帧停留一段时间 */
+		/* 让本帧停留一段时间，没有需要更新的内容时会一直等待 */
 		FrameControl_Remain( display.fc_ctx );
 	}
 	LCUIThread_Exit(NULL);
@@ -595,6 +961,7 @@ int LCUI_InitDisplay( LCUI_DisplayDriver driver )
 	root = LCUIWidget_GetRoot();
 	LCUIMutex_Init( &display.mutex );
 	LinkedList_Init( &display.surfaces );
+	Region_Init( &display.rects );
 	if( !driver ) {
 		driver = LCUI_CreateDisplayDriver();
 		if( !driver ) {
@@ -608,8 +975,11 @@ int LCUI_InitDisplay( LCUI_DisplayDriver driver )
 	display.driver->bindEvent( DET_RESIZE, OnResize, NULL, NULL );
 	display.driver->bindEvent( DET_PAINT, OnPaint, NULL, NULL );
 	FrameControl_SetMaxFPS( display.fc_ctx, MAX_FRAMES_PER_SEC );
+	/* 只在部件有任务、有无效区域或游标移动时才更新画面 */
+	FrameControl_SetOnDemand( display.fc_ctx, TRUE );
 	Widget_BindEvent( root, "surface", OnSurfaceEvent, NULL, NULL );
 	LCUIDisplay_SetMode( LCDM_DEFAULT );
+	RenderPool_Init();
 	LOG("[display] init ok, driver name: %s\n", display.driver->name);
 	return LCUIThread_Create( &display.thread, LCUIDisplay_Thread, NULL );
 }
@@ -617,11 +987,17 @@ int LCUI_InitDisplay( LCUI_DisplayDriver driver )
 /** 停用图形输出模块 */
 int LCUI_ExitDisplay( void )
 {
+	int ret;
 	if( !display.is_working ) {
 		return -1;
 	}
 	display.is_working = FALSE;
+	/* 显示线程可能正在等待更新请求，需要唤醒它 */
+	FrameControl_SetOnDemand( display.fc_ctx, FALSE );
+	ret = LCUIThread_Join( display.thread, NULL );
+	RenderPool_Exit();
+	Region_Destroy( &display.rects );
 	LCUIMutex_Destroy( &display.mutex );
 	FrameControl_Destroy( display.fc_ctx );
-	return LCUIThread_Join( display.thread, NULL );
+	return ret;
 }
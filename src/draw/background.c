@@ -37,10 +37,102 @@
  * 没有，请查看：<http://www.gnu.org/licenses/>.
  * ***************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
 
+#define SCALED_IMAGE_CACHE_MAX_BYTES	(8 * 1024 * 1024)
+
+/**
+ * 缩放后的背景图像的索引
+ * 源图像用像素数据的地址、代数和引用的区域标识，像素数据释放后地址可能被新的
+ * 图像重用，但代数不同，所以不会命中旧的缓存
+ */
+typedef struct ScaledImageKeyRec_ {
+	const uchar_t *bytes;
+	unsigned long generation;
+	int color_type;
+	LCUI_Rect rect;
+	int width, height;
+} ScaledImageKeyRec, *ScaledImageKey;
+
+/** 缩放后的背景图像 */
+typedef struct ScaledImageRec_ {
+	ScaledImageKeyRec key;
+	LCUI_Graph image;
+	LCUI_LRUCacheEntryRec entry;	/**< 缓存项，以 key 为索引 */
+} ScaledImageRec, *ScaledImage;
+
+/**
+ * 缩放后的背景图像缓存
+ * 以整张图像为单位缓存缩放结果，绘制时只需引用其中的一块区域，因此尺寸不变
+ * 的背景在重绘时不需要重新缩放。超出内存预算时淘汰最久未使用的图像。
+ */
+static LRUCache cache;
+
+static void ScaledImage_Delete( void *arg )
+{
+	ScaledImage img = arg;
+	Graph_Free( &img->image );
+	free( img );
+}
+
+/**
+ * 获取缩放后的背景图像，用完后需调用 ScaledImage_Release() 释放
+ * @returns 缓存未初始化或图像超出内存预算时返回 NULL
+ */
+static ScaledImage ScaledImage_Get( const LCUI_Graph *image, 
+				    int width, int height )
+{
+	size_t mem_size;
+	ScaledImageKeyRec key;
+	ScaledImage img;
+	LCUI_LRUCacheStatsRec stats;
+	const LCUI_Graph *source = Graph_GetQuote( image );
+
+	if( !cache ) {
+		return NULL;
+	}
+	memset( &key, 0, sizeof( key ) );
+	key.bytes = source->bytes;
+	key.generation = source->generation;
+	key.color_type = source->color_type;
+	key.width = width;
+	key.height = height;
+	Graph_GetValidRect( image, &key.rect );
+	mem_size = sizeof( ScaledImageRec ) + 
+		   (size_t)width * height * source->bytes_per_pixel;
+	/* 超出内存预算的图像不会被缓存，不必缩放整张图像 */
+	LRUCache_GetStats( cache, &stats );
+	if( mem_size > stats.max_bytes ) {
+		return NULL;
+	}
+	img = LRUCache_Get( cache, &key );
+	if( img ) {
+		return img;
+	}
+	/* 缩放图像时不占用锁，以免阻塞其它线程的绘制 */
+	img = NEW( ScaledImageRec, 1 );
+	img->key = key;
+	img->entry.data = img;
+	img->entry.key = &img->key;
+	img->entry.size = mem_size;
+	Graph_Init( &img->image );
+	if( Graph_ZoomEx( image, &img->image, FALSE, width, 
+			  height, ZOOM_FILTER_AUTO ) != 0 ) {
+		ScaledImage_Delete( img );
+		return NULL;
+	}
+	return LRUCache_Add( cache, &img->entry );
+}
+
+static void ScaledImage_Release( ScaledImage img )
+{
+	LRUCache_Release( cache, &img->entry );
+}
+
 void Background_Init( LCUI_Background *bg )
 {
 	bg->color = RGB( 255, 255, 255 );
@@ -55,9 +147,10 @@ void Graph_DrawBackground( LCUI_PaintContext paint, const LCUI_Rect *box,
 			   LCUI_Background *bg )
 {
 	float scale;
-	LCUI_Graph graph;
+	LCUI_Graph graph, buffer;
 	LCUI_BOOL with_alpha;
-	LCUI_Rect read_rect, paint_rect;
+	ScaledImage scaled;
+	LCUI_Rect read_rect, paint_rect, quote_rect;
 	int image_x, image_y, image_w, image_h;
 
 	/* 计算背景图应有的尺寸 */
@@ -199,47 +292,97 @@ void Graph_DrawBackground( LCUI_PaintContext paint, const LCUI_Rect *box,
 	/* 转换成相对于图像的坐标 */
 	read_rect.x -= image_x;
 	read_rect.y -= image_y;
+	/* 转换成相对于当前绘制区域的坐标 */
+	image_x = image_x + box->x - paint->rect.x;
+	image_y = image_y + box->y - paint->rect.y;
 	/* 如果尺寸没有变化则直接引用 */
 	if( image_w == bg->image.w && image_h == bg->image.h ) {
 		Graph_Quote( &graph, &bg->image, &read_rect );
-		/* 转换成相对于当前绘制区域的坐标 */
-		image_x = image_x + box->x - paint->rect.x;
-		image_y = image_y + box->y - paint->rect.y;
-		image_x += read_rect.x;
-		image_y += read_rect.y;
-		Graph_Mix( &paint->canvas, &graph, image_x,
-			   image_y, with_alpha );
-	} else {
-		float scale;
-		LCUI_Graph buffer;
-		LCUI_Rect quote_rect;
-
-		Graph_Init( &buffer );
-		quote_rect = read_rect;
-		/* 根据宽高的缩放比例，计算实际需要引用的区域 */
-		if( image_w != bg->image.w ) {
-			scale = 1.0 * bg->image.width / image_w;
-			quote_rect.x *= scale;
-			quote_rect.width *= scale;
-		}
-		if( image_h != bg->image.h ) {
-			scale = 1.0 * bg->image.height / image_h;
-			quote_rect.y *= scale;
-			quote_rect.height *= scale;
-		}
-		/* 引用源背景图像的一块区域 */
-		Graph_Quote( &graph, &bg->image, &quote_rect );
-		image_w = read_rect.width;
-		image_h = read_rect.height;
-		/* 计算相对于绘制区域的坐标 */
-		image_x = read_rect.x + image_x;
-		image_x = image_x + box->x - paint->rect.x;
-		image_y = read_rect.y + image_y;
-		image_y = image_y + box->y - paint->rect.y;
-		/* 按比例进行缩放 */
-		Graph_Zoom( &graph, &buffer, FALSE, image_w, image_h );
-		Graph_Mix( &paint->canvas, &buffer, image_x, 
-			   image_y, with_alpha );
-		Graph_Free( &buffer );
+		Graph_Mix( &paint->canvas, &graph, image_x + read_rect.x,
+			   image_y + read_rect.y, with_alpha );
+		return;
+	}
+	/* 优先使用缓存的整张缩放后的图像，只需引用需要绘制的区域 */
+	scaled = ScaledImage_Get( &bg->image, image_w, image_h );
+	if( scaled ) {
+		Graph_Quote( &graph, &scaled->image, &read_rect );
+		Graph_Mix( &paint->canvas, &graph, image_x + read_rect.x,
+			   image_y + read_rect.y, with_alpha );
+		ScaledImage_Release( scaled );
+		return;
+	}
+	/* 图像太大，无法缓存，只缩放需要绘制的区域 */
+	Graph_Init( &buffer );
+	quote_rect = read_rect;
+	/* 根据宽高的缩放比例，计算实际需要引用的区域 */
+	if( image_w != bg->image.w ) {
+		scale = 1.0f * bg->image.width / image_w;
+		quote_rect.x = (int)(quote_rect.x * scale);
+		quote_rect.width = (int)(quote_rect.width * scale);
+	}
+	if( image_h != bg->image.h ) {
+		scale = 1.0f * bg->image.height / image_h;
+		quote_rect.y = (int)(quote_rect.y * scale);
+		quote_rect.height = (int)(quote_rect.height * scale);
+	}
+	/* 引用源背景图像的一块区域 */
+	Graph_Quote( &graph, &bg->image, &quote_rect );
+	Graph_ZoomEx( &graph, &buffer, FALSE, read_rect.width,
+		      read_rect.height, ZOOM_FILTER_AUTO );
+	Graph_Mix( &paint->canvas, &buffer, image_x + read_rect.x, 
+		   image_y + read_rect.y, with_alpha );
+	Graph_Free( &buffer );
+}
+
+void Background_SetCacheSize( size_t max_bytes )
+{
+	if( cache ) {
+		LRUCache_SetMaxBytes( cache, max_bytes );
+	}
+}
+
+void Background_GetCacheStats( LCUI_BackgroundCacheStats stats )
+{
+	LCUI_LRUCacheStatsRec s;
+	if( !cache ) {
+		memset( stats, 0, sizeof( LCUI_BackgroundCacheStatsRec ) );
+		return;
+	}
+	LRUCache_GetStats( cache, &s );
+	stats->hits = s.hits;
+	stats->misses = s.misses;
+	stats->used_bytes = s.used_bytes;
+	stats->max_bytes = s.max_bytes;
+	stats->count = s.count;
+}
+
+/** 判断图像是否由该地址的像素数据缩放得到，旧代数的缓存也一并释放 */
+static LCUI_BOOL IsScaledFrom( void *data, const void *arg )
+{
+	return ((ScaledImage)data)->key.bytes == arg;
+}
+
+void Background_ReleaseImageCache( const LCUI_Graph *image )
+{
+	if( cache && image ) {
+		image = Graph_GetQuote( image );
+		LRUCache_RemoveIf( cache, IsScaledFrom, image->bytes );
+	}
+}
+
+void LCUI_InitBackground( void )
+{
+	if( !cache ) {
+		cache = LRUCache_Create( sizeof( ScaledImageKeyRec ),
+					 SCALED_IMAGE_CACHE_MAX_BYTES,
+					 ScaledImage_Delete );
+	}
+}
+
+void LCUI_ExitBackground( void )
+{
+	if( cache ) {
+		LRUCache_Destroy( cache );
+		cache = NULL;
 	}
 }
@@ -37,10 +37,377 @@
  * 没有，请查看：<http://www.gnu.org/licenses/>.
  * ***************************************************************************/
 
+/**
+ * 圆角边框采用预先生成的覆盖率遮罩绘制：每个圆角各有一张遮罩，分别记录边框外
+ * 边缘和内边缘以内的区域对每个像素的覆盖率，两者之差即为边框的覆盖率。外边缘
+ * 的遮罩用于裁剪背景，内边缘的遮罩用于裁剪子部件的内容。遮罩只取决于圆角半径
+ * 和边框宽度，所以按这两者缓存，尺寸不变的部件在重绘时不需要重新计算。
+ */
+
+#include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
-#include <math.h>
+#include <LCUI/graph_blend.h>
+
+#define BORDER_CACHE_MAX_BYTES	(256 * 1024)
+/** 计算覆盖率时，每个像素在水平和垂直方向上的采样数 */
+#define SAMPLES			4
+/** 绘制圆角时每次混合的像素数量 */
+#define SPAN_SIZE		64
+#define max(a, b) ((a) > (b) ? (a):(b))
+#define min(a, b) ((a) < (b) ? (a):(b))
+
+/** 按覆盖率减小透明度 */
+#define MaskAlpha(A, M) (uchar_t)((M) == 255 ? (A) : ((A) * (M) + 127) / 255)
+
+/** 圆角的序号，按顺时针顺序排列 */
+enum BorderCorner {
+	CORNER_TOP_LEFT,
+	CORNER_TOP_RIGHT,
+	CORNER_BOTTOM_RIGHT,
+	CORNER_BOTTOM_LEFT
+};
+
+/** 边的序号，与 CSS 中的顺序一致 */
+enum BorderSide {
+	SIDE_TOP,
+	SIDE_RIGHT,
+	SIDE_BOTTOM,
+	SIDE_LEFT
+};
+
+/** 圆角两侧的竖边和横边 */
+#define CornerSideX(I) ((I) == CORNER_TOP_LEFT || (I) == CORNER_BOTTOM_LEFT ? \
+			SIDE_LEFT : SIDE_RIGHT)
+#define CornerSideY(I) ((I) < CORNER_BOTTOM_RIGHT ? SIDE_TOP : SIDE_BOTTOM)
+/** 圆角是否在右侧、下侧，这些圆角读取遮罩时需要翻转坐标 */
+#define IsRightCorner(I) (CornerSideX(I) == SIDE_RIGHT)
+#define IsBottomCorner(I) (CornerSideY(I) == SIDE_BOTTOM)
+
+/** 遮罩的索引，圆角半径已按边框尺寸限制过 */
+typedef struct BorderMaskKeyRec_ {
+	int radius[4];		/**< 各个圆角的半径，为 0 时是直角 */
+	int width[4];		/**< 各条边的宽度 */
+} BorderMaskKeyRec, *BorderMaskKey;
+
+/**
+ * 圆角遮罩
+ * 圆角所在的区域宽度为圆角半径与竖边宽度中的较大者，高度为圆角半径与横边宽度
+ * 中的较大者。遮罩按左上角的方向存放，其它圆角在读取时翻转坐标。
+ */
+typedef struct CornerMaskRec_ {
+	int width, height;
+	uchar_t *outer;		/**< 边框外边缘以内的区域的覆盖率 */
+	uchar_t *inner;		/**< 边框内边缘以内的区域的覆盖率 */
+} CornerMaskRec, *CornerMask;
+
+/** 边框遮罩 */
+typedef struct BorderMaskRec_ {
+	BorderMaskKeyRec key;
+	CornerMaskRec corners[4];
+	uchar_t *data;		/**< 所有圆角遮罩共用的内存 */
+	LCUI_LRUCacheEntryRec entry;	/**< 缓存项，以 key 为索引 */
+} BorderMaskRec, *BorderMask;
+
+/** 边框遮罩缓存，超出内存预算时淘汰最久未使用的遮罩 */
+static LRUCache cache;
+
+/**
+ * 计算边框遮罩的索引
+ * 圆角半径不能超过边框宽高的一半，也不能与对边的边框重叠
+ * @returns 有圆角时返回 TRUE，否则返回 FALSE
+ */
+static LCUI_BOOL Border_GetMaskKey( const LCUI_Rect *box,
+				    const LCUI_Border *border,
+				    BorderMaskKey key )
+{
+	int i, limit;
+	LCUI_BOOL has_radius = FALSE;
+
+	memset( key, 0, sizeof( BorderMaskKeyRec ) );
+	key->radius[CORNER_TOP_LEFT] = border->top_left_radius;
+	key->radius[CORNER_TOP_RIGHT] = border->top_right_radius;
+	key->radius[CORNER_BOTTOM_RIGHT] = border->bottom_right_radius;
+	key->radius[CORNER_BOTTOM_LEFT] = border->bottom_left_radius;
+	key->width[SIDE_TOP] = border->top.width;
+	key->width[SIDE_RIGHT] = border->right.width;
+	key->width[SIDE_BOTTOM] = border->bottom.width;
+	key->width[SIDE_LEFT] = border->left.width;
+	for( i = 0; i < 4; ++i ) {
+		limit = min( box->width, box->height ) / 2;
+		limit = min( limit, box->width -
+			     key->width[SIDE_LEFT + SIDE_RIGHT -
+					CornerSideX( i )] );
+		limit = min( limit, box->height -
+			     key->width[SIDE_TOP + SIDE_BOTTOM -
+					CornerSideY( i )] );
+		key->radius[i] = min( key->radius[i], limit );
+		if( key->radius[i] > 0 ) {
+			has_radius = TRUE;
+		} else {
+			key->radius[i] = 0;
+		}
+	}
+	return has_radius;
+}
+
+/** 获取圆角所在的区域，直角的区域为空 */
+static void Border_GetCornerRect( const LCUI_Rect *box, BorderMaskKey key,
+				  int i, LCUI_Rect *rect )
+{
+	rect->x = box->x;
+	rect->y = box->y;
+	rect->width = rect->height = 0;
+	if( key->radius[i] <= 0 ) {
+		return;
+	}
+	rect->width = max( key->radius[i], key->width[CornerSideX( i )] );
+	rect->height = max( key->radius[i], key->width[CornerSideY( i )] );
+	if( IsRightCorner( i ) ) {
+		rect->x += box->width - rect->width;
+	}
+	if( IsBottomCorner( i ) ) {
+		rect->y += box->height - rect->height;
+	}
+}
+
+/**
+ * 计算圆角遮罩
+ * 以左上角为例，圆心位于 (r, r)，外边缘是半径为 r 的圆，内边缘是半轴长分别为
+ * r 减去左边框宽度、r 减去上边框宽度的椭圆，两者的圆心相同。每个像素的覆盖率
+ * 取落在区域内的采样点所占的比例。
+ */
+static void CornerMask_Init( CornerMask corner, uchar_t *data,
+			     int r, int side_x, int side_y )
+{
+	int x, y, i, j, n_outer, n_inner;
+	double px, py, dx, dy, rx = r - side_x, ry = r - side_y;
+
+	corner->width = max( r, side_x );
+	corner->height = max( r, side_y );
+	corner->outer = data;
+	corner->inner = data + corner->width * corner->height;
+	for( y = 0; y < corner->height; ++y ) {
+		for( x = 0; x < corner->width; ++x ) {
+			n_outer = n_inner = 0;
+			for( j = 0; j < SAMPLES; ++j ) {
+				py = y + (j + 0.5) / SAMPLES;
+				dy = r - py;
+				for( i = 0; i < SAMPLES; ++i ) {
+					px = x + (i + 0.5) / SAMPLES;
+					dx = r - px;
+					/* 圆心右侧和下方的点不在圆角内 */
+					if( dx <= 0 || dy <= 0 ) {
+						++n_outer;
+					} else if( dx * dx + dy * dy <= r * r ) {
+						++n_outer;
+					}
+					if( px < side_x || py < side_y ) {
+						continue;
+					}
+					if( rx <= 0 || ry <= 0 || dx <= 0 ||
+					    dy <= 0 || (dx * dx) / (rx * rx) +
+					    (dy * dy) / (ry * ry) <= 1.0 ) {
+						++n_inner;
+					}
+				}
+			}
+			j = y * corner->width + x;
+			i = SAMPLES * SAMPLES;
+			corner->outer[j] = (uchar_t)((n_outer * 255 + i / 2) / i);
+			corner->inner[j] = (uchar_t)((n_inner * 255 + i / 2) / i);
+		}
+	}
+}
+
+static BorderMask BorderMask_New( BorderMaskKey key )
+{
+	int i, w, h;
+	size_t size = 0;
+	uchar_t *data;
+	BorderMask mask;
+
+	for( i = 0; i < 4; ++i ) {
+		if( key->radius[i] > 0 ) {
+			w = max( key->radius[i], key->width[CornerSideX( i )] );
+			h = max( key->radius[i], key->width[CornerSideY( i )] );
+			size += (size_t)w * h * 2;
+		}
+	}
+	mask = NEW( BorderMaskRec, 1 );
+	if( !mask ) {
+		return NULL;
+	}
+	mask->data = malloc( size );
+	if( !mask->data ) {
+		free( mask );
+		return NULL;
+	}
+	mask->key = *key;
+	mask->entry.data = mask;
+	mask->entry.key = &mask->key;
+	mask->entry.size = sizeof( BorderMaskRec ) + size;
+	for( i = 0, data = mask->data; i < 4; ++i ) {
+		CornerMask corner = &mask->corners[i];
+		if( key->radius[i] <= 0 ) {
+			corner->width = corner->height = 0;
+			corner->outer = corner->inner = NULL;
+			continue;
+		}
+		CornerMask_Init( corner, data, key->radius[i],
+				 key->width[CornerSideX( i )],
+				 key->width[CornerSideY( i )] );
+		data += corner->width * corner->height * 2;
+	}
+	return mask;
+}
+
+static void BorderMask_Delete( void *arg )
+{
+	BorderMask mask = arg;
+	free( mask->data );
+	free( mask );
+}
+
+/** 获取边框遮罩，用完后需调用 BorderMask_Release() 释放 */
+static BorderMask BorderMask_Get( BorderMaskKey key )
+{
+	BorderMask mask;
+	if( !cache ) {
+		return BorderMask_New( key );
+	}
+	mask = LRUCache_Get( cache, key );
+	if( mask ) {
+		return mask;
+	}
+	/* 生成遮罩时不占用锁，以免阻塞其它线程的绘制 */
+	mask = BorderMask_New( key );
+	if( !mask ) {
+		return NULL;
+	}
+	return LRUCache_Add( cache, &mask->entry );
+}
+
+static void BorderMask_Release( BorderMask mask )
+{
+	if( !cache ) {
+		BorderMask_Delete( mask );
+		return;
+	}
+	LRUCache_Release( cache, &mask->entry );
+}
+
+/**
+ * 获取圆角与绘制区域重叠的部分
+ * @param[out] area 重叠的区域，相对于边框所在的坐标系
+ * @returns 在画布中第一个像素的地址，没有重叠或画布不是 ARGB 格式时返回 NULL
+ */
+static LCUI_ARGB *Border_GetCornerArea( LCUI_PaintContext paint,
+					const LCUI_Rect *rect, LCUI_Rect *area )
+{
+	LCUI_Graph *graph;
+	LCUI_Rect canvas_rect;
+
+	graph = Graph_GetQuote( &paint->canvas );
+	if( graph->color_type != COLOR_TYPE_ARGB ||
+	    !LCUIRect_GetOverlayRect( rect, &paint->rect, area ) ) {
+		return NULL;
+	}
+	Graph_GetValidRect( &paint->canvas, &canvas_rect );
+	/* 避免超出画布的范围 */
+	if( area->x + area->w > paint->rect.x + canvas_rect.w ) {
+		area->w = paint->rect.x + canvas_rect.w - area->x;
+	}
+	if( area->y + area->h > paint->rect.y + canvas_rect.h ) {
+		area->h = paint->rect.y + canvas_rect.h - area->y;
+	}
+	if( area->w <= 0 || area->h <= 0 ) {
+		return NULL;
+	}
+	return graph->argb + (canvas_rect.y + area->y - paint->rect.y) *
+		graph->w + canvas_rect.x + area->x - paint->rect.x;
+}
+
+/**
+ * 绘制一个圆角
+ * 圆角两侧的边框颜色不同时，以边框内外两个角点的连线为分界线
+ */
+static void Graph_DrawBorderCorner( LCUI_PaintContext paint,
+				    const LCUI_Rect *rect, CornerMask mask,
+				    BorderMaskKey key, int i,
+				    LCUI_Color color_x, LCUI_Color color_y )
+{
+	LCUI_Rect area;
+	LCUI_ARGB *px_row, span[SPAN_SIZE];
+	LCUI_BlendKernel kernel;
+	int x, y, k, n, mx, my, a;
+	int side_x = key->width[CornerSideX( i )];
+	int side_y = key->width[CornerSideY( i )];
+	LCUI_Graph *graph = Graph_GetQuote( &paint->canvas );
+
+	px_row = Border_GetCornerArea( paint, rect, &area );
+	if( !px_row ) {
+		return;
+	}
+	kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
+	for( y = 0; y < area.h; ++y, px_row += graph->w ) {
+		my = area.y + y - rect->y;
+		if( IsBottomCorner( i ) ) {
+			my = mask->height - 1 - my;
+		}
+		for( x = 0; x < area.w; x += n ) {
+			n = min( SPAN_SIZE, area.w - x );
+			for( k = 0; k < n; ++k ) {
+				mx = area.x + x + k - rect->x;
+				if( IsRightCorner( i ) ) {
+					mx = mask->width - 1 - mx;
+				}
+				/* 按像素中心与分界线的位置关系选择颜色 */
+				if( (2 * my + 1) * side_x < (2 * mx + 1) * side_y ) {
+					span[k] = color_y;
+				} else {
+					span[k] = color_x;
+				}
+				a = my * mask->width + mx;
+				a = mask->outer[a] - mask->inner[a];
+				span[k].alpha = MaskAlpha( span[k].alpha, a );
+			}
+			kernel->mix( px_row + x, span, n, 255 );
+		}
+	}
+}
+
+/** 按圆角遮罩减小像素的透明度 */
+static void Graph_ClipCorner( LCUI_PaintContext paint, const LCUI_Rect *rect,
+			      CornerMask mask, int i, LCUI_BOOL inner )
+{
+	LCUI_Rect area;
+	LCUI_ARGB *px_row;
+	const uchar_t *data = inner ? mask->inner : mask->outer;
+	int x, y, mx, my;
+	LCUI_Graph *graph = Graph_GetQuote( &paint->canvas );
+
+	px_row = Border_GetCornerArea( paint, rect, &area );
+	if( !px_row ) {
+		return;
+	}
+	for( y = 0; y < area.h; ++y, px_row += graph->w ) {
+		my = area.y + y - rect->y;
+		if( IsBottomCorner( i ) ) {
+			my = mask->height - 1 - my;
+		}
+		for( x = 0; x < area.w; ++x ) {
+			mx = area.x + x - rect->x;
+			if( IsRightCorner( i ) ) {
+				mx = mask->width - 1 - mx;
+			}
+			px_row[x].alpha = MaskAlpha( px_row[x].alpha,
+						     data[my * mask->width + mx] );
+		}
+	}
+}
 
 /** 初始化边框数据 */
 void Border_Init( LCUI_Border *border )
@@ -95,214 +462,164 @@ void Border_Radius( LCUI_Border *border, unsigned int radius )
 	border->bottom_right_radius = radius;
 }
 
-/** 绘制左上角的圆角，从左边框的上端到上边框的左端绘制一条圆角线 */
-static int Graph_DrawRoundBorderLeftTop(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+/** 用边框颜色填充一段直线边框 */
+static void Graph_FillBorderLine( LCUI_PaintContext paint, LCUI_Rect *bound,
+				  LCUI_Color color )
 {
-	int y, x;
-
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
-	}
-
-	/* 根据y轴计算各点的x轴坐标并填充点 */
-	for( y=0; y<=radius; ++y ) {
-		/* 计算出x轴整数坐标 */
-		x = (int)sqrt( 1.0*radius*radius - y*y );
-		// ...
+	LCUI_Graph canvas;
+	if( LCUIRect_GetOverlayRect( bound, &paint->rect, bound ) ) {
+		bound->x -= paint->rect.x;
+		bound->y -= paint->rect.y;
+		Graph_Quote( &canvas, &paint->canvas, bound );
+		Graph_FillRect( &canvas, color, NULL, TRUE );
 	}
-	return 0;
 }
 
-/** 绘制左上角的圆角，从上边框的左端到左边框的上端绘制一条圆角线 */
-static int Graph_DrawRoundBorderTopLeft(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+/** 绘制边框 */
+int Graph_DrawBorder( LCUI_PaintContext paint, LCUI_Rect *box, LCUI_Border *border )
 {
-	int y, x;
+	int i;
+	LCUI_Rect bound, corners[4];
+	BorderMaskKeyRec key;
+	BorderMask mask = NULL;
 
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
+	if( !Graph_IsValid(&paint->canvas) ) {
+		return -1;
 	}
-
-	for( x=0; x<=radius; ++x ) {
-		y = sqrt( 1.0*radius*radius - x*x );
-		// ...
+	if( Border_GetMaskKey( box, border, &key ) ) {
+		mask = BorderMask_Get( &key );
 	}
-	return 0;
-}
-
-/** 绘制右上角的圆角，从右边框的上端到上边框的右端绘制一条圆角线 */
-static int Graph_DrawRoundBorderRightTop(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
-{
-	int y, x;
-
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
+	for( i = 0; i < 4; ++i ) {
+		Border_GetCornerRect( box, &key, i, &corners[i] );
 	}
-
-	for( y=0; y<=radius; ++y ) {
-		x = (int)sqrt( 1.0*radius*radius - y*y );
-		// ...
+	/* 绘制上边框线 */
+	bound.x = box->x + corners[CORNER_TOP_LEFT].width;
+	bound.y = box->y;
+	bound.width = box->width - corners[CORNER_TOP_RIGHT].width;
+	bound.width -= corners[CORNER_TOP_LEFT].width;
+	bound.height = border->top.width;
+	Graph_FillBorderLine( paint, &bound, border->top.color );
+	/* 绘制下边框线 */
+	bound.x = box->x + corners[CORNER_BOTTOM_LEFT].width;
+	bound.y = box->y + box->height - border->bottom.width;
+	bound.width = box->width - corners[CORNER_BOTTOM_RIGHT].width;
+	bound.width -= corners[CORNER_BOTTOM_LEFT].width;
+	bound.height = border->bottom.width;
+	Graph_FillBorderLine( paint, &bound, border->bottom.color );
+	/* 绘制左边框线 */
+	bound.y = box->y + corners[CORNER_TOP_LEFT].height;
+	bound.x = box->x;
+	bound.width = border->left.width;
+	bound.height = box->height - corners[CORNER_TOP_LEFT].height;
+	bound.height -= corners[CORNER_BOTTOM_LEFT].height;
+	Graph_FillBorderLine( paint, &bound, border->left.color );
+	/* 绘制右边框线 */
+	bound.x = box->x + box->width - border->right.width;
+	bound.y = box->y + corners[CORNER_TOP_RIGHT].height;
+	bound.width = border->right.width;
+	bound.height = box->height - corners[CORNER_TOP_RIGHT].height;
+	bound.height -= corners[CORNER_BOTTOM_RIGHT].height;
+	Graph_FillBorderLine( paint, &bound, border->right.color );
+	if( !mask ) {
+		return 0;
+	}
+	/* 绘制圆角 */
+	for( i = 0; i < 4; ++i ) {
+		if( key.radius[i] <= 0 ) {
+			continue;
+		}
+		Graph_DrawBorderCorner( paint, &corners[i], &mask->corners[i],
+					&key, i, CornerSideX( i ) == SIDE_LEFT ?
+					border->left.color : border->right.color,
+					CornerSideY( i ) == SIDE_TOP ?
+					border->top.color : border->bottom.color );
 	}
+	BorderMask_Release( mask );
 	return 0;
 }
 
-/* 绘制右上角的圆角，从上边框的右端到右边框的上端绘制一条圆角线 */
-static int Graph_DrawRoundBorderTopRight(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+void Graph_ClipByBorder( LCUI_PaintContext paint, const LCUI_Rect *box,
+			 const LCUI_Border *border, LCUI_BOOL inner )
 {
-	int y, x;
+	int i;
+	LCUI_Rect rect;
+	BorderMask mask;
+	BorderMaskKeyRec key;
 
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
+	if( !Graph_IsValid( &paint->canvas ) ||
+	    !Border_GetMaskKey( box, border, &key ) ) {
+		return;
 	}
-	for( x=0; x<=radius; ++x ) {
-		y = (int)sqrt( 1.0*radius*radius - x*x );
-		// ...
+	mask = BorderMask_Get( &key );
+	if( !mask ) {
+		return;
 	}
-	return 0;
+	for( i = 0; i < 4; ++i ) {
+		if( key.radius[i] > 0 ) {
+			Border_GetCornerRect( box, &key, i, &rect );
+			Graph_ClipCorner( paint, &rect, &mask->corners[i],
+					  i, inner );
+		}
+	}
+	BorderMask_Release( mask );
 }
 
-/** 绘制左下角的圆角，从左边框的下端到下边框的左端绘制一条圆角线 */
-static int Graph_DrawRoundBorderLeftBottom(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+LCUI_BOOL Border_IsCoverCorner( const LCUI_Rect *box,
+				const LCUI_Border *border,
+				const LCUI_Rect *rect )
 {
-	int y, x;
+	int i;
+	LCUI_Rect corner;
+	BorderMaskKeyRec key;
 
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
+	if( !Border_GetMaskKey( box, border, &key ) ) {
+		return FALSE;
 	}
-	for( y=0; y<=radius; ++y ) {
-		x = (int)sqrt( 1.0*radius*radius - y*y );
-		// ...
+	for( i = 0; i < 4; ++i ) {
+		Border_GetCornerRect( box, &key, i, &corner );
+		if( corner.width > 0 &&
+		    LCUIRect_GetOverlayRect( &corner, rect, &corner ) ) {
+			return TRUE;
+		}
 	}
-	return 0;
+	return FALSE;
 }
 
-/** 绘制左下角的圆角，从下边框的左端到左边框的下端绘制一条圆角线 */
-static int Graph_DrawRoundBorderBottomLeft(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+void Border_SetCacheSize( size_t max_bytes )
 {
-	int y, x;
-
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
+	if( cache ) {
+		LRUCache_SetMaxBytes( cache, max_bytes );
 	}
-	for( x=0; x<=radius; ++x ) {
-		y = (int)sqrt( 1.0*radius*radius - x*x );
-		// ...
-	}
-	return 0;
 }
 
-/** 绘制右下角的圆角，从右边框的下端到下边框的右端绘制一条圆角线 */
-static int Graph_DrawRoundBorderRightBottom(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+void Border_GetCacheStats( LCUI_BorderCacheStats stats )
 {
-	int y, x;
-
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
+	LCUI_LRUCacheStatsRec s;
+	if( !cache ) {
+		memset( stats, 0, sizeof( LCUI_BorderCacheStatsRec ) );
+		return;
 	}
-	for( y=0; y<=radius; ++y ) {
-		x = (int)sqrt( 1.0*radius*radius - y*y );
-		// ...
-	}
-	return 0;
+	LRUCache_GetStats( cache, &s );
+	stats->hits = s.hits;
+	stats->misses = s.misses;
+	stats->used_bytes = s.used_bytes;
+	stats->max_bytes = s.max_bytes;
+	stats->count = s.count;
 }
 
-/** 绘制右下角的圆角，从下边框的右端到右边框的下端绘制一条圆角线 */
-static int Graph_DrawRoundBorderBottomRight(
-	LCUI_Graph *des,	LCUI_Pos center,
-	int radius,		int line_width,
-	LCUI_Color line_color,	LCUI_BOOL hide_outarea )
+void LCUI_InitBorder( void )
 {
-	int y, x;
-
-	if( line_width <= 0 && !hide_outarea ) {
-		return 1;
-	}
-	for( x=0; x<=radius; ++x ) {
-		y = (int)sqrt( 1.0*radius*radius - x*x );
-		// ...
+	if( !cache ) {
+		cache = LRUCache_Create( sizeof( BorderMaskKeyRec ),
+					 BORDER_CACHE_MAX_BYTES,
+					 BorderMask_Delete );
 	}
-	return 0;
 }
 
-/** 绘制边框 */
-int Graph_DrawBorder( LCUI_PaintContext paint, LCUI_Rect *box, LCUI_Border *border )
+void LCUI_ExitBorder( void )
 {
-	int  radius;
-	LCUI_Rect bound;
-	LCUI_Pos start, end;
-	LCUI_Graph canvas;
-
-	if( !Graph_IsValid(&paint->canvas) ) {
-		return -1;
+	if( cache ) {
+		LRUCache_Destroy( cache );
+		cache = NULL;
 	}
-
-	/* 绘制上边框线 */
-	bound.x = box->x + border->top_left_radius;
-	bound.y = box->y;
-	bound.width = box->width - border->top_right_radius;
-	bound.width -= border->top_left_radius;
-	bound.height = border->top.width;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		Graph_FillRect( &canvas, border->top.color, NULL, TRUE );
-	}
-	/* 绘制下边框线 */
-	bound.x = box->x;
-	bound.y = box->y + box->height - border->bottom.width;
-	bound.width = box->width - border->bottom_right_radius;
-	bound.width -= border->bottom_left_radius;
-	bound.height = border->bottom.width;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		Graph_FillRect( &canvas, border->bottom.color, NULL, TRUE );
-	}
-	/* 绘制左边框线 */
-	bound.y = box->y + border->top_left_radius;
-	bound.x = box->x;
-	bound.width = border->left.width;
-	bound.height = box->height - border->top_left_radius;
-	bound.height -= border->bottom_left_radius;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		Graph_FillRect( &canvas, border->left.color, NULL, TRUE );
-	}
-	/* 绘制右边框线 */
-	bound.x = box->x + box->width - border->right.width;
-	bound.y = box->y + border->top_right_radius;
-	bound.width = border->right.width;
-	bound.height = box->height - border->top_right_radius;
-	bound.height -= border->bottom_right_radius;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		Graph_FillRect( &canvas, border->right.color, NULL, TRUE );
-	}
-	return 0;
 }
@@ -42,15 +42,20 @@
  * 字、多边形等不规则图形的阴影。
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
 #include <math.h>
 
+#define SHADOW_CACHE_MAX_BYTES	(512 * 1024)
 #define BLUR_N			1.5
 #define SHADOW_WIDTH(sd)	(sd->blur + sd->spread)
 #define BLUR_WIDTH(sd)		(int)(sd->blur*BLUR_N)
 #define INNER_SHADOW_WIDTH(sd)	(SHADOW_WIDTH(sd)-BLUR_WIDTH(sd))
+#define max(a, b) ((a) > (b) ? (a):(b))
+#define min(a, b) ((a) < (b) ? (a):(b))
 
 LCUI_BoxShadow BoxShadow( int x, int y, int blur, LCUI_Color color )
 {
@@ -148,420 +153,179 @@ int BoxShadow_GetX( LCUI_BoxShadow *shadow )
 	return shadow->x - SHADOW_WIDTH(shadow);
 }
 
-static void DrawCircle( LCUI_Graph *graph, LCUI_Pos center,
-			int r, LCUI_ARGB color )
+/**
+ * 阴影遮罩
+ * 阴影的模糊边缘都用同一张遮罩绘制：遮罩的第 y 行第 x 列记录的是与阴影内框
+ * 角落的水平距离为 x、垂直距离为 y 的像素的透明度，第 0 行即为边缘阴影的一
+ * 维透明度分布。spread 只影响阴影的位置，因此遮罩只取决于模糊宽度。
+ */
+typedef struct ShadowMaskRec_ {
+	int size;		/**< 模糊宽度，遮罩的边长为 size + 1 */
+	uchar_t *data;		/**< 透明度数据 */
+	LCUI_LRUCacheEntryRec entry;	/**< 缓存项，以模糊宽度为索引 */
+} ShadowMaskRec, *ShadowMask;
+
+/** 阴影中的一块区域，区域内的像素按其与内框角落的距离从遮罩中取透明度 */
+typedef struct ShadowPieceRec_ {
+	LCUI_Rect rect;		/**< 区域，相对于阴影所在的矩形 */
+	int x, y;		/**< 区域左上角的像素在遮罩中的坐标 */
+	int step_x, step_y;	/**< 向右、向下移动一个像素时遮罩坐标的增量 */
+} ShadowPieceRec, *ShadowPiece;
+
+/** 阴影遮罩缓存，按模糊宽度索引，超出内存预算时淘汰最久未使用的遮罩 */
+static LRUCache cache;
+
+#define ShadowAlpha(M, A) (uchar_t)((A) == 255 ? (M) : (M) * (A) / 255)
+
+static ShadowMask ShadowMask_New( int size )
 {
-	int x, y;
-	int t = r;
-	int s = 255;
-	float v = 512.0/t;
-	float a = 2*(v*t-s)/(t*t);
-	LCUI_Rect area, box_rect;
-	LCUI_Graph *src, box_graph;
-	LCUI_ARGB tmp_px, *px;
-	uchar_t *px_row_bytes;
-	LCUI_Rect2 circle;
-
-	tmp_px = color;
-	Graph_GetValidRect( graph, &area );
-	src = Graph_GetQuote( graph );
-	center.x += area.x;
-	center.y += area.y;
-	circle.r = center.x + r;
-	circle.l = center.x - r;
-	circle.b = center.y + r;
-	circle.t = center.y - r;
-	/* 先填充 圆外切矩形 外的矩形区域 */
-	box_rect.x = area.x;
-	box_rect.y = area.y;
-	box_rect.w = area.w;
-	box_rect.h = circle.t - area.y;
-	Graph_Quote( &box_graph, src, &box_rect );
-	Graph_FillAlpha( &box_graph, 0 );
-	box_rect.y = circle.t;
-	box_rect.w = circle.l - area.x;
-	box_rect.h = area.y + area.h - circle.t;
-	Graph_Quote( &box_graph, src, &box_rect );
-	Graph_FillAlpha( &box_graph, 0 );
-	/* 调整圆的区域 */
-	if( circle.l < area.x ) {
-		circle.l = area.x;
-	}
-	if( circle.t < area.y ) {
-		circle.t = area.y;
-	}
-	if( circle.r > area.x + area.w ) {
-		circle.r = area.x + area.w;
-	}
-	if( circle.b > area.y + area.h ) {
-		circle.b = area.y + area.h;
-	}
-	if( src->color_type != COLOR_TYPE_ARGB ) {
-		return;
+	float v, a;
+	int x, y, t, n = size + 1;
+	uchar_t *row, *profile;
+	ShadowMask mask = NEW( ShadowMaskRec, 1 );
+
+	mask->size = size;
+	mask->data = malloc( n * n );
+	mask->entry.data = mask;
+	mask->entry.key = &mask->size;
+	mask->entry.size = sizeof( ShadowMaskRec ) + n * n;
+	profile = mask->data;
+	profile[0] = 255;
+	/**
+	 * 边缘阴影的透明度采用匀减速直线运动的公式： s = vt - at²/2
+	 * 加速度 a 的求值公式为：a = 2x(vt - s)/t²
+	 */
+	if( size > 0 ) {
+		v = 512.0f / size;
+		a = 2 * (v * size - 255) / (size * size);
+		for( t = 0; t < n; ++t ) {
+			x = (int)(255 - (v * t - (a * t * t) / 2));
+			profile[t] = (uchar_t)(x < 0 ? 0 : x);
+		}
 	}
-	px_row_bytes = src->bytes + circle.top*src->bytes_per_row;
-	px_row_bytes += circle.left * src->bytes_per_pixel;
-	/* 遍历区域内每个像素点，根据点到圆心的距离，计算其alpha透明度 */
-	for( y=circle.top; y<circle.bottom; ++y ) {
-		px = (LCUI_ARGB*)px_row_bytes;
-		for( x=circle.left; x<circle.right; ++x ) {
-			t = (y-center.y)*(y-center.y);
-			t += (x-center.x)*(x-center.x);
-			t = (int)((double)sqrt(1.0*t)+0.5);
-			if( t <= r ) {
-				tmp_px.a = (uchar_t)(s-(v*t-(a*t*t)/2));
-				tmp_px.a *= color.a/255.0;
-			} else {
-				tmp_px.alpha = 0;
-			}
-			*px++ = tmp_px;
+	/* 角落阴影的透明度取决于像素到圆心的距离 */
+	for( y = 1; y < n; ++y ) {
+		row = mask->data + y * n;
+		for( x = 0; x < n; ++x ) {
+			t = (int)(sqrt( 1.0 * (x * x + y * y) ) + 0.5);
+			row[x] = t < size ? profile[t] : 0;
 		}
-		px_row_bytes += src->bytes_per_row;
 	}
+	return mask;
 }
 
-static void Graph_DrawTopLeftShadow( LCUI_PaintContext paint, LCUI_Rect *box, 
-				     LCUI_BoxShadow *shadow)
+static void ShadowMask_Delete( void *arg )
 {
-	LCUI_Pos pos;
-	LCUI_Rect bound;
-	LCUI_Graph canvas;
-	bound.w = bound.h = BLUR_WIDTH(shadow);
-	bound.x = box->x + BoxShadow_GetX( shadow );
-	bound.y = box->y + BoxShadow_GetY( shadow );
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		Graph_Init( &canvas );
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		pos.x = bound.x + BLUR_WIDTH( shadow );
-		pos.y = bound.y + BLUR_WIDTH( shadow );
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.w, shadow->color );
-	}
+	ShadowMask mask = arg;
+	free( mask->data );
+	free( mask );
 }
 
-static void Graph_DrawTopRightShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-				      LCUI_BoxShadow *shadow )
+/** 获取指定模糊宽度的遮罩，用完后需调用 ShadowMask_Release() 释放 */
+static ShadowMask ShadowMask_Get( int size )
 {
-	LCUI_Pos pos;
-	LCUI_Rect bound;
-	LCUI_Graph canvas;
-	pos.x = 0;
-	pos.y = BLUR_WIDTH( shadow );
-	bound.w = bound.h = BLUR_WIDTH( shadow );
-	bound.y = box->y + BoxShadow_GetY( shadow );
-	bound.x = box->x + BoxShadow_GetX( shadow );
-	bound.x += BoxShadow_GetBoxWidth( shadow, box->w );
-	bound.x += BLUR_WIDTH( shadow ) + INNER_SHADOW_WIDTH( shadow ) * 2;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		Graph_Init( &canvas );
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.w, shadow->color );
+	ShadowMask mask;
+	if( !cache ) {
+		return ShadowMask_New( size );
 	}
+	mask = LRUCache_Get( cache, &size );
+	if( mask ) {
+		return mask;
+	}
+	/* 生成遮罩时不占用锁，以免阻塞其它线程的绘制 */
+	mask = ShadowMask_New( size );
+	return LRUCache_Add( cache, &mask->entry );
 }
 
-static void Graph_DrawBottomLeftShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-					LCUI_BoxShadow *shadow )
+static void ShadowMask_Release( ShadowMask mask )
 {
-	LCUI_Pos pos;
-	LCUI_Rect bound;
-	LCUI_Graph canvas;
-
-	pos.y = 0;
-	bound.x = box->x + BoxShadow_GetX( shadow );
-	pos.x = bound.w = bound.h = BLUR_WIDTH( shadow );
-	bound.y = box->y + BoxShadow_GetY( shadow );
-	bound.y += BoxShadow_GetBoxHeight( shadow, box->h );
-	bound.y += INNER_SHADOW_WIDTH( shadow ) * 2 + BLUR_WIDTH( shadow );
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.w, shadow->color );
+	if( !cache ) {
+		ShadowMask_Delete( mask );
+		return;
 	}
+	LRUCache_Release( cache, &mask->entry );
 }
 
-static void Graph_DrawBottomRightShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-					 LCUI_BoxShadow *shadow )
+/** 用遮罩中的一行数据填充一段连续的像素 */
+static void FillShadowSpan( LCUI_ARGB *px, const uchar_t *mask_row, int mx,
+			    int step_x, int n, LCUI_Color color )
 {
-	LCUI_Pos pos;
-	LCUI_Rect bound;
-	LCUI_Graph canvas;
-	pos.x = pos.y = 0;
-	bound.x = BoxShadow_GetX( shadow ) + BLUR_WIDTH(shadow);
-	bound.x += BoxShadow_GetBoxWidth( shadow, box->w );
-	bound.x += INNER_SHADOW_WIDTH(shadow)*2;
-	bound.y = BoxShadow_GetY( shadow ) + BLUR_WIDTH(shadow);
-	bound.y += BoxShadow_GetBoxHeight( shadow, box->h );
-	bound.y += INNER_SHADOW_WIDTH(shadow)*2;
-	bound.w = bound.h = BLUR_WIDTH(shadow);
-	bound.x += box->x;
-	bound.y += box->y;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.w, shadow->color );
+	LCUI_ARGB pixel = color;
+	if( step_x == 0 ) {
+		pixel.alpha = ShadowAlpha( mask_row[mx], color.alpha );
+		while( n-- > 0 ) {
+			*px++ = pixel;
+		}
+		return;
+	}
+	for( ; n > 0; --n, mx += step_x ) {
+		pixel.alpha = ShadowAlpha( mask_row[mx], color.alpha );
+		*px++ = pixel;
 	}
 }
 
 /**
- * 绘制上边阴影
+ * 绘制阴影中的一块区域
  * @param[in] paint 绘制上下文
- * @param[in] box 可供绘制阴影的区域范围
- * @param[in] shadow 阴影参数
+ * @param[in] box 阴影所在的矩形
+ * @param[in] content 被内容框遮挡的区域，这块区域内不绘制阴影
+ * @param[in] mask 阴影遮罩
+ * @param[in] piece 需要绘制的区域
+ * @param[in] color 阴影颜色
  */
-static void Graph_DrawTopShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-				 LCUI_BoxShadow *shadow )
+static void Graph_DrawShadowPiece( LCUI_PaintContext paint, LCUI_Rect *box,
+				   LCUI_Rect *content, ShadowMask mask,
+				   ShadowPiece piece, LCUI_Color color )
 {
-	float v, a;
-	LCUI_Color color;
 	LCUI_Graph *graph;
-	int s, t, x, y, bound_x, bound_y;
-	LCUI_Rect shadow_area, box_area, paint_area, area;
-
-	/**
-	* 这里采用匀减速直线运动的公式： s = vt - at²/2
-	* 加速度 a 的求值公式为：a = 2x(vt - s)/t²
-	*/
-	s = 255;
-	t = BLUR_WIDTH( shadow );
-	v = 512.0 / t;
-	a = 2 * (v*t - s) / (t*t);
-	color = shadow->color;
-	/* 计算阴影内框区域 */
-	box_area.x = BoxShadow_GetBoxX( shadow );
-	box_area.y = BoxShadow_GetBoxY( shadow );
-	box_area.w = BoxShadow_GetBoxWidth( shadow, box->w );
-	box_area.h = BoxShadow_GetBoxHeight( shadow, box->h );
-	/* 计算需要绘制的阴影区域 */
-	shadow_area.x = BoxShadow_GetX( shadow ) + BLUR_WIDTH(shadow);
-	shadow_area.y = BoxShadow_GetY( shadow );
-	shadow_area.w = box_area.w + INNER_SHADOW_WIDTH(shadow)*2;
-	shadow_area.h = BLUR_WIDTH(shadow);
-	/* 调整坐标 */
-	box_area.x += box->x;
-	box_area.y += box->y;
-	shadow_area.x += box->x;
-	shadow_area.y += box->y;
-	/* 如果阴影区域不在绘制范围内 */
-	if( !LCUIRect_GetOverlayRect( &shadow_area, &paint->rect, &area ) ) {
+	LCUI_ARGB *px_row;
+	const uchar_t *mask_row;
+	int y, x0, x1, cx0, cx1, mx, my, n = mask->size + 1;
+	LCUI_Rect rect, area, canvas_rect;
+
+	rect = piece->rect;
+	rect.x += box->x;
+	rect.y += box->y;
+	if( !LCUIRect_GetOverlayRect( &rect, &paint->rect, &area ) ) {
 		return;
 	}
-	/* 获取有效的绘制范围 */
-	Graph_GetValidRect( &paint->canvas, &paint_area );
+	Graph_GetValidRect( &paint->canvas, &canvas_rect );
 	graph = Graph_GetQuote( &paint->canvas );
-	/* 将坐标转换成相对于绘制区域 */
-	shadow_area.x -= paint->rect.x;
-	shadow_area.y -= paint->rect.y;
-	box_area.x -= paint->rect.x;
-	box_area.y -= paint->rect.y;
-	area.x -= paint->rect.x;
-	area.y -= paint->rect.y;
-	bound_x = area.x + area.width;
-	bound_y = area.y + area.height;
-	/* 避免超出绘制范围 */
-	if( bound_x > paint_area.x + paint_area.width ) {
-		bound_x = paint_area.x + paint_area.width;
-	}
-	if( bound_y > paint_area.y + paint_area.height ) {
-		bound_y = paint_area.y + paint_area.height;
-	}
-	t -= area.x - shadow_area.x;
-	for( y = area.y; y < bound_y; ++y, --t ) {
-		/* 计算当前行像素点的透明度 */
-		color.alpha = (uchar_t)(s - (v*t - (a*t*t) / 2));
-		color.alpha *= shadow->color.a / 255.0;
-		for( x = area.x; x < bound_x; ++x ) {
-			if( y >= box_area.y && y < box_area.y + box_area.h
-			    && x >= box_area.x && x < box_area.x + box_area.w ) {
-				continue;
-			}
-			Graph_SetPixel( graph, x, y, color );
-		}
-	}
-}
-
-static void Graph_DrawBottomShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-				    LCUI_BoxShadow *shadow )
-{
-	float v, a;
-	LCUI_Color color;
-	LCUI_Graph *graph;
-	int s, t, x, y, bound_x, bound_y;
-	LCUI_Rect shadow_area, box_area, paint_area, area;
-
-	s = 255;
-	t = BLUR_WIDTH( shadow );
-	v = 512.0 / t;
-	a = 2 * (v*t - s) / (t*t);
-	color = shadow->color;
-	box_area.x = BoxShadow_GetBoxX( shadow );
-	box_area.y = BoxShadow_GetBoxY( shadow );
-	box_area.w = BoxShadow_GetBoxWidth( shadow, box->w );
-	box_area.h = BoxShadow_GetBoxHeight( shadow, box->h );
-	shadow_area.x = BoxShadow_GetX( shadow ) + BLUR_WIDTH( shadow );
-	shadow_area.y = BoxShadow_GetY( shadow ) + BLUR_WIDTH( shadow );
-	shadow_area.y += box_area.h + INNER_SHADOW_WIDTH( shadow ) * 2;
-	shadow_area.w = box_area.w + INNER_SHADOW_WIDTH( shadow ) * 2;
-	shadow_area.h = BLUR_WIDTH( shadow );
-	box_area.x += box->x;
-	box_area.y += box->y;
-	shadow_area.x += box->x;
-	shadow_area.y += box->y;
-	if( !LCUIRect_GetOverlayRect( &shadow_area, &paint->rect, &area ) ) {
-		return;
+	/* 避免超出画布的范围 */
+	if( area.x + area.w > paint->rect.x + canvas_rect.w ) {
+		area.w = paint->rect.x + canvas_rect.w - area.x;
 	}
-	Graph_GetValidRect( &paint->canvas, &paint_area );
-	graph = Graph_GetQuote( &paint->canvas );
-	shadow_area.x -= paint->rect.x;
-	shadow_area.y -= paint->rect.y;
-	box_area.x -= paint->rect.x;
-	box_area.y -= paint->rect.y;
-	area.x -= paint->rect.x;
-	area.y -= paint->rect.y;
-	bound_x = area.x + area.width;
-	bound_y = area.y + area.height;
-	if( bound_x > paint_area.x + paint_area.width ) {
-		bound_x = paint_area.x + paint_area.width;
-	}
-	if( bound_y > paint_area.y + paint_area.height ) {
-		bound_y = paint_area.y + paint_area.height;
-	}
-	for( t = area.y - shadow_area.y, y = area.y; y < bound_y; ++y, ++t ) {
-		color.alpha = (uchar_t)(s - (v*t - (a*t*t) / 2));
-		color.alpha *= shadow->color.a / 255.0;
-		for( x = area.x; x < bound_x; ++x ) {
-			if( y >= box_area.y && y < box_area.y + box_area.h &&
-			    x >= box_area.x && x < box_area.x + box_area.w ) {
-				continue;
-			}
-			Graph_SetPixel( graph, x, y, color );
-		}
+	if( area.y + area.h > paint->rect.y + canvas_rect.h ) {
+		area.h = paint->rect.y + canvas_rect.h - area.y;
 	}
-}
-
-static void Graph_DrawLeftShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-				  LCUI_BoxShadow *shadow )
-{
-	float v, a;
-	LCUI_Color color;
-	LCUI_Graph *graph;
-	int s, t, x, y, bound_x, bound_y;
-	LCUI_Rect shadow_area, box_area, paint_area, area;
-
-	s = 255;
-	t = BLUR_WIDTH(shadow);
-	v = 512.0/t;
-	a = 2*(v*t-s)/(t*t);
-	color = shadow->color;
-	box_area.x = BoxShadow_GetBoxX( shadow );
-	box_area.y = BoxShadow_GetBoxY( shadow );
-	box_area.w = BoxShadow_GetBoxWidth( shadow, box->w );
-	box_area.h = BoxShadow_GetBoxHeight( shadow, box->h );
-	shadow_area.x = BoxShadow_GetX( shadow );
-	shadow_area.y = BoxShadow_GetY( shadow ) + BLUR_WIDTH(shadow);
-	shadow_area.w = BLUR_WIDTH(shadow);
-	shadow_area.h = box_area.h + INNER_SHADOW_WIDTH(shadow)*2;
-	box_area.x += box->x;
-	box_area.y += box->y;
-	shadow_area.x += box->x;
-	shadow_area.y += box->y;
-	if( !LCUIRect_GetOverlayRect( &shadow_area, &paint->rect, &area ) ) {
+	if( area.w <= 0 || area.h <= 0 ) {
 		return;
 	}
-	Graph_GetValidRect( &paint->canvas, &paint_area );
-	graph = Graph_GetQuote( &paint->canvas );
-	shadow_area.x -= paint->rect.x;
-	shadow_area.y -= paint->rect.y;
-	box_area.x -= paint->rect.x;
-	box_area.y -= paint->rect.y;
-	area.x -= paint->rect.x;
-	area.y -= paint->rect.y;
-	bound_x = area.x + area.width;
-	bound_y = area.y + area.height;
-	if( bound_x > paint_area.x + paint_area.width ) {
-		bound_x = paint_area.x + paint_area.width;
-	}
-	if( bound_y > paint_area.y + paint_area.height ) {
-		bound_y = paint_area.y + paint_area.height;
-	}
-	t -= area.x - shadow_area.x;
-	for( x = area.x; x < bound_x; ++x, --t ) {
-		color.alpha = (uchar_t)(s - (v*t - (a*t*t) / 2));
-		color.alpha *= shadow->color.a / 255.0;
-		for( y = area.y; y < bound_y; ++y ) {
-			if( y >= box_area.y && y < box_area.y + box_area.h &&
-			    x >= box_area.x && x < box_area.x + box_area.w ) {
-				continue;
+	px_row = graph->argb + canvas_rect.x - paint->rect.x;
+	px_row += (canvas_rect.y - paint->rect.y + area.y) * graph->w;
+	my = piece->y + piece->step_y * (area.y - rect.y);
+	mx = piece->x + piece->step_x * (area.x - rect.x);
+	for( y = area.y; y < area.y + area.h; ++y ) {
+		mask_row = mask->data + my * n;
+		x0 = area.x;
+		x1 = area.x + area.w;
+		if( y >= content->y && y < content->y + content->h ) {
+			/* 跳过被内容框遮挡的部分 */
+			cx0 = max( x0, content->x );
+			cx1 = min( x1, content->x + content->w );
+			if( cx1 > cx0 ) {
+				FillShadowSpan( px_row + x0, mask_row, mx,
+						piece->step_x, cx0 - x0, color );
+				x0 = cx1;
 			}
-			Graph_SetPixel( graph, x, y, color );
 		}
-	}
-}
-
-static void Graph_DrawRightShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-				   LCUI_BoxShadow *shadow )
-{
-	float v, a;
-	LCUI_Color color;
-	LCUI_Graph *graph;
-	int s, t, x, y, bound_x, bound_y;
-	LCUI_Rect shadow_area, box_area, paint_area, area;
-
-	s = 255;
-	t = BLUR_WIDTH(shadow);
-	v = 512.0/t;
-	a = 2*(v*t-s)/(t*t);
-	color = shadow->color;
-	box_area.x = BoxShadow_GetBoxX( shadow );
-	box_area.y = BoxShadow_GetBoxY( shadow );
-	box_area.w = BoxShadow_GetBoxWidth( shadow, box->w );
-	box_area.h = BoxShadow_GetBoxHeight( shadow, box->h );
-	shadow_area.x = BoxShadow_GetX( shadow ) + SHADOW_WIDTH(shadow);
-	shadow_area.x += box_area.w + INNER_SHADOW_WIDTH(shadow);
-	shadow_area.y = BoxShadow_GetY( shadow ) + BLUR_WIDTH(shadow);
-	shadow_area.w = BLUR_WIDTH(shadow);
-	shadow_area.h = box_area.h + INNER_SHADOW_WIDTH(shadow)*2;
-	box_area.x += box->x;
-	box_area.y += box->y;
-	shadow_area.x += box->x;
-	shadow_area.y += box->y;
-	if( !LCUIRect_GetOverlayRect( &shadow_area, &paint->rect, &area ) ) {
-		return;
-	}
-	Graph_GetValidRect( &paint->canvas, &paint_area );
-	graph = Graph_GetQuote( &paint->canvas );
-	shadow_area.x -= paint->rect.x;
-	shadow_area.y -= paint->rect.y;
-	box_area.x -= paint->rect.x;
-	box_area.y -= paint->rect.y;
-	area.x -= paint->rect.x;
-	area.y -= paint->rect.y;
-	bound_x = area.x + area.width;
-	bound_y = area.y + area.height;
-	if( bound_x > paint_area.x + paint_area.width ) {
-		bound_x = paint_area.x + paint_area.width;
-	}
-	if( bound_y > paint_area.y + paint_area.height ) {
-		bound_y = paint_area.y + paint_area.height;
-	}
-	t = area.x - shadow_area.x;
-	for( x = shadow_area.x; x < bound_x; ++x, ++t ) {
-		if( x < area.x || x >= area.x + area.w ) {
-			continue;
-		}
-		color.alpha = (uchar_t)(s - (v*t - (a*t*t) / 2));
-		color.alpha *= shadow->color.a / 255.0;
-		for( y = area.y; y < bound_y; ++y ) {
-			if( y >= box_area.y && y < box_area.y + box_area.h
-			    && x >= box_area.x && x < box_area.x + box_area.w ) {
-				continue;
-			}
-			Graph_SetPixel( graph, x, y, color );
+		if( x1 > x0 ) {
+			FillShadowSpan( px_row + x0, mask_row,
+					mx + piece->step_x * (x0 - area.x),
+					piece->step_x, x1 - x0, color );
 		}
+		px_row += graph->w;
+		my += piece->step_y;
 	}
 }
 
@@ -592,45 +356,6 @@ void Graph_ClearShadowArea( LCUI_PaintContext paint, LCUI_Rect *box,
 	}
 }
 
-static void Graph_DrawInnerShadow( LCUI_PaintContext paint, LCUI_Rect *box,
-				   LCUI_BoxShadow *s )
-{
-	int i;
-	LCUI_Graph canvas;
-	LCUI_Rect rsd, rb, rects[4];
-	rb.x = BoxShadow_GetBoxX( s );
-	rb.y = BoxShadow_GetBoxY( s );
-	rb.w = BoxShadow_GetBoxWidth( s, box->w );
-	rb.h = BoxShadow_GetBoxHeight( s, box->h );
-	rsd.x = BoxShadow_GetX( s ) + BLUR_WIDTH(s);
-	rsd.y = BoxShadow_GetY( s ) + BLUR_WIDTH(s);
-	rsd.w = rb.w + INNER_SHADOW_WIDTH(s)*2;
-	rsd.h = rb.h + INNER_SHADOW_WIDTH(s)*2;
-	/* 截取出与内容区重叠的区域 */
-	if( LCUIRect_GetOverlayRect(&rb, &rsd, &rb) ) {
-		LCUIRect_CutFourRect( &rb, &rsd, rects );
-		/* 从阴影区域中排除部件占用的区域 */
-		for( i=0; i<4; ++i ) {
-			if( !LCUIRect_GetOverlayRect(
-				&paint->rect, &rects[i],&rects[i]) ) {
-				continue;
-			}
-			rects[i].x -= paint->rect.x;
-			rects[i].y -= paint->rect.y;
-			Graph_Quote( &canvas, &paint->canvas, &rects[i] );
-			Graph_FillRect( &canvas, s->color, NULL, TRUE );
-		}
-		return;
-	}
-	/* 不重叠则直接填充 */
-	if( LCUIRect_GetOverlayRect(&paint->rect, &rsd, &rb) ) {
-		rb.x -= paint->rect.x;
-		rb.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &rb );
-		Graph_FillRect( &canvas, s->color, NULL, TRUE );
-	}
-}
-
 void BoxShadow_Init( LCUI_BoxShadow *shadow )
 {
 	shadow->color.r = 0;
@@ -645,19 +370,119 @@ void BoxShadow_Init( LCUI_BoxShadow *shadow )
 int Graph_DrawBoxShadow( LCUI_PaintContext paint, LCUI_Rect *box,
 			 LCUI_BoxShadow *shadow )
 {
+	int i, t, x, y, w, h;
+	ShadowMask mask;
+	LCUI_Rect content;
+	LCUI_Graph *graph;
+	ShadowPieceRec pieces[9];
+
 	/* 判断容器尺寸是否低于阴影占用的最小尺寸 */
 	if( box->w < BoxShadow_GetWidth(shadow, 0)
 	 || box->h < BoxShadow_GetHeight(shadow, 0) ) {
 		return -1;
 	}
-	Graph_DrawInnerShadow( paint, box, shadow );
-	Graph_DrawTopLeftShadow( paint, box, shadow );
-	Graph_DrawTopRightShadow( paint, box, shadow );
-	Graph_DrawBottomLeftShadow( paint, box, shadow );
-	Graph_DrawBottomRightShadow( paint, box, shadow );
-	Graph_DrawTopShadow( paint, box, shadow );
-	Graph_DrawBottomShadow( paint, box, shadow );
-	Graph_DrawLeftShadow( paint, box, shadow );
-	Graph_DrawRightShadow( paint, box, shadow );
+	graph = Graph_GetQuote( &paint->canvas );
+	if( shadow->color.alpha == 0 || !graph ||
+	    graph->color_type != COLOR_TYPE_ARGB ) {
+		return 0;
+	}
+	content.x = box->x + BoxShadow_GetBoxX( shadow );
+	content.y = box->y + BoxShadow_GetBoxY( shadow );
+	content.w = BoxShadow_GetBoxWidth( shadow, box->w );
+	content.h = BoxShadow_GetBoxHeight( shadow, box->h );
+	/* 阴影的外框、内框和模糊宽度 */
+	t = BLUR_WIDTH( shadow );
+	x = BoxShadow_GetX( shadow );
+	y = BoxShadow_GetY( shadow );
+	w = content.w + INNER_SHADOW_WIDTH( shadow ) * 2;
+	h = content.h + INNER_SHADOW_WIDTH( shadow ) * 2;
+	/* 按从左到右、从上到下的顺序划分出 9 块区域，中间的一块没有模糊 */
+	for( i = 0; i < 9; ++i ) {
+		ShadowPiece piece = &pieces[i];
+		switch( i % 3 ) {
+		case 0:
+			piece->rect.x = x;
+			piece->rect.w = t;
+			piece->x = t;
+			piece->step_x = -1;
+			break;
+		case 1:
+			piece->rect.x = x + t;
+			piece->rect.w = w;
+			piece->x = 0;
+			piece->step_x = 0;
+			break;
+		default:
+			piece->rect.x = x + t + w;
+			piece->rect.w = t;
+			piece->x = 0;
+			piece->step_x = 1;
+			break;
+		}
+		switch( i / 3 ) {
+		case 0:
+			piece->rect.y = y;
+			piece->rect.h = t;
+			piece->y = t;
+			piece->step_y = -1;
+			break;
+		case 1:
+			piece->rect.y = y + t;
+			piece->rect.h = h;
+			piece->y = 0;
+			piece->step_y = 0;
+			break;
+		default:
+			piece->rect.y = y + t + h;
+			piece->rect.h = t;
+			piece->y = 0;
+			piece->step_y = 1;
+			break;
+		}
+	}
+	mask = ShadowMask_Get( t );
+	for( i = 0; i < 9; ++i ) {
+		Graph_DrawShadowPiece( paint, box, &content, mask,
+				       &pieces[i], shadow->color );
+	}
+	ShadowMask_Release( mask );
 	return 0;
 }
+
+void BoxShadow_SetCacheSize( size_t max_bytes )
+{
+	if( cache ) {
+		LRUCache_SetMaxBytes( cache, max_bytes );
+	}
+}
+
+void BoxShadow_GetCacheStats( LCUI_BoxShadowCacheStats stats )
+{
+	LCUI_LRUCacheStatsRec s;
+	if( !cache ) {
+		memset( stats, 0, sizeof( LCUI_BoxShadowCacheStatsRec ) );
+		return;
+	}
+	LRUCache_GetStats( cache, &s );
+	stats->hits = s.hits;
+	stats->misses = s.misses;
+	stats->used_bytes = s.used_bytes;
+	stats->max_bytes = s.max_bytes;
+	stats->count = s.count;
+}
+
+void LCUI_InitBoxShadow( void )
+{
+	if( !cache ) {
+		cache = LRUCache_Create( sizeof( int ), SHADOW_CACHE_MAX_BYTES,
+					 ShadowMask_Delete );
+	}
+}
+
+void LCUI_ExitBoxShadow( void )
+{
+	if( cache ) {
+		LRUCache_Destroy( cache );
+		cache = NULL;
+	}
+}
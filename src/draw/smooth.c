@@ -1,148 +1,306 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
 #include <LCUI/graph.h>
 
-static const double PI = 3.141592653;
+/**
+ * 本模块用三次盒式模糊来近似高斯模糊，每个像素的计算量与模糊半径无关。
+ * 每次盒式模糊都用滑动窗口的累加值求均值，除法用 16 位定点小数的乘法代替。
+ * 标准差较小时盒式模糊的近似效果较差，而高斯核也很小，所以直接用定点数的
+ * 高斯核计算。
+ * 水平方向的模糊按行处理，垂直方向的模糊先将图像分块转置，再按行处理，然后
+ * 转置回来，以免按列访问像素。行与行之间互不影响，因此可以分成多个行带交给
+ * 多个线程处理。
+ */
 
-/** X轴方向线性模糊 */
-static void HorizSmoothARGB( LCUI_ARGB *pSrcPixels, LCUI_ARGB *pDesPixels, 
-			     size_t len, double *kvalue, int kcenter )
+#define BOX_PASSES		3
+#define TRANSPOSE_BLOCK		32
+#define MAX_SMOOTH_THREADS	16
+#define SMALL_SIGMA		2.0
+#define MAX_KERNEL_RADIUS	6
+
+/** 模糊参数 */
+typedef struct SmoothParamsRec_ {
+	int radius[BOX_PASSES];		/**< 每次盒式模糊的半径 */
+	int kernel_radius;		/**< 高斯核的半径，为 0 时使用盒式模糊 */
+	int kernel[MAX_KERNEL_RADIUS * 2 + 1];	/**< 高斯核，16 位定点小数 */
+} SmoothParamsRec, *SmoothParams;
+
+/** 一个行带的模糊任务 */
+typedef struct SmoothTaskRec_ {
+	LCUI_ARGB *pixels;		/**< 第一行的像素 */
+	int width;			/**< 每行的像素数量 */
+	int rows;			/**< 行数 */
+	SmoothParams params;		/**< 模糊参数 */
+} SmoothTaskRec, *SmoothTask;
+
+/** 计算高斯核，权重之和为 1 << 16 */
+static void ComputeKernel( double sigma, SmoothParams params )
 {
-	int j;
-	double i;
-	LCUI_ARGB *px_src, *px_des;
-	double sum, amul, bmul, gmul, rmul, *pkvalue;
-
-	for( i=0; i<len; ++i ) { 
-		sum = amul = bmul = gmul = rmul = 0;
-		px_src = pSrcPixels;
-		px_des = pDesPixels;
-		pkvalue = kvalue;
-		for( j=-kcenter; j<=kcenter; ++j ) {
-			if((i+j) >= 0 && (i+j) < len) {
-				bmul += px_src->b*(*pkvalue);
-				gmul += px_src->g*(*pkvalue);
-				rmul += px_src->r*(*pkvalue);
-				amul += px_src->a*(*pkvalue);
-				sum += (*pkvalue);
-			}
-			++px_src;
-			++pkvalue;
+	double sum = 0, *weights;
+	int i, total = 0, r = (int)ceil( sigma * 3 );
+
+	if( r > MAX_KERNEL_RADIUS ) {
+		r = MAX_KERNEL_RADIUS;
+	}
+	weights = malloc( sizeof( double ) * (r * 2 + 1) );
+	for( i = -r; i <= r; ++i ) {
+		weights[i + r] = exp( -i * i / (2 * sigma * sigma) );
+		sum += weights[i + r];
+	}
+	for( i = 0; i <= r * 2; ++i ) {
+		params->kernel[i] = (int)(weights[i] / sum * (1 << 16) + 0.5);
+		total += params->kernel[i];
+	}
+	/* 把舍入误差补到中心，保证纯色的图像模糊后不变 */
+	params->kernel[r] += (1 << 16) - total;
+	params->kernel_radius = r;
+	free( weights );
+}
+
+/** 计算与指定标准差的高斯模糊相近的各次盒式模糊的半径 */
+static void ComputeBoxRadius( double sigma, int radius[BOX_PASSES] )
+{
+	int i, m, wl, wu;
+	double w_ideal = sqrt( 12 * sigma * sigma / BOX_PASSES + 1 );
+
+	wl = (int)floor( w_ideal );
+	if( wl % 2 == 0 ) {
+		wl -= 1;
+	}
+	wu = wl + 2;
+	/* 前 m 次用较小的窗口，其余用较大的窗口，使总方差与高斯核一致 */
+	m = (int)floor( (12 * sigma * sigma - BOX_PASSES * wl * wl -
+			 4.0 * BOX_PASSES * wl - 3 * BOX_PASSES) /
+			(-4.0 * wl - 4) + 0.5 );
+	for( i = 0; i < BOX_PASSES; ++i ) {
+		radius[i] = ((i < m ? wl : wu) - 1) / 2;
+	}
+}
+
+/** 对一行像素进行盒式模糊，超出边界的像素取边缘像素的值 */
+static void BoxBlurRow( const LCUI_ARGB *src, LCUI_ARGB *dst,
+			int len, int r )
+{
+	int i;
+	uint64_t inv;
+	const LCUI_ARGB *px;
+	unsigned int sa, sr, sg, sb;
+
+	if( r < 1 ) {
+		memcpy( dst, src, sizeof( LCUI_ARGB ) * len );
+		return;
+	}
+	/* 用 24 位精度的倒数代替除法，并且四舍五入，否则半径较大时每次模糊
+	 * 都会少算一点，纯色也会越模糊越暗 */
+	inv = ((1 << 24) + (2 * r + 1) / 2) / (2 * r + 1);
+	sa = src[0].a * (r + 1);
+	sr = src[0].r * (r + 1);
+	sg = src[0].g * (r + 1);
+	sb = src[0].b * (r + 1);
+	for( i = 1; i <= r; ++i ) {
+		px = &src[i < len ? i : len - 1];
+		sa += px->a;
+		sr += px->r;
+		sg += px->g;
+		sb += px->b;
+	}
+	for( i = 0; i < len; ++i ) {
+		dst[i].a = (uchar_t)((sa * inv + (1 << 23)) >> 24);
+		dst[i].r = (uchar_t)((sr * inv + (1 << 23)) >> 24);
+		dst[i].g = (uchar_t)((sg * inv + (1 << 23)) >> 24);
+		dst[i].b = (uchar_t)((sb * inv + (1 << 23)) >> 24);
+		/* 窗口右移一个像素 */
+		px = &src[i + r + 1 < len ? i + r + 1 : len - 1];
+		sa += px->a;
+		sr += px->r;
+		sg += px->g;
+		sb += px->b;
+		px = &src[i - r > 0 ? i - r : 0];
+		sa -= px->a;
+		sr -= px->r;
+		sg -= px->g;
+		sb -= px->b;
+	}
+}
+
+/** 用高斯核对一行像素进行模糊，超出边界的像素取边缘像素的值 */
+static void KernelBlurRow( const LCUI_ARGB *src, LCUI_ARGB *dst, int len,
+			   const int *kernel, int r )
+{
+	int i, j, k;
+	const LCUI_ARGB *px;
+	unsigned int sa, sr, sg, sb;
+
+	for( i = 0; i < len; ++i ) {
+		sa = sr = sg = sb = 1 << 15;
+		for( j = -r; j <= r; ++j ) {
+			k = i + j < 0 ? 0 : (i + j >= len ? len - 1 : i + j);
+			px = &src[k];
+			sa += px->a * kernel[j + r];
+			sr += px->r * kernel[j + r];
+			sg += px->g * kernel[j + r];
+			sb += px->b * kernel[j + r];
+		}
+		dst[i].a = (uchar_t)(sa >> 16);
+		dst[i].r = (uchar_t)(sr >> 16);
+		dst[i].g = (uchar_t)(sg >> 16);
+		dst[i].b = (uchar_t)(sb >> 16);
+	}
+}
+
+/** 对行带中的每一行进行模糊，结果写回原处 */
+static void SmoothRows( void *arg )
+{
+	int y, i;
+	SmoothTask task = arg;
+	LCUI_ARGB *row, *buf[2];
+	SmoothParams params = task->params;
+
+	buf[0] = malloc( sizeof( LCUI_ARGB ) * task->width * 2 );
+	if( !buf[0] ) {
+		return;
+	}
+	buf[1] = buf[0] + task->width;
+	row = task->pixels;
+	for( y = 0; y < task->rows; ++y, row += task->width ) {
+		if( params->kernel_radius > 0 ) {
+			KernelBlurRow( row, buf[0], task->width,
+				       params->kernel, params->kernel_radius );
+			memcpy( row, buf[0], sizeof( LCUI_ARGB ) * task->width );
+			continue;
+		}
+		BoxBlurRow( row, buf[0], task->width, params->radius[0] );
+		for( i = 1; i < BOX_PASSES - 1; ++i ) {
+			BoxBlurRow( buf[(i - 1) % 2], buf[i % 2],
+				    task->width, params->radius[i] );
 		}
-		px_des->b = bmul/sum;
-		px_des->g = gmul/sum;
-		px_des->r = rmul/sum;
-		px_des->a = amul/sum;
-		++px_des;
-		++px_src;
+		BoxBlurRow( buf[(i - 1) % 2], row, task->width,
+			    params->radius[i] );
 	}
+	free( buf[0] );
 }
 
-/** Y轴方向线性模糊 */
-static void VertiSmoothARGB( LCUI_ARGB *pSrcPixels, LCUI_ARGB *pDesPixels, 
-		size_t rows, size_t cols, double *pkernel, int kcenter )
+/** 将图像中的所有行分成多个行带，分别交给多个线程模糊 */
+static void SmoothRowsInBands( LCUI_ARGB *pixels, int width, int rows,
+			       SmoothParams params, int n_threads )
 {
-	int j;
-	double i;
-	LCUI_ARGB *px_src, *px_des;
-	double sum, amul, bmul, gmul, rmul, *pkvalue;
-	
-	for( i=0; i<rows; ++i ) { 
-		sum = amul = bmul = gmul = rmul = 0;
-		px_src = pSrcPixels;
-		px_des = pDesPixels;
-		pkvalue = pkernel;
-		for( j=-kcenter; j<=kcenter; ++j ) {
-			if((i+j) >= 0 && (i+j) < rows) {
-				bmul += px_src->b*(*pkvalue);
-				gmul += px_src->g*(*pkvalue);
-				rmul += px_src->r*(*pkvalue);
-				amul += px_src->a*(*pkvalue);
-				sum += (*pkvalue);
+	int i, y, n;
+	SmoothTaskRec tasks[MAX_SMOOTH_THREADS];
+	LCUI_Thread threads[MAX_SMOOTH_THREADS];
+
+	if( n_threads > rows ) {
+		n_threads = rows;
+	}
+	if( n_threads > MAX_SMOOTH_THREADS ) {
+		n_threads = MAX_SMOOTH_THREADS;
+	}
+	if( n_threads < 1 ) {
+		n_threads = 1;
+	}
+	for( i = 0, y = 0; i < n_threads; ++i ) {
+		n = (rows - y) / (n_threads - i);
+		tasks[i].pixels = pixels + y * width;
+		tasks[i].width = width;
+		tasks[i].rows = n;
+		tasks[i].params = params;
+		y += n;
+	}
+	/* 当前线程处理第一个行带，创建线程失败时也由当前线程处理 */
+	for( i = 1; i < n_threads; ++i ) {
+		if( LCUIThread_Create( &threads[i], SmoothRows,
+				       &tasks[i] ) != 0 ) {
+			break;
+		}
+	}
+	n = i;
+	SmoothRows( &tasks[0] );
+	for( ; i < n_threads; ++i ) {
+		SmoothRows( &tasks[i] );
+	}
+	for( i = 1; i < n; ++i ) {
+		LCUIThread_Join( threads[i], NULL );
+	}
+}
+
+/** 分块转置图像，src 有 rows 行，每行 cols 个像素 */
+static void TransposeARGB( const LCUI_ARGB *src, LCUI_ARGB *dst,
+			   int cols, int rows )
+{
+	int x, y, bx, by, x_end, y_end;
+	for( by = 0; by < rows; by += TRANSPOSE_BLOCK ) {
+		y_end = by + TRANSPOSE_BLOCK < rows ? by + TRANSPOSE_BLOCK : rows;
+		for( bx = 0; bx < cols; bx += TRANSPOSE_BLOCK ) {
+			x_end = bx + TRANSPOSE_BLOCK < cols ?
+				bx + TRANSPOSE_BLOCK : cols;
+			for( y = by; y < y_end; ++y ) {
+				for( x = bx; x < x_end; ++x ) {
+					dst[x * rows + y] = src[y * cols + x];
+				}
 			}
-			px_src += cols;
-			++pkvalue;
 		}
-		px_des->b = bmul/sum;
-		px_des->g = gmul/sum;
-		px_des->r = rmul/sum;
-		px_des->a = amul/sum;
-		px_des += cols;
-		px_src += cols;
 	}
 }
 
-/** 对图像进行高斯模糊处理 */
-LCUI_API int GaussianSmooth( LCUI_Graph *src, LCUI_Graph *des, double sigma )
+int Graph_SmoothEx( LCUI_Graph *src, LCUI_Graph *des,
+		    double sigma, int n_threads )
 {
-	LCUI_Graph temp;
-	int kcenter, i;
-	int x, y, ksize;
-	double *kernel, scale, cons, sum = 0;
-	LCUI_ARGB *p_src_px, *p_des_px;
-	
+	int y;
+	LCUI_Rect rect;
+	SmoothParamsRec params;
+	LCUI_Graph *graph;
+	LCUI_ARGB *temp;
+
+	if( !Graph_IsValid( src ) ) {
+		return -1;
+	}
+	Graph_GetValidRect( src, &rect );
+	graph = Graph_GetQuote( src );
+	if( graph->color_type != COLOR_TYPE_ARGB ) {
+		return -1;
+	}
+	des->color_type = COLOR_TYPE_ARGB;
+	if( Graph_Create( des, rect.width, rect.height ) != 0 ) {
+		return -2;
+	}
+	for( y = 0; y < rect.height; ++y ) {
+		memcpy( des->argb + y * des->w,
+			graph->argb + (rect.y + y) * graph->w + rect.x,
+			sizeof( LCUI_ARGB ) * rect.width );
+	}
 	sigma = sigma > 0 ? sigma : -sigma;
-	// ksize为奇数 
-	ksize = ceil(sigma * 3) * 2 + 1; 
-	if(ksize == 1) {
-		Graph_Copy( des, src );
+	if( sigma < 0.2 ) {
 		return 0;
 	}
-
-	// 计算一维高斯核 
-	scale = -0.5/(sigma*sigma);
-	cons = 1/sqrt(-scale / PI); 
-	kcenter = ksize/2; 
-	kernel = (double*)malloc( ksize*sizeof(double) );
-	for(i = 0; i < ksize; ++i) {
-		int x = i - kcenter;
-		*(kernel+i) = cons * exp(x * x * scale); // 一维高斯函数
-		sum += *(kernel+i);
-	} 
-	// 归一化,确保高斯权值在[0,1]之间
-	for(i = 0; i < ksize; i++) {
-		*(kernel+i) /= sum;
-	}
-	
-	des->color_type = src->color_type;
-	if( Graph_Create( des, src->w, src->h ) != 0 ) {
-		return -1;
+	params.kernel_radius = 0;
+	if( sigma < SMALL_SIGMA ) {
+		ComputeKernel( sigma, &params );
+	} else {
+		ComputeBoxRadius( sigma, params.radius );
 	}
-	
-	Graph_Init( &temp );
-	temp.color_type = src->color_type;
-	if( Graph_Create( &temp, src->w, src->h ) != 0 ) {
+	temp = malloc( sizeof( LCUI_ARGB ) * des->w * des->h );
+	if( !temp ) {
 		return -2;
 	}
-	
-	// x方向一维高斯模糊
-	p_des_px = temp.argb;
-	p_src_px = src->argb - kcenter;
-	for( y=0; y<src->h; ++y ) {
-		HorizSmoothARGB( p_src_px, p_des_px, src->w, kernel, kcenter );
-		p_des_px += temp.w;
-		p_src_px += src->w;
-	}
-
-	// y方向一维高斯模糊
-	p_des_px = temp.argb;
-	p_src_px = src->argb - kcenter*temp.w;
-	for( x=0; x<temp.w; ++x ) {
-		VertiSmoothARGB( p_src_px, p_des_px, src->h, src->w, kernel, kcenter );
-		++p_des_px;
-		++p_src_px;
-	}
-	
-	Graph_Free( &temp );
-	free(kernel);
+	/* 先模糊每一行，然后转置，模糊每一列，再转置回来 */
+	SmoothRowsInBands( des->argb, des->w, des->h, &params, n_threads );
+	TransposeARGB( des->argb, temp, des->w, des->h );
+	SmoothRowsInBands( temp, des->h, des->w, &params, n_threads );
+	TransposeARGB( temp, des->argb, des->h, des->w );
+	free( temp );
 	return 0;
 }
 
-/** 对图像进行模糊处理 */
-LCUI_API int Graph_Smooth( LCUI_Graph *src, LCUI_Graph *des, double sigma )
+int GaussianSmooth( LCUI_Graph *src, LCUI_Graph *des, double sigma )
+{
+	return Graph_SmoothEx( src, des, sigma, 1 );
+}
+
+int Graph_Smooth( LCUI_Graph *src, LCUI_Graph *des, double sigma )
 {
-	return GaussianSmooth( src, des, sigma );
+	return Graph_SmoothEx( src, des, sigma, 1 );
 }
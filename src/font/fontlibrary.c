@@ -39,22 +39,78 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
+#include <LCUI/thread.h>
 #include <LCUI/font.h>
 
-#define FONT_CACHE_SIZE	32
+#define FONT_CACHE_SIZE		32
+#define GLYPH_PAGE_SIZE		16384
+#define GLYPH_NUM_CLASSES	15
+#define GLYPH_MIN_BUCKETS	256
+#define GLYPH_CACHE_MAX_BYTES	(4 * 1024 * 1024)
 
 /**
- * 库中缓存的字体位图是分组存放的，共有三级分组，分别为：
- * 字符->字体信息->字体大小
- * 获取字体位图时的搜索顺序为：先找到字符的记录，然后在记录中的字体数据库里找
- * 到指定字体样式标识号的字体位图库，之后在字体位图库中找到指定像素大小的字体
- * 位图。
+ * 字体位图缓存
+ * 字体位图按 字符、字体标识号、像素大小 组成的键存放在哈希表中。位图数据存放
+ * 在共享的缓存页中，每个页被划分成大小相同的块，一个块存放一个字形的位图，过
+ * 大的位图则单独分配内存。
+ * 缓存页和单独分配的内存总量受内存预算限制，超出预算时，会在下一帧开始前淘汰
+ * 最久未使用的字形的位图数据。
+ * 每个缓存项都有引用计数，LCUIFont_GetBitmap() 获取的字体位图在调用
+ * LCUIFont_ReleaseBitmap() 之前一直有效，被淘汰的字形仍保留尺寸信息，绘制前
+ * 调用 LCUIFont_UseBitmap() 即可重新载入位图数据。没有被引用的缓存项在位图
+ * 数据被淘汰时会从哈希表中移除，所以缓存项的数量不会无限增长。
  */
 
+/** 字形缓存页 */
+typedef struct GlyphPageRec_ {
+	int block_size;		/**< 块的大小 */
+	int n_used;		/**< 已使用的块的数量 */
+	int free_block;		/**< 空闲块链表的第一个块，-1 表示没有空闲块 */
+	uchar_t *data;		/**< 页的数据 */
+	LinkedListNode node;	/**< 在缓存页列表中的结点 */
+} GlyphPageRec, *GlyphPage;
+
+/** 字形缓存项 */
+typedef struct GlyphEntryRec_ {
+	LCUI_FontBitmap bitmap;		/**< 字体位图，必须是第一个成员 */
+	wchar_t ch;			/**< 字符码 */
+	int font_id;			/**< 字体标识号 */
+	int size;			/**< 像素大小 */
+	int load_ret;			/**< 载入位图时的返回值 */
+	int refs;			/**< 引用计数 */
+	LCUI_BOOL is_loaded;		/**< 位图数据是否已载入 */
+	GlyphPage page;			/**< 位图数据所在的页，NULL 表示单独分配 */
+	unsigned int last_used;		/**< 最近一次使用时的帧序号 */
+	struct GlyphEntryRec_ *next;	/**< 哈希表中同一个桶的下一项 */
+	LinkedListNode node;		/**< 在已载入列表中的结点 */
+} GlyphEntryRec, *GlyphEntry;
+
+static struct LCUI_GlyphCache {
+	GlyphEntry *buckets;		/**< 哈希表 */
+	unsigned int n_buckets;		/**< 哈希表的桶数量，为 2 的幂 */
+	int count;			/**< 缓存项的数量 */
+	LinkedList loaded;		/**< 已载入位图数据的缓存项 */
+	LinkedList pages[GLYPH_NUM_CLASSES];	/**< 各种块大小的缓存页 */
+	size_t used_bytes;		/**< 缓存页和单独分配的位图占用的内存 */
+	size_t max_bytes;		/**< 内存预算 */
+	unsigned int frame;		/**< 帧序号，每次整理缓存时递增 */
+	unsigned long hits;		/**< 命中次数 */
+	unsigned long misses;		/**< 未命中次数 */
+	unsigned long evictions;	/**< 淘汰次数 */
+	LCUI_Mutex mutex;
+} glyphs;
+
+/** 各类缓存页中块的大小，大于最后一类的位图会单独分配内存 */
+static const int glyph_block_sizes[GLYPH_NUM_CLASSES] = {
+	32, 48, 64, 96, 128, 192, 256, 384, 512,
+	768, 1024, 1536, 2048, 3072, 4096
+};
+
 /** 字体字族索引结点 */
 typedef struct LCUI_FontFamilyNode {
 	char *family_name;	/**< 字族名称  */
@@ -72,7 +128,6 @@ static struct LCUI_FontLibraryContext {
 	int font_cache_num;			/**< 字体信息缓存区的数量 */
 	LCUI_BOOL is_inited;			/**< 标记，指示数据库是否初始化 */
 	RBTree family_tree;		/**< 字族信息树，按字族名称记录着各个字体的信息 */
-	RBTree bitmap_cache;		/**< 字体位图缓存区 */
 	LCUI_Font ***font_cache;		/**< 字体信息缓存区 */
 	LCUI_Font *default_font;		/**< 默认字体的信息 */
 	LCUI_Font *incore_font;			/**< 内置字体的信息 */
@@ -82,9 +137,6 @@ static struct LCUI_FontLibraryContext {
 
 /** 检测位图数据是否有效 */
 #define FontBitmap_IsValid(fbmp) (fbmp && fbmp->width>0 && fbmp->rows>0)
-#define SelectChar(ch) (RBTree*)RBTree_GetData( &fontlib.bitmap_cache, ch )
-#define SelectFont(ch, font_id) (RBTree*)RBTree_GetData( ch, font_id )
-#define SelectBitmap(font, size) (LCUI_FontBitmap*)RBTree_GetData( font, size )
 #define SelectFontFamliy(family_name) (LCUI_FontFamilyNode*)\
 	RBTree_CustomGetData( &fontlib.family_tree, family_name );
 #define SelectFontCache(id) \
@@ -105,16 +157,356 @@ static void DestroyFontFamilyNode( void *arg )
 	LinkedList_Clear( &node->styles, NULL );
 }
 
-static void DestroyFontBitmap( void *arg )
+static unsigned int GlyphCache_Hash( wchar_t ch, int font_id, int size )
+{
+	unsigned int h = (unsigned int)ch * 2654435761u;
+	h ^= (unsigned int)font_id * 40503u + (unsigned int)size * 97u;
+	return h ^ (h >> 15);
+}
+
+static GlyphEntry GlyphCache_Find( wchar_t ch, int font_id, int size )
+{
+	GlyphEntry entry;
+	unsigned int i;
+	if( glyphs.n_buckets == 0 ) {
+		return NULL;
+	}
+	i = GlyphCache_Hash( ch, font_id, size ) & (glyphs.n_buckets - 1);
+	for( entry = glyphs.buckets[i]; entry; entry = entry->next ) {
+		if( entry->ch == ch && entry->font_id == font_id &&
+		    entry->size == size ) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/** 扩大哈希表，使缓存项的数量不超过桶的数量 */
+static int GlyphCache_Grow( void )
+{
+	unsigned int i, j, n;
+	GlyphEntry entry, next, *buckets;
+	n = glyphs.n_buckets > 0 ? glyphs.n_buckets * 2 : GLYPH_MIN_BUCKETS;
+	buckets = calloc( n, sizeof( GlyphEntry ) );
+	if( !buckets ) {
+		return -1;
+	}
+	for( i = 0; i < glyphs.n_buckets; ++i ) {
+		for( entry = glyphs.buckets[i]; entry; entry = next ) {
+			next = entry->next;
+			j = GlyphCache_Hash( entry->ch, entry->font_id,
+					     entry->size ) & (n - 1);
+			entry->next = buckets[j];
+			buckets[j] = entry;
+		}
+	}
+	free( glyphs.buckets );
+	glyphs.buckets = buckets;
+	glyphs.n_buckets = n;
+	return 0;
+}
+
+static GlyphEntry GlyphCache_Add( wchar_t ch, int font_id, int size )
+{
+	unsigned int i;
+	GlyphEntry entry;
+	if( (unsigned int)glyphs.count >= glyphs.n_buckets ) {
+		if( GlyphCache_Grow() != 0 ) {
+			return NULL;
+		}
+	}
+	entry = NEW( GlyphEntryRec, 1 );
+	if( !entry ) {
+		return NULL;
+	}
+	FontBitmap_Init( &entry->bitmap );
+	entry->ch = ch;
+	entry->font_id = font_id;
+	entry->size = size;
+	entry->load_ret = 0;
+	entry->refs = 0;
+	entry->is_loaded = FALSE;
+	entry->page = NULL;
+	entry->node.data = entry;
+	i = GlyphCache_Hash( ch, font_id, size ) & (glyphs.n_buckets - 1);
+	entry->next = glyphs.buckets[i];
+	glyphs.buckets[i] = entry;
+	++glyphs.count;
+	return entry;
+}
+
+/** 从哈希表中移除缓存项，并释放它 */
+static void GlyphCache_Remove( GlyphEntry entry )
+{
+	unsigned int i;
+	GlyphEntry *prev;
+	i = GlyphCache_Hash( entry->ch, entry->font_id,
+			     entry->size ) & (glyphs.n_buckets - 1);
+	for( prev = &glyphs.buckets[i]; *prev; prev = &(*prev)->next ) {
+		if( *prev == entry ) {
+			*prev = entry->next;
+			break;
+		}
+	}
+	--glyphs.count;
+	free( entry );
+}
+
+/** 获取字体位图所属的缓存项，字体位图是缓存项的第一个成员 */
+static GlyphEntry GlyphCache_GetEntry( const LCUI_FontBitmap *bmp )
+{
+	return (GlyphEntry)((char*)bmp - offsetof( GlyphEntryRec, bitmap ));
+}
+
+/** 为缓存项分配位图数据的存储空间 */
+static uchar_t *GlyphCache_AllocData( GlyphEntry entry, size_t size )
 {
-	FontBitmap_Free( arg );
-	free( arg );
+	int i, block;
+	GlyphPage page = NULL;
+	LinkedListNode *node;
+	for( i = 0; i < GLYPH_NUM_CLASSES; ++i ) {
+		if( size <= (size_t)glyph_block_sizes[i] ) {
+			break;
+		}
+	}
+	/* 过大的位图不放在缓存页中 */
+	if( i >= GLYPH_NUM_CLASSES ) {
+		uchar_t *data = malloc( size );
+		entry->page = NULL;
+		if( data ) {
+			glyphs.used_bytes += size;
+		}
+		return data;
+	}
+	for( LinkedList_Each( node, &glyphs.pages[i] ) ) {
+		page = node->data;
+		if( page->free_block >= 0 ) {
+			break;
+		}
+		page = NULL;
+	}
+	if( !page ) {
+		page = NEW( GlyphPageRec, 1 );
+		if( !page ) {
+			return NULL;
+		}
+		page->data = malloc( GLYPH_PAGE_SIZE );
+		if( !page->data ) {
+			free( page );
+			return NULL;
+		}
+		page->n_used = 0;
+		page->block_size = glyph_block_sizes[i];
+		/* 把所有块串成空闲块链表，每个空闲块记录下一个空闲块的序号 */
+		for( block = 0; block < GLYPH_PAGE_SIZE / page->block_size;
+		     ++block ) {
+			int next = block + 1;
+			if( (block + 2) * page->block_size > GLYPH_PAGE_SIZE ) {
+				next = -1;
+			}
+			memcpy( page->data + block * page->block_size,
+				&next, sizeof( int ) );
+		}
+		page->free_block = 0;
+		page->node.data = page;
+		LinkedList_AppendNode( &glyphs.pages[i], &page->node );
+		glyphs.used_bytes += GLYPH_PAGE_SIZE;
+	}
+	block = page->free_block;
+	memcpy( &page->free_block, page->data + block * page->block_size,
+		sizeof( int ) );
+	page->n_used += 1;
+	entry->page = page;
+	return page->data + block * page->block_size;
 }
 
-static void DestroyTreeNode( void *arg )
+/** 释放缓存项的位图数据，缓存页中没有位图时释放该页 */
+static void GlyphCache_FreeData( GlyphEntry entry )
 {
-	RBTree_Destroy( arg );
-	free( arg );
+	int i, block;
+	GlyphPage page = entry->page;
+	if( !entry->bitmap.buffer ) {
+		return;
+	}
+	if( !page ) {
+		glyphs.used_bytes -= entry->bitmap.width * entry->bitmap.rows;
+		free( entry->bitmap.buffer );
+		entry->bitmap.buffer = NULL;
+		return;
+	}
+	block = (int)(entry->bitmap.buffer - page->data) / page->block_size;
+	memcpy( entry->bitmap.buffer, &page->free_block, sizeof( int ) );
+	page->free_block = block;
+	page->n_used -= 1;
+	entry->bitmap.buffer = NULL;
+	entry->page = NULL;
+	if( page->n_used > 0 ) {
+		return;
+	}
+	for( i = 0; i < GLYPH_NUM_CLASSES; ++i ) {
+		if( glyph_block_sizes[i] == page->block_size ) {
+			break;
+		}
+	}
+	LinkedList_Unlink( &glyphs.pages[i], &page->node );
+	glyphs.used_bytes -= GLYPH_PAGE_SIZE;
+	free( page->data );
+	free( page );
+}
+
+/** 将字体位图存入缓存项中，bmp 的位图数据会被释放 */
+static void GlyphCache_Store( GlyphEntry entry, LCUI_FontBitmap *bmp )
+{
+	uchar_t *buffer = NULL;
+	size_t size = 0;
+	if( entry->is_loaded ) {
+		GlyphCache_FreeData( entry );
+		LinkedList_Unlink( &glyphs.loaded, &entry->node );
+	}
+	if( FontBitmap_IsValid( bmp ) && bmp->buffer ) {
+		size = bmp->width * bmp->rows;
+		buffer = GlyphCache_AllocData( entry, size );
+	}
+	if( buffer ) {
+		memcpy( buffer, bmp->buffer, size );
+	}
+	entry->bitmap = *bmp;
+	entry->bitmap.buffer = buffer;
+	entry->is_loaded = TRUE;
+	entry->last_used = glyphs.frame;
+	LinkedList_AppendNode( &glyphs.loaded, &entry->node );
+	FontBitmap_Free( bmp );
+}
+
+/** 载入缓存项的字体位图 */
+static void GlyphCache_Load( GlyphEntry entry )
+{
+	LCUI_FontBitmap bmp;
+	FontBitmap_Init( &bmp );
+	entry->load_ret = FontBitmap_Load( &bmp, entry->ch,
+					   entry->font_id, entry->size );
+	GlyphCache_Store( entry, &bmp );
+}
+
+/**
+ * 淘汰缓存项的位图数据
+ * 仍被引用的缓存项只保留字体位图的尺寸信息，没有被引用的则直接移除
+ */
+static void GlyphCache_Evict( GlyphEntry entry )
+{
+	GlyphCache_FreeData( entry );
+	LinkedList_Unlink( &glyphs.loaded, &entry->node );
+	entry->is_loaded = FALSE;
+	++glyphs.evictions;
+	if( entry->refs <= 0 ) {
+		GlyphCache_Remove( entry );
+	}
+}
+
+static int CompareGlyphEntry( const void *a, const void *b )
+{
+	const GlyphEntryRec *ea = *(const GlyphEntry*)a;
+	const GlyphEntryRec *eb = *(const GlyphEntry*)b;
+	/* 帧序号可能会回绕，所以比较它们的差值 */
+	int diff = (int)(ea->last_used - eb->last_used);
+	return diff < 0 ? -1 : (diff > 0 ? 1 : 0);
+}
+
+void LCUIFont_TrimCache( void )
+{
+	int i, n = 0;
+	GlyphEntry *entries;
+	LinkedListNode *node;
+	if( !fontlib.is_inited ) {
+		return;
+	}
+	LCUIMutex_Lock( &glyphs.mutex );
+	++glyphs.frame;
+	if( glyphs.used_bytes <= glyphs.max_bytes ) {
+		LCUIMutex_Unlock( &glyphs.mutex );
+		return;
+	}
+	entries = malloc( sizeof( GlyphEntry ) * glyphs.loaded.length );
+	if( !entries ) {
+		LCUIMutex_Unlock( &glyphs.mutex );
+		return;
+	}
+	for( LinkedList_Each( node, &glyphs.loaded ) ) {
+		entries[n++] = node->data;
+	}
+	qsort( entries, n, sizeof( GlyphEntry ), CompareGlyphEntry );
+	for( i = 0; i < n && glyphs.used_bytes > glyphs.max_bytes; ++i ) {
+		GlyphCache_Evict( entries[i] );
+	}
+	free( entries );
+	LCUIMutex_Unlock( &glyphs.mutex );
+}
+
+void LCUIFont_SetCacheSize( size_t max_bytes )
+{
+	LCUIMutex_Lock( &glyphs.mutex );
+	glyphs.max_bytes = max_bytes;
+	LCUIMutex_Unlock( &glyphs.mutex );
+}
+
+void LCUIFont_GetCacheStats( LCUI_FontCacheStats stats )
+{
+	LCUIMutex_Lock( &glyphs.mutex );
+	stats->hits = glyphs.hits;
+	stats->misses = glyphs.misses;
+	stats->evictions = glyphs.evictions;
+	stats->used_bytes = glyphs.used_bytes;
+	stats->max_bytes = glyphs.max_bytes;
+	stats->count = glyphs.loaded.length;
+	stats->entries = glyphs.count;
+	LCUIMutex_Unlock( &glyphs.mutex );
+}
+
+void LCUIFont_ResetCacheStats( void )
+{
+	LCUIMutex_Lock( &glyphs.mutex );
+	glyphs.hits = 0;
+	glyphs.misses = 0;
+	glyphs.evictions = 0;
+	LCUIMutex_Unlock( &glyphs.mutex );
+}
+
+static void GlyphCache_Init( void )
+{
+	int i;
+	glyphs.buckets = NULL;
+	glyphs.n_buckets = 0;
+	glyphs.count = 0;
+	glyphs.used_bytes = 0;
+	glyphs.max_bytes = GLYPH_CACHE_MAX_BYTES;
+	glyphs.frame = 0;
+	glyphs.hits = 0;
+	glyphs.misses = 0;
+	glyphs.evictions = 0;
+	LinkedList_Init( &glyphs.loaded );
+	for( i = 0; i < GLYPH_NUM_CLASSES; ++i ) {
+		LinkedList_Init( &glyphs.pages[i] );
+	}
+	LCUIMutex_Init( &glyphs.mutex );
+}
+
+static void GlyphCache_Destroy( void )
+{
+	unsigned int i;
+	GlyphEntry entry, next;
+	for( i = 0; i < glyphs.n_buckets; ++i ) {
+		for( entry = glyphs.buckets[i]; entry; entry = next ) {
+			next = entry->next;
+			GlyphCache_FreeData( entry );
+			free( entry );
+		}
+	}
+	free( glyphs.buckets );
+	glyphs.buckets = NULL;
+	glyphs.n_buckets = 0;
+	glyphs.count = 0;
+	LinkedList_Init( &glyphs.loaded );
+	LCUIMutex_Destroy( &glyphs.mutex );
 }
 
 int LCUIFont_Add( LCUI_Font *font )
@@ -225,58 +617,38 @@ void LCUIFont_SetDefault( int id )
 LCUI_FontBitmap* LCUIFont_AddBitmap( wchar_t ch, int font_id,
 				     int size, const LCUI_FontBitmap *bmp )
 {
-	LCUI_FontBitmap *bmp_cache;
-	RBTree *tree_font, *tree_bmp;
+	GlyphEntry entry;
+	LCUI_FontBitmap bmp_cache;
 
 	if( !fontlib.is_inited ) {
 		return NULL;
 	}
-	/* 获取字符的字体信息集 */
-	tree_font = SelectChar( ch );
-	if( !tree_font ) {
-		tree_font = NEW(RBTree, 1);
-		if( !tree_font ) {
-			return NULL;
-		}
-		RBTree_Init( tree_font );
-		RBTree_OnDestroy( tree_font, DestroyTreeNode );
-		RBTree_Insert( &fontlib.bitmap_cache, ch, tree_font );
-	}
 	/* 当字体ID不大于0时，使用内置字体 */
 	if( font_id <= 0 ) {
 		font_id = fontlib.incore_font->id;
 	}
-	/* 获取相应字体样式标识号的字体位图库 */
-	tree_bmp = SelectFont( tree_font, font_id );
-	if( !tree_bmp ) {
-		tree_bmp = NEW(RBTree, 1);
-		if( !tree_bmp ) {
+	LCUIMutex_Lock( &glyphs.mutex );
+	entry = GlyphCache_Find( ch, font_id, size );
+	if( !entry ) {
+		entry = GlyphCache_Add( ch, font_id, size );
+		if( !entry ) {
+			LCUIMutex_Unlock( &glyphs.mutex );
 			return NULL;
 		}
-		RBTree_Init( tree_bmp );
-		RBTree_OnDestroy( tree_bmp, DestroyFontBitmap );
-		RBTree_Insert( tree_font, font_id, tree_bmp );
 	}
-	/* 在字体位图库中获取指定像素大小的字体位图 */
-	bmp_cache = SelectBitmap( tree_bmp, size );
-	if( !bmp_cache ) {
-		bmp_cache = NEW(LCUI_FontBitmap, 1);
-		if( !bmp_cache ) {
-			return NULL;
-		}
-		RBTree_Insert( tree_bmp, size, bmp_cache );
-	}
-	/* 拷贝数据至该空间内 */
-	memcpy( bmp_cache, bmp, sizeof(LCUI_FontBitmap) );
-	return bmp_cache;
+	/* 位图数据会被复制到缓存页中，原来的位图数据由缓存负责释放 */
+	bmp_cache = *bmp;
+	entry->load_ret = 0;
+	GlyphCache_Store( entry, &bmp_cache );
+	LCUIMutex_Unlock( &glyphs.mutex );
+	return &entry->bitmap;
 }
 
 int LCUIFont_GetBitmap( wchar_t ch, int font_id, int size,
 			const LCUI_FontBitmap **bmp )
 {
 	int ret;
-	RBTree *ctx;
-	LCUI_FontBitmap bmp_cache;
+	GlyphEntry entry;
 
 	*bmp = NULL;
 	if( !fontlib.is_inited ) {
@@ -289,27 +661,67 @@ int LCUIFont_GetBitmap( wchar_t ch, int font_id, int size,
 			font_id = fontlib.incore_font->id;
 		}
 	}
-	/* 这里的 while 只是为了减少缩进 */
-	while( TRUE ) {
-		if( !(ctx = SelectChar(ch)) ) {
-			break;
-		}
-		ctx = SelectFont( ctx, font_id );
-		if( !ctx ) {
-			break;
+	LCUIMutex_Lock( &glyphs.mutex );
+	entry = GlyphCache_Find( ch, font_id, size );
+	if( entry && entry->is_loaded ) {
+		++glyphs.hits;
+		entry->last_used = glyphs.frame;
+	} else {
+		++glyphs.misses;
+		if( !entry ) {
+			entry = GlyphCache_Add( ch, font_id, size );
 		}
-		*bmp = SelectBitmap( ctx, size );
-		if( *bmp ) {
-			return 0;
+		if( entry ) {
+			GlyphCache_Load( entry );
 		}
-		break;
 	}
-	FontBitmap_Init( &bmp_cache );
-	ret = FontBitmap_Load( &bmp_cache, ch, font_id, size );
-	*bmp = LCUIFont_AddBitmap( ch, font_id, size, &bmp_cache );
+	if( !entry ) {
+		LCUIMutex_Unlock( &glyphs.mutex );
+		return -3;
+	}
+	*bmp = &entry->bitmap;
+	ret = entry->load_ret;
+	entry->refs += 1;
+	LCUIMutex_Unlock( &glyphs.mutex );
 	return ret;
 }
 
+int LCUIFont_UseBitmap( const LCUI_FontBitmap *bmp )
+{
+	int ret = 0;
+	GlyphEntry entry = GlyphCache_GetEntry( bmp );
+	/* 多个渲染线程会同时使用同一个字形，使用时间也需要在锁内更新 */
+	LCUIMutex_Lock( &glyphs.mutex );
+	if( entry->is_loaded ) {
+		entry->last_used = glyphs.frame;
+	} else {
+		++glyphs.misses;
+		GlyphCache_Load( entry );
+		ret = entry->load_ret;
+	}
+	LCUIMutex_Unlock( &glyphs.mutex );
+	return ret;
+}
+
+void LCUIFont_ReleaseBitmap( const LCUI_FontBitmap *bmp )
+{
+	GlyphEntry entry;
+	if( !bmp || !fontlib.is_inited ) {
+		return;
+	}
+	entry = GlyphCache_GetEntry( bmp );
+	LCUIMutex_Lock( &glyphs.mutex );
+	entry->refs -= 1;
+	/* 没有位图数据的缓存项不占用内存预算，不会被淘汰，所以直接移除 */
+	if( entry->refs <= 0 && !entry->bitmap.buffer ) {
+		if( entry->is_loaded ) {
+			LinkedList_Unlink( &glyphs.loaded, &entry->node );
+		}
+		GlyphCache_Remove( entry );
+	}
+	LCUIMutex_Unlock( &glyphs.mutex );
+}
+
 int LCUIFont_LoadFile( const char *filepath )
 {
 	LCUI_Font **fonts;
@@ -501,6 +913,57 @@ int FontBitmap_Mix( LCUI_Graph *graph, LCUI_Pos pos,
 	return 0;
 }
 
+/** 将一组使用相同颜色的字体位图绘制到目标图像上 */
+int FontBitmap_MixRun( LCUI_Graph *graph, const LCUI_FontBitmap **bmps,
+		       const LCUI_Pos *pos, int n, LCUI_Color color )
+{
+	int i, right, bottom;
+	LCUI_Rect clip, r_rect, w_rect;
+	/* 整组位图只需计算一次图像的有效区域 */
+	Graph_GetValidRect( graph, &clip );
+	graph = Graph_GetQuote( graph );
+	right = clip.x + clip.width;
+	bottom = clip.y + clip.height;
+	for( i = 0; i < n; ++i ) {
+		const LCUI_FontBitmap *bmp = bmps[i];
+		if( !bmp->buffer ) {
+			continue;
+		}
+		w_rect.x = clip.x + pos[i].x;
+		w_rect.y = clip.y + pos[i].y;
+		w_rect.width = bmp->width;
+		w_rect.height = bmp->rows;
+		r_rect.x = r_rect.y = 0;
+		if( w_rect.x < clip.x ) {
+			r_rect.x = clip.x - w_rect.x;
+		}
+		if( w_rect.y < clip.y ) {
+			r_rect.y = clip.y - w_rect.y;
+		}
+		r_rect.width = w_rect.width - r_rect.x;
+		r_rect.height = w_rect.height - r_rect.y;
+		if( w_rect.x + w_rect.width > right ) {
+			r_rect.width -= w_rect.x + w_rect.width - right;
+		}
+		if( w_rect.y + w_rect.height > bottom ) {
+			r_rect.height -= w_rect.y + w_rect.height - bottom;
+		}
+		if( r_rect.width <= 0 || r_rect.height <= 0 ) {
+			continue;
+		}
+		w_rect.x += r_rect.x;
+		w_rect.y += r_rect.y;
+		w_rect.width = r_rect.width;
+		w_rect.height = r_rect.height;
+		if( graph->color_type == COLOR_TYPE_ARGB ) {
+			FontBitmap_MixARGB( graph, &w_rect, bmp, color, &r_rect );
+		} else {
+			FontBitmap_MixRGB( graph, &w_rect, bmp, color, &r_rect );
+		}
+	}
+	return 0;
+}
+
 /** 载入字体位图 */
 int FontBitmap_Load( LCUI_FontBitmap *buff, wchar_t ch,
 		     int font_id, int pixel_size )
@@ -571,11 +1034,10 @@ void LCUI_InitFont( void )
 	fontlib.font_cache_num = 1;
 	fontlib.font_cache = NEW( LCUI_Font**, 1 );
 	fontlib.font_cache[0] = NEW( LCUI_Font*, FONT_CACHE_SIZE );
-	RBTree_Init( &fontlib.bitmap_cache );
 	RBTree_Init( &fontlib.family_tree );
 	RBTree_OnCompare( &fontlib.family_tree, OnCompareFamily );
 	RBTree_OnDestroy( &fontlib.family_tree, DestroyFontFamilyNode );
-	RBTree_OnDestroy( &fontlib.bitmap_cache, DestroyTreeNode );
+	GlyphCache_Init();
 	fontlib.is_inited = TRUE;
 
 	/* 先初始化内置的字体引擎 */
@@ -618,7 +1080,7 @@ void LCUI_ExitFont( void )
 		return;
 	}
 	fontlib.is_inited = FALSE;
-	RBTree_Destroy( &fontlib.bitmap_cache );
+	GlyphCache_Destroy();
 	while( fontlib.font_cache_num > 0 ) {
 		--fontlib.font_cache_num;
 		for( i=0; i<FONT_CACHE_SIZE; ++i ) {
@@ -38,6 +38,7 @@
  * ****************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
@@ -53,6 +54,8 @@ enum TextAddType {
 #define max(a, b) ((a) > (b) ? (a):(b))
 #define TextRowList_AddNewRow(ROWLIST) TextRowList_InsertNewRow(ROWLIST, (ROWLIST)->length)
 #define TextLayer_GetRow(layer, n) (n >= layer->rowlist.length) ? NULL:layer->rowlist.rows[n]
+#define TextRowList_HasOffsets(ROWLIST) ((ROWLIST)->n_offsets > (ROWLIST)->length)
+#define GLYPH_RUN_SIZE 64
 
 /* 根据对齐方式，计算文本行的起始X轴位置 */
 static int TextLayer_GetRowStartX( LCUI_TextLayer layer, TextRow txtrow )
@@ -96,13 +99,120 @@ int TextLayer_GetRowTextLength( LCUI_TextLayer layer, int row )
         return layer->rowlist.rows[row]->length;
 }
 
-/** 添加 更新文本排版 的任务 */
-void TextLayer_AddUpdateTypeset( LCUI_TextLayer layer, int start_row )
+/**
+ * 添加 更新文本排版 的任务
+ * start_row 至 end_row 之间的文本行是被修改过的，排版时至少要处理到 end_row，
+ * 之后只要某一行的断行位置没有变化，就可以停止排版。end_row 为 -1 时，表示
+ * 需要对后面所有的文本行进行排版。
+ */
+static void TextLayer_AddUpdateTypesetRange( LCUI_TextLayer layer,
+					     int start_row, int end_row )
 {
+	if( !layer->task.update_typeset ) {
+		layer->task.typeset_start_row = start_row;
+		layer->task.typeset_end_row = end_row;
+		layer->task.update_typeset = TRUE;
+		return;
+	}
+	/* 之前的修改可能已经让行号发生了偏移，合并不同的范围时只能全部处理 */
+	if( start_row != layer->task.typeset_start_row ||
+	    end_row != layer->task.typeset_end_row ) {
+		layer->task.typeset_end_row = -1;
+	}
 	if( start_row < layer->task.typeset_start_row ) {
 		layer->task.typeset_start_row = start_row;
 	}
-	layer->task.update_typeset = TRUE;
+}
+
+void TextLayer_AddUpdateTypeset( LCUI_TextLayer layer, int start_row )
+{
+	TextLayer_AddUpdateTypesetRange( layer, start_row, -1 );
+}
+
+/** 标记文本行偏移量索引中从指定行开始的记录为无效 */
+static void TextRowList_InvalidateOffsets( TextRowList rowlist, int i_row )
+{
+	if( rowlist->n_offsets > i_row + 1 ) {
+		rowlist->n_offsets = i_row + 1;
+	}
+}
+
+/** 更新文本行偏移量索引，只重新计算无效的记录 */
+static int TextRowList_UpdateOffsets( TextRowList rowlist )
+{
+	int i, *offsets;
+	if( TextRowList_HasOffsets( rowlist ) ) {
+		return 0;
+	}
+	if( rowlist->max_offsets < rowlist->length + 1 ) {
+		i = max( rowlist->length + 1, rowlist->max_offsets * 2 );
+		offsets = realloc( rowlist->offsets, sizeof( int ) * i );
+		if( !offsets ) {
+			return -1;
+		}
+		rowlist->offsets = offsets;
+		rowlist->max_offsets = i;
+	}
+	if( rowlist->n_offsets < 1 ) {
+		rowlist->offsets[0] = 0;
+		rowlist->n_offsets = 1;
+	}
+	for( i = rowlist->n_offsets; i <= rowlist->length; ++i ) {
+		rowlist->offsets[i] = rowlist->offsets[i - 1];
+		rowlist->offsets[i] += rowlist->rows[i - 1]->height;
+	}
+	rowlist->n_offsets = rowlist->length + 1;
+	return 0;
+}
+
+/**
+ * 查找包含指定 Y 轴坐标的文本行
+ * 偏移量索引有效时使用二分查找，否则逐行累加行高。此函数不会修改索引，所以
+ * 可以在多个渲染线程中同时调用。
+ * @param[in] y 相对于第一行文本的 Y 轴坐标
+ * @param[out] row_y 找到的文本行的 Y 轴坐标
+ * @returns 文本行的序号，若坐标在最后一行之后，则返回总行数
+ */
+static int TextLayer_FindRow( LCUI_TextLayer layer, int y, int *row_y )
+{
+	int low, high, mid;
+	TextRowList rowlist = &layer->rowlist;
+	if( !TextRowList_HasOffsets( rowlist ) ) {
+		*row_y = 0;
+		for( low = 0; low < rowlist->length; ++low ) {
+			if( *row_y + rowlist->rows[low]->height > y ) {
+				break;
+			}
+			*row_y += rowlist->rows[low]->height;
+		}
+		return low;
+	}
+	/* 找到第一个底边超过 y 的文本行 */
+	low = 0;
+	high = rowlist->length;
+	while( low < high ) {
+		mid = (low + high) / 2;
+		if( rowlist->offsets[mid + 1] > y ) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+	*row_y = rowlist->offsets[low];
+	return low;
+}
+
+/** 获取文本行的 Y 轴坐标（相对于第一行文本） */
+static int TextLayer_GetRowY( LCUI_TextLayer layer, int i_row )
+{
+	int i, y;
+	if( TextRowList_UpdateOffsets( &layer->rowlist ) == 0 ) {
+		return layer->rowlist.offsets[i_row];
+	}
+	for( i = 0, y = 0; i < i_row; ++i ) {
+		y += layer->rowlist.rows[i]->height;
+	}
+	return y;
 }
 
 static void TextRow_Init( TextRow txtrow )
@@ -110,22 +220,27 @@ static void TextRow_Init( TextRow txtrow )
 	txtrow->width = 0;
 	txtrow->height = 0;
 	txtrow->length = 0;
+	txtrow->capacity = 0;
 	txtrow->string = NULL;
 	txtrow->eol = EOL_NONE;
 	txtrow->text_height = 0;
 }
 
-static void TextRow_Destroy( TextRow txtrow )
+/** 释放文本行中一段字符所引用的字体位图 */
+static void TextRow_ReleaseBitmaps( TextRow txtrow, int start, int end )
 {
-	int i;
-	for( i=0; i<txtrow->length; ++i ) {
-		if( txtrow->string[i] ) {
-			free( txtrow->string[i] );
-		}
+	for( ; start < end; ++start ) {
+		LCUIFont_ReleaseBitmap( txtrow->string[start].bitmap );
 	}
+}
+
+static void TextRow_Destroy( TextRow txtrow )
+{
+	TextRow_ReleaseBitmaps( txtrow, 0, txtrow->length );
 	txtrow->width = 0;
 	txtrow->height = 0;
 	txtrow->length = 0;
+	txtrow->capacity = 0;
 	txtrow->text_height = 0;
 	if( txtrow->string ) {
 		free( txtrow->string );
@@ -136,30 +251,33 @@ static void TextRow_Destroy( TextRow txtrow )
 /** 向文本行列表中插入新的文本行 */
 static TextRow TextRowList_InsertNewRow( TextRowList rowlist, int i_row )
 {
-	int i, size;
+	int size;
 	TextRow txtrow, *txtrows;
 	if( i_row > rowlist->length ) {
 		i_row = rowlist->length;
 	}
-	++rowlist->length;
-	size = sizeof( TextRow )*(rowlist->length + 1);
-	txtrows = realloc( rowlist->rows, size );
-	if( !txtrows ) {
-		--rowlist->length;
-		return NULL;
+	/* 容量不足时按两倍扩充，让连续追加文本行的开销保持在常数级别 */
+	if( rowlist->length + 1 >= rowlist->max_length ) {
+		size = max( 16, rowlist->max_length * 2 );
+		txtrows = realloc( rowlist->rows, sizeof( TextRow ) * size );
+		if( !txtrows ) {
+			return NULL;
+		}
+		rowlist->rows = txtrows;
+		rowlist->max_length = size;
 	}
-	txtrows[rowlist->length] = NULL;
 	txtrow = malloc( sizeof( TextRowRec ) );
 	if( !txtrow ) {
-		--rowlist->length;
 		return NULL;
 	}
 	TextRow_Init( txtrow );
-	for( i = rowlist->length - 1; i > i_row; --i ) {
-		txtrows[i] = txtrows[i - 1];
-	}
+	TextRowList_InvalidateOffsets( rowlist, i_row );
+	txtrows = rowlist->rows;
+	memmove( txtrows + i_row + 1, txtrows + i_row,
+		 sizeof( TextRow ) * (rowlist->length - i_row) );
 	txtrows[i_row] = txtrow;
-	rowlist->rows = txtrows;
+	++rowlist->length;
+	txtrows[rowlist->length] = NULL;
 	return txtrow;
 }
 
@@ -169,25 +287,26 @@ static int TextRowList_RemoveRow( TextRowList rowlist, int i_row )
 	if( i_row < 0 || i_row >= rowlist->length ) {
 		return -1;
 	}
+	TextRowList_InvalidateOffsets( rowlist, i_row );
 	TextRow_Destroy( rowlist->rows[i_row] );
 	free( rowlist->rows[i_row] );
-	for( ; i_row < rowlist->length - 1; ++i_row ) {
-		rowlist->rows[i_row] = rowlist->rows[i_row + 1];
-	}
-	rowlist->rows[i_row] = NULL;
+	memmove( rowlist->rows + i_row, rowlist->rows + i_row + 1,
+		 sizeof( TextRow ) * (rowlist->length - i_row - 1) );
 	--rowlist->length;
+	rowlist->rows[rowlist->length] = NULL;
 	return 0;
 }
 
 /** 更新文本行的尺寸 */
-static void TextLayer_UpdateRowSize( LCUI_TextLayer layer, TextRow txtrow )
+static void TextLayer_UpdateRowSize( LCUI_TextLayer layer, int i_row )
 {
-	int i;
 	TextChar txtchar;
+	TextRow txtrow = layer->rowlist.rows[i_row];
+	int i, height = txtrow->height;
 	txtrow->width = 0;
 	txtrow->text_height = layer->text_style.pixel_size;
 	for( i = 0; i < txtrow->length; ++i ) {
-		txtchar = txtrow->string[i];
+		txtchar = &txtrow->string[i];
 		if( !txtchar->bitmap ) {
 			continue;
 		}
@@ -207,29 +326,55 @@ static void TextLayer_UpdateRowSize( LCUI_TextLayer layer, TextRow txtrow )
 		txtrow->height = txtrow->text_height * 11 / 10;
 		break;
 	}
+	/* 行高变化时，后面各行的偏移量都需要重新计算 */
+	if( txtrow->height != height ) {
+		TextRowList_InvalidateOffsets( &layer->rowlist, i_row );
+	}
+}
+
+/**
+ * 调整文本行的容量
+ * 容量不足时按两倍扩充，在行尾逐字插入时的开销是均摊常数级别的；当文本行
+ * 被截短到容量的四分之一以下时，释放多余的空间。
+ */
+static int TextRow_Reserve( TextRow txtrow, int len )
+{
+	int size;
+	TextCharRec *txtstr;
+	if( len <= txtrow->capacity ) {
+		if( txtrow->capacity <= 64 || len > txtrow->capacity / 4 ) {
+			return 0;
+		}
+		size = max( len * 2, 64 );
+	} else {
+		size = max( len, max( 16, txtrow->capacity * 2 ) );
+	}
+	txtstr = realloc( txtrow->string, sizeof( TextCharRec ) * size );
+	if( !txtstr ) {
+		return len <= txtrow->capacity ? 0 : -1;
+	}
+	txtrow->string = txtstr;
+	txtrow->capacity = size;
+	return 0;
 }
 
 /** 设置文本行的字符串长度 */
 static int TextRow_SetLength( TextRow txtrow, int len )
 {
-	TextChar *txtstr;
 	if( len < 0 ) {
 		len = 0;
 	}
-	txtstr = realloc( txtrow->string, sizeof(TextChar)*(len + 1) );
-	if( !txtstr ) {
+	if( TextRow_Reserve( txtrow, len ) != 0 ) {
 		return -1;
 	}
-	txtstr[len] = NULL;
-	txtrow->string = txtstr;
 	txtrow->length = len;
 	return 0;
 }
 
-/** 将字符数据直接插入至文本行 */
-static int TextRow_Insert( TextRow txtrow, int ins_pos, TextChar txtchar )
+/** 将字符数据插入至文本行 */
+static int TextRow_Insert( TextRow txtrow, int ins_pos,
+			   const TextCharRec *txtchar )
 {
-	int i;
 	if( ins_pos < 0 ) {
 		ins_pos = txtrow->length + 1 + ins_pos;
 		if( ins_pos < 0 ) {
@@ -238,27 +383,35 @@ static int TextRow_Insert( TextRow txtrow, int ins_pos, TextChar txtchar )
 	} else if( ins_pos > txtrow->length ) {
 		ins_pos = txtrow->length;
 	}
-	TextRow_SetLength( txtrow, txtrow->length + 1 );
-	for( i = txtrow->length - 1; i > ins_pos; --i ) {
-		txtrow->string[i] = txtrow->string[i - 1];
+	if( TextRow_Reserve( txtrow, txtrow->length + 1 ) != 0 ) {
+		return -1;
 	}
-	txtrow->string[ins_pos] = txtchar;
+	memmove( txtrow->string + ins_pos + 1, txtrow->string + ins_pos,
+		 sizeof( TextCharRec ) * (txtrow->length - ins_pos) );
+	txtrow->string[ins_pos] = *txtchar;
+	++txtrow->length;
 	return 0;
 }
 
-/** 向文本行插入一个字符数据副本 */
-static int TextRow_InsertCopy( TextRow txtrow, int ins_pos, TextChar txtchar )
+/** 将多个字符数据追加至文本行末尾 */
+static int TextRow_Append( TextRow txtrow, const TextCharRec *txtchars,
+			   int n )
 {
-	TextChar txtchar2;
-	txtchar2 = malloc( sizeof(TextCharRec) );
-	*txtchar2 = *txtchar;
-	return TextRow_Insert( txtrow, ins_pos, txtchar2 );
+	if( n <= 0 ) {
+		return 0;
+	}
+	if( TextRow_Reserve( txtrow, txtrow->length + n ) != 0 ) {
+		return -1;
+	}
+	memcpy( txtrow->string + txtrow->length, txtchars,
+		sizeof( TextCharRec ) * n );
+	txtrow->length += n;
+	return 0;
 }
 
 /** 将文本行中的内容向左移动 */
 static void TextRow_LeftMove( TextRow txtrow, int n )
 {
-	int i, j;
 	if( n <= 0 ) {
 		return;
 	}
@@ -266,9 +419,8 @@ static void TextRow_LeftMove( TextRow txtrow, int n )
 		n = txtrow->length;
 	}
 	txtrow->length -= n;
-	for( i=0,j=n; i<txtrow->length; ++i,++j ) {
-		txtrow->string[i] = txtrow->string[j];
-	}
+	memmove( txtrow->string, txtrow->string + n,
+		 sizeof( TextCharRec ) * txtrow->length );
 }
 
 /** 更新字体位图 */
@@ -277,6 +429,8 @@ static void TextChar_UpdateBitmap( TextChar ch, LCUI_TextStyle *style )
 	int i = 0;
 	int size = style->pixel_size;
 	int *font_ids = style->font_ids;
+	LCUIFont_ReleaseBitmap( ch->bitmap );
+	ch->bitmap = NULL;
 	if( ch->style ) {
 		if( ch->style->has_family ) {
 			font_ids = ch->style->font_ids;
@@ -291,6 +445,7 @@ static void TextChar_UpdateBitmap( TextChar ch, LCUI_TextStyle *style )
 		if( ret == 0 ) {
 			return;
 		}
+		LCUIFont_ReleaseBitmap( ch->bitmap );
 		++i;
 	}
 	LCUIFont_GetBitmap( ch->char_code, -1, size, &ch->bitmap );
@@ -314,7 +469,11 @@ LCUI_TextLayer TextLayer_New(void)
 	layer->new_offset_x = 0;
 	layer->new_offset_y = 0;
 	layer->rowlist.length = 0;
+	layer->rowlist.max_length = 0;
 	layer->rowlist.rows = NULL;
+	layer->rowlist.offsets = NULL;
+	layer->rowlist.n_offsets = 0;
+	layer->rowlist.max_offsets = 0;
 	layer->text_align = SV_LEFT;
 	layer->is_using_buffer = FALSE;
 	layer->is_autowrap_mode = FALSE;
@@ -325,6 +484,7 @@ LCUI_TextLayer TextLayer_New(void)
 	TextStyle_Init( &layer->text_style );
 	LinkedList_Init( &layer->style_cache );
 	layer->task.typeset_start_row = 0;
+	layer->task.typeset_end_row = -1;
 	layer->task.update_typeset = 0;
 	layer->task.update_bitmap = 0;
 	layer->task.redraw_all = 0;
@@ -340,13 +500,21 @@ static void TextRowList_Destroy( TextRowList list )
 	int row;
 	for( row=0; row<list->length; ++row ) {
 		TextRow_Destroy( list->rows[row] );
+		free( list->rows[row] );
 		list->rows[row] = NULL;
 	}
 	list->length = 0;
+	list->max_length = 0;
 	if( list->rows ) {
 		free( list->rows );
 	}
+	if( list->offsets ) {
+		free( list->offsets );
+	}
 	list->rows = NULL;
+	list->offsets = NULL;
+	list->n_offsets = 0;
+	list->max_offsets = 0;
 }
 
 /** 销毁TextLayer */
@@ -368,11 +536,8 @@ static int TextLayer_GetRowRect( LCUI_TextLayer layer, int i_row,
 		return -1;
 	}
 	/* 先计算在有效区域内的起始行的Y轴坐标 */
-	rect->y = layer->offset_y;
+	rect->y = layer->offset_y + TextLayer_GetRowY( layer, i_row );
 	rect->x = layer->offset_x;
-	for( i = 0; i < i_row; ++i ) {
-		rect->y += layer->rowlist.rows[i]->height;
-	}
 	txtrow = layer->rowlist.rows[i_row];
 	if( end_col < 0 || end_col >= txtrow->length ) {
 		end_col = txtrow->length - 1;
@@ -383,17 +548,17 @@ static int TextLayer_GetRowRect( LCUI_TextLayer layer, int i_row,
 		rect->width = txtrow->width;
 	} else {
 		for( i = 0; i < start_col; ++i ) {
-			if( !txtrow->string[i]->bitmap ) {
+			if( !txtrow->string[i].bitmap ) {
 				continue;
 			}
-			rect->x += txtrow->string[i]->bitmap->advance.x;
+			rect->x += txtrow->string[i].bitmap->advance.x;
 		}
 		rect->width = 0;
 		for( i = start_col; i <= end_col && i < txtrow->length; ++i ) {
-			if( !txtrow->string[i]->bitmap ) {
+			if( !txtrow->string[i].bitmap ) {
 				continue;
 			}
-			rect->width += txtrow->string[i]->bitmap->advance.x;
+			rect->width += txtrow->string[i].bitmap->advance.x;
 		}
 	}
 	if( rect->width <= 0 || rect->height <= 0 ) {
@@ -423,14 +588,14 @@ void TextLayer_InvalidateRowsRect( LCUI_TextLayer layer,
 		end_row = layer->rowlist.length - 1;
 	}
 
-	y = layer->offset_y;
-	for( i = 0; i < layer->rowlist.length; ++i ) {
-		y += layer->rowlist.rows[i]->height;
-		if( i >= start_row && y >= 0 ) {
-			y -= layer->rowlist.rows[i]->height;
-			break;
-		}
+	/* 跳过在可见区域上方的文本行 */
+	TextRowList_UpdateOffsets( &layer->rowlist );
+	i = TextLayer_FindRow( layer, -layer->offset_y - 1, &y );
+	if( i < start_row ) {
+		i = start_row;
+		y = TextLayer_GetRowY( layer, i );
 	}
+	y += layer->offset_y;
 	for( ; i <= end_row; ++i ) {
 		TextLayer_GetRowRect( layer, i, 0, -1, &rect );
 		RectList_Add( &layer->dirty_rect, &rect );
@@ -495,7 +660,7 @@ int TextLayer_SetCaretPosByPixelPos( LCUI_TextLayer layer, int x, int y )
 	pixel_pos = TextLayer_GetRowStartX( layer, txtrow );
 	for( i = 0; i < txtrow->length; ++i ) {
 		TextChar txtchar;
-		txtchar = txtrow->string[i];
+		txtchar = &txtrow->string[i];
 		if( !txtchar->bitmap ) {
 			continue;
 		}
@@ -531,13 +696,10 @@ int TextLayer_GetCharPixelPos( LCUI_TextLayer layer, int row,
 	txtrow = layer->rowlist.rows[row];
 	pixel_x = TextLayer_GetRowStartX( layer, txtrow );
 	for( i = 0; i < col; ++i ) {
-		if( !txtrow->string[i] ) {
-			break;
-		}
-		if( !txtrow->string[i]->bitmap ) {
+		if( !txtrow->string[i].bitmap ) {
 			continue;
 		}
-		pixel_x += txtrow->string[i]->bitmap->advance.x;
+		pixel_x += txtrow->string[i].bitmap->advance.x;
 	}
 	pixel_pos->x = pixel_x;
 	pixel_pos->y = pixel_y;
@@ -569,28 +731,27 @@ void TextLayer_ClearText( LCUI_TextLayer layer )
 static void TextLayer_BreakTextRow( LCUI_TextLayer layer, int i_row,
 				    int col, EOLChar eol )
 {
-	int n;
 	TextRow txtrow, next_txtrow;
 	txtrow = layer->rowlist.rows[i_row];
 	next_txtrow = TextRowList_InsertNewRow( &layer->rowlist, i_row + 1 );
 	/* 将本行原有的行尾符转移至下一行 */
 	next_txtrow->eol = txtrow->eol;
 	txtrow->eol = eol;
-	for( n = txtrow->length - 1; n >= col; --n ) {
-		TextRow_Insert( next_txtrow, 0, txtrow->string[n] );
-		txtrow->string[n] = NULL;
-	}
-	txtrow->length = col;
-	TextLayer_UpdateRowSize( layer, txtrow );
-	TextLayer_UpdateRowSize( layer, next_txtrow );
+	TextRow_Append( next_txtrow, txtrow->string + col, txtrow->length - col );
+	TextRow_SetLength( txtrow, col );
+	TextLayer_UpdateRowSize( layer, i_row );
+	TextLayer_UpdateRowSize( layer, i_row + 1 );
 }
 
-/** 对指定行的文本进行排版 */
-static void TextLayer_TextRowTypeset( LCUI_TextLayer layer, int row )
+/**
+ * 对指定行的文本进行排版
+ * @returns 如果下一行文本也被修改了（插入新行、转移文字或删除），则返回 TRUE
+ */
+static LCUI_BOOL TextLayer_TextRowTypeset( LCUI_TextLayer layer, int row )
 {
 	TextRow txtrow;
 	TextChar txtchar;
-	LCUI_BOOL not_autowrap;
+	LCUI_BOOL not_autowrap, changed = FALSE;
 	int col, row_width = 0;
 	int max_width;
 	if( layer->fixed_width > 0 ) {
@@ -606,7 +767,7 @@ static void TextLayer_TextRowTypeset( LCUI_TextLayer layer, int row )
 	}
 	txtrow = layer->rowlist.rows[row];
 	for( col = 0; col < txtrow->length; ++col ) {
-		txtchar = txtrow->string[col];
+		txtchar = &txtrow->string[col];
 		if( !txtchar->bitmap ) {
 			continue;
 		}
@@ -617,12 +778,12 @@ static void TextLayer_TextRowTypeset( LCUI_TextLayer layer, int row )
 			continue;
 		}
 		TextLayer_BreakTextRow( layer, row, col, EOL_NONE );
-		return;
+		return TRUE;
 	}
-	TextLayer_UpdateRowSize( layer, txtrow );
+	TextLayer_UpdateRowSize( layer, row );
 	/* 如果本行有换行符，或者是最后一行 */
 	if( txtrow->eol != EOL_NONE || row == layer->rowlist.length - 1 ) {
-		return;
+		return FALSE;
 	}
 	row_width = txtrow->width;
 	/* 本行的文本宽度未达到限制宽度，需要将下行的文本转移至本行 */
@@ -632,61 +793,106 @@ static void TextLayer_TextRowTypeset( LCUI_TextLayer layer, int row )
 		if( !next_txtrow ) {
 			break;
 		}
+		/* 计算能转移至本行的文字数量 */
 		for( col = 0; col < next_txtrow->length; ++col ) {
-			txtchar = next_txtrow->string[col];
-			/* 忽略无字体位图的文字 */
+			txtchar = &next_txtrow->string[col];
+			/* 无字体位图的文字不占宽度，可以直接转移 */
 			if( !txtchar->bitmap ) {
-				TextRow_Insert( txtrow, -1, txtchar );
-				next_txtrow->string[col] = NULL;
 				continue;
 			}
 			row_width += txtchar->bitmap->advance.x;
-			/* 如果没有超过宽度限制 */
-			if( not_autowrap || row_width <= max_width ) {
-				TextRow_Insert( txtrow, -1, txtchar );
-				next_txtrow->string[col] = NULL;
-				continue;
+			/* 如果超过宽度限制 */
+			if( !not_autowrap && row_width > max_width ) {
+				break;
 			}
-			/* 如果插入点在下一行 */
-			if( layer->insert_y == row + 1 ) {
-				/* 如果插入点处于被转移的几个文字中 */
-				if( layer->insert_x < col ) {
-					layer->insert_y = row;
-					layer->insert_x += txtrow->length;
-				} else {
-					/* 否则，减去被转移的文字数 */
-					layer->insert_x -= col;
-				}
+		}
+		TextRow_Append( txtrow, next_txtrow->string, col );
+		/* 如果插入点在下一行 */
+		if( layer->insert_y == row + 1 ) {
+			/* 如果插入点处于被转移的几个文字中 */
+			if( layer->insert_x < col ||
+			    col == next_txtrow->length ) {
+				layer->insert_y = row;
+				layer->insert_x += txtrow->length - col;
+			} else {
+				/* 否则，减去被转移的文字数 */
+				layer->insert_x -= col;
 			}
+		} else if( layer->insert_y > row + 1 &&
+			   col == next_txtrow->length ) {
+			--layer->insert_y;
+		}
+		if( col < next_txtrow->length ) {
 			/* 将这一行剩余的文字向前移 */
 			TextRow_LeftMove( next_txtrow, col );
-			TextLayer_UpdateRowSize( layer, txtrow );
-			return;
+			TextLayer_UpdateRowSize( layer, row );
+			if( col < 1 ) {
+				return changed;
+			}
+			TextLayer_UpdateRowSize( layer, row + 1 );
+			return TRUE;
 		}
 		txtrow->eol = next_txtrow->eol;
-		TextLayer_UpdateRowSize( layer, txtrow );
+		TextLayer_UpdateRowSize( layer, row );
 		TextLayer_InvalidateRowRect( layer, row, 0, -1 );
 		TextLayer_InvalidateRowRect( layer, row + 1, 0, -1 );
 		/* 删除这一行，因为这一行的内容已经转移至当前行 */
 		TextRowList_RemoveRow( &layer->rowlist, row + 1 );
-		/* 如果插入点当前行在后面 */
-		if( layer->insert_y > row ) {
-			--layer->insert_y;
-		}
+		changed = TRUE;
 	}
+	return changed;
 }
 
-/** 从指定行开始，对文本进行排版 */
-static void TextLayer_TextTypeset( LCUI_TextLayer layer, int start_row )
+/**
+ * 从指定行开始，对文本进行排版
+ * 处理完 end_row 行后，如果某一行的排版没有影响到下一行，那么后面的文本行的
+ * 断行位置都与之前相同，不需要再继续排版。end_row 为 -1 时处理所有文本行。
+ */
+static void TextLayer_TextTypeset( LCUI_TextLayer layer,
+				   int start_row, int end_row )
 {
-	int row;
-	/* 记录排版前各个文本行的矩形区域 */
-	TextLayer_InvalidateRowsRect( layer, start_row, -1 );
+	LCUI_Rect rect;
+	LCUI_BOOL changed = TRUE;
+	int row, n_rows, height, bottom, width;
+
+	if( start_row >= layer->rowlist.length ) {
+		return;
+	}
+	height = TextLayer_GetHeight( layer );
+	width = max( layer->width, layer->fixed_width );
 	for( row = start_row; row < layer->rowlist.length; ++row ) {
-		TextLayer_TextRowTypeset( layer, row );
+		if( end_row >= 0 && row > end_row && !changed ) {
+			break;
+		}
+		n_rows = layer->rowlist.length;
+		changed = TextLayer_TextRowTypeset( layer, row );
+		if( end_row >= row ) {
+			end_row += layer->rowlist.length - n_rows;
+		}
+		width = max( width, layer->rowlist.rows[row]->width );
+	}
+	/* 只需重绘被排版过的文本行，如果总高度有变化，则后面的行也需要重绘 */
+	rect.y = TextLayer_GetRowY( layer, start_row );
+	bottom = TextLayer_GetHeight( layer );
+	if( bottom == height ) {
+		bottom = TextLayer_GetRowY( layer, row );
+	} else {
+		bottom = max( bottom, height );
+	}
+	rect.x = layer->offset_x;
+	rect.y += layer->offset_y;
+	rect.width = width;
+	rect.height = bottom + layer->offset_y - rect.y;
+	if( rect.y < 0 ) {
+		rect.height += rect.y;
+		rect.y = 0;
+	}
+	if( layer->max_height > 0 && rect.y + rect.height > layer->max_height ) {
+		rect.height = layer->max_height - rect.y;
+	}
+	if( rect.width > 0 && rect.height > 0 ) {
+		RectList_Add( &layer->dirty_rect, &rect );
 	}
-	/* 记录排版后各个文本行的矩形区域 */
-	TextLayer_InvalidateRowsRect( layer, start_row, -1 );
 }
 
 /** 对文本进行预处理 */
@@ -787,13 +993,15 @@ static int TextLayer_ProcessText( LCUI_TextLayer layer, const wchar_t *wstr,
 		}
 		txtchar.style = style;
 		txtchar.char_code = *p;
+		/* 上一个字符的位图引用已经转交给了文本行 */
+		txtchar.bitmap = NULL;
 		TextChar_UpdateBitmap( &txtchar, &layer->text_style );
-		TextRow_InsertCopy( txtrow, ins_x, &txtchar );
+		TextRow_Insert( txtrow, ins_x, &txtchar );
 		++layer->length;
 		++ins_x;
 	}
 	/* 更新当前行的尺寸 */
-	TextLayer_UpdateRowSize( layer, txtrow );
+	TextLayer_UpdateRowSize( layer, ins_y );
 	layer->width = max( layer->width, txtrow->width );
 	if( add_type == TAT_INSERT ) {
 		layer->insert_x = ins_x;
@@ -801,7 +1009,7 @@ static int TextLayer_ProcessText( LCUI_TextLayer layer, const wchar_t *wstr,
 	}
 	/* 若启用了自动换行模式，则标记需要重新对文本进行排版 */
 	if( layer->is_autowrap_mode || need_typeset ) {
-		TextLayer_AddUpdateTypeset( layer, cur_row );
+		TextLayer_AddUpdateTypesetRange( layer, cur_row, ins_y );
 	} else {
 		TextLayer_InvalidateRowRect( layer, cur_row, 0, -1 );
 	}
@@ -901,7 +1109,7 @@ int TextLayer_GetTextW( LCUI_TextLayer layer, int start_pos,
 	for( i = 0; row < layer->rowlist.length && i < max_len; ++row ) {
 		row_ptr = layer->rowlist.rows[row];
 		for( ; col < row_ptr->length && i < max_len; ++col, ++i ) {
-			wstr_buff[i] = row_ptr->string[col]->char_code;
+			wstr_buff[i] = row_ptr->string[col].char_code;
 		}
 	}
 	wstr_buff[i] = L'\0';
@@ -918,20 +1126,11 @@ LCUI_Graph* TextLayer_GetGraphBuffer( LCUI_TextLayer layer )
 
 int TextLayer_GetWidth( LCUI_TextLayer layer )
 {
-	int i, row, w, max_w;
-	TextRow txtrow;
-
+	int row, max_w;
+	/* 文本行的宽度在每次修改后都会由 TextLayer_UpdateRowSize() 更新 */
 	for( row = 0, max_w = 0; row < layer->rowlist.length; ++row ) {
-		txtrow = layer->rowlist.rows[row];
-		for( i = 0, w = 0; i < txtrow->length; ++i ) {
-			if( !txtrow->string[i]->bitmap ||
-			    !txtrow->string[i]->bitmap->buffer ) {
-				continue;
-			}
-			w += txtrow->string[i]->bitmap->advance.x;
-		}
-		if( w > max_w ) {
-			max_w = w;
+		if( layer->rowlist.rows[row]->width > max_w ) {
+			max_w = layer->rowlist.rows[row]->width;
 		}
 	}
 	return max_w;
@@ -940,6 +1139,9 @@ int TextLayer_GetWidth( LCUI_TextLayer layer )
 int TextLayer_GetHeight( LCUI_TextLayer layer )
 {
 	int i, h;
+	if( TextRowList_HasOffsets( &layer->rowlist ) ) {
+		return layer->rowlist.offsets[layer->rowlist.length];
+	}
 	for( i = 0, h = 0; i < layer->rowlist.length; ++i ) {
 		h += layer->rowlist.rows[i]->height;
 	}
@@ -948,30 +1150,40 @@ int TextLayer_GetHeight( LCUI_TextLayer layer )
 
 int TextLayer_SetFixedSize( LCUI_TextLayer layer, int width, int height )
 {
+	LCUI_BOOL width_changed = layer->fixed_width != width;
+	/* 尺寸没有变化时，不需要重新排版 */
+	if( !width_changed && layer->fixed_height == height ) {
+		return 0;
+	}
 	layer->fixed_width = width;
 	layer->fixed_height = height;
 	if( layer->is_using_buffer ) {
 		Graph_Create( &layer->graph, width, height );
 	}
 	layer->task.redraw_all = TRUE;
-	if( layer->is_autowrap_mode ) {
-		layer->task.typeset_start_row = 0;
-		layer->task.update_typeset = TRUE;
+	/* 断行位置只取决于宽度 */
+	if( layer->is_autowrap_mode && width_changed ) {
+		TextLayer_AddUpdateTypeset( layer, 0 );
 	}
 	return 0;
 }
 
 int TextLayer_SetMaxSize( LCUI_TextLayer layer, int width, int height )
 {
+	LCUI_BOOL width_changed = layer->max_width != width;
+	/* 尺寸没有变化时，不需要重新排版 */
+	if( !width_changed && layer->max_height == height ) {
+		return 0;
+	}
 	layer->max_width = width;
 	layer->max_height = height;
 	if( layer->is_using_buffer ) {
 		Graph_Create( &layer->graph, width, height );
 	}
 	layer->task.redraw_all = TRUE;
-	if( layer->is_autowrap_mode ) {
-		layer->task.typeset_start_row = 0;
-		layer->task.update_typeset = TRUE;
+	/* 断行位置只取决于宽度 */
+	if( layer->is_autowrap_mode && width_changed ) {
+		TextLayer_AddUpdateTypeset( layer, 0 );
 	}
 	return 0;
 }
@@ -986,11 +1198,14 @@ void TextLayer_SetMultiline( LCUI_TextLayer layer, int is_true )
 	}
 }
 
-/** 删除指定行列的文字及其右边的文本 */
+/**
+ * 删除指定行列的文字及其右边的文本
+ * 行尾的换行符也算作一个字，自动换行产生的行之间没有换行符
+ */
 static int TextLayer_TextDeleteEx( LCUI_TextLayer layer, int char_y,
 				   int char_x, int n_char )
 {
-	int end_x, end_y, i, j, len;
+	int end_x, end_y, i;
 	TextRow txtrow, end_txtrow, prev_txtrow;
 
 	if( char_x < 0 ) {
@@ -1012,103 +1227,72 @@ static int TextLayer_TextDeleteEx( LCUI_TextLayer layer, int char_y,
 	i = n_char;
 	end_x = char_x;
 	end_y = char_y;
-	/* 计算结束点的位置 */
-	for( ; end_y < layer->rowlist.length && n_char > 0; ++end_y ) {
-		txtrow = layer->rowlist.rows[end_y];
-		if( end_x + n_char <= txtrow->length ) {
+	/* 计算结束点的位置，结束点上的字不会被删除 */
+	while( n_char > 0 ) {
+		end_txtrow = layer->rowlist.rows[end_y];
+		if( end_x + n_char <= end_txtrow->length ) {
 			end_x += n_char;
 			n_char = 0;
 			break;
 		}
-		n_char -= (txtrow->length - end_x);
-		if( txtrow->eol == EOL_NONE ) {
-			end_x = 0;
-		} else {
+		n_char -= end_txtrow->length - end_x;
+		end_x = end_txtrow->length;
+		if( end_y >= layer->rowlist.length - 1 ) {
+			break;
+		}
+		if( end_txtrow->eol != EOL_NONE ) {
 			n_char -= 1;
-			end_x = 0;
 		}
+		end_x = 0;
+		++end_y;
 	}
-	if( n_char >= 0 ) {
-		layer->length -= i - n_char;
-	} else {
-		layer->length -= n_char;
-	}
-	if( end_y >= layer->rowlist.length ) {
-		end_y = layer->rowlist.length - 1;
-		end_txtrow = layer->rowlist.rows[end_y];
-		end_x = end_txtrow->length;
-	} else {
-		end_txtrow = layer->rowlist.rows[end_y];
-	}
-	if( end_x > end_txtrow->length ) {
-		end_x = end_txtrow->length;
-	}
+	layer->length -= i - n_char;
 	if( end_x == char_x && end_y == char_y ) {
 		return 0;
 	}
-	/* 获取上一行文本 */
-	prev_txtrow = layer->rowlist.rows[char_y - 1];
-	// 计算起始行与结束行拼接后的长度
-	// 起始行：0 1 2 3 4 5，起点位置：2
-	// 结束行：0 1 2 3 4 5，终点位置：4
-	// 拼接后的长度：2 + 6 - 4 = 4
-	len = char_x + end_txtrow->length - end_x;
-	if( len < 0 ) {
-		return -3;
-	}
-	/* 如果是同一行 */
+	end_txtrow = layer->rowlist.rows[end_y];
+	TextLayer_InvalidateRowRect( layer, char_y, char_x, -1 );
 	if( txtrow == end_txtrow ) {
-		if( end_x > end_txtrow->length ) {
-			return -4;
-		}
-		TextLayer_InvalidateRowRect( layer, char_y, char_x, -1 );
-		TextLayer_AddUpdateTypeset( layer, char_y );
-		for( i = char_x, j = end_x; j < txtrow->length; ++i, ++j ) {
-			txtrow->string[i] = txtrow->string[j];
-		}
-		/* 如果当前行为空，也不是第一行，并且上一行没有结束符 */
-		if( len <= 0 && end_y > 0 && prev_txtrow->eol != EOL_NONE ) {
-			TextRowList_RemoveRow( &layer->rowlist, end_y );
+		TextRow_ReleaseBitmaps( txtrow, char_x, end_x );
+		memmove( txtrow->string + char_x, txtrow->string + end_x,
+			 sizeof( TextCharRec ) * (txtrow->length - end_x) );
+		TextRow_SetLength( txtrow, txtrow->length - end_x + char_x );
+	} else {
+		/* 后面的行都会移动，需要刷新它们的区域 */
+		TextLayer_InvalidateRowsRect( layer, char_y + 1, -1 );
+		TextRow_ReleaseBitmaps( txtrow, char_x, txtrow->length );
+		TextRow_ReleaseBitmaps( end_txtrow, 0, end_x );
+		/* 将结束行剩下的内容拼接至起始行，它们的字体位图引用也一起转移 */
+		TextRow_SetLength( txtrow, char_x );
+		TextRow_Append( txtrow, end_txtrow->string + end_x,
+				end_txtrow->length - end_x );
+		txtrow->eol = end_txtrow->eol;
+		end_txtrow->length = 0;
+		/* 移除起始行与结束行之间的文本行，以及结束行 */
+		for( i = char_y + 1; i <= end_y; ++i ) {
+			TextRowList_RemoveRow( &layer->rowlist, char_y + 1 );
 		}
-		/* 调整起始行的容量 */
-		TextRow_SetLength( txtrow, len );
-		/* 更新文本行的尺寸 */
-		TextLayer_UpdateRowSize( layer, txtrow );
+	}
+	TextLayer_UpdateRowSize( layer, char_y );
+	TextLayer_AddUpdateTypesetRange( layer, char_y, char_y );
+	if( txtrow->length > 0 || char_y < 1 ) {
 		return 0;
 	}
-	/* 如果结束点在行尾，并且该行不是最后一行 */
-	if( end_x == end_txtrow->length && end_y < layer->rowlist.length - 1 ) {
-		++end_y;
-		end_txtrow = TextLayer_GetRow( layer, end_y );
-		end_x = -1;
-		len = char_x + end_txtrow->length;
-	}
-	TextRow_SetLength( txtrow, len );
-	/* 标记当前行后面的所有行的矩形需区域需要刷新 */
-	TextLayer_InvalidateRowsRect( layer, char_y + 1, -1 );
-	/* 移除起始行与结束行之间的文本行 */
-	for( i = char_y + 1, j = i; j < end_y; ++j ) {
-		TextLayer_InvalidateRowRect( layer, i, 0, -1 );
-		TextRowList_RemoveRow( &layer->rowlist, i );
-	}
-	i = char_x;
-	j = end_x + 1;
-	end_y = char_y + 1;
-	/* 将结束行的内容拼接至起始行 */
-	for( ; i < len && j < end_txtrow->length; ++i, ++j ) {
-		txtrow->string[i] = end_txtrow->string[j];
-	}
-	TextLayer_UpdateRowSize( layer, txtrow );
-	TextLayer_InvalidateRowRect( layer, end_y, 0, -1 );
-	/* 移除结束行 */
-	TextRowList_RemoveRow( &layer->rowlist, end_y );
-	/* 如果起始行无内容，并且上一行没有结束符（换行符），则
-	 * 说明需要删除起始行 */
-	if( len <= 0 && char_y > 0 && prev_txtrow->eol != EOL_NONE ) {
-		TextLayer_InvalidateRowRect( layer, char_y, 0, -1 );
+	/* 自动换行产生的行被删空后，把它的换行符交给上一行，然后移除它 */
+	prev_txtrow = layer->rowlist.rows[char_y - 1];
+	if( prev_txtrow->eol == EOL_NONE ) {
+		prev_txtrow->eol = txtrow->eol;
+		TextLayer_InvalidateRowsRect( layer, char_y, -1 );
 		TextRowList_RemoveRow( &layer->rowlist, char_y );
+		if( layer->insert_y >= char_y ) {
+			--layer->insert_y;
+			if( layer->insert_y == char_y - 1 ) {
+				layer->insert_x = prev_txtrow->length;
+			}
+		}
+		TextLayer_AddUpdateTypesetRange( layer, char_y - 1,
+						 char_y - 1 );
 	}
-	TextLayer_AddUpdateTypeset( layer, char_y );;
 	return 0;
 }
 
@@ -1189,10 +1373,10 @@ void TextLayer_ReloadCharBitmap( LCUI_TextLayer layer )
 	for( row = 0; row < layer->rowlist.length; ++row ) {
 		TextRow txtrow = layer->rowlist.rows[row];
 		for( col = 0; col < txtrow->length; ++col ) {
-			TextChar txtchar = txtrow->string[col];
+			TextChar txtchar = &txtrow->string[col];
 			TextChar_UpdateBitmap( txtchar, &layer->text_style );
 		}
-		TextLayer_UpdateRowSize( layer, txtrow );
+		TextLayer_UpdateRowSize( layer, row );
 	}
 }
 
@@ -1206,9 +1390,11 @@ void TextLayer_Update( LCUI_TextLayer layer, LinkedList *rects )
 		layer->task.redraw_all = TRUE;
 	}
 	if( layer->task.update_typeset ) {
-		TextLayer_TextTypeset( layer, layer->task.typeset_start_row );
+		TextLayer_TextTypeset( layer, layer->task.typeset_start_row,
+				       layer->task.typeset_end_row );
 		layer->task.update_typeset = FALSE;
 		layer->task.typeset_start_row = 0;
+		layer->task.typeset_end_row = -1;
 	}
 	layer->width = TextLayer_GetWidth( layer );
 	/* 如果坐标偏移量有变化，记录各个文本行区域 */
@@ -1220,6 +1406,8 @@ void TextLayer_Update( LCUI_TextLayer layer, LinkedList *rects )
 		TextLayer_InvalidateRowsRect( layer, 0, -1 );
 		layer->task.redraw_all = TRUE;
 	}
+	/* 绘制时可能有多个线程同时查找文本行，所以在这里更新好索引 */
+	TextRowList_UpdateOffsets( &layer->rowlist );
 	if( rects ) {
 		LinkedList_Concat( rects, &layer->dirty_rect );
 	 }
@@ -1230,39 +1418,35 @@ int TextLayer_DrawToGraph( LCUI_TextLayer layer, LCUI_Rect area,
 {
 	TextRow txtrow;
 	TextChar txtchar;
-	LCUI_Pos char_pos;
-	int x, y, row, col, width, height;
-	y = layer->offset_y;
+	LCUI_Color color, run_color;
+	LCUI_Pos pos[GLYPH_RUN_SIZE];
+	const LCUI_FontBitmap *bmps[GLYPH_RUN_SIZE];
+	int x, y, row, col, width, height, n;
 	if( layer->fixed_width > 0 ) {
 		width = layer->fixed_width;
 	} else {
 		width = layer->width;
 	}
-	if( layer->fixed_width > 0 ) {
-		height = layer->fixed_width;
+	if( layer->fixed_height > 0 ) {
+		height = layer->fixed_height;
 	} else {
 		height = TextLayer_GetHeight( layer );
 	}
 	LCUIRect_ValidateArea( &area, width, height );
-	for( row = 0; row < layer->rowlist.length; ++row ) {
-		txtrow = TextLayer_GetRow( layer, row );
-		y += txtrow->height;
-		if( y > area.y ) {
-			y -= txtrow->height;
-			break;
-		}
-	}
+	row = TextLayer_FindRow( layer, area.y - layer->offset_y, &y );
+	y += layer->offset_y;
 	/* 如果没有可绘制的文本行 */
 	if( row >= layer->rowlist.length ) {
 		return -1;
 	}
+	run_color = layer->text_style.fore_color;
 	for( ; row < layer->rowlist.length; ++row ) {
 		txtrow = TextLayer_GetRow( layer, row );
 		x = TextLayer_GetRowStartX( layer, txtrow );
 		x += layer->offset_x;
 		/* 确定从哪个文字开始绘制 */
 		for( col = 0; col < txtrow->length; ++col ) {
-			txtchar = txtrow->string[col];
+			txtchar = &txtrow->string[col];
 			/* 忽略无字体位图的文字 */
 			if( !txtchar->bitmap ) {
 				continue;
@@ -1278,33 +1462,42 @@ int TextLayer_DrawToGraph( LCUI_TextLayer layer, LCUI_Rect area,
 			y += txtrow->height;
 			continue;
 		}
-		/* 遍历该行的文字 */
-		for( ; col < txtrow->length; ++col ) {
-			txtchar = txtrow->string[col];
+		/* 遍历该行的文字，将相同颜色的连续文字合并成一组再绘制 */
+		for( n = 0; col < txtrow->length; ++col ) {
+			txtchar = &txtrow->string[col];
 			if( !txtchar->bitmap ) {
 				continue;
 			}
-			/* 计算字体位图的绘制坐标 */
-			char_pos.x = layer_pos.x + x;
-			char_pos.y = layer_pos.y + y;
-			char_pos.x += txtchar->bitmap->left;
-			char_pos.y += txtrow->text_height * 4 / 5;
-			char_pos.y += (txtrow->height - txtrow->text_height) / 2;
-			char_pos.y -= txtchar->bitmap->top;
-			x += txtchar->bitmap->advance.x;
-			/* 判断文字使用的前景颜色，再进行绘制 */
 			if( txtchar->style && txtchar->style->has_fore_color ) {
-				FontBitmap_Mix( graph, char_pos, txtchar->bitmap,
-						txtchar->style->fore_color );
+				color = txtchar->style->fore_color;
 			} else {
-				FontBitmap_Mix( graph, char_pos, txtchar->bitmap,
-						layer->text_style.fore_color );
+				color = layer->text_style.fore_color;
+			}
+			if( n > 0 && (n >= GLYPH_RUN_SIZE ||
+				      color.value != run_color.value) ) {
+				FontBitmap_MixRun( graph, bmps, pos, n, run_color );
+				n = 0;
 			}
+			/* 计算字体位图的绘制坐标 */
+			pos[n].x = layer_pos.x + x;
+			pos[n].y = layer_pos.y + y;
+			pos[n].x += txtchar->bitmap->left;
+			pos[n].y += txtrow->text_height * 4 / 5;
+			pos[n].y += (txtrow->height - txtrow->text_height) / 2;
+			pos[n].y -= txtchar->bitmap->top;
+			x += txtchar->bitmap->advance.x;
+			/* 位图数据可能已被缓存淘汰，需要重新载入 */
+			LCUIFont_UseBitmap( txtchar->bitmap );
+			bmps[n++] = txtchar->bitmap;
+			run_color = color;
 			/* 如果超过绘制区域则不继续绘制该行文本 */
 			if( x > area.x + area.width ) {
 				break;
 			}
 		}
+		if( n > 0 ) {
+			FontBitmap_MixRun( graph, bmps, pos, n, run_color );
+		}
 		y += txtrow->height;
 		/* 超出绘制区域范围就不绘制了 */
 		if( y > area.y + area.height ) {
@@ -1360,16 +1553,14 @@ void TextLayer_SetTextStyle( LCUI_TextLayer layer, LCUI_TextStyle *style )
 void TextLayer_SetTextAlign( LCUI_TextLayer layer, int align )
 {
 	layer->text_align = align;
-	layer->task.update_typeset = TRUE;
-	layer->task.typeset_start_row = 0;
+	TextLayer_AddUpdateTypeset( layer, 0 );
 }
 
 /** 设置文本行的高度 */
 void TextLayer_SetLineHeight( LCUI_TextLayer layer, LCUI_Style val )
 {
 	layer->line_height = *val;
-	layer->task.update_typeset = TRUE;
-	layer->task.typeset_start_row = 0;
+	TextLayer_AddUpdateTypeset( layer, 0 );
 }
 
 void TextLayer_SetOffset( LCUI_TextLayer layer, int offset_x, int offset_y )
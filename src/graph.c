@@ -43,6 +43,23 @@
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+#include <LCUI/graph_convert.h>
+
+/**
+ * 像素数据的代数计数器
+ * 每次创建像素数据时取一个新值，释放后重新分配到相同地址的像素数据也能被区分，
+ * 用作缓存的索引时不会误用旧图像的缓存
+ */
+#ifdef _MSC_VER
+#include <intrin.h>
+static volatile long graph_generation = 0;
+#define NextGeneration() (unsigned long)_InterlockedIncrement( &graph_generation )
+#else
+static unsigned long graph_generation = 0;
+#define NextGeneration() \
+	__atomic_add_fetch( &graph_generation, 1, __ATOMIC_RELAXED )
+#endif
 
 void Graph_PrintInfo( LCUI_Graph *graph )
 {
@@ -76,6 +93,7 @@ void Graph_Init( LCUI_Graph *graph )
 	graph->height = 0;
 	graph->bytes_per_pixel = 3;
 	graph->bytes_per_row = 0;
+	graph->generation = 0;
 }
 
 LCUI_Graph *Graph_New(void)
@@ -126,101 +144,12 @@ static size_t get_pixel_size( int color_type )
 
 /*----------------------------------- RGB ----------------------------------*/
 
-static void Pixels_ARGBFormatToRGB( const uchar_t *in_pixels,
-				    uchar_t *out_pixels,
-				    size_t pixel_count )
-{
-	const LCUI_ARGB8888 *p_px, *p_end_px;
-	LCUI_ARGB8888 *p_out_px;
-	uchar_t *p_out_byte;
-
-	p_out_byte = out_pixels;
-	p_out_px = (LCUI_ARGB8888*)out_pixels;
-	p_px = (const LCUI_ARGB8888*)in_pixels;
-	/* 遍历到倒数第二个像素为止 */
-	p_end_px = p_px + pixel_count - 1;
-	for( ; p_px < p_end_px; ++p_px ) {
-		*p_out_px = *p_px;
-		/* 将后3字节的数据当成4字节（LCUI_ARGB8888）的像素点访问 */
-		p_out_px = (LCUI_ARGB8888*)(((uchar_t*)p_out_px) + 3);
-	}
-	/* 最后一个像素，以逐个字节的形式写数据 */
-	p_out_byte = (uchar_t*)(p_out_px + 1);
-	*p_out_byte++ = p_px->blue;
-	*p_out_byte++ = p_px->green;
-	*p_out_byte++ = p_px->red;
-}
-
-static void Pixels_RGBFormatToARGB( const uchar_t *in_pixels,
-				    uchar_t *out_pixels,
-				    size_t pixel_count )
-{
-	LCUI_ARGB8888 *p_px, *p_end_px;
-	const uchar_t *p_in_byte;
-
-	p_in_byte = in_pixels;
-	p_px = (LCUI_ARGB8888*)out_pixels;
-	p_end_px = p_px + pixel_count;
-	while( p_px < p_end_px ) {
-		p_px->blue = *p_in_byte++;
-		p_px->green = *p_in_byte++;
-		p_px->red = *p_in_byte++;
-		p_px->alpha = 255;
-		++p_px;
-	}
-}
-
 void PixelsFormat( const uchar_t *in_pixels, int in_color_type,
 		   uchar_t *out_pixels, int out_color_type,
 		   size_t pixel_count )
 {
-	switch( in_color_type ) {
-	case COLOR_TYPE_ARGB8888:
-		if( out_color_type == COLOR_TYPE_ARGB8888 ) {
-			return;
-		}
-		Pixels_ARGBFormatToRGB( in_pixels, out_pixels, pixel_count );
-		break;
-	case COLOR_TYPE_RGB888:
-		if( out_color_type == COLOR_TYPE_RGB888 ) {
-			return;
-		}
-		Pixels_RGBFormatToARGB( in_pixels, out_pixels, pixel_count );
-		break;
-	default: break;
-	}
-}
-
-static int Graph_RGBToARGB( LCUI_Graph *graph )
-{
-	int x, y;
-	LCUI_ARGB *px_des, *px_row_des, *buffer;
-	uchar_t *byte_row_src, *byte_src;
-
-	buffer = (LCUI_ARGB*)malloc( sizeof(LCUI_ARGB)*graph->w*graph->h );
-	if( !buffer ) {
-		return -1;
-	}
-	px_row_des = buffer;
-	byte_row_src = graph->bytes;
-	for( y=0; y<graph->h; ++y ) {
-		px_des = px_row_des;
-		byte_src = byte_row_src;
-		for( x=0; x<graph->w; ++x ) {
-			px_des->b = *byte_src++;
-			px_des->g = *byte_src++;
-			px_des->r = *byte_src++;
-			px_des->a = 255;
-			++px_des;
-		}
-		byte_row_src += graph->bytes_per_row;
-		px_row_des += graph->w;
-	}
-	free( graph->argb );
-	graph->argb = buffer;
-	graph->mem_size = sizeof(LCUI_ARGB)*graph->w*graph->h;
-	graph->color_type = COLOR_TYPE_ARGB8888;
-	return 0;
+	Pixels_Convert( out_pixels, out_color_type, in_pixels,
+			in_color_type, (int)pixel_count );
 }
 
 static int Graph_CutRGB( const LCUI_Graph *graph, LCUI_Rect rect,
@@ -370,39 +299,6 @@ static int Graph_FillRectRGB( LCUI_Graph *graph, LCUI_Color color, LCUI_Rect rec
 
 /*---------------------------------- ARGB ----------------------------------*/
 
-static int Graph_ARGBToRGB( LCUI_Graph *graph )
-{
-	int x, y;
-	LCUI_ARGB *px_src, *px_row_src;
-	uchar_t *buffer, *byte_row_des, *byte_des;
-
-	buffer = (uchar_t*)malloc( sizeof(uchar_t)*graph->w*graph->h*3 );
-	if( !buffer ) {
-		return -1;
-	}
-	byte_row_des = buffer;
-	px_row_src = graph->argb;
-	for( y=0; y<graph->h; ++y ) {
-		px_src = px_row_src;
-		byte_des = byte_row_des;
-		for( x=0; x<graph->w; ++x ) {
-			px_src->b = *byte_des++;
-			px_src->g = *byte_des++;
-			px_src->r = *byte_des++;
-			px_src->a = 255;
-			++px_src;
-		}
-		byte_row_des += graph->bytes_per_row;
-		px_row_src += graph->w;
-	}
-	free( graph->argb );
-	graph->bytes = buffer;
-	graph->mem_size = sizeof(uchar_t)*graph->w*graph->h*3;
-	graph->color_type = COLOR_TYPE_RGB888;
-	graph->bytes_per_pixel = 3;
-	return 0;
-}
-
 static int Graph_CutARGB( const LCUI_Graph *graph, LCUI_Rect rect,
 			  LCUI_Graph *buff )
 {
@@ -429,104 +325,32 @@ static int Graph_CutARGB( const LCUI_Graph *graph, LCUI_Rect rect,
 static void Graph_ARGBMixARGB( LCUI_Graph *dst, LCUI_Rect des_rect,
 			       const LCUI_Graph *src, int src_x, int src_y )
 {
-	int x, y;
-	LCUI_ARGB *px_src, *px_dst;
+	int y, opacity;
+	LCUI_BlendKernel kernel;
 	LCUI_ARGB *px_row_src, *px_row_des;
-	double a, out_a, out_r, out_g, out_b, src_a;
+	kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
+	opacity = BLEND_OPACITY( src->opacity );
 	px_row_src = src->argb + src_y*src->width + src_x;
 	px_row_des = dst->argb + des_rect.y*dst->width + des_rect.x;
-	if( src->opacity < 1.0 ) {
-		goto mix_with_opacity;
-	}
 	for( y=0; y<des_rect.h; ++y ) {
-		px_src = px_row_src;
-		px_dst = px_row_des;
-		for( x=0; x<des_rect.w; ++x ) {
-			src_a = px_src->a / 255.0;
-			a = (1.0 - src_a) * px_dst->a / 255.0;
-			out_r = px_dst->r * a + px_src->r * src_a;
-			out_g = px_dst->g * a + px_src->g * src_a;
-			out_b = px_dst->b * a + px_src->b * src_a;
-			out_a = src_a + a;
-			if( out_a > 0 ) {
-				out_r /= out_a;
-				out_g /= out_a;
-				out_b /= out_a;
-			}
-			px_dst->r = (uchar_t)(out_r + 0.5);
-			px_dst->g = (uchar_t)(out_g + 0.5);
-			px_dst->b = (uchar_t)(out_b + 0.5);
-			px_dst->a = (uchar_t)(255.0 * out_a + 0.5);
-			++px_src;
-			++px_dst;
-		}
+		kernel->mix( px_row_des, px_row_src, des_rect.w, opacity );
 		px_row_des += dst->w;
 		px_row_src += src->w;
 	}
-	return;
-
-mix_with_opacity:
-	for( y=0; y<des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dst = px_row_des;
-		for( x=0; x<des_rect.width; ++x ) {
-			src_a = px_src->a / 255.0 * src->opacity;
-			a = (1.0 - src_a) * px_dst->a / 255.0;
-			out_r = px_dst->r * a + px_src->r * src_a;
-			out_g = px_dst->g * a + px_src->g * src_a;
-			out_b = px_dst->b * a + px_src->b * src_a;
-			out_a = src_a + a;
-			if( out_a > 0 ) {
-				out_r /= out_a;
-				out_g /= out_a;
-				out_b /= out_a;
-			}
-			px_dst->r = (uchar_t)(out_r + 0.5);
-			px_dst->g = (uchar_t)(out_g + 0.5);
-			px_dst->b = (uchar_t)(out_b + 0.5);
-			px_dst->a = (uchar_t)(255.0 * out_a + 0.5);
-			++px_src;
-			++px_dst;
-		}
-		px_row_des += dst->width;
-		px_row_src += src->width;
-	}
 }
 
 static void Graph_ARGBMixARGB2( LCUI_Graph *dest, LCUI_Rect des_rect,
 				const LCUI_Graph *src, int src_x, int src_y )
 {
-	int x, y, a;
-	LCUI_ARGB *px_src, *px_dest;
+	int y, opacity;
+	LCUI_BlendKernel kernel;
 	LCUI_ARGB *px_row_src, *px_row_des;
+	kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
+	opacity = BLEND_OPACITY( src->opacity );
 	px_row_src = src->argb + src_y*src->width + src_x;
 	px_row_des = dest->argb + des_rect.y*dest->width + des_rect.x;
-	if( src->opacity < 1.0 ) {
-		goto mix_with_opacity;
-	}
-	for( y=0; y<des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dest = px_row_des;
-		for( x=0; x<des_rect.width; ++x ) {
-			PIXEL_BLEND( px_dest, px_src, px_src->a );
-			++px_src;
-			++px_dest;
-		}
-		px_row_des += dest->width;
-		px_row_src += src->width;
-	}
-	return;
-
-mix_with_opacity:
 	for( y=0; y<des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dest = px_row_des;
-		for( x=0; x<des_rect.width; ++x ) {
-			a = px_src->a * src->opacity;
-			PIXEL_BLEND( px_dest, px_src, a );
-			++px_src;
-			++px_dest;
-		}
+		kernel->blend( px_row_des, px_row_src, des_rect.w, opacity );
 		px_row_des += dest->width;
 		px_row_src += src->width;
 	}
@@ -535,47 +359,19 @@ mix_with_opacity:
 static void Graph_RGBMixARGB( LCUI_Graph *des, LCUI_Rect des_rect,
 			      const LCUI_Graph *src, int src_x, int src_y )
 {
-	int x, y;
-	uchar_t a;
-	LCUI_ARGB *px, *px_row;
-	uchar_t *rowbytep, *bytep;
+	int y, opacity;
+	LCUI_ARGB *px_row;
+	uchar_t *rowbytep;
+	LCUI_BlendKernel kernel;
 
+	kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
+	opacity = BLEND_OPACITY( src->opacity );
 	/* 计算并保存第一行的首个像素的位置 */
 	px_row = src->argb + src_y*src->w + src_x;
 	rowbytep = des->bytes + des_rect.y*des->bytes_per_row;
 	rowbytep += des_rect.x*des->bytes_per_pixel;
-	if( src->opacity < 1.0 ) {
-		goto mix_with_opacity;
-	}
-	for( y=0; y<des_rect.h; ++y ) {
-		px = px_row;
-		bytep = rowbytep;
-		for( x=0; x<des_rect.w; ++x,++px ) {
-			*bytep = _ALPHA_BLEND( *bytep, px->b, px->a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->g, px->a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->r, px->a );
-			++bytep;
-		}
-		rowbytep += des->bytes_per_row;
-		px_row += src->w;
-	}
-	return;
-
-mix_with_opacity:
 	for( y=0; y<des_rect.h; ++y ) {
-		px = px_row;
-		bytep = rowbytep;
-		for( x=0; x<des_rect.w; ++x,++px ) {
-			a = px->a * src->opacity;
-			*bytep = _ALPHA_BLEND( *bytep, px->b, a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->g, a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->r, a );
-			++bytep;
-		}
+		kernel->blend_rgb( rowbytep, px_row, des_rect.w, opacity );
 		rowbytep += des->bytes_per_row;
 		px_row += src->w;
 	}
@@ -584,28 +380,15 @@ mix_with_opacity:
 static int Graph_ARGBReplaceARGB( LCUI_Graph *des, LCUI_Rect des_rect,
 				  const LCUI_Graph *src, int src_x, int src_y )
 {
-	int x, y, row_size;
-	LCUI_ARGB *px_row_src, *px_row_des, *px_src, *px_des;
+	int y, opacity;
+	LCUI_BlendKernel kernel;
+	LCUI_ARGB *px_row_src, *px_row_des;
+	kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
+	opacity = BLEND_OPACITY( src->opacity );
 	px_row_src = src->argb + src_y*src->w + src_x;
 	px_row_des = des->argb + des_rect.y*des->w + des_rect.x;
-	if( src->opacity < 1.0 ) {
-		for( y=0; y<des_rect.h; ++y ) {
-			px_src = px_row_src;
-			px_des = px_row_des;
-			for( x=0; x<des_rect.w; ++x ) {
-				px_des->b = px_src->b;
-				px_des->g = px_src->g;
-				px_des->r = px_src->r;
-				px_des->a = src->opacity*px_src->a;
-			}
-			px_row_src += src->w;
-			px_row_des += des->w;
-		}
-		return 0;
-	}
-	row_size = sizeof(LCUI_ARGB)*des_rect.w;
 	for( y=0; y<des_rect.h; ++y ) {
-		memcpy( px_row_des, px_row_src, row_size );
+		kernel->copy( px_row_des, px_row_src, des_rect.w, opacity );
 		px_row_src += src->w;
 		px_row_des += des->w;
 	}
@@ -670,34 +453,22 @@ static int Graph_VertiFlipARGB( const LCUI_Graph *graph, LCUI_Graph *buff )
 static int Graph_FillRectARGB( LCUI_Graph *graph, LCUI_Color color,
 			       LCUI_Rect rect, LCUI_BOOL with_alpha )
 {
-	int x, y;
+	int y;
 	LCUI_Rect rect_src;
-	LCUI_ARGB *px_p, *px_row_p;
+	LCUI_ARGB *px_row_p;
+	LCUI_BlendKernel kernel;
 
 	if(!Graph_IsValid(graph)) {
 		return -1;
 	}
+	kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
 	Graph_GetValidRect( graph, &rect_src );
 	graph = Graph_GetQuote( graph );
 	px_row_p = graph->argb + (rect_src.y+rect.y)*graph->w;
 	px_row_p += rect.x + rect_src.x;
-	if( with_alpha ) {
-		for( y = 0; y < rect.h; ++y ) {
-			px_p = px_row_p;
-			for( x = 0; x < rect.w; ++x ) {
-				*px_p++ = color;
-			}
-			px_row_p += graph->w;
-		}
-	} else {
-		for( y = 0; y < rect.h; ++y ) {
-			px_p = px_row_p;
-			for( x = 0; x < rect.w; ++x ) {
-				color.alpha = px_p->alpha;
-				*px_p++ = color;
-			}
-			px_row_p += graph->w;
-		}
+	for( y = 0; y < rect.h; ++y ) {
+		kernel->fill( px_row_p, color, rect.w, with_alpha );
+		px_row_p += graph->w;
 	}
 	return 0;
 }
@@ -706,28 +477,45 @@ static int Graph_FillRectARGB( LCUI_Graph *graph, LCUI_Color color,
 
 int Graph_SetColorType( LCUI_Graph *graph, int color_type )
 {
+	int y;
+	LCUI_Graph buff;
+	uchar_t *byte_row_src, *byte_row_des;
+
 	if( graph->color_type == color_type ) {
 		return -1;
 	}
-	switch( graph->color_type ) {
-	case COLOR_TYPE_ARGB8888:
-		switch( color_type ) {
-		case COLOR_TYPE_RGB888:
-			return Graph_ARGBToRGB( graph );
-		default:break;
-		}
-		break;
-	case COLOR_TYPE_RGB888:
-		switch( color_type ) {
-		case COLOR_TYPE_ARGB8888:
-			return Graph_RGBToARGB( graph );
-		default:break;
-		}
-		break;
-	default:
-		break;
+	/* 转换 0 个像素，只检查是否支持这两种色彩类型 */
+	if( Pixels_Convert( NULL, color_type, NULL,
+			    graph->color_type, 0 ) != 0 ) {
+		return -2;
+	}
+	if( !graph->bytes || graph->w <= 0 || graph->h <= 0 ) {
+		graph->color_type = color_type;
+		graph->bytes_per_pixel = get_pixel_size( color_type );
+		graph->bytes_per_row = graph->bytes_per_pixel * graph->w;
+		return 0;
 	}
-	return -2;
+	Graph_Init( &buff );
+	buff.color_type = color_type;
+	if( Graph_Create( &buff, graph->w, graph->h ) != 0 ) {
+		return -3;
+	}
+	byte_row_src = graph->bytes;
+	byte_row_des = buff.bytes;
+	for( y = 0; y < graph->h; ++y ) {
+		Pixels_Convert( byte_row_des, color_type, byte_row_src,
+				graph->color_type, graph->w );
+		byte_row_src += graph->bytes_per_row;
+		byte_row_des += buff.bytes_per_row;
+	}
+	free( graph->bytes );
+	graph->bytes = buff.bytes;
+	graph->mem_size = buff.mem_size;
+	graph->color_type = color_type;
+	graph->bytes_per_pixel = buff.bytes_per_pixel;
+	graph->bytes_per_row = buff.bytes_per_row;
+	graph->generation = buff.generation;
+	return 0;
 }
 
 int Graph_Create( LCUI_Graph *graph, int w, int h )
@@ -750,6 +538,7 @@ int Graph_Create( LCUI_Graph *graph, int w, int h )
 			memset( graph->bytes, 0, graph->mem_size );
 			graph->w = w;
 			graph->h = h;
+			graph->generation = NextGeneration();
 			return 0;
 		}
 		Graph_Free( graph );
@@ -764,6 +553,7 @@ int Graph_Create( LCUI_Graph *graph, int w, int h )
 	memset( graph->bytes, 0, graph->mem_size );
 	graph->w = w;
 	graph->h = h;
+	graph->generation = NextGeneration();
 	return 0;
 }
 
@@ -796,6 +586,7 @@ void Graph_Free( LCUI_Graph *graph )
 	graph->w = 0;
 	graph->h = 0;
 	graph->mem_size = 0;
+	graph->generation = 0;
 }
 
 /**
@@ -942,76 +733,363 @@ int Graph_SetBlueBits( LCUI_Graph *graph, uchar_t *b, size_t size )
 	return 0;
 }
 
-int Graph_Zoom( const LCUI_Graph *graph, LCUI_Graph *buff,
-		LCUI_BOOL keep_scale, int width, int height )
+/**
+ * 区域平均缩放时一个坐标轴上的采样表
+ * 第 i 个目标像素由从 index[i] 开始的 count[i] 个源像素加权平均得到，
+ * 权重存放在 weight[i * taps] 开始的位置，总和为 65536
+ */
+typedef struct ZoomAxisRec_ {
+	int taps;		/**< 每个目标像素最多对应的源像素数量 */
+	int *index;
+	int *count;
+	int *weight;
+} ZoomAxisRec, *ZoomAxis;
+
+/** 将 num / den 形式的缩放比例转换为 16.16 定点数表示的采样步长 */
+#define ZOOM_STEP(NUM, DEN) (int)(((int64_t)(NUM) << 16) / (DEN))
+
+static void ZoomAxis_Free( ZoomAxis axis )
+{
+	free( axis->index );
+	free( axis->count );
+	free( axis->weight );
+	axis->index = axis->count = axis->weight = NULL;
+}
+
+/**
+ * 计算区域平均缩放的采样表
+ * 目标像素 i 覆盖的源区域为 [i * step, (i + 1) * step)，源像素的权重与它
+ * 被覆盖的长度成正比
+ */
+static int ZoomAxis_Init( ZoomAxis axis, int src_len, int dst_len, int step )
+{
+	int i, k, w, sum, *weight;
+	int64_t start, end, p0, p1, span;
+	int64_t limit = (int64_t)src_len << 16;
+
+	axis->taps = (step >> 16) + 2;
+	axis->index = malloc( sizeof( int ) * dst_len );
+	axis->count = malloc( sizeof( int ) * dst_len );
+	axis->weight = malloc( sizeof( int ) * dst_len * axis->taps );
+	if( !axis->index || !axis->count || !axis->weight ) {
+		ZoomAxis_Free( axis );
+		return -2;
+	}
+	for( i = 0; i < dst_len; ++i ) {
+		start = (int64_t)i * step;
+		end = start + step;
+		if( end > limit ) {
+			end = limit;
+		}
+		if( start >= end ) {
+			start = end - 1;
+		}
+		span = end - start;
+		weight = axis->weight + i * axis->taps;
+		axis->index[i] = (int)(start >> 16);
+		axis->count[i] = (int)((end - 1) >> 16) - axis->index[i] + 1;
+		for( k = 0, sum = 0; k < axis->count[i]; ++k ) {
+			p0 = (int64_t)(axis->index[i] + k) << 16;
+			p1 = p0 + 65536;
+			p0 = p0 > start ? p0 : start;
+			p1 = p1 < end ? p1 : end;
+			w = (int)(((p1 - p0) << 16) / span);
+			weight[k] = w;
+			sum += w;
+		}
+		/* 舍入误差补到最后一个源像素上，保证权重的总和是 65536 */
+		weight[k - 1] += 65536 - sum;
+	}
+	return 0;
+}
+
+static int ZoomNearest( const LCUI_Graph *graph, const LCUI_Rect *rect,
+			LCUI_Graph *buff, int num_x, int den_x,
+			int num_y, int den_y )
+{
+	int x, y, src_y, prev_y = -1;
+	int bpp = graph->bytes_per_pixel;
+	int *offset = malloc( sizeof( int ) * buff->width );
+	uchar_t *byte_src, *byte_des, *byte_row_src;
+
+	if( !offset ) {
+		return -2;
+	}
+	for( x = 0; x < buff->width; ++x ) {
+		offset[x] = (int)((int64_t)x * num_x / den_x) * bpp;
+	}
+	for( y = 0; y < buff->height; ++y ) {
+		src_y = (int)((int64_t)y * num_y / den_y);
+		byte_des = buff->bytes + y * buff->bytes_per_row;
+		/* 放大时相邻的几行是一样的，直接复制上一行 */
+		if( src_y == prev_y ) {
+			memcpy( byte_des, byte_des - buff->bytes_per_row,
+				buff->bytes_per_row );
+			continue;
+		}
+		prev_y = src_y;
+		byte_row_src = graph->bytes;
+		byte_row_src += (src_y + rect->y) * graph->bytes_per_row;
+		byte_row_src += rect->x * bpp;
+		if( graph->color_type == COLOR_TYPE_ARGB ) {
+			LCUI_ARGB *px_des = (LCUI_ARGB*)byte_des;
+			for( x = 0; x < buff->width; ++x ) {
+				byte_src = byte_row_src + offset[x];
+				*px_des++ = *(LCUI_ARGB*)byte_src;
+			}
+			continue;
+		}
+		for( x = 0; x < buff->width; ++x ) {
+			byte_src = byte_row_src + offset[x];
+			*byte_des++ = *byte_src++;
+			*byte_des++ = *byte_src++;
+			*byte_des++ = *byte_src;
+		}
+	}
+	free( offset );
+	return 0;
+}
+
+/**
+ * 计算双线性插值的采样位置
+ * 目标像素的中心对齐到源像素的中心，pos 为 16.16 定点数表示的源像素坐标，
+ * 返回值为左侧（上方）的源像素，weight 为右侧（下方）的源像素的权重
+ */
+static int BilinearPos( int64_t pos, int src_len, int *weight )
+{
+	int i;
+	if( pos <= 0 || src_len < 2 ) {
+		*weight = 0;
+		return 0;
+	}
+	i = (int)(pos >> 16);
+	if( i >= src_len - 1 ) {
+		*weight = 256;
+		return src_len - 2;
+	}
+	*weight = (int)(((pos & 0xffff) + 128) >> 8);
+	return i;
+}
+
+/** 按 0~256 的权重对两个像素分量做线性插值 */
+#define BILINEAR(A, B, W) (uchar_t)(((A) * (256 - (W)) + (B) * (W) + 128) >> 8)
+
+static int ZoomBilinear( const LCUI_Graph *graph, const LCUI_Rect *rect,
+			 LCUI_Graph *buff, int step_x, int step_y )
+{
+	uchar_t *row, *src_row;
+	const uchar_t *p, *row0, *row1;
+	int x, y, c, w, y0, wy, prev_y0 = -1, prev_wy = -1;
+	int bpp = graph->bytes_per_pixel;
+	int next = rect->width > 1 ? bpp : 0;
+	int row_size = rect->width * bpp;
+	int *offset = malloc( sizeof( int ) * buff->width * 2 );
+	LCUI_BlendKernel kernel = Graph_GetBlendKernel( BLEND_KERNEL_AUTO );
+
+	row = malloc( row_size );
+	if( !offset || !row ) {
+		free( offset );
+		free( row );
+		return -2;
+	}
+	for( x = 0; x < buff->width; ++x ) {
+		c = BilinearPos( (int64_t)x * step_x + step_x / 2 - 32768,
+				 rect->width, &w );
+		offset[x * 2] = c * bpp;
+		offset[x * 2 + 1] = w;
+	}
+	src_row = graph->bytes + rect->y * graph->bytes_per_row;
+	src_row += rect->x * bpp;
+	for( y = 0; y < buff->height; ++y ) {
+		uchar_t *byte_des = buff->bytes + y * buff->bytes_per_row;
+		y0 = BilinearPos( (int64_t)y * step_y + step_y / 2 - 32768,
+				  rect->height, &wy );
+		/* 先用混合内核对相邻的两行做垂直方向的插值，再做水平方向的插值 */
+		if( y0 != prev_y0 || wy != prev_wy ) {
+			row0 = src_row + y0 * graph->bytes_per_row;
+			row1 = rect->height > 1 ? 
+				row0 + graph->bytes_per_row : row0;
+			kernel->lerp( row, row0, row1, row_size, wy );
+			prev_y0 = y0;
+			prev_wy = wy;
+		}
+		for( x = 0; x < buff->width; ++x ) {
+			p = row + offset[x * 2];
+			w = offset[x * 2 + 1];
+			byte_des[0] = BILINEAR( p[0], p[next], w );
+			byte_des[1] = BILINEAR( p[1], p[next + 1], w );
+			byte_des[2] = BILINEAR( p[2], p[next + 2], w );
+			if( bpp == 4 ) {
+				byte_des[3] = BILINEAR( p[3], p[next + 3], w );
+			}
+			byte_des += bpp;
+		}
+	}
+	free( offset );
+	free( row );
+	return 0;
+}
+
+/**
+ * 计算源图像中的一行在水平方向上缩放后的结果
+ * 结果保留 8 位小数，最大值为 255 * 256，供垂直方向的累加使用
+ */
+static void BoxZoomRow( const uchar_t *src, unsigned int *des, 
+			ZoomAxis axis, int width, int bpp )
+{
+	int x, k;
+	const int *weight;
+	const uchar_t *p;
+	unsigned int s0, s1, s2, s3;
+	for( x = 0; x < width; ++x ) {
+		p = src + axis->index[x] * bpp;
+		weight = axis->weight + x * axis->taps;
+		s0 = s1 = s2 = s3 = 0;
+		for( k = 0; k < axis->count[x]; ++k, p += bpp ) {
+			s0 += p[0] * weight[k];
+			s1 += p[1] * weight[k];
+			s2 += p[2] * weight[k];
+			if( bpp == 4 ) {
+				s3 += p[3] * weight[k];
+			}
+		}
+		*des++ = (s0 + 128) >> 8;
+		*des++ = (s1 + 128) >> 8;
+		*des++ = (s2 + 128) >> 8;
+		if( bpp == 4 ) {
+			*des++ = (s3 + 128) >> 8;
+		}
+	}
+}
+
+static int ZoomBox( const LCUI_Graph *graph, const LCUI_Rect *rect,
+		    LCUI_Graph *buff, int step_x, int step_y )
+{
+	ZoomAxisRec ax = { 0 }, ay = { 0 };
+	int x, y, k, i, sy, wy, n, ret = -2;
+	int bpp = graph->bytes_per_pixel;
+	unsigned int *acc = NULL, *rows[2] = { NULL, NULL };
+	/* 缓存最近两个经过水平缩放的源行，相邻的目标行会共用边界上的源行 */
+	int rows_y[2] = { -1, -1 }, lru = 0;
+	const uchar_t *src_row;
+	uchar_t *byte_des;
+
+	n = buff->width * bpp;
+	if( ZoomAxis_Init( &ax, rect->width, buff->width, step_x ) != 0 ||
+	    ZoomAxis_Init( &ay, rect->height, buff->height, step_y ) != 0 ) {
+		goto exit;
+	}
+	acc = malloc( sizeof( unsigned int ) * n );
+	rows[0] = malloc( sizeof( unsigned int ) * n );
+	rows[1] = malloc( sizeof( unsigned int ) * n );
+	if( !acc || !rows[0] || !rows[1] ) {
+		goto exit;
+	}
+	src_row = graph->bytes + rect->y * graph->bytes_per_row;
+	src_row += rect->x * bpp;
+	for( y = 0; y < buff->height; ++y ) {
+		memset( acc, 0, sizeof( unsigned int ) * n );
+		for( k = 0; k < ay.count[y]; ++k ) {
+			sy = ay.index[y] + k;
+			wy = ay.weight[y * ay.taps + k];
+			if( rows_y[0] == sy ) {
+				i = 0;
+			} else if( rows_y[1] == sy ) {
+				i = 1;
+			} else {
+				i = lru;
+				rows_y[i] = sy;
+				BoxZoomRow( src_row + sy * graph->bytes_per_row,
+					    rows[i], &ax, buff->width, bpp );
+			}
+			lru = !i;
+			/* 累加结果不超过 255 * 256 * 65536，不会溢出 */
+			for( x = 0; x < n; ++x ) {
+				acc[x] += rows[i][x] * wy;
+			}
+		}
+		byte_des = buff->bytes + y * buff->bytes_per_row;
+		for( x = 0; x < n; ++x ) {
+			byte_des[x] = (uchar_t)((acc[x] + (1 << 23)) >> 24);
+		}
+	}
+	ret = 0;
+
+exit:
+	ZoomAxis_Free( &ax );
+	ZoomAxis_Free( &ay );
+	free( acc );
+	free( rows[0] );
+	free( rows[1] );
+	return ret;
+}
+
+int Graph_ZoomEx( const LCUI_Graph *graph, LCUI_Graph *buff,
+		  LCUI_BOOL keep_scale, int width, int height, int filter )
 {
 	LCUI_Rect rect;
-	int x, y, src_x, src_y;
-	double scale_x = 0.0, scale_y = 0.0;
+	int num_x, den_x, num_y, den_y, step_x, step_y;
+
 	if( !Graph_IsValid( graph ) || (width <= 0 && height <= 0) ) {
 		return -1;
 	}
 	/* 获取引用的有效区域，以及指向引用的对象的指针 */
 	Graph_GetValidRect( graph, &rect );
 	graph = Graph_GetQuote( graph );
-	if( width > 0 ) {
-		scale_x = 1.0 * rect.width / width;
-	}
-	if( height > 0 ) {
-		scale_y = 1.0 * rect.height / height;
+	if( rect.width <= 0 || rect.height <= 0 ) {
+		return -1;
 	}
+	/* 缩放比例用分数表示，以免浮点数的舍入误差 */
+	num_x = rect.width, den_x = width;
+	num_y = rect.height, den_y = height;
 	if( width <= 0 ) {
-		scale_x = scale_y;
-		width = (int)(0.5 + 1.0 * graph->width / scale_x);
+		num_x = num_y, den_x = den_y;
+		width = (int)(((int64_t)rect.width * den_x + num_x / 2) / num_x);
 	}
 	if( height <= 0 ) {
-		scale_y = scale_x;
-		height = (int)(0.5 + 1.0 * graph->height / scale_y);
+		num_y = num_x, den_y = den_x;
+		height = (int)(((int64_t)rect.height * den_y + num_y / 2) / num_y);
+	}
+	if( width <= 0 || height <= 0 ) {
+		return -1;
 	}
-	/* 如果保持宽高比 */
+	/* 如果保持宽高比，则两个方向都使用较小的缩放比例 */
 	if( keep_scale ) {
-		if( scale_x < scale_y ) {
-			scale_y = scale_x;
+		if( (int64_t)num_x * den_y < (int64_t)num_y * den_x ) {
+			num_y = num_x, den_y = den_x;
+		} else {
+			num_x = num_y, den_x = den_y;
+		}
+	}
+	step_x = ZOOM_STEP( num_x, den_x );
+	step_y = ZOOM_STEP( num_y, den_y );
+	if( filter == ZOOM_FILTER_AUTO ) {
+		if( step_x > 65536 || step_y > 65536 ) {
+			filter = ZOOM_FILTER_BOX;
 		} else {
-			scale_x = scale_y;
+			filter = ZOOM_FILTER_BILINEAR;
 		}
 	}
 	buff->color_type = graph->color_type;
-	if( Graph_Create(buff, width, height) < 0 ) {
+	if( Graph_Create( buff, width, height ) < 0 ) {
 		return -2;
 	}
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
-		LCUI_ARGB *px_src, *px_des, *px_row_src;
-		for( y=0; y < height; ++y )  {
-			src_y = y * scale_y;
-			px_row_src = graph->argb;
-			px_row_src += (src_y + rect.y) * graph->w + rect.x;
-			px_des = buff->argb + y * width;
-			for( x=0; x < width; ++x ) {
-				src_x = x * scale_x;
-				px_src = px_row_src + src_x;
-				*px_des++ = *px_src;
-			}
-		}
-	} else {
-		uchar_t *byte_src, *byte_des, *byte_row_src;
-		for( y = 0; y < height; ++y ) {
-			src_y = y * scale_y;
-			byte_row_src = graph->bytes;
-			byte_row_src += (src_y + rect.y) * graph->bytes_per_row;
-			byte_row_src += rect.x * graph->bytes_per_pixel;
-			byte_des = buff->bytes + y * buff->bytes_per_row;
-			for( x = 0; x < width; ++x ) {
-				src_x = x * scale_x;
-				src_x *= graph->bytes_per_pixel;
-				byte_src = byte_row_src + src_x;
-				*byte_des++ = *byte_src++;
-				*byte_des++ = *byte_src++;
-				*byte_des++ = *byte_src;
-			}
-		}
+	switch( filter ) {
+	case ZOOM_FILTER_BILINEAR:
+		return ZoomBilinear( graph, &rect, buff, step_x, step_y );
+	case ZOOM_FILTER_BOX:
+		return ZoomBox( graph, &rect, buff, step_x, step_y );
+	case ZOOM_FILTER_NEAREST:
+	default: break;
 	}
-	return 0;
+	return ZoomNearest( graph, &rect, buff, num_x, den_x, num_y, den_y );
+}
+
+int Graph_Zoom( const LCUI_Graph *graph, LCUI_Graph *buff,
+		LCUI_BOOL keep_scale, int width, int height )
+{
+	return Graph_ZoomEx( graph, buff, keep_scale, 
+			     width, height, ZOOM_FILTER_NEAREST );
 }
 
 int Graph_Cut( const LCUI_Graph *graph, LCUI_Rect rect,
@@ -1130,7 +1208,7 @@ typedef void(*MixerPtr)(LCUI_Graph*, LCUI_Rect, const LCUI_Graph *, int, int);
 int Graph_Mix( LCUI_Graph *back, const LCUI_Graph *fore,
 	       int left, int top, LCUI_BOOL with_alpha )
 {
-	LCUI_Graph w_slot;
+	LCUI_Graph w_slot, source;
 	LCUI_Rect r_rect, w_rect;
 	MixerPtr mixer = NULL;
 
@@ -1156,8 +1234,14 @@ int Graph_Mix( LCUI_Graph *back, const LCUI_Graph *fore,
 	}
 	top = r_rect.y;
 	left = r_rect.x;
-	/* 获取引用的源图像 */
-	fore = Graph_GetQuote( fore );
+	/* 获取引用的源图像，引用本身设置的不透明度也需要参与混合 */
+	if( fore->quote.is_valid && fore->opacity < 1.0 ) {
+		source = *(Graph_GetQuote( fore ));
+		source.opacity *= fore->opacity;
+		fore = &source;
+	} else {
+		fore = Graph_GetQuote( fore );
+	}
 	back = Graph_GetQuote( back );
 	switch( fore->color_type ) {
 	case COLOR_TYPE_RGB888:
@@ -0,0 +1,570 @@
+/* ***************************************************************************
+ * graph_blend.c -- pixel compositing kernels for the graph module
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * graph_blend.c -- 图像模块的像素混合内核
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define BLEND_ENABLE_X86
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define BLEND_ENABLE_X86
+#define TARGET_SSE2
+#define TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/**
+ * 计算 X / 255 并四舍五入，X 的取值范围为 0 ~ 255 * 255
+ * 用移位代替除法，SIMD 实现中使用的是相同的算法，以保证结果一致
+ */
+#define DIV255(X) ((((X) + 128) + (((X) + 128) >> 8)) >> 8)
+
+static struct BlendModule {
+	LCUI_BlendKernel kernel;	/**< 当前使用的内核 */
+	LCUI_BOOL cpu_checked;		/**< 是否已经检测过 CPU 特性 */
+	LCUI_BOOL has_sse2;		/**< CPU 是否支持 SSE2 指令集 */
+	LCUI_BOOL has_avx2;		/**< CPU 是否支持 AVX2 指令集 */
+} blend = { NULL, FALSE, FALSE, FALSE };
+
+/*------------------------------- Reference --------------------------------*/
+
+static void Mix_Reference( LCUI_ARGB *dst, const LCUI_ARGB *src,
+			   int n, int opacity )
+{
+	int sa, ba, oa;
+	for( ; n > 0; --n, ++src, ++dst ) {
+		sa = src->a;
+		if( opacity < 255 ) {
+			sa = DIV255( sa * opacity );
+		}
+		if( sa == 0 ) {
+			continue;
+		}
+		/* 以 255 * 255 为单位计算前景色和背景色所占的比重，避免
+		 * 在背景较透明时因舍入误差导致颜色偏差过大 */
+		ba = dst->a * (255 - sa);
+		sa *= 255;
+		oa = sa + ba;
+		dst->r = (src->r * sa + dst->r * ba + oa / 2) / oa;
+		dst->g = (src->g * sa + dst->g * ba + oa / 2) / oa;
+		dst->b = (src->b * sa + dst->b * ba + oa / 2) / oa;
+		dst->a = DIV255( oa );
+	}
+}
+
+static void Blend_Reference( LCUI_ARGB *dst, const LCUI_ARGB *src,
+			     int n, int opacity )
+{
+	int a;
+	for( ; n > 0; --n, ++src, ++dst ) {
+		a = src->a;
+		if( opacity < 255 ) {
+			a = DIV255( a * opacity );
+		}
+		if( a == 0 ) {
+			continue;
+		}
+		dst->r = DIV255( src->r * a + dst->r * (255 - a) );
+		dst->g = DIV255( src->g * a + dst->g * (255 - a) );
+		dst->b = DIV255( src->b * a + dst->b * (255 - a) );
+	}
+}
+
+static void BlendRGB_Reference( uchar_t *dst, const LCUI_ARGB *src,
+				int n, int opacity )
+{
+	int a;
+	for( ; n > 0; --n, ++src, dst += 3 ) {
+		a = src->a;
+		if( opacity < 255 ) {
+			a = DIV255( a * opacity );
+		}
+		if( a == 0 ) {
+			continue;
+		}
+		dst[0] = DIV255( src->b * a + dst[0] * (255 - a) );
+		dst[1] = DIV255( src->g * a + dst[1] * (255 - a) );
+		dst[2] = DIV255( src->r * a + dst[2] * (255 - a) );
+	}
+}
+
+static void Copy_Reference( LCUI_ARGB *dst, const LCUI_ARGB *src,
+			    int n, int opacity )
+{
+	if( opacity >= 255 ) {
+		memcpy( dst, src, sizeof( LCUI_ARGB ) * n );
+		return;
+	}
+	for( ; n > 0; --n, ++src, ++dst ) {
+		*dst = *src;
+		dst->a = DIV255( src->a * opacity );
+	}
+}
+
+static void Fill_Reference( LCUI_ARGB *dst, LCUI_ARGB color,
+			    int n, LCUI_BOOL with_alpha )
+{
+	if( with_alpha ) {
+		for( ; n > 0; --n, ++dst ) {
+			*dst = color;
+		}
+		return;
+	}
+	for( ; n > 0; --n, ++dst ) {
+		color.alpha = dst->alpha;
+		*dst = color;
+	}
+}
+
+static void LerpBytes_Reference( uchar_t *dst, const uchar_t *a,
+			    const uchar_t *b, int n, int weight )
+{
+	int w = 256 - weight;
+	for( ; n > 0; --n, ++dst, ++a, ++b ) {
+		*dst = (uchar_t)((*a * w + *b * weight + 128) >> 8);
+	}
+}
+
+/*---------------------------- End Reference -------------------------------*/
+
+#ifdef BLEND_ENABLE_X86
+
+/*---------------------------------- SSE2 ----------------------------------*/
+
+/**
+ * 混合两组已经展开为 16 位的像素（每组 2 个像素）
+ * 计算 (s * a + d * (255 - a)) / 255，a 取自前景像素的 alpha 值
+ */
+TARGET_SSE2 static __m128i Lerp_SSE2( __m128i s, __m128i d,
+				      __m128i op, int opacity )
+{
+	__m128i a, t;
+	const __m128i c128 = _mm_set1_epi16( 128 );
+	const __m128i c255 = _mm_set1_epi16( 255 );
+	a = _mm_shufflelo_epi16( s, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+	a = _mm_shufflehi_epi16( a, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+	if( opacity < 255 ) {
+		t = _mm_add_epi16( _mm_mullo_epi16( a, op ), c128 );
+		a = _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16( t, 8 ) ), 8 );
+	}
+	t = _mm_add_epi16( _mm_mullo_epi16( s, a ),
+			   _mm_mullo_epi16( d, _mm_sub_epi16( c255, a ) ) );
+	t = _mm_add_epi16( t, c128 );
+	return _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16( t, 8 ) ), 8 );
+}
+
+/** 混合 4 个像素的颜色，alpha 通道的结果无意义，由调用者处理 */
+TARGET_SSE2 static __m128i Blend4_SSE2( __m128i s, __m128i d,
+					__m128i op, int opacity )
+{
+	__m128i lo, hi;
+	const __m128i zero = _mm_setzero_si128();
+	lo = Lerp_SSE2( _mm_unpacklo_epi8( s, zero ),
+			_mm_unpacklo_epi8( d, zero ), op, opacity );
+	hi = Lerp_SSE2( _mm_unpackhi_epi8( s, zero ),
+			_mm_unpackhi_epi8( d, zero ), op, opacity );
+	return _mm_packus_epi16( lo, hi );
+}
+
+TARGET_SSE2 static void Mix_SSE2( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				  int n, int opacity )
+{
+	__m128i s, d;
+	const __m128i op = _mm_set1_epi16( (short)opacity );
+	const __m128i amask = _mm_set1_epi32( (int)0xff000000 );
+	for( ; n >= 4; n -= 4, src += 4, dst += 4 ) {
+		s = _mm_loadu_si128( (const __m128i*)src );
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		/* 背景不完全透明时的合成需要做除法，交给参考实现处理 */
+		d = _mm_cmpeq_epi32( _mm_and_si128( d, amask ), amask );
+		if( _mm_movemask_epi8( d ) != 0xffff ) {
+			Mix_Reference( dst, src, 4, opacity );
+			continue;
+		}
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		d = _mm_or_si128( Blend4_SSE2( s, d, op, opacity ), amask );
+		_mm_storeu_si128( (__m128i*)dst, d );
+	}
+	Mix_Reference( dst, src, n, opacity );
+}
+
+TARGET_SSE2 static void Blend_SSE2( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				    int n, int opacity )
+{
+	__m128i s, d, c;
+	const __m128i op = _mm_set1_epi16( (short)opacity );
+	const __m128i amask = _mm_set1_epi32( (int)0xff000000 );
+	for( ; n >= 4; n -= 4, src += 4, dst += 4 ) {
+		s = _mm_loadu_si128( (const __m128i*)src );
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		c = Blend4_SSE2( s, d, op, opacity );
+		c = _mm_or_si128( _mm_andnot_si128( amask, c ),
+				  _mm_and_si128( amask, d ) );
+		_mm_storeu_si128( (__m128i*)dst, c );
+	}
+	Blend_Reference( dst, src, n, opacity );
+}
+
+TARGET_SSE2 static void Copy_SSE2( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				   int n, int opacity )
+{
+	__m128i s, a;
+	const __m128i op = _mm_set1_epi32( opacity );
+	const __m128i c128 = _mm_set1_epi32( 128 );
+	const __m128i amask = _mm_set1_epi32( (int)0xff000000 );
+	if( opacity >= 255 ) {
+		memcpy( dst, src, sizeof( LCUI_ARGB ) * n );
+		return;
+	}
+	for( ; n >= 4; n -= 4, src += 4, dst += 4 ) {
+		s = _mm_loadu_si128( (const __m128i*)src );
+		a = _mm_mullo_epi16( _mm_srli_epi32( s, 24 ), op );
+		a = _mm_add_epi32( a, c128 );
+		a = _mm_srli_epi32( _mm_add_epi32( a, _mm_srli_epi32( a, 8 ) ), 8 );
+		s = _mm_or_si128( _mm_andnot_si128( amask, s ),
+				  _mm_slli_epi32( a, 24 ) );
+		_mm_storeu_si128( (__m128i*)dst, s );
+	}
+	Copy_Reference( dst, src, n, opacity );
+}
+
+TARGET_SSE2 static void Fill_SSE2( LCUI_ARGB *dst, LCUI_ARGB color,
+				   int n, LCUI_BOOL with_alpha )
+{
+	__m128i d;
+	const __m128i c = _mm_set1_epi32( color.value );
+	const __m128i amask = _mm_set1_epi32( (int)0xff000000 );
+	if( with_alpha ) {
+		for( ; n >= 4; n -= 4, dst += 4 ) {
+			_mm_storeu_si128( (__m128i*)dst, c );
+		}
+		Fill_Reference( dst, color, n, with_alpha );
+		return;
+	}
+	for( ; n >= 4; n -= 4, dst += 4 ) {
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		d = _mm_or_si128( _mm_and_si128( amask, d ),
+				  _mm_andnot_si128( amask, c ) );
+		_mm_storeu_si128( (__m128i*)dst, d );
+	}
+	Fill_Reference( dst, color, n, with_alpha );
+}
+
+/** 插值结果不超过 255 * 256 + 128，可以用无符号的 16 位整数计算 */
+TARGET_SSE2 static void LerpBytes_SSE2( uchar_t *dst, const uchar_t *a,
+				   const uchar_t *b, int n, int weight )
+{
+	__m128i va, vb, lo, hi;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c128 = _mm_set1_epi16( 128 );
+	const __m128i wa = _mm_set1_epi16( (short)(256 - weight) );
+	const __m128i wb = _mm_set1_epi16( (short)weight );
+	for( ; n >= 16; n -= 16, dst += 16, a += 16, b += 16 ) {
+		va = _mm_loadu_si128( (const __m128i*)a );
+		vb = _mm_loadu_si128( (const __m128i*)b );
+		lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( va, zero ), wa ),
+				    _mm_mullo_epi16( _mm_unpacklo_epi8( vb, zero ), wb ) );
+		hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( va, zero ), wa ),
+				    _mm_mullo_epi16( _mm_unpackhi_epi8( vb, zero ), wb ) );
+		lo = _mm_srli_epi16( _mm_add_epi16( lo, c128 ), 8 );
+		hi = _mm_srli_epi16( _mm_add_epi16( hi, c128 ), 8 );
+		_mm_storeu_si128( (__m128i*)dst, _mm_packus_epi16( lo, hi ) );
+	}
+	LerpBytes_Reference( dst, a, b, n, weight );
+}
+
+/*-------------------------------- End SSE2 --------------------------------*/
+
+/*---------------------------------- AVX2 ----------------------------------*/
+
+TARGET_AVX2 static __m256i Lerp_AVX2( __m256i s, __m256i d,
+				      __m256i op, int opacity )
+{
+	__m256i a, t;
+	const __m256i c128 = _mm256_set1_epi16( 128 );
+	const __m256i c255 = _mm256_set1_epi16( 255 );
+	a = _mm256_shufflelo_epi16( s, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+	a = _mm256_shufflehi_epi16( a, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+	if( opacity < 255 ) {
+		t = _mm256_add_epi16( _mm256_mullo_epi16( a, op ), c128 );
+		a = _mm256_srli_epi16( _mm256_add_epi16( t, 
+				       _mm256_srli_epi16( t, 8 ) ), 8 );
+	}
+	t = _mm256_add_epi16( _mm256_mullo_epi16( s, a ),
+			      _mm256_mullo_epi16( d, _mm256_sub_epi16( c255, a ) ) );
+	t = _mm256_add_epi16( t, c128 );
+	return _mm256_srli_epi16( _mm256_add_epi16( t, 
+				  _mm256_srli_epi16( t, 8 ) ), 8 );
+}
+
+/** 混合 8 个像素的颜色，解包和打包都在 128 位的通道内进行，像素顺序不变 */
+TARGET_AVX2 static __m256i Blend8_AVX2( __m256i s, __m256i d,
+					__m256i op, int opacity )
+{
+	__m256i lo, hi;
+	const __m256i zero = _mm256_setzero_si256();
+	lo = Lerp_AVX2( _mm256_unpacklo_epi8( s, zero ),
+			_mm256_unpacklo_epi8( d, zero ), op, opacity );
+	hi = Lerp_AVX2( _mm256_unpackhi_epi8( s, zero ),
+			_mm256_unpackhi_epi8( d, zero ), op, opacity );
+	return _mm256_packus_epi16( lo, hi );
+}
+
+TARGET_AVX2 static void Mix_AVX2( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				  int n, int opacity )
+{
+	__m256i s, d;
+	const __m256i op = _mm256_set1_epi16( (short)opacity );
+	const __m256i amask = _mm256_set1_epi32( (int)0xff000000 );
+	for( ; n >= 8; n -= 8, src += 8, dst += 8 ) {
+		s = _mm256_loadu_si256( (const __m256i*)src );
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		d = _mm256_cmpeq_epi32( _mm256_and_si256( d, amask ), amask );
+		if( _mm256_movemask_epi8( d ) != -1 ) {
+			Mix_Reference( dst, src, 8, opacity );
+			continue;
+		}
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		d = _mm256_or_si256( Blend8_AVX2( s, d, op, opacity ), amask );
+		_mm256_storeu_si256( (__m256i*)dst, d );
+	}
+	Mix_SSE2( dst, src, n, opacity );
+}
+
+TARGET_AVX2 static void Blend_AVX2( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				    int n, int opacity )
+{
+	__m256i s, d, c;
+	const __m256i op = _mm256_set1_epi16( (short)opacity );
+	const __m256i amask = _mm256_set1_epi32( (int)0xff000000 );
+	for( ; n >= 8; n -= 8, src += 8, dst += 8 ) {
+		s = _mm256_loadu_si256( (const __m256i*)src );
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		c = Blend8_AVX2( s, d, op, opacity );
+		c = _mm256_or_si256( _mm256_andnot_si256( amask, c ),
+				     _mm256_and_si256( amask, d ) );
+		_mm256_storeu_si256( (__m256i*)dst, c );
+	}
+	Blend_SSE2( dst, src, n, opacity );
+}
+
+TARGET_AVX2 static void Copy_AVX2( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				   int n, int opacity )
+{
+	__m256i s, a;
+	const __m256i op = _mm256_set1_epi32( opacity );
+	const __m256i c128 = _mm256_set1_epi32( 128 );
+	const __m256i amask = _mm256_set1_epi32( (int)0xff000000 );
+	if( opacity >= 255 ) {
+		memcpy( dst, src, sizeof( LCUI_ARGB ) * n );
+		return;
+	}
+	for( ; n >= 8; n -= 8, src += 8, dst += 8 ) {
+		s = _mm256_loadu_si256( (const __m256i*)src );
+		a = _mm256_mullo_epi16( _mm256_srli_epi32( s, 24 ), op );
+		a = _mm256_add_epi32( a, c128 );
+		a = _mm256_srli_epi32( _mm256_add_epi32( a, 
+				       _mm256_srli_epi32( a, 8 ) ), 8 );
+		s = _mm256_or_si256( _mm256_andnot_si256( amask, s ),
+				     _mm256_slli_epi32( a, 24 ) );
+		_mm256_storeu_si256( (__m256i*)dst, s );
+	}
+	Copy_SSE2( dst, src, n, opacity );
+}
+
+TARGET_AVX2 static void Fill_AVX2( LCUI_ARGB *dst, LCUI_ARGB color,
+				   int n, LCUI_BOOL with_alpha )
+{
+	__m256i d;
+	const __m256i c = _mm256_set1_epi32( color.value );
+	const __m256i amask = _mm256_set1_epi32( (int)0xff000000 );
+	if( with_alpha ) {
+		for( ; n >= 8; n -= 8, dst += 8 ) {
+			_mm256_storeu_si256( (__m256i*)dst, c );
+		}
+		Fill_SSE2( dst, color, n, with_alpha );
+		return;
+	}
+	for( ; n >= 8; n -= 8, dst += 8 ) {
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		d = _mm256_or_si256( _mm256_and_si256( amask, d ),
+				     _mm256_andnot_si256( amask, c ) );
+		_mm256_storeu_si256( (__m256i*)dst, d );
+	}
+	Fill_SSE2( dst, color, n, with_alpha );
+}
+
+TARGET_AVX2 static void LerpBytes_AVX2( uchar_t *dst, const uchar_t *a,
+				   const uchar_t *b, int n, int weight )
+{
+	__m256i va, vb, lo, hi;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i c128 = _mm256_set1_epi16( 128 );
+	const __m256i wa = _mm256_set1_epi16( (short)(256 - weight) );
+	const __m256i wb = _mm256_set1_epi16( (short)weight );
+	/* unpack 和 pack 都是在 128 位的通道内进行的，两者的顺序变化会相互抵消 */
+	for( ; n >= 32; n -= 32, dst += 32, a += 32, b += 32 ) {
+		va = _mm256_loadu_si256( (const __m256i*)a );
+		vb = _mm256_loadu_si256( (const __m256i*)b );
+		lo = _mm256_add_epi16(
+			_mm256_mullo_epi16( _mm256_unpacklo_epi8( va, zero ), wa ),
+			_mm256_mullo_epi16( _mm256_unpacklo_epi8( vb, zero ), wb ) );
+		hi = _mm256_add_epi16(
+			_mm256_mullo_epi16( _mm256_unpackhi_epi8( va, zero ), wa ),
+			_mm256_mullo_epi16( _mm256_unpackhi_epi8( vb, zero ), wb ) );
+		lo = _mm256_srli_epi16( _mm256_add_epi16( lo, c128 ), 8 );
+		hi = _mm256_srli_epi16( _mm256_add_epi16( hi, c128 ), 8 );
+		_mm256_storeu_si256( (__m256i*)dst, 
+				     _mm256_packus_epi16( lo, hi ) );
+	}
+	LerpBytes_SSE2( dst, a, b, n, weight );
+}
+
+/*-------------------------------- End AVX2 --------------------------------*/
+
+/** 检测 CPU 支持的指令集 */
+static void DetectCPUFeatures( void )
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid( info, 0 );
+	if( info[0] >= 1 ) {
+		__cpuid( info, 1 );
+		blend.has_sse2 = (info[3] & (1 << 26)) != 0;
+		/* AVX2 需要操作系统支持保存 YMM 寄存器（OSXSAVE） */
+		if( (info[2] & (1 << 27)) && 
+		    (_xgetbv( 0 ) & 0x6) == 0x6 ) {
+			__cpuid( info, 0 );
+			if( info[0] >= 7 ) {
+				__cpuidex( info, 7, 0 );
+				blend.has_avx2 = (info[1] & (1 << 5)) != 0;
+			}
+		}
+	}
+#else
+	__builtin_cpu_init();
+	blend.has_sse2 = __builtin_cpu_supports( "sse2" ) != 0;
+	blend.has_avx2 = __builtin_cpu_supports( "avx2" ) != 0;
+#endif
+}
+
+#endif
+
+static LCUI_BlendKernelRec blend_kernels[BLEND_KERNEL_TOTAL_NUM] = {
+	{ BLEND_KERNEL_AUTO, NULL },
+	{ BLEND_KERNEL_REFERENCE, "reference", Mix_Reference, Blend_Reference,
+	  BlendRGB_Reference, Copy_Reference, Fill_Reference,
+	  LerpBytes_Reference },
+#ifdef BLEND_ENABLE_X86
+	/* RGB888 的像素是 3 字节对齐的，向量化的收益不大，沿用参考实现 */
+	{ BLEND_KERNEL_SSE2, "sse2", Mix_SSE2, Blend_SSE2,
+	  BlendRGB_Reference, Copy_SSE2, Fill_SSE2,
+	  LerpBytes_SSE2 },
+	{ BLEND_KERNEL_AVX2, "avx2", Mix_AVX2, Blend_AVX2,
+	  BlendRGB_Reference, Copy_AVX2, Fill_AVX2,
+	  LerpBytes_AVX2 }
+#else
+	{ BLEND_KERNEL_SSE2, NULL },
+	{ BLEND_KERNEL_AVX2, NULL }
+#endif
+};
+
+/** 检查当前 CPU 是否支持该类型的内核 */
+static LCUI_BOOL IsKernelSupported( int type )
+{
+#ifdef BLEND_ENABLE_X86
+	if( !blend.cpu_checked ) {
+		DetectCPUFeatures();
+		blend.cpu_checked = TRUE;
+	}
+#endif
+	switch( type ) {
+	case BLEND_KERNEL_REFERENCE:
+		return TRUE;
+	case BLEND_KERNEL_SSE2:
+		return blend.has_sse2;
+	case BLEND_KERNEL_AVX2:
+		return blend.has_avx2;
+	default: break;
+	}
+	return FALSE;
+}
+
+LCUI_BlendKernel Graph_GetBlendKernel( int type )
+{
+	if( type == BLEND_KERNEL_AUTO ) {
+		if( !blend.kernel ) {
+			Graph_SetBlendKernel( BLEND_KERNEL_AUTO );
+		}
+		return blend.kernel;
+	}
+	if( type < 0 || type >= BLEND_KERNEL_TOTAL_NUM || 
+	    !IsKernelSupported( type ) ) {
+		return NULL;
+	}
+	return &blend_kernels[type];
+}
+
+int Graph_SetBlendKernel( int type )
+{
+	if( type != BLEND_KERNEL_AUTO ) {
+		LCUI_BlendKernel kernel = Graph_GetBlendKernel( type );
+		if( !kernel ) {
+			return -1;
+		}
+		blend.kernel = kernel;
+		return 0;
+	}
+	for( type = BLEND_KERNEL_TOTAL_NUM - 1; 
+	     type > BLEND_KERNEL_REFERENCE; --type ) {
+		if( IsKernelSupported( type ) ) {
+			break;
+		}
+	}
+	blend.kernel = &blend_kernels[type];
+	return 0;
+}
@@ -0,0 +1,706 @@
+/* ***************************************************************************
+ * graph_convert.c -- pixel format conversion for the graph module
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * graph_convert.c -- 图像模块的像素格式转换
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+#include <LCUI/graph_convert.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define CONVERT_ENABLE_X86
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#include <emmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define CONVERT_ENABLE_X86
+#define TARGET_SSE2
+#include <emmintrin.h>
+#endif
+
+/** 中转缓存能容纳的像素数量，必须是 4 的倍数，以保证抖动矩阵能衔接上 */
+#define CHUNK_SIZE	256
+
+/** 用位复制的方法将低位深的颜色分量扩展到 8 位，使最大值能映射为 255 */
+#define EXPAND5(V) (uchar_t)(((V) << 3) | ((V) >> 2))
+#define EXPAND6(V) (uchar_t)(((V) << 2) | ((V) >> 4))
+#define EXPAND3(V) (uchar_t)(((V) << 5) | ((V) << 2) | ((V) >> 1))
+#define EXPAND2(V) (uchar_t)((V) * 0x55)
+
+/** 加上抖动偏移量，结果超出 255 时取 255 */
+#define ADD_BIAS(V, B) (uchar_t)((V) + (B) > 255 ? 255 : (V) + (B))
+
+/**
+ * 对颜色分量做抖动
+ * 截断后的颜色分量会用位复制的方法扩展回 8 位，量化的间隔比 2^(8-BITS) 略大，
+ * 所以先将颜色分量缩小 1/2^BITS，使抖动后的平均值与原值一致
+ */
+#define DITHER(V, B, BITS) ADD_BIAS( (V) - ((V) >> (BITS)), B )
+
+/** 计算灰度值，三个权重之和为 256 */
+#define LUMA(R, G, B) (uchar_t)((77 * (R) + 150 * (G) + 29 * (B) + 128) >> 8)
+
+/** 4x4 的 Bayer 有序抖动矩阵，取值范围为 0 ~ 15 */
+static const uchar_t bayer4x4[4][4] = {
+	{ 0, 8, 2, 10 },
+	{ 12, 4, 14, 6 },
+	{ 3, 11, 1, 9 },
+	{ 15, 7, 13, 5 }
+};
+
+static struct ConvertModule {
+	LCUI_ConvertKernel kernel;	/**< 当前使用的内核 */
+} convert = { NULL };
+
+/*------------------------------- Reference --------------------------------*/
+
+static void ToRGB565_Reference( uchar_t *dst, const LCUI_ARGB *src,
+				int n, const uchar_t *bias )
+{
+	int i;
+	uchar_t r, g, b;
+	unsigned short px;
+	for( i = 0; i < n; ++i ) {
+		r = src[i].r, g = src[i].g, b = src[i].b;
+		if( bias ) {
+			b = DITHER( b, bias[(i & 3) * 4], 5 );
+			g = DITHER( g, bias[(i & 3) * 4 + 1], 6 );
+			r = DITHER( r, bias[(i & 3) * 4 + 2], 5 );
+		}
+		RGB565_FROM_RGB( px, r, g, b );
+		memcpy( dst + i * 2, &px, 2 );
+	}
+}
+
+static void ToRGB555_Reference( uchar_t *dst, const LCUI_ARGB *src,
+				int n, const uchar_t *bias )
+{
+	int i;
+	uchar_t r, g, b;
+	unsigned short px;
+	for( i = 0; i < n; ++i ) {
+		r = src[i].r, g = src[i].g, b = src[i].b;
+		if( bias ) {
+			b = DITHER( b, bias[(i & 3) * 4], 5 );
+			g = DITHER( g, bias[(i & 3) * 4 + 1], 5 );
+			r = DITHER( r, bias[(i & 3) * 4 + 2], 5 );
+		}
+		RGB555_FROM_RGB( px, r, g, b );
+		memcpy( dst + i * 2, &px, 2 );
+	}
+}
+
+static void ToRGB888_Reference( uchar_t *dst, const LCUI_ARGB *src, int n )
+{
+	for( ; n > 0; --n, ++src ) {
+		*dst++ = src->b;
+		*dst++ = src->g;
+		*dst++ = src->r;
+	}
+}
+
+static void FromRGB565_Reference( LCUI_ARGB *dst, const uchar_t *src, int n )
+{
+	unsigned short px;
+	for( ; n > 0; --n, src += 2, ++dst ) {
+		memcpy( &px, src, 2 );
+		dst->r = EXPAND5( px >> 11 );
+		dst->g = EXPAND6( (px >> 5) & 0x3f );
+		dst->b = EXPAND5( px & 0x1f );
+		dst->a = 255;
+	}
+}
+
+static void FromRGB555_Reference( LCUI_ARGB *dst, const uchar_t *src, int n )
+{
+	unsigned short px;
+	for( ; n > 0; --n, src += 2, ++dst ) {
+		memcpy( &px, src, 2 );
+		dst->r = EXPAND5( (px >> 10) & 0x1f );
+		dst->g = EXPAND5( (px >> 5) & 0x1f );
+		dst->b = EXPAND5( px & 0x1f );
+		dst->a = 255;
+	}
+}
+
+static void FromRGB888_Reference( LCUI_ARGB *dst, const uchar_t *src, int n )
+{
+	for( ; n > 0; --n, ++dst ) {
+		dst->b = *src++;
+		dst->g = *src++;
+		dst->r = *src++;
+		dst->a = 255;
+	}
+}
+
+static void SwapRB_Reference( uchar_t *dst, const uchar_t *src, int n )
+{
+	uchar_t t;
+	for( ; n > 0; --n, src += 4, dst += 4 ) {
+		t = src[0];
+		dst[0] = src[2];
+		dst[1] = src[1];
+		dst[2] = t;
+		dst[3] = src[3];
+	}
+}
+
+/*----------------------------- End Reference ------------------------------*/
+
+/*---------------------------------- SSE2 ----------------------------------*/
+
+#ifdef CONVERT_ENABLE_X86
+
+/**
+ * 在 32 位通道中拼出的 16 位像素值会被 packs 指令按有符号数饱和，所以要先
+ * 符号扩展低 16 位，才能原样保留这些值
+ */
+TARGET_SSE2 static __m128i Pack16_SSE2( __m128i v0, __m128i v1 )
+{
+	v0 = _mm_srai_epi32( _mm_slli_epi32( v0, 16 ), 16 );
+	v1 = _mm_srai_epi32( _mm_slli_epi32( v1, 16 ), 16 );
+	return _mm_packs_epi32( v0, v1 );
+}
+
+/**
+ * 计算每个颜色分量右移 BITS 位后的值，用于与参考实现一致地缩小颜色分量
+ * 以 RGB565 为例，蓝色和红色分量右移 5 位，绿色分量右移 6 位
+ */
+TARGET_SSE2 static __m128i DitherScale_SSE2( __m128i p, int g_bits )
+{
+	__m128i c;
+	c = _mm_and_si128( _mm_srli_epi32( p, 5 ), _mm_set1_epi32( 0x070007 ) );
+	if( g_bits == 6 ) {
+		return _mm_or_si128( c, _mm_and_si128( _mm_srli_epi32( p, 6 ),
+					_mm_set1_epi32( 0x0300 ) ) );
+	}
+	return _mm_or_si128( c, _mm_and_si128( _mm_srli_epi32( p, 5 ),
+				_mm_set1_epi32( 0x0700 ) ) );
+}
+
+TARGET_SSE2 static void ToRGB565_SSE2( uchar_t *dst, const LCUI_ARGB *src,
+				       int n, const uchar_t *bias )
+{
+	__m128i p0, p1, v0, v1;
+	const __m128i mask_r = _mm_set1_epi32( 0xf800 );
+	const __m128i mask_g = _mm_set1_epi32( 0x07e0 );
+	const __m128i mask_b = _mm_set1_epi32( 0x001f );
+	const __m128i b = bias ? _mm_loadu_si128( (const __m128i*)bias ) :
+				 _mm_setzero_si128();
+	for( ; n >= 8; n -= 8, src += 8, dst += 16 ) {
+		p0 = _mm_loadu_si128( (const __m128i*)src );
+		p1 = _mm_loadu_si128( (const __m128i*)(src + 4) );
+		if( bias ) {
+			p0 = _mm_sub_epi8( p0, DitherScale_SSE2( p0, 6 ) );
+			p1 = _mm_sub_epi8( p1, DitherScale_SSE2( p1, 6 ) );
+			p0 = _mm_adds_epu8( p0, b );
+			p1 = _mm_adds_epu8( p1, b );
+		}
+		v0 = _mm_or_si128( _mm_and_si128( _mm_srli_epi32( p0, 8 ), mask_r ),
+				   _mm_and_si128( _mm_srli_epi32( p0, 5 ), mask_g ) );
+		v0 = _mm_or_si128( v0, _mm_and_si128( _mm_srli_epi32( p0, 3 ),
+						      mask_b ) );
+		v1 = _mm_or_si128( _mm_and_si128( _mm_srli_epi32( p1, 8 ), mask_r ),
+				   _mm_and_si128( _mm_srli_epi32( p1, 5 ), mask_g ) );
+		v1 = _mm_or_si128( v1, _mm_and_si128( _mm_srli_epi32( p1, 3 ),
+						      mask_b ) );
+		_mm_storeu_si128( (__m128i*)dst, Pack16_SSE2( v0, v1 ) );
+	}
+	ToRGB565_Reference( dst, src, n, bias );
+}
+
+TARGET_SSE2 static void ToRGB555_SSE2( uchar_t *dst, const LCUI_ARGB *src,
+				       int n, const uchar_t *bias )
+{
+	__m128i p0, p1, v0, v1;
+	const __m128i mask_r = _mm_set1_epi32( 0x7c00 );
+	const __m128i mask_g = _mm_set1_epi32( 0x03e0 );
+	const __m128i mask_b = _mm_set1_epi32( 0x001f );
+	const __m128i b = bias ? _mm_loadu_si128( (const __m128i*)bias ) :
+				 _mm_setzero_si128();
+	for( ; n >= 8; n -= 8, src += 8, dst += 16 ) {
+		p0 = _mm_loadu_si128( (const __m128i*)src );
+		p1 = _mm_loadu_si128( (const __m128i*)(src + 4) );
+		if( bias ) {
+			p0 = _mm_sub_epi8( p0, DitherScale_SSE2( p0, 5 ) );
+			p1 = _mm_sub_epi8( p1, DitherScale_SSE2( p1, 5 ) );
+			p0 = _mm_adds_epu8( p0, b );
+			p1 = _mm_adds_epu8( p1, b );
+		}
+		v0 = _mm_or_si128( _mm_and_si128( _mm_srli_epi32( p0, 9 ), mask_r ),
+				   _mm_and_si128( _mm_srli_epi32( p0, 6 ), mask_g ) );
+		v0 = _mm_or_si128( v0, _mm_and_si128( _mm_srli_epi32( p0, 3 ),
+						      mask_b ) );
+		v1 = _mm_or_si128( _mm_and_si128( _mm_srli_epi32( p1, 9 ), mask_r ),
+				   _mm_and_si128( _mm_srli_epi32( p1, 6 ), mask_g ) );
+		v1 = _mm_or_si128( v1, _mm_and_si128( _mm_srli_epi32( p1, 3 ),
+						      mask_b ) );
+		_mm_storeu_si128( (__m128i*)dst, Pack16_SSE2( v0, v1 ) );
+	}
+	ToRGB555_Reference( dst, src, n, bias );
+}
+
+/**
+ * 将 4 个 16 位像素扩展到 32 位通道中，之后用位运算直接拼出 8 位的颜色分量，
+ * 与参考实现的位复制算法等价
+ */
+TARGET_SSE2 static void FromRGB565_SSE2( LCUI_ARGB *dst, const uchar_t *src,
+					 int n )
+{
+	int i;
+	__m128i p, v, c;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha = _mm_set1_epi32( (int)0xff000000 );
+	for( ; n >= 8; n -= 8, src += 16, dst += 8 ) {
+		p = _mm_loadu_si128( (const __m128i*)src );
+		for( i = 0; i < 2; ++i ) {
+			v = i ? _mm_unpackhi_epi16( p, zero ) :
+				_mm_unpacklo_epi16( p, zero );
+			c = _mm_or_si128( _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0xf800 ) ), 8 ),
+					  _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0xe000 ) ), 3 ) );
+			c = _mm_or_si128( c, _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x07e0 ) ), 5 ) );
+			c = _mm_or_si128( c, _mm_srli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x0600 ) ), 1 ) );
+			c = _mm_or_si128( c, _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x001f ) ), 3 ) );
+			c = _mm_or_si128( c, _mm_srli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x001c ) ), 2 ) );
+			_mm_storeu_si128( (__m128i*)(dst + i * 4),
+					  _mm_or_si128( c, alpha ) );
+		}
+	}
+	FromRGB565_Reference( dst, src, n );
+}
+
+TARGET_SSE2 static void FromRGB555_SSE2( LCUI_ARGB *dst, const uchar_t *src,
+					 int n )
+{
+	int i;
+	__m128i p, v, c;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha = _mm_set1_epi32( (int)0xff000000 );
+	for( ; n >= 8; n -= 8, src += 16, dst += 8 ) {
+		p = _mm_loadu_si128( (const __m128i*)src );
+		for( i = 0; i < 2; ++i ) {
+			v = i ? _mm_unpackhi_epi16( p, zero ) :
+				_mm_unpacklo_epi16( p, zero );
+			c = _mm_or_si128( _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x7c00 ) ), 9 ),
+					  _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x7000 ) ), 4 ) );
+			c = _mm_or_si128( c, _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x03e0 ) ), 6 ) );
+			c = _mm_or_si128( c, _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x0380 ) ), 1 ) );
+			c = _mm_or_si128( c, _mm_slli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x001f ) ), 3 ) );
+			c = _mm_or_si128( c, _mm_srli_epi32( _mm_and_si128( v,
+					  _mm_set1_epi32( 0x001c ) ), 2 ) );
+			_mm_storeu_si128( (__m128i*)(dst + i * 4),
+					  _mm_or_si128( c, alpha ) );
+		}
+	}
+	FromRGB555_Reference( dst, src, n );
+}
+
+/**
+ * SSE2 没有字节重排指令，RGB888 与 ARGB8888 之间的转换改为每次读写 3 个 32
+ * 位整数来处理 4 个像素，x86 是小端字节序，移位拼接的结果与逐字节复制一致
+ */
+TARGET_SSE2 static void ToRGB888_SSE2( uchar_t *dst, const LCUI_ARGB *src,
+				       int n )
+{
+	unsigned int p[4], w[3];
+	for( ; n >= 4; n -= 4, src += 4, dst += 12 ) {
+		memcpy( p, src, 16 );
+		w[0] = (p[0] & 0xffffff) | (p[1] << 24);
+		w[1] = ((p[1] >> 8) & 0xffff) | (p[2] << 16);
+		w[2] = ((p[2] >> 16) & 0xff) | (p[3] << 8);
+		memcpy( dst, w, 12 );
+	}
+	ToRGB888_Reference( dst, src, n );
+}
+
+TARGET_SSE2 static void FromRGB888_SSE2( LCUI_ARGB *dst, const uchar_t *src,
+					 int n )
+{
+	unsigned int p[4], w[3];
+	for( ; n >= 4; n -= 4, src += 12, dst += 4 ) {
+		memcpy( w, src, 12 );
+		p[0] = w[0] | 0xff000000;
+		p[1] = (w[0] >> 24) | (w[1] << 8) | 0xff000000;
+		p[2] = (w[1] >> 16) | (w[2] << 16) | 0xff000000;
+		p[3] = (w[2] >> 8) | 0xff000000;
+		memcpy( dst, p, 16 );
+	}
+	FromRGB888_Reference( dst, src, n );
+}
+
+TARGET_SSE2 static void SwapRB_SSE2( uchar_t *dst, const uchar_t *src, int n )
+{
+	__m128i s, rb;
+	const __m128i mask_ag = _mm_set1_epi32( (int)0xff00ff00 );
+	for( ; n >= 4; n -= 4, src += 16, dst += 16 ) {
+		s = _mm_loadu_si128( (const __m128i*)src );
+		/* 交换每个 32 位通道中的两个 16 位整数，即交换红色和蓝色 */
+		rb = _mm_andnot_si128( mask_ag, s );
+		rb = _mm_shufflelo_epi16( rb, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+		rb = _mm_shufflehi_epi16( rb, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+		s = _mm_or_si128( _mm_and_si128( mask_ag, s ), rb );
+		_mm_storeu_si128( (__m128i*)dst, s );
+	}
+	SwapRB_Reference( dst, src, n );
+}
+
+#endif
+
+/*-------------------------------- End SSE2 --------------------------------*/
+
+static LCUI_ConvertKernelRec convert_kernels[BLEND_KERNEL_TOTAL_NUM] = {
+	{ BLEND_KERNEL_AUTO, NULL },
+	{ BLEND_KERNEL_REFERENCE, "reference", ToRGB565_Reference,
+	  ToRGB555_Reference, ToRGB888_Reference, FromRGB565_Reference,
+	  FromRGB555_Reference, FromRGB888_Reference, SwapRB_Reference },
+#ifdef CONVERT_ENABLE_X86
+	{ BLEND_KERNEL_SSE2, "sse2", ToRGB565_SSE2, ToRGB555_SSE2,
+	  ToRGB888_SSE2, FromRGB565_SSE2, FromRGB555_SSE2,
+	  FromRGB888_SSE2, SwapRB_SSE2 },
+#else
+	{ BLEND_KERNEL_SSE2, NULL },
+#endif
+	/* 格式转换受限于内存带宽，更宽的向量收益不大，不提供 AVX2 实现 */
+	{ BLEND_KERNEL_AVX2, NULL }
+};
+
+/** 检查当前 CPU 是否支持该类型的内核，CPU 特性的检测交给混合模块完成 */
+static LCUI_BOOL IsKernelSupported( int type )
+{
+	if( type <= BLEND_KERNEL_AUTO || type >= BLEND_KERNEL_TOTAL_NUM ||
+	    !convert_kernels[type].name ) {
+		return FALSE;
+	}
+	return Graph_GetBlendKernel( type ) != NULL;
+}
+
+LCUI_ConvertKernel Graph_GetConvertKernel( int type )
+{
+	if( type == BLEND_KERNEL_AUTO ) {
+		if( !convert.kernel ) {
+			Graph_SetConvertKernel( BLEND_KERNEL_AUTO );
+		}
+		return convert.kernel;
+	}
+	if( !IsKernelSupported( type ) ) {
+		return NULL;
+	}
+	return &convert_kernels[type];
+}
+
+int Graph_SetConvertKernel( int type )
+{
+	if( type != BLEND_KERNEL_AUTO ) {
+		LCUI_ConvertKernel kernel = Graph_GetConvertKernel( type );
+		if( !kernel ) {
+			return -1;
+		}
+		convert.kernel = kernel;
+		return 0;
+	}
+	for( type = BLEND_KERNEL_TOTAL_NUM - 1;
+	     type > BLEND_KERNEL_REFERENCE; --type ) {
+		if( IsKernelSupported( type ) ) {
+			break;
+		}
+	}
+	convert.kernel = &convert_kernels[type];
+	return 0;
+}
+
+/*----------------------------- Other Formats ------------------------------*/
+
+static void ToGray8( uchar_t *dst, const LCUI_ARGB *src, int n )
+{
+	for( ; n > 0; --n, ++src ) {
+		*dst++ = LUMA( src->r, src->g, src->b );
+	}
+}
+
+static void FromGray8( LCUI_ARGB *dst, const uchar_t *src, int n )
+{
+	for( ; n > 0; --n, ++dst ) {
+		dst->r = dst->g = dst->b = *src++;
+		dst->a = 255;
+	}
+}
+
+/** RGB323 的高 3 位是红色，中间 2 位是绿色，低 3 位是蓝色 */
+static void ToRGB323( uchar_t *dst, const LCUI_ARGB *src, int n,
+		      const uchar_t *bias )
+{
+	int i;
+	uchar_t r, g, b;
+	for( i = 0; i < n; ++i ) {
+		r = src[i].r, g = src[i].g, b = src[i].b;
+		if( bias ) {
+			b = DITHER( b, bias[(i & 3) * 4], 3 );
+			g = DITHER( g, bias[(i & 3) * 4 + 1], 2 );
+			r = DITHER( r, bias[(i & 3) * 4 + 2], 3 );
+		}
+		dst[i] = (uchar_t)((r & 0xe0) | ((g >> 3) & 0x18) | (b >> 5));
+	}
+}
+
+static void FromRGB323( LCUI_ARGB *dst, const uchar_t *src, int n )
+{
+	for( ; n > 0; --n, ++src, ++dst ) {
+		dst->r = EXPAND3( *src >> 5 );
+		dst->g = EXPAND2( (*src >> 3) & 3 );
+		dst->b = EXPAND3( *src & 7 );
+		dst->a = 255;
+	}
+}
+
+static void ToARGB2222( uchar_t *dst, const LCUI_ARGB *src, int n,
+			const uchar_t *bias )
+{
+	int i;
+	uchar_t r, g, b;
+	for( i = 0; i < n; ++i ) {
+		r = src[i].r, g = src[i].g, b = src[i].b;
+		if( bias ) {
+			b = DITHER( b, bias[(i & 3) * 4], 2 );
+			g = DITHER( g, bias[(i & 3) * 4 + 1], 2 );
+			r = DITHER( r, bias[(i & 3) * 4 + 2], 2 );
+		}
+		dst[i] = (uchar_t)((src[i].a & 0xc0) | ((r >> 2) & 0x30) |
+				   ((g >> 4) & 0x0c) | (b >> 6));
+	}
+}
+
+static void FromARGB2222( LCUI_ARGB *dst, const uchar_t *src, int n )
+{
+	for( ; n > 0; --n, ++src, ++dst ) {
+		dst->a = EXPAND2( *src >> 6 );
+		dst->r = EXPAND2( (*src >> 4) & 3 );
+		dst->g = EXPAND2( (*src >> 2) & 3 );
+		dst->b = EXPAND2( *src & 3 );
+	}
+}
+
+/*--------------------------- End Other Formats ----------------------------*/
+
+/** 获取色彩类型中每个颜色分量的位数，按 B、G、R 的顺序排列 */
+static LCUI_BOOL GetChannelBits( int color_type, int bits[3] )
+{
+	switch( color_type ) {
+	case COLOR_TYPE_RGB565:
+		bits[0] = 5, bits[1] = 6, bits[2] = 5;
+		break;
+	case COLOR_TYPE_RGB555:
+		bits[0] = bits[1] = bits[2] = 5;
+		break;
+	case COLOR_TYPE_RGB323:
+		bits[0] = 3, bits[1] = 2, bits[2] = 3;
+		break;
+	case COLOR_TYPE_ARGB2222:
+		bits[0] = bits[1] = bits[2] = 2;
+		break;
+	default: return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * 生成一行像素的抖动偏移量
+ * 偏移量是舍入误差在 [0, 1) 之间的均匀分布，加上后再截断，即可让颜色的平均值
+ * 接近原值，alpha 通道不做抖动
+ */
+static LCUI_BOOL InitDitherBias( uchar_t bias[16], int color_type,
+				 int x, int y )
+{
+	int i, c, bits[3];
+	if( !GetChannelBits( color_type, bits ) ) {
+		return FALSE;
+	}
+	for( i = 0; i < 4; ++i ) {
+		int m = bayer4x4[y & 3][(x + i) & 3];
+		for( c = 0; c < 3; ++c ) {
+			bias[i * 4 + c] = (uchar_t)((m << (8 - bits[c])) >> 4);
+		}
+		bias[i * 4 + 3] = 0;
+	}
+	return TRUE;
+}
+
+/** 将 ARGB 像素转换为其它格式 */
+static void PackPixels( LCUI_ConvertKernel kernel, uchar_t *out,
+			int out_color_type, const LCUI_ARGB *in, int n,
+			const uchar_t *bias )
+{
+	switch( out_color_type ) {
+	case COLOR_TYPE_GRAY8: ToGray8( out, in, n ); break;
+	case COLOR_TYPE_RGB323: ToRGB323( out, in, n, bias ); break;
+	case COLOR_TYPE_ARGB2222: ToARGB2222( out, in, n, bias ); break;
+	case COLOR_TYPE_RGB555: kernel->to_rgb555( out, in, n, bias ); break;
+	case COLOR_TYPE_RGB565: kernel->to_rgb565( out, in, n, bias ); break;
+	case COLOR_TYPE_RGB888: kernel->to_rgb888( out, in, n ); break;
+	default: memcpy( out, in, n * sizeof( LCUI_ARGB ) ); break;
+	}
+}
+
+/** 将其它格式的像素转换为 ARGB 像素 */
+static void UnpackPixels( LCUI_ConvertKernel kernel, LCUI_ARGB *out,
+			  const uchar_t *in, int in_color_type, int n )
+{
+	switch( in_color_type ) {
+	case COLOR_TYPE_GRAY8: FromGray8( out, in, n ); break;
+	case COLOR_TYPE_RGB323: FromRGB323( out, in, n ); break;
+	case COLOR_TYPE_ARGB2222: FromARGB2222( out, in, n ); break;
+	case COLOR_TYPE_RGB555: kernel->from_rgb555( out, in, n ); break;
+	case COLOR_TYPE_RGB565: kernel->from_rgb565( out, in, n ); break;
+	case COLOR_TYPE_RGB888: kernel->from_rgb888( out, in, n ); break;
+	default: memcpy( out, in, n * sizeof( LCUI_ARGB ) ); break;
+	}
+}
+
+static int GetPixelSize( int color_type )
+{
+	switch( color_type ) {
+	case COLOR_TYPE_GRAY8:
+	case COLOR_TYPE_RGB323:
+	case COLOR_TYPE_ARGB2222:
+		return 1;
+	case COLOR_TYPE_RGB555:
+	case COLOR_TYPE_RGB565:
+		return 2;
+	case COLOR_TYPE_RGB888:
+		return 3;
+	case COLOR_TYPE_ARGB8888:
+		return 4;
+	default: break;
+	}
+	/* 没有调色板格式的定义，不支持 COLOR_TYPE_INDEX8 */
+	return 0;
+}
+
+static int ConvertPixels( uchar_t *out, int out_color_type,
+			  const uchar_t *in, int in_color_type,
+			  int n, const uchar_t *bias )
+{
+	int i, count;
+	LCUI_ARGB buffer[CHUNK_SIZE];
+	int in_size = GetPixelSize( in_color_type );
+	int out_size = GetPixelSize( out_color_type );
+	LCUI_ConvertKernel kernel = Graph_GetConvertKernel( BLEND_KERNEL_AUTO );
+
+	if( in_size == 0 || out_size == 0 ) {
+		return -1;
+	}
+	if( n <= 0 ) {
+		return 0;
+	}
+	if( in_color_type == out_color_type ) {
+		memcpy( out, in, n * in_size );
+		return 0;
+	}
+	if( in_color_type == COLOR_TYPE_ARGB8888 ) {
+		PackPixels( kernel, out, out_color_type,
+			    (const LCUI_ARGB*)in, n, bias );
+		return 0;
+	}
+	if( out_color_type == COLOR_TYPE_ARGB8888 ) {
+		UnpackPixels( kernel, (LCUI_ARGB*)out, in, in_color_type, n );
+		return 0;
+	}
+	/* 其它格式之间的转换以 ARGB 为中转，每次转换一小段 */
+	for( i = 0; i < n; i += count ) {
+		count = n - i < CHUNK_SIZE ? n - i : CHUNK_SIZE;
+		UnpackPixels( kernel, buffer, in + i * in_size,
+			      in_color_type, count );
+		PackPixels( kernel, out + i * out_size, out_color_type,
+			    buffer, count, bias );
+	}
+	return 0;
+}
+
+int Pixels_Convert( uchar_t *out_pixels, int out_color_type,
+		    const uchar_t *in_pixels, int in_color_type, int n )
+{
+	return ConvertPixels( out_pixels, out_color_type,
+			      in_pixels, in_color_type, n, NULL );
+}
+
+int Pixels_ConvertDither( uchar_t *out_pixels, int out_color_type,
+			  const uchar_t *in_pixels, int in_color_type,
+			  int n, int x, int y )
+{
+	uchar_t bias[16];
+	if( !InitDitherBias( bias, out_color_type, x, y ) ) {
+		return ConvertPixels( out_pixels, out_color_type,
+				      in_pixels, in_color_type, n, NULL );
+	}
+	return ConvertPixels( out_pixels, out_color_type,
+			      in_pixels, in_color_type, n, bias );
+}
+
+int Pixels_SwapRB( uchar_t *out_pixels, const uchar_t *in_pixels,
+		   int color_type, int n )
+{
+	uchar_t t;
+	switch( color_type ) {
+	case COLOR_TYPE_ARGB8888:
+		Graph_GetConvertKernel( BLEND_KERNEL_AUTO )->swap_rb(
+			out_pixels, in_pixels, n );
+		break;
+	case COLOR_TYPE_RGB888:
+		for( ; n > 0; --n, in_pixels += 3, out_pixels += 3 ) {
+			t = in_pixels[0];
+			out_pixels[0] = in_pixels[2];
+			out_pixels[1] = in_pixels[1];
+			out_pixels[2] = t;
+		}
+		break;
+	default: return -1;
+	}
+	return 0;
+}
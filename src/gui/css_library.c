@@ -103,11 +103,19 @@ typedef struct StyleLinkRec_ {
 	Dict *parents;		/**< 父级节点 */
 } StyleLinkRec, *StyleLink;
 
+/** 样式表缓存 */
+typedef struct StyleCacheRec_ {
+	unsigned int fingerprint;	/**< 指纹，每份缓存的指纹都不相同 */
+	LCUI_Selector selector;		/**< 选择器，用于校验哈希值和定向失效 */
+	LCUI_StyleSheet sheet;		/**< 合并后的样式表 */
+} StyleCacheRec, *StyleCache;
+
 static struct {
 	LCUI_BOOL is_inited;
 	LCUI_Mutex mutex;		/**< 互斥锁 */
 	LinkedList groups;		/**< 样式组列表 */
 	Dict *cache;			/**< 样式表缓存，以选择器的 hash 值索引 */
+	unsigned int fingerprint;	/**< 最近一次分配的缓存指纹 */
 	Dict *names;			/**< 样式属性名称表，以值的名称索引 */
 	Dict *value_keys;		/**< 样式属性值表，以值的名称索引 */
 	Dict *value_names;		/**< 样式属性值名称表，以值索引 */
@@ -164,6 +172,10 @@ static KeyNameGroupRec style_name_map[] = {
 	{ key_border_right_style, "border-right-style" },
 	{ key_border_bottom_style, "border-bottom-style" },
 	{ key_border_left_style, "border-left-style" },
+	{ key_border_top_left_radius, "border-top-left-radius" },
+	{ key_border_top_right_radius, "border-top-right-radius" },
+	{ key_border_bottom_left_radius, "border-bottom-left-radius" },
+	{ key_border_bottom_right_radius, "border-bottom-right-radius" },
 	{ key_box_shadow_x, "box-shadow-x" },
 	{ key_box_shadow_y, "box-shadow-y" },
 	{ key_box_shadow_blur, "box-shadow-blur" },
@@ -329,7 +341,7 @@ LCUI_BOOL SelectorNode_Match( LCUI_SelectorNode sn1,
 		for( i = 0; sn2->classes[i]; ++i ) {
 			for( j = 0; sn1->classes[j]; ++j ) {
 				if( strcmp( sn2->classes[i],
-					    sn1->classes[i] ) == 0 ) {
+					    sn1->classes[j] ) == 0 ) {
 					j = -1;
 					break;
 				}
@@ -346,7 +358,7 @@ LCUI_BOOL SelectorNode_Match( LCUI_SelectorNode sn1,
 		for( i = 0; sn2->status[i]; ++i ) {
 			for( j = 0; sn1->status[j]; ++j ) {
 				if( strcmp( sn2->status[i],
-					    sn1->status[i] ) == 0 ) {
+					    sn1->status[j] ) == 0 ) {
 					j = -1;
 					break;
 				}
@@ -419,6 +431,62 @@ void Selector_Delete( LCUI_Selector s )
 	free( s );
 }
 
+static LCUI_Selector Selector_Copy( LCUI_Selector s )
+{
+	int i;
+	LCUI_Selector s2 = NEW( LCUI_SelectorRec, 1 );
+	s2->nodes = NEW( LCUI_SelectorNode, MAX_SELECTOR_DEPTH );
+	for( i = 0; i < s->length; ++i ) {
+		s2->nodes[i] = NEW( LCUI_SelectorNodeRec, 1 );
+		SelectorNode_Copy( s2->nodes[i], s->nodes[i] );
+		s2->nodes[i]->rank = s->nodes[i]->rank;
+	}
+	s2->rank = s->rank;
+	s2->hash = s->hash;
+	s2->length = s->length;
+	s2->batch_num = s->batch_num;
+	return s2;
+}
+
+LCUI_BOOL Selector_Compare( LCUI_Selector s1, LCUI_Selector s2 )
+{
+	int i;
+	if( s1->hash != s2->hash || s1->length != s2->length ) {
+		return FALSE;
+	}
+	for( i = 0; i < s1->length; ++i ) {
+		if( strcmp( s1->nodes[i]->fullname,
+			    s2->nodes[i]->fullname ) != 0 ) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * 判断样式规则的选择器是否能匹配选择器路径
+ * 最右边的结点必须匹配路径的最后一个结点，其余结点按从右到左的顺序匹配路径
+ * 中的祖先结点，每次都选择最近的一个。
+ */
+static LCUI_BOOL Selector_MatchRule( LCUI_Selector rule, LCUI_Selector path )
+{
+	int i, j;
+	if( rule->length < 1 || path->length < 1 ) {
+		return FALSE;
+	}
+	i = rule->length - 1;
+	j = path->length - 1;
+	if( !SelectorNode_Match( path->nodes[j], rule->nodes[i] ) ) {
+		return FALSE;
+	}
+	for( --i, --j; i >= 0 && j >= 0; --j ) {
+		if( SelectorNode_Match( path->nodes[j], rule->nodes[i] ) ) {
+			--i;
+		}
+	}
+	return i < 0;
+}
+
 LCUI_StyleSheet StyleSheet( void )
 {
 	LCUI_StyleSheet ss;
@@ -426,11 +494,25 @@ LCUI_StyleSheet StyleSheet( void )
 	if( !ss ) {
 		return ss;
 	}
+	ss->refs = 1;
 	ss->length = LCUI_GetStyleTotal();
 	ss->sheet = NEW( LCUI_StyleRec, ss->length + 1 );
 	return ss;
 }
 
+LCUI_StyleSheet StyleSheet_Ref( LCUI_StyleSheet ss )
+{
+	/* 共享的样式表可能会在其它线程中被引用或释放 */
+	if( library.is_inited ) {
+		LCUIMutex_Lock( &library.mutex );
+		++ss->refs;
+		LCUIMutex_Unlock( &library.mutex );
+	} else {
+		++ss->refs;
+	}
+	return ss;
+}
+
 void StyleSheet_Clear( LCUI_StyleSheet ss )
 {
 	int i;
@@ -452,6 +534,17 @@ void StyleSheet_Clear( LCUI_StyleSheet ss )
 
 void StyleSheet_Delete( LCUI_StyleSheet ss )
 {
+	int refs;
+	if( library.is_inited ) {
+		LCUIMutex_Lock( &library.mutex );
+		refs = --ss->refs;
+		LCUIMutex_Unlock( &library.mutex );
+	} else {
+		refs = --ss->refs;
+	}
+	if( refs > 0 ) {
+		return;
+	}
 	StyleSheet_Clear( ss );
 	free( ss->sheet );
 	free( ss );
@@ -1116,12 +1209,31 @@ static LCUI_StyleSheet LCUI_SelectStyleSheet( LCUI_Selector selector,
 	return snode->sheet;
 }
 
+/** 删除受样式规则影响的样式表缓存，其它缓存仍然可以继续使用 */
+static void StyleCache_Invalidate( LCUI_Selector selector )
+{
+	StyleCache cache;
+	DictEntry *entry;
+	DictIterator *iter;
+	if( Dict_Size( library.cache ) < 1 ) {
+		return;
+	}
+	iter = Dict_GetSafeIterator( library.cache );
+	while( (entry = Dict_Next( iter )) ) {
+		cache = DictEntry_GetVal( entry );
+		if( Selector_MatchRule( selector, cache->selector ) ) {
+			Dict_Delete( library.cache, DictEntry_GetKey( entry ) );
+		}
+	}
+	Dict_ReleaseIterator( iter );
+}
+
 int LCUI_PutStyleSheet( LCUI_Selector selector, 
 		   LCUI_StyleSheet in_ss, const char *space )
 {
 	LCUI_StyleSheet ss;
 	LCUIMutex_Lock( &library.mutex );
-	Dict_Empty( library.cache );
+	StyleCache_Invalidate( selector );
 	ss = LCUI_SelectStyleSheet( selector, space );
 	if( ss ) {
 		StyleSheet_Replace( ss, in_ss );
@@ -1355,35 +1467,93 @@ void LCUI_PrintCSSLibrary( void )
 	LOG( "style library end\n" );
 }
 
-void LCUI_GetStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss )
+/** 获取选择器对应的样式表缓存，没有则生成一个 */
+static StyleCache LCUI_GetStyleCache( LCUI_Selector s )
 {
+	StyleCache cache;
 	LinkedList list;
 	LinkedListNode *node;
-	LCUI_StyleSheet ss;
-	LinkedList_Init( &list );
-	StyleSheet_Clear( out_ss );
-	LCUIMutex_Lock( &library.mutex );
-	ss = Dict_FetchValue( library.cache, &s->hash );
-	if( ss ) {
-		StyleSheet_Replace( out_ss, ss );
-		LCUIMutex_Unlock( &library.mutex );
-		return;
+	cache = Dict_FetchValue( library.cache, &s->hash );
+	if( cache ) {
+		if( Selector_Compare( cache->selector, s ) ) {
+			return cache;
+		}
+		/* 哈希值冲突，用新的选择器替换掉旧的缓存 */
+		Dict_Delete( library.cache, &s->hash );
 	}
-	ss = StyleSheet();
+	cache = NEW( StyleCacheRec, 1 );
+	if( ++library.fingerprint == 0 ) {
+		++library.fingerprint;
+	}
+	cache->fingerprint = library.fingerprint;
+	cache->selector = Selector_Copy( s );
+	cache->sheet = StyleSheet();
+	LinkedList_Init( &list );
 	LCUI_FindStyleSheet( s, &list );
 	for( LinkedList_Each( node, &list ) ) {
 		StyleNode sn = node->data;
-		StyleSheet_Merge( ss, sn->sheet );
+		StyleSheet_Merge( cache->sheet, sn->sheet );
 	}
 	LinkedList_Clear( &list, NULL );
-	Dict_Add( library.cache, &s->hash, ss );
-	StyleSheet_Replace( out_ss, ss );
+	Dict_Add( library.cache, &s->hash, cache );
+	return cache;
+}
+
+LCUI_BOOL LCUI_UpdateStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss,
+				 unsigned int *fingerprint )
+{
+	StyleCache cache;
+	LCUIMutex_Lock( &library.mutex );
+	cache = LCUI_GetStyleCache( s );
+	if( *fingerprint == cache->fingerprint ) {
+		LCUIMutex_Unlock( &library.mutex );
+		return FALSE;
+	}
+	*fingerprint = cache->fingerprint;
+	StyleSheet_Clear( out_ss );
+	StyleSheet_Replace( out_ss, cache->sheet );
+	LCUIMutex_Unlock( &library.mutex );
+	return TRUE;
+}
+
+LCUI_StyleSheet LCUI_GetSharedStyleSheet( LCUI_Selector s,
+					  unsigned int *fingerprint )
+{
+	StyleCache cache;
+	LCUI_StyleSheet ss;
+	LCUIMutex_Lock( &library.mutex );
+	cache = LCUI_GetStyleCache( s );
+	*fingerprint = cache->fingerprint;
+	ss = StyleSheet_Ref( cache->sheet );
+	LCUIMutex_Unlock( &library.mutex );
+	return ss;
+}
+
+LCUI_BOOL LCUI_CheckStyleSheet( unsigned int hash, unsigned int fingerprint )
+{
+	StyleCache cache;
+	LCUI_BOOL result = FALSE;
+	LCUIMutex_Lock( &library.mutex );
+	cache = Dict_FetchValue( library.cache, &hash );
+	if( cache && cache->fingerprint == fingerprint ) {
+		result = TRUE;
+	}
 	LCUIMutex_Unlock( &library.mutex );
+	return result;
+}
+
+void LCUI_GetStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss )
+{
+	unsigned int fingerprint = 0;
+	LCUI_UpdateStyleSheet( s, out_ss, &fingerprint );
 }
 
 static void DestroyStyleSheetCache( void *privdata, void *val )
 {
-	StyleSheet_Delete( val );
+	StyleCache cache = val;
+	Selector_Delete( cache->selector );
+	StyleSheet_Delete( cache->sheet );
+	free( cache );
 }
 
 static void DestroyStyleName( void *privdata, void *val )
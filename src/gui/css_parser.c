@@ -402,6 +402,19 @@ static int OnParseBorderWidth( LCUI_StyleSheet ss, int key, const char *str )
 	return 0;
 }
 
+static int OnParseBorderRadius( LCUI_StyleSheet ss, int key, const char *str )
+{
+	LCUI_StyleRec s;
+	if( !ParseNumber( &s, str ) ) {
+		return -1;
+	}
+	ss->sheet[key_border_top_left_radius] = s;
+	ss->sheet[key_border_top_right_radius] = s;
+	ss->sheet[key_border_bottom_left_radius] = s;
+	ss->sheet[key_border_bottom_right_radius] = s;
+	return 0;
+}
+
 static int OnParseBorderStyle( LCUI_StyleSheet ss, int key, const char *str )
 {
 	LCUI_StyleRec s;
@@ -577,6 +590,10 @@ static LCUI_StyleParserRec style_parser_map[] = {
 	{ key_border_right_style, NULL, OnParseStyleOption },
 	{ key_border_bottom_style, NULL, OnParseStyleOption },
 	{ key_border_left_style, NULL, OnParseStyleOption },
+	{ key_border_top_left_radius, NULL, OnParseNumber },
+	{ key_border_top_right_radius, NULL, OnParseNumber },
+	{ key_border_bottom_left_radius, NULL, OnParseNumber },
+	{ key_border_bottom_right_radius, NULL, OnParseNumber },
 	{ key_padding_top, NULL, OnParseNumber },
 	{ key_padding_right, NULL, OnParseNumber },
 	{ key_padding_bottom, NULL, OnParseNumber },
@@ -596,6 +613,7 @@ static LCUI_StyleParserRec style_parser_map[] = {
 	{ -1, "border-color", OnParseBorderColor },
 	{ -1, "border-width", OnParseBorderWidth },
 	{ -1, "border-style", OnParseBorderStyle },
+	{ -1, "border-radius", OnParseBorderRadius },
 	{ -1, "padding", OnParsePadding },
 	{ -1, "margin", OnParseMargin },
 	{ -1, "box-shadow", OnParseBoxShadow },
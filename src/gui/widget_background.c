@@ -115,6 +115,7 @@ static int OnComparePath( void *data, const void *keydata )
 static void OnDestroyCache( void *arg )
 {
 	ImageCache cache = arg;
+	Background_ReleaseImageCache( &cache->image );
 	Graph_Free( &cache->image );
 	free( cache->path );
 	cache->path = NULL;
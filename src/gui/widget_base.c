@@ -265,7 +265,10 @@ static void Widget_Init( LCUI_Widget widget )
 	Border_Init( &widget->computed_style.border );
 	LinkedList_Init( &widget->children );
 	LinkedList_Init( &widget->children_show );
-	LinkedList_Init( &widget->dirty_rects );
+	Region_Init( &widget->dirty_rects );
+	Region_Init( &widget->layer.dirty_rects );
+	widget->layer.node.data = widget;
+	widget->layer.mode = WLM_NONE;
 	LCUIMutex_Init( &widget->mutex );
 	Graph_Init( &widget->graph );
 }
@@ -313,12 +316,14 @@ void Widget_ExecDestroy( LCUI_Widget widget )
 	if( widget->proto && widget->proto->destroy ) {
 		widget->proto->destroy( widget );
 	}
-	RectList_Clear( &widget->dirty_rects );
-	StyleSheet_Delete( widget->inherited_style );
-	StyleSheet_Delete( widget->custom_style );
-	StyleSheet_Delete( widget->style );
+	Region_Destroy( &widget->dirty_rects );
+	Widget_SetLayerMode( widget, WLM_NONE );
+	Region_Destroy( &widget->layer.dirty_rects );
+	Widget_DestroyStyle( widget );
 	Widget_PostSurfaceEvent( widget, WET_REMOVE );
-	Widget_UpdateLayout( widget->parent );
+	if( widget->parent ) {
+		Widget_UpdateLayout( widget->parent );
+	}
 	Widget_SetId( widget, NULL );
 	if( widget->type && !widget->proto ) {
 		free( widget->type );
@@ -552,6 +557,18 @@ static void ComputeBorderStyle( LCUI_StyleSheet ss, LCUI_Border *b )
 		case key_border_left_style:
 			b->left.style = style->value;
 			break;
+		case key_border_top_left_radius:
+			b->top_left_radius = style->value;
+			break;
+		case key_border_top_right_radius:
+			b->top_right_radius = style->value;
+			break;
+		case key_border_bottom_left_radius:
+			b->bottom_left_radius = style->value;
+			break;
+		case key_border_bottom_right_radius:
+			b->bottom_right_radius = style->value;
+			break;
 		default: break;
 		}
 	}
@@ -573,6 +590,14 @@ void Widget_UpdateBorder( LCUI_Widget w )
 		Widget_AddTask( w, WTT_POSITION );
 		return;
 	}
+	/* 圆角会影响背景和子部件内容的裁剪，所以需要重绘整个边框盒 */
+	if( ob.top_left_radius != nb->top_left_radius ||
+	    ob.top_right_radius != nb->top_right_radius ||
+	    ob.bottom_left_radius != nb->bottom_left_radius ||
+	    ob.bottom_right_radius != nb->bottom_right_radius ) {
+		Widget_InvalidateArea( w, NULL, SV_BORDER_BOX );
+		return;
+	}
 	rect.x = rect.y = 0;
 	rect.width = w->box.border.width;
 	rect.width -= max( ob.top_right_radius, ob.right.width );
@@ -913,22 +938,6 @@ static void Widget_UpdateGraphBox( LCUI_Widget w )
 	rg->y = w->y - BoxShadow_GetBoxY( shadow );
 	rg->width = BoxShadow_GetWidth( shadow, rb->width );
 	rg->height = BoxShadow_GetHeight( shadow, rb->height );
-	if( !w->enable_graph ) {
-		Graph_Free( &w->graph );
-		return;
-	}
-	/* 如果有会产生透明效果的样式 */
-	if( w->computed_style.border.bottom_left_radius > 0
-	    || w->computed_style.border.bottom_right_radius > 0
-	    || w->computed_style.border.top_left_radius > 0
-	    || w->computed_style.border.top_right_radius > 0
-	    || w->computed_style.background.color.alpha < 255
-	    || w->computed_style.shadow.blur > 0 ) {
-		w->graph.color_type = COLOR_TYPE_ARGB;
-	} else {
-		w->graph.color_type = COLOR_TYPE_RGB;
-	}
-	Graph_Create( &w->graph, rg->width, rg->height );
 }
 
 /** 计算合适的内容框大小 */
@@ -1684,6 +1693,7 @@ void LCUI_InitWidget( void )
 	LCUIWidget_InitEvent();
 	LCUIWidget_InitPrototype();
 	LCUIWidget_InitStyle();
+	LCUIWidget_InitPaint();
 	LCUIWidget_AddTextView();
 	LCUIWidget_AddButton();
 	LCUIWidget_AddSideBar();
@@ -1698,5 +1708,5 @@ void LCUI_InitWidget( void )
 
 void LCUI_ExitWidget( void )
 {
-
+	LCUIWidget_ExitPaint();
 }
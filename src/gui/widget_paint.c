@@ -40,10 +40,78 @@
 //#define DEBUG
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/display.h>
 #include <LCUI/gui/widget.h>
 
+/** 图层缓存默认的内存预算 */
+#define DEFAULT_LAYER_CACHE_SIZE (16 * 1024 * 1024)
+
+#define max(a, b) ((a) > (b) ? (a):(b))
+
+/** 子部件数量不超过该值时，遮挡标记存放在栈上 */
+#define CULL_STACK_SIZE 64
+
+/** 部件图层缓存 */
+static struct LayerCache {
+	LCUI_BOOL is_inited;		/**< 是否已经初始化 */
+	LinkedList layers;		/**< 已分配位图的部件图层列表 */
+	size_t used_bytes;		/**< 图层位图占用的内存 */
+	size_t max_bytes;		/**< 内存预算 */
+	size_t pending_bytes;		/**< 因预算不足而未能分配的内存 */
+	unsigned int frame;		/**< 当前帧序号，用于判断图层的使用时间 */
+	unsigned long hits;		/**< 命中次数 */
+	unsigned long misses;		/**< 未命中次数 */
+	unsigned long evictions;	/**< 被释放的图层数量 */
+	LCUI_Mutex mutex;
+} cache;
+
+/** 遮挡剔除的设置和统计信息，计数与图层缓存共用 cache.mutex */
+static struct PaintStats {
+	LCUI_BOOL culling;		/**< 是否启用遮挡剔除 */
+	unsigned long culls;		/**< 因被完全遮挡而跳过的绘制次数 */
+} stats = { TRUE, 0 };
+
+/**
+ * 为绘制过程创建临时位图
+ * 若绘制上下文带有临时内存，则从中分配，在当前帧结束时统一回收，否则使用
+ * Graph_Create() 分配。
+ */
+static int Paint_CreateGraph( LCUI_PaintContext paint, LCUI_Graph *graph,
+			      int width, int height )
+{
+	size_t size;
+	graph->color_type = COLOR_TYPE_ARGB;
+	if( !paint->arena || width <= 0 || height <= 0 ) {
+		return Graph_Create( graph, width, height );
+	}
+	size = (size_t)width * height * sizeof( LCUI_ARGB );
+	graph->bytes = Arena_Alloc( paint->arena, size );
+	if( !graph->bytes ) {
+		return Graph_Create( graph, width, height );
+	}
+	memset( graph->bytes, 0, size );
+	graph->bytes_per_pixel = sizeof( LCUI_ARGB );
+	graph->bytes_per_row = width * sizeof( LCUI_ARGB );
+	graph->mem_size = size;
+	graph->width = width;
+	graph->height = height;
+	return 0;
+}
+
+/** 释放由 Paint_CreateGraph() 创建的临时位图 */
+static void Paint_FreeGraph( LCUI_PaintContext paint, LCUI_Graph *graph )
+{
+	if( !graph->quote.is_valid && paint->arena &&
+	    Arena_Contains( paint->arena, graph->bytes ) ) {
+		Graph_Init( graph );
+		return;
+	}
+	Graph_Free( graph );
+}
+
 /** 判断部件是否有可绘制内容 */
 static LCUI_BOOL Widget_IsPaintable( LCUI_Widget w )
 {
@@ -58,6 +126,31 @@ static LCUI_BOOL Widget_IsPaintable( LCUI_Widget w )
 	return w->proto && w->proto->paint;
 }
 
+/**
+ * 获取部件中完全不透明的区域
+ * 只根据部件的不透明度和背景色判断，背景色不透明时边框框内都会被它覆盖，圆角
+ * 处的区域不一定被覆盖，所以按最大的圆角半径向内收缩。
+ * @param[out] rect 相对于部件呈现框的矩形区域
+ * @returns 有不透明区域时返回 TRUE
+ */
+static LCUI_BOOL Widget_GetOpaqueRect( LCUI_Widget w, LCUI_Rect *rect )
+{
+	int radius;
+	const LCUI_WidgetStyle *s = &w->computed_style;
+	const LCUI_Border *b = &s->border;
+	if( s->opacity < 1.0 || s->background.color.alpha < 255 ) {
+		return FALSE;
+	}
+	radius = (int)max( max( b->top_left_radius, b->top_right_radius ),
+			   max( b->bottom_left_radius,
+				b->bottom_right_radius ) );
+	rect->x = w->box.border.x - w->box.graph.x + radius;
+	rect->y = w->box.border.y - w->box.graph.y + radius;
+	rect->width = w->box.border.width - radius * 2;
+	rect->height = w->box.border.height - radius * 2;
+	return rect->width > 0 && rect->height > 0;
+}
+
 /**
  * 根据所处框区域，调整矩形
  * @param[in] w		目标部件
@@ -90,16 +183,54 @@ static void Widget_AdjustArea(	LCUI_Widget w, LCUI_Rect *in_rect,
 	out_rect->y += (box->y - w->box.graph.y);
 }
 
+/**
+ * 将无效区域记录到部件及其父级部件的图层缓存中
+ * @param[in] w		目标部件
+ * @param[in] rect	相对于部件图层的矩形区域
+ * @param[in] with_self	是否包括部件自身的图层
+ */
+static void Widget_InvalidateLayers( LCUI_Widget w, LCUI_Rect *rect,
+				     LCUI_BOOL with_self )
+{
+	LCUI_Rect r = *rect;
+	if( cache.layers.length < 1 ) {
+		return;
+	}
+	if( with_self && w->layer.mode != WLM_NONE &&
+	    Graph_IsValid( &w->graph ) ) {
+		Region_AddRect( &w->layer.dirty_rects, &r );
+	}
+	while( w->parent ) {
+		/* 转换为相对于父级部件内边距框的坐标 */
+		r.x += w->box.graph.x;
+		r.y += w->box.graph.y;
+		w = w->parent;
+		LCUIRect_ValidateArea( &r, w->box.padding.width,
+				       w->box.padding.height );
+		if( r.width <= 0 || r.height <= 0 ) {
+			break;
+		}
+		/* 转换为相对于父级部件图层的坐标 */
+		r.x += w->box.padding.x - w->box.graph.x;
+		r.y += w->box.padding.y - w->box.graph.y;
+		if( w->layer.mode == WLM_TREE && Graph_IsValid( &w->graph ) ) {
+			Region_AddRect( &w->layer.dirty_rects, &r );
+		}
+	}
+}
+
 void Widget_InvalidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type )
 {
 	LCUI_Rect rect;
 	Widget_AdjustArea( w, r, &rect, box_type );
 	DEBUG_MSG("[%s]: invalidRect:(%d,%d,%d,%d)\n", w->type, 
 		   rect.x, rect.y, rect.width, rect.height);
-	RectList_Add( &w->dirty_rects, &rect );
+	Region_AddRect( &w->dirty_rects, &rect );
+	Widget_InvalidateLayers( w, &rect, TRUE );
 	while( w = w->parent, w ) {
 		w->has_dirty_child = TRUE;
 	}
+	LCUIDisplay_RequestUpdate();
 }
 
 LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget, 
@@ -112,6 +243,8 @@ LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget,
 		w = root;
 	}
 	Widget_AdjustArea( w, r, &rect, box_type );
+	/* 部件自身的内容没有变化，只需更新父级部件的图层缓存 */
+	Widget_InvalidateLayers( w, &rect, FALSE );
 	rect.x += w->box.graph.x;
 	rect.y += w->box.graph.y;
 	while( w && w->parent ) {
@@ -132,13 +265,10 @@ LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget,
 int Widget_GetInvalidArea( LCUI_Widget widget, LCUI_Rect *area )
 {
 	LCUI_Rect *rect;
-	if( widget->dirty_rects.length <= 0 ) {
+	if( Region_IsEmpty( &widget->dirty_rects ) ) {
 		return -1;
 	}
-	rect = LinkedList_Get( &widget->dirty_rects, 0 );
-	if( !rect ) {
-		return -2;
-	}
+	rect = &widget->dirty_rects.rects[0];
 	DEBUG_MSG("p_rect: %d,%d,%d,%d\n", rect->x, rect->y, rect->w, rect->h);
 	*area = *rect;
 	return 0;
@@ -148,7 +278,7 @@ void Widget_ValidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type )
 {
 	LCUI_Rect rect;
 	Widget_AdjustArea( w, r, &rect, box_type );
-	RectList_Delete( &w->dirty_rects, &rect );
+	Region_Subtract( &w->dirty_rects, &rect );
 }
 
 /** 当前部件的绘制函数 */
@@ -162,16 +292,14 @@ static void Widget_OnPaint( LCUI_Widget w, LCUI_PaintContext paint )
 	s = &w->computed_style;
 	box.width = w->box.graph.width;
 	box.height = w->box.graph.height;
-	/* 如果是有位图缓存的话，则先清空缓存里的阴影区域 */
-	if( w->enable_graph ) {
-		Graph_ClearShadowArea( paint, &box, &s->shadow );
-	}
 	Graph_DrawBoxShadow( paint, &box, &s->shadow );
 	box.x = w->box.border.x - w->box.graph.x;
 	box.y = w->box.border.y - w->box.graph.y;
 	box.width = w->box.border.width;
 	box.height = w->box.border.height;
 	Graph_DrawBackground( paint, &box, &s->background );
+	/* 阴影不会绘制在边框区域内，所以这里只会裁剪掉圆角外的背景 */
+	Graph_ClipByBorder( paint, &box, &s->border, FALSE );
 	Graph_DrawBorder( paint, &box, &s->border );
 	Widget_Unlock( w );
 	if( w->proto && w->proto->paint ) {
@@ -179,42 +307,266 @@ static void Widget_OnPaint( LCUI_Widget w, LCUI_PaintContext paint )
 	}
 }
 
+static void Widget_RenderTree( LCUI_Widget w, LCUI_PaintContext paint,
+			      float opacity );
+
+/** 释放部件的图层位图，调用前需锁定 cache.mutex */
+static void Widget_FreeLayer( LCUI_Widget w )
+{
+	if( !Graph_IsValid( &w->graph ) ) {
+		return;
+	}
+	cache.used_bytes -= w->graph.mem_size;
+	LinkedList_Unlink( &cache.layers, &w->layer.node );
+	Region_Clear( &w->layer.dirty_rects );
+	Graph_Free( &w->graph );
+}
+
+/** 为部件分配图层位图，内存预算不足时记录所需的内存，留待下一帧腾出空间 */
+static int Widget_AllocLayer( LCUI_Widget w, int width, int height )
+{
+	int ret = -1;
+	LCUI_Rect rect;
+	size_t size = (size_t)width * height * sizeof( LCUI_ARGB );
+	LCUIMutex_Lock( &cache.mutex );
+	Widget_FreeLayer( w );
+	if( cache.used_bytes + size > cache.max_bytes ) {
+		/* 超出整个预算的图层不会被缓存 */
+		if( size <= cache.max_bytes ) {
+			cache.pending_bytes += size;
+		}
+	} else {
+		w->graph.color_type = COLOR_TYPE_ARGB;
+		if( Graph_Create( &w->graph, width, height ) == 0 ) {
+			cache.used_bytes += w->graph.mem_size;
+			LinkedList_AppendNode( &cache.layers, &w->layer.node );
+			rect.x = rect.y = 0;
+			rect.width = width;
+			rect.height = height;
+			Region_Union( &w->layer.dirty_rects, &rect );
+			ret = 0;
+		}
+	}
+	LCUIMutex_Unlock( &cache.mutex );
+	return ret;
+}
+
+/**
+ * 更新部件的图层缓存，重绘其中的无效区域
+ * 多个渲染线程可能同时访问同一个部件，所以整个过程需要锁定部件。
+ * @returns 图层缓存可用时返回 TRUE，否则返回 FALSE
+ */
+static LCUI_BOOL Widget_UpdateLayer( LCUI_Widget w )
+{
+	int i;
+	LCUI_PaintContextRec paint;
+	LCUI_BOOL is_valid = TRUE, is_hit = TRUE;
+	int width = w->box.graph.width, height = w->box.graph.height;
+
+	if( width <= 0 || height <= 0 ) {
+		return FALSE;
+	}
+	Widget_Lock( w );
+	if( !Graph_IsValid( &w->graph ) ||
+	    w->graph.width != width || w->graph.height != height ) {
+		is_valid = Widget_AllocLayer( w, width, height ) == 0;
+	}
+	if( is_valid && !Region_IsEmpty( &w->layer.dirty_rects ) ) {
+		is_hit = FALSE;
+		paint.with_alpha = TRUE;
+		/* 图层位图是持久的，其绘制过程不使用帧内的临时内存 */
+		paint.arena = NULL;
+		for( i = 0; i < w->layer.dirty_rects.length; ++i ) {
+			paint.rect = w->layer.dirty_rects.rects[i];
+			LCUIRect_ValidateArea( &paint.rect, width, height );
+			if( paint.rect.width <= 0 || paint.rect.height <= 0 ) {
+				continue;
+			}
+			Graph_Quote( &paint.canvas, &w->graph, &paint.rect );
+			Graph_FillRect( &paint.canvas, ARGB( 0, 0, 0, 0 ),
+					NULL, TRUE );
+			/* 图层中不包含部件自身的不透明度，混合时再应用 */
+			if( w->layer.mode == WLM_TREE ) {
+				Widget_RenderTree( w, &paint, 1.0 );
+			} else {
+				Widget_OnPaint( w, &paint );
+			}
+		}
+		Region_Clear( &w->layer.dirty_rects );
+	}
+	Widget_Unlock( w );
+	LCUIMutex_Lock( &cache.mutex );
+	if( is_valid && is_hit ) {
+		++cache.hits;
+	} else {
+		++cache.misses;
+	}
+	if( is_valid ) {
+		w->layer.last_used = cache.frame;
+	}
+	LCUIMutex_Unlock( &cache.mutex );
+	return is_valid;
+}
+
+/**
+ * 按照最近最少使用的顺序释放图层，直到满足内存预算
+ * 此时不能有正在进行的渲染，所以只在收集无效区域时调用。
+ */
+static void LCUIWidget_TrimLayers( void )
+{
+	LCUI_Widget w, target;
+	LinkedListNode *node;
+	LCUIMutex_Lock( &cache.mutex );
+	++cache.frame;
+	while( cache.used_bytes + cache.pending_bytes > cache.max_bytes ) {
+		target = NULL;
+		for( LinkedList_Each( node, &cache.layers ) ) {
+			w = node->data;
+			if( !target || (int)(w->layer.last_used -
+					     target->layer.last_used) < 0 ) {
+				target = w;
+			}
+		}
+		if( !target ) {
+			break;
+		}
+		Widget_FreeLayer( target );
+		++cache.evictions;
+	}
+	cache.pending_bytes = 0;
+	LCUIMutex_Unlock( &cache.mutex );
+}
+
+void Widget_SetLayerMode( LCUI_Widget w, int mode )
+{
+	if( !cache.is_inited ) {
+		w->layer.mode = mode;
+		return;
+	}
+	LCUIMutex_Lock( &cache.mutex );
+	if( w->layer.mode != mode ) {
+		Widget_FreeLayer( w );
+		w->layer.mode = mode;
+	}
+	LCUIMutex_Unlock( &cache.mutex );
+}
+
+void LCUIWidget_SetLayerCacheSize( size_t max_bytes )
+{
+	LCUIMutex_Lock( &cache.mutex );
+	cache.max_bytes = max_bytes;
+	LCUIMutex_Unlock( &cache.mutex );
+}
+
+void LCUIWidget_GetLayerStats( LCUI_WidgetLayerStats stats )
+{
+	LCUIMutex_Lock( &cache.mutex );
+	stats->hits = cache.hits;
+	stats->misses = cache.misses;
+	stats->evictions = cache.evictions;
+	stats->used_bytes = cache.used_bytes;
+	stats->max_bytes = cache.max_bytes;
+	stats->count = cache.layers.length;
+	LCUIMutex_Unlock( &cache.mutex );
+}
+
+void LCUIWidget_ResetLayerStats( void )
+{
+	LCUIMutex_Lock( &cache.mutex );
+	cache.hits = 0;
+	cache.misses = 0;
+	cache.evictions = 0;
+	LCUIMutex_Unlock( &cache.mutex );
+}
+
+void LCUIWidget_SetOcclusionCulling( LCUI_BOOL enable )
+{
+	stats.culling = enable;
+}
+
+unsigned long LCUIWidget_GetCulledCount( void )
+{
+	unsigned long count;
+	LCUIMutex_Lock( &cache.mutex );
+	count = stats.culls;
+	LCUIMutex_Unlock( &cache.mutex );
+	return count;
+}
+
+void LCUIWidget_ResetCulledCount( void )
+{
+	LCUIMutex_Lock( &cache.mutex );
+	stats.culls = 0;
+	LCUIMutex_Unlock( &cache.mutex );
+}
+
+void LCUIWidget_InitPaint( void )
+{
+	if( cache.is_inited ) {
+		return;
+	}
+	LinkedList_Init( &cache.layers );
+	LCUIMutex_Init( &cache.mutex );
+	cache.max_bytes = DEFAULT_LAYER_CACHE_SIZE;
+	cache.used_bytes = 0;
+	cache.pending_bytes = 0;
+	cache.frame = 0;
+	cache.hits = 0;
+	cache.misses = 0;
+	cache.evictions = 0;
+	cache.is_inited = TRUE;
+	stats.culls = 0;
+	LCUI_InitBoxShadow();
+	LCUI_InitBackground();
+	LCUI_InitBorder();
+}
+
+void LCUIWidget_ExitPaint( void )
+{
+	LinkedListNode *node, *next;
+	if( !cache.is_inited ) {
+		return;
+	}
+	LCUIMutex_Lock( &cache.mutex );
+	for( node = cache.layers.head.next; node; node = next ) {
+		next = node->next;
+		Widget_FreeLayer( node->data );
+	}
+	LCUIMutex_Unlock( &cache.mutex );
+	LCUI_ExitBoxShadow();
+	LCUI_ExitBackground();
+	LCUI_ExitBorder();
+}
+
 /**
  * 处理部件无效区域
  * @param[in] w 部件
  * @param[in] x 当前部件的绝对 X 坐标
  * @param[in] y 当前部件的绝对 Y 坐标
  * @param[in] valid_box 当前部件内的有效框
- * @param[out] rlist 收集到的无效区域列表
+ * @param[out] region 收集到的无效区域
  */
 static int _Widget_ProcInvalidArea( LCUI_Widget w, int x, int y, 
 				    LCUI_Rect *valid_box, 
-				    LinkedList *rlist )
+				    LCUI_Region region )
 {
-	int count;
+	int i, count;
 	LCUI_Widget child;
 	LinkedListNode *node;
-	LCUI_Rect rect, child_box, *r;
+	LCUI_Rect rect, child_box;
 	count = w->dirty_rects.length;
 	/* 取出当前记录的无效区域 */
-	for( LinkedList_Each( node, &w->dirty_rects ) ) {
-		r = node->data;
-		/* 若有独立位图缓存，则重绘脏矩形区域 */
-		if( w->enable_graph && Graph_IsValid( &w->graph ) ) {
-			LCUI_PaintContextRec paint;
-			paint.rect = *r;
-			Graph_Quote( &paint.canvas, &w->graph, &paint.rect );
-			Widget_OnPaint( w, &paint );
-		}
+	for( i = 0; i < w->dirty_rects.length; ++i ) {
 		/* 取出与容器内有效区域相交的区域 */
-		if( LCUIRect_GetOverlayRect( r, valid_box, &rect ) ) {
+		if( LCUIRect_GetOverlayRect( &w->dirty_rects.rects[i],
+					     valid_box, &rect ) ) {
 			/* 转换成绝对坐标 */
 			rect.x += x;
 			rect.y += y;
-			RectList_Add( rlist, &rect );
+			Region_AddRect( region, &rect );
 		}
 	}
-	RectList_Clear( &w->dirty_rects );
+	Region_Clear( &w->dirty_rects );
 	/* 若子级部件没有脏矩形记录 */
 	if( !w->has_dirty_child ) {
 		return count;
@@ -247,20 +599,21 @@ static int _Widget_ProcInvalidArea( LCUI_Widget w, int x, int y,
 		child_box.x -= w->box.padding.x - w->box.graph.x;
 		child_box.y -= w->box.padding.y - w->box.graph.y;
 		count += _Widget_ProcInvalidArea( child, child_x, child_y, 
-						  &child_box, rlist );
+						  &child_box, region );
 	}
 	w->has_dirty_child = FALSE;
 	return count;
 }
 
-int Widget_ProcInvalidArea( LCUI_Widget w, LinkedList *rlist )
+int Widget_ProcInvalidArea( LCUI_Widget w, LCUI_Region region )
 {
 	LCUI_Rect valid_box;
 	valid_box.x = 0;
 	valid_box.y = 0;
 	valid_box.w = w->box.graph.w;
 	valid_box.h = w->box.graph.h;
-	return _Widget_ProcInvalidArea( w, 0, 0, &valid_box, rlist );
+	LCUIWidget_TrimLayers();
+	return _Widget_ProcInvalidArea( w, 0, 0, &valid_box, region );
 }
 
 int Widget_ConvertArea( LCUI_Widget w, LCUI_Rect *in_rect,
@@ -315,47 +668,164 @@ int Widget_ConvertArea( LCUI_Widget w, LCUI_Rect *in_rect,
 	return 0;
 }
 
-void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
+/**
+ * 从顶到底分析子部件的遮挡关系
+ * 上层子部件的不透明区域会被累积起来，若某个子部件需要绘制的区域已被完全覆盖，
+ * 则它和它的子级部件都不需要绘制。
+ * @param[in] w			部件
+ * @param[in] paint		进行绘制时所需的上下文
+ * @param[in] content_rect	内容框中需要绘制的区域，相对于脏矩形
+ * @param[out] opaque		子部件的不透明区域，相对于脏矩形
+ * @param[out] culled		按从顶到底的顺序记录每个子部件是否被完全遮挡
+ * @returns 被完全遮挡的子部件数量
+ */
+static int Widget_CullChildren( LCUI_Widget w, LCUI_PaintContext paint,
+				const LCUI_Rect *content_rect,
+				LCUI_Region opaque, LCUI_BOOL *culled )
+{
+	int i = 0, count = 0;
+	LinkedListNode *node;
+	LCUI_Rect child_rect, rect;
+	int content_left = w->box.padding.x - w->box.graph.x - paint->rect.x;
+	int content_top = w->box.padding.y - w->box.graph.y - paint->rect.y;
+
+	LinkedList_ForEach( node, &w->children_show ) {
+		LCUI_Widget child = node->data;
+		culled[i++] = FALSE;
+		if( !child->computed_style.visible ||
+		    child->state != WSTATE_NORMAL ) {
+			continue;
+		}
+		child_rect = child->box.graph;
+		child_rect.x += content_left;
+		child_rect.y += content_top;
+		if( !LCUIRect_GetOverlayRect( content_rect, &child_rect,
+					      &rect ) ) {
+			continue;
+		}
+		if( Region_GetAreaIn( opaque, &rect ) >=
+		    rect.width * rect.height ) {
+			culled[i - 1] = TRUE;
+			++count;
+			continue;
+		}
+		if( !Widget_GetOpaqueRect( child, &rect ) ) {
+			continue;
+		}
+		rect.x += child_rect.x;
+		rect.y += child_rect.y;
+		/* 子部件的内容不会超出父部件的内容框 */
+		if( LCUIRect_GetOverlayRect( content_rect, &rect, &rect ) ) {
+			Region_Union( opaque, &rect );
+		}
+	}
+	return count;
+}
+
+/**
+ * 渲染部件及其子级部件
+ * @param[in] w		部件
+ * @param[in] paint	进行绘制时所需的上下文
+ * @param[in] opacity	部件图层的不透明度
+ */
+static void Widget_RenderTree( LCUI_Widget w, LCUI_PaintContext paint,
+			      float opacity )
 {
 	LinkedListNode *node;
 	int content_left, content_top;
 	LCUI_PaintContextRec self_paint;
 	LCUI_PaintContextRec child_paint;
-	LCUI_Rect canvas_rect, content_rect;
+	LCUI_Rect canvas_rect, content_rect, border_rect;
 	LCUI_Graph content_graph, self_graph, layer_graph;
 	LCUI_BOOL has_overlay, has_content_graph = FALSE,
 		has_self_graph = FALSE, has_layer_graph = FALSE,
-		is_cover_border = FALSE, is_paintable;
+		is_cover_border = FALSE, is_paintable, is_covered = FALSE;
+	LCUI_BOOL culled_buf[CULL_STACK_SIZE], *culled = NULL;
+	LCUI_RegionRec opaque;
+	int i, n_culled = 0;
 
 	Graph_Init( &self_graph );
 	Graph_Init( &layer_graph );
 	Graph_Init( &content_graph );
-	layer_graph.color_type = COLOR_TYPE_ARGB;
 	/* 若部件本身是透明的 */
-	if( w->computed_style.opacity < 1.0 ) {
+	if( opacity < 1.0 ) {
 		has_self_graph = TRUE;
 		has_content_graph = TRUE;
 		has_layer_graph = TRUE;
-	} else {
-		/* 若使用了圆角边框，则判断当前脏矩形区域是否在圆角边框内
-		...
-		if( ... ) {
+	}
+	/* 计算内容框相对于图层的坐标 */
+	content_left = w->box.padding.x - w->box.graph.x;
+	content_top = w->box.padding.y - w->box.graph.y;
+	/* 获取内容框 */
+	content_rect.x = content_left;
+	content_rect.y = content_top;
+	content_rect.width = w->box.padding.width;
+	content_rect.height = w->box.padding.height;
+	/* 获取内容框与脏矩形重叠的区域 */
+	has_overlay = LCUIRect_GetOverlayRect(
+		&content_rect, &paint->rect, &content_rect
+	);
+	/* 将重叠区域的坐标转换为相对于脏矩形的坐标 */
+	content_rect.x -= paint->rect.x;
+	content_rect.y -= paint->rect.y;
+	/* 获取边框相对于图层的区域 */
+	border_rect.x = w->box.border.x - w->box.graph.x;
+	border_rect.y = w->box.border.y - w->box.graph.y;
+	border_rect.width = w->box.border.width;
+	border_rect.height = w->box.border.height;
+	/* 若内容框中需要绘制的区域与圆角重叠，则需要先将子部件绘制到内容位图
+	 * 上，裁剪掉圆角外的部分后再混合 */
+	if( has_overlay && w->children_show.length > 0 ) {
+		LCUI_Rect rect = content_rect;
+		rect.x += paint->rect.x;
+		rect.y += paint->rect.y;
+		if( Border_IsCoverCorner( &border_rect,
+					  &w->computed_style.border, &rect ) ) {
 			has_content_graph = TRUE;
 			is_cover_border = TRUE;
 		}
-		*/
+	}
+	Region_Init( &opaque );
+	if( has_overlay && stats.culling && w->children_show.length > 0 ) {
+		size_t size = sizeof( LCUI_BOOL ) * w->children_show.length;
+		culled = culled_buf;
+		if( w->children_show.length > CULL_STACK_SIZE ) {
+			culled = NULL;
+			if( paint->arena ) {
+				culled = Arena_Alloc( paint->arena, size );
+			}
+			if( !culled ) {
+				culled = malloc( size );
+			}
+		}
+	}
+	if( culled ) {
+		LCUI_Rect rect;
+		n_culled = Widget_CullChildren( w, paint, &content_rect,
+						&opaque, culled );
+		/* 若脏矩形已被子部件完全覆盖，则部件自身也不需要绘制，但子部件
+		 * 被圆角裁剪后会露出部件自身的背景 */
+		rect.x = rect.y = 0;
+		rect.width = paint->rect.width;
+		rect.height = paint->rect.height;
+		is_covered = !has_self_graph && !is_cover_border &&
+			Region_GetAreaIn( &opaque, &rect ) >=
+			rect.width * rect.height;
 	}
 	is_paintable = Widget_IsPaintable( w );
 	/* 如果部件有需要绘制的内容 */
-	if( is_paintable ) {
-		if( w->enable_graph && Graph_IsValid( &w->graph ) ) {
+	if( is_paintable && is_covered ) {
+		++n_culled;
+	} else if( is_paintable ) {
+		if( w->layer.mode == WLM_SELF && Widget_UpdateLayer( w ) ) {
 			Graph_Quote( &self_graph, &w->graph, &paint->rect );
 		} else {
-			self_graph.color_type = COLOR_TYPE_ARGB;
-			Graph_Create( &self_graph, paint->rect.width,
-				      paint->rect.height );
+			Paint_CreateGraph( paint, &self_graph, paint->rect.width,
+					   paint->rect.height );
 			self_paint.canvas = self_graph;
 			self_paint.rect = paint->rect;
+			self_paint.arena = paint->arena;
+			self_paint.with_alpha = TRUE;
 			Widget_OnPaint( w, &self_paint );
 		}
 		/* 若不需要缓存自身位图则直接绘制到画布上 */
@@ -364,39 +834,29 @@ void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
 				   0, 0, paint->with_alpha );
 		}
 	}
-	/* 计算内容框相对于图层的坐标 */
-	content_left = w->box.padding.x - w->box.graph.x;
-	content_top = w->box.padding.y - w->box.graph.y;
-	/* 获取内容框 */
-	content_rect.x = content_left;
-	content_rect.y = content_top;
-	content_rect.width = w->box.padding.width;
-	content_rect.height = w->box.padding.height;
-	/* 获取内容框与脏矩形重叠的区域 */
-	has_overlay = LCUIRect_GetOverlayRect(
-		&content_rect, &paint->rect, &content_rect
-	);
 	/* 如果没有与内容框重叠，则跳过内容绘制 */
 	if( !has_overlay ) {
 		goto content_paint_done;
 	}
-	/* 将重叠区域的坐标转换为相对于脏矩形的坐标 */
-	content_rect.x -= paint->rect.x;
-	content_rect.y -= paint->rect.y;
 	/* 若需要部件内容区的位图缓存 */
 	if( has_content_graph ) {
 		child_paint.with_alpha = TRUE;
-		content_graph.color_type = COLOR_TYPE_ARGB;
-		Graph_Create( &content_graph, content_rect.w, content_rect.h );
+		Paint_CreateGraph( paint, &content_graph,
+				   content_rect.w, content_rect.h );
 	} else {
 		child_paint.with_alpha = paint->with_alpha;
 		/* 引用该区域的位图，作为内容框的位图 */
 		Graph_Quote( &content_graph, &paint->canvas, &content_rect );
 	}
+	child_paint.arena = paint->arena;
 	/* 按照显示顺序，从底到顶，递归遍历子级部件 */
+	i = w->children_show.length;
 	LinkedList_ForEachReverse( node, &w->children_show ) {
 		LCUI_Rect child_rect;
 		LCUI_Widget child = node->data;
+		if( culled && culled[--i] ) {
+			continue;
+		}
 		if( !child->computed_style.visible || 
 		    child->state != WSTATE_NORMAL ) {
 			continue;
@@ -430,7 +890,15 @@ void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
 	}
 	/* 如果与圆角边框重叠，则裁剪掉边框外的内容 */
 	if( is_cover_border ) {
-		/* content_graph ... */
+		LCUI_PaintContextRec content_paint;
+		content_paint.canvas = content_graph;
+		content_paint.rect = content_rect;
+		content_paint.rect.x += paint->rect.x;
+		content_paint.rect.y += paint->rect.y;
+		content_paint.with_alpha = TRUE;
+		content_paint.arena = paint->arena;
+		Graph_ClipByBorder( &content_paint, &border_rect,
+				    &w->computed_style.border, TRUE );
 	}
 
 content_paint_done:
@@ -439,25 +907,49 @@ content_paint_done:
 	 * 前部件的图层，然后将该图层混合到输出的位图中
 	 */
 	if( has_layer_graph ) {
+		Paint_CreateGraph( paint, &layer_graph, paint->rect.width,
+				   paint->rect.height );
 		if( is_paintable ) {
-			Graph_Copy( &layer_graph, &self_graph );
+			Graph_Replace( &layer_graph, &self_graph, 0, 0 );
 			Graph_Mix( &layer_graph, &content_graph,
 				   content_rect.x, content_rect.y, TRUE );
 		} else {
-			Graph_Create( &layer_graph, paint->rect.width, 
-				      paint->rect.height );
 			Graph_Replace( &layer_graph, &content_graph, 
 				       content_rect.x, content_rect.y );
 		}
-		layer_graph.opacity = w->computed_style.opacity;
+		layer_graph.opacity = opacity;
 		Graph_Mix( &paint->canvas, &layer_graph, 
 			   0, 0, paint->with_alpha );
 	}
 	else if( has_content_graph ) {
 		Graph_Mix( &paint->canvas, &content_graph,
-			   content_rect.x, content_rect.y, TRUE );
+			   content_rect.x, content_rect.y, paint->with_alpha );
+	}
+	Paint_FreeGraph( paint, &layer_graph );
+	Paint_FreeGraph( paint, &self_graph );
+	Paint_FreeGraph( paint, &content_graph );
+	Region_Destroy( &opaque );
+	if( culled && culled != culled_buf && !(paint->arena &&
+	    Arena_Contains( paint->arena, culled )) ) {
+		free( culled );
+	}
+	if( n_culled > 0 ) {
+		LCUIMutex_Lock( &cache.mutex );
+		stats.culls += n_culled;
+		LCUIMutex_Unlock( &cache.mutex );
+	}
+}
+
+void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
+{
+	LCUI_Graph layer;
+	/* 若有可用的图层缓存，则直接将它混合到画布上 */
+	if( w->layer.mode == WLM_TREE && Widget_UpdateLayer( w ) ) {
+		Graph_Init( &layer );
+		Graph_Quote( &layer, &w->graph, &paint->rect );
+		layer.opacity = w->computed_style.opacity;
+		Graph_Mix( &paint->canvas, &layer, 0, 0, paint->with_alpha );
+		return;
 	}
-	Graph_Free( &layer_graph );
-	Graph_Free( &self_graph );
-	Graph_Free( &content_graph );
+	Widget_RenderTree( w, paint, w->computed_style.opacity );
 }
@@ -51,6 +51,9 @@ typedef struct {
 	LCUI_BOOL is_valid;
 } TaskMap;
 
+/** 样式表共享情况的统计 */
+static LCUI_WidgetStyleStatsRec style_stats;
+
 /** 部件的缺省样式 */
 const char *global_css = ToString(
 
@@ -129,6 +132,155 @@ LCUI_Selector Widget_GetSelector( LCUI_Widget w )
 	return s;
 }
 
+static unsigned int HashString( unsigned int hash, const char *str )
+{
+	const unsigned char *p = (const unsigned char*)str;
+	while( *p ) {
+		hash = ((hash << 5) + hash) + (*p++);
+	}
+	return hash;
+}
+
+static int CompareString( const void *a, const void *b )
+{
+	return strcmp( *(char**)a, *(char**)b );
+}
+
+/** 按字母顺序计算名称列表的哈希值，与选择器结点中的全名的顺序一致 */
+static int HashSortedNames( unsigned int *hash, char **names,
+			    const char *prefix )
+{
+	int i, n;
+	char *sorted[MAX_SELECTOR_DEPTH];
+	for( n = 0; names[n]; ++n ) {
+		if( n >= MAX_SELECTOR_DEPTH ) {
+			return -1;
+		}
+		sorted[n] = names[n];
+	}
+	qsort( sorted, n, sizeof( char* ), CompareString );
+	for( i = 0; i < n; ++i ) {
+		*hash = HashString( *hash, prefix );
+		*hash = HashString( *hash, sorted[i] );
+	}
+	return 0;
+}
+
+/**
+ * 计算部件的选择器的哈希值
+ * 结果与 Widget_GetSelector() 生成的选择器的哈希值相同，但不需要创建选择器
+ * @returns 正常返回 0，部件层级过深或名称过多时返回 -1
+ */
+static int Widget_GetSelectorHash( LCUI_Widget w, unsigned int *hash )
+{
+	int depth = 0, ret = 0;
+	LCUI_Widget parent, path[MAX_SELECTOR_DEPTH];
+	for( parent = w; parent; parent = parent->parent ) {
+		if( parent->id || parent->type ||
+		    parent->classes || parent->status ) {
+			if( depth >= MAX_SELECTOR_DEPTH - 1 ) {
+				return -1;
+			}
+			path[depth++] = parent;
+		}
+	}
+	*hash = 5381;
+	while( --depth >= 0 && ret == 0 ) {
+		parent = path[depth];
+		Widget_Lock( parent );
+		if( parent->type ) {
+			*hash = HashString( *hash, parent->type );
+		}
+		if( parent->id ) {
+			*hash = HashString( *hash, "#" );
+			*hash = HashString( *hash, parent->id );
+		}
+		if( parent->classes ) {
+			ret = HashSortedNames( hash, parent->classes, "." );
+		}
+		if( parent->status && ret == 0 ) {
+			ret = HashSortedNames( hash, parent->status, ":" );
+		}
+		Widget_Unlock( parent );
+	}
+	return ret;
+}
+
+static size_t StyleSheet_GetSize( LCUI_StyleSheet ss )
+{
+	return sizeof( LCUI_StyleSheetRec ) + sizeof( LCUI_StyleRec ) * ss->length;
+}
+
+/**
+ * 统计部件共享的样式表
+ * 继承得到的样式表在获取到指纹后就是样式库缓存的，当没有自定义样式时，
+ * 部件的最终样式表与继承得到的样式表也是同一份。指纹为 0 时，继承得到的
+ * 样式表是部件私有的，不算作共享；引用次数不多于部件自己持有的次数时，
+ * 也没有被样式库或其它部件共享。
+ * 引用次数会随其它部件变化，所以移除时按记录的次数移除，以免统计出现偏差。
+ * @param[in] is_add 为 TRUE 时计入统计，否则从统计中移除
+ */
+static void Widget_CountSharedStyle( LCUI_Widget w, LCUI_BOOL is_add )
+{
+	int n;
+	size_t size;
+	if( !is_add ) {
+		n = w->shared_styles;
+		size = StyleSheet_GetSize( w->inherited_style );
+		style_stats.shared -= n;
+		style_stats.saved_bytes -= size * n;
+		w->shared_styles = 0;
+		return;
+	}
+	if( w->style_fingerprint == 0 ) {
+		return;
+	}
+	n = w->style == w->inherited_style ? 2 : 1;
+	if( w->inherited_style->refs <= n ) {
+		return;
+	}
+	size = StyleSheet_GetSize( w->inherited_style );
+	style_stats.shared += n;
+	style_stats.saved_bytes += size * n;
+	w->shared_styles = n;
+}
+
+/** 判断部件是否有自定义样式 */
+static LCUI_BOOL Widget_HasCustomStyle( LCUI_Widget w )
+{
+	int i;
+	for( i = 0; i < w->custom_style->length; ++i ) {
+		if( w->custom_style->sheet[i].is_valid ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/** 更新部件继承的样式表，如果样式表的指纹没有变化，则不用重新获取 */
+static void Widget_UpdateInheritStyle( LCUI_Widget w )
+{
+	unsigned int hash;
+	LCUI_Selector s;
+	LCUI_StyleSheet ss;
+	if( w->style_fingerprint > 0 &&
+	    Widget_GetSelectorHash( w, &hash ) == 0 &&
+	    LCUI_CheckStyleSheet( hash, w->style_fingerprint ) ) {
+		return;
+	}
+	s = Widget_GetSelector( w );
+	if( !s ) {
+		return;
+	}
+	/* 直接引用样式库缓存的样式表，选择器相同的部件共用同一份 */
+	Widget_CountSharedStyle( w, FALSE );
+	ss = LCUI_GetSharedStyleSheet( s, &w->style_fingerprint );
+	StyleSheet_Delete( w->inherited_style );
+	w->inherited_style = ss;
+	Widget_CountSharedStyle( w, TRUE );
+	Selector_Delete( s );
+}
+
 int Widget_HandleChildrenStyleChange( LCUI_Widget w, int type, const char *name )
 {
 	LCUI_Selector s;
@@ -227,16 +379,29 @@ void Widget_ExecUpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all )
 	};
 
 	if( is_update_all ) {
-		Widget_GetInheritStyle( w, w->inherited_style );
+		Widget_UpdateInheritStyle( w );
 	}
 	ss = w->style;
-	w->style = StyleSheet();
-	StyleSheet_Merge( w->style, w->custom_style );
-	StyleSheet_Merge( w->style, w->inherited_style );
+	Widget_CountSharedStyle( w, FALSE );
+	if( Widget_HasCustomStyle( w ) ) {
+		/* 有自定义样式时才需要一份独立的样式表 */
+		w->style = StyleSheet();
+		StyleSheet_Merge( w->style, w->custom_style );
+		StyleSheet_Merge( w->style, w->inherited_style );
+	} else {
+		w->style = StyleSheet_Ref( w->inherited_style );
+	}
+	Widget_CountSharedStyle( w, TRUE );
+	if( w->style == ss ) {
+		/* 共享的样式表没有变化，不需要对比 */
+		StyleSheet_Delete( ss );
+		return;
+	}
 	/* 对比两张样式表，确定哪些需要更新 */
 	for( key = 0; key < w->style->length; ++key ) {
 		s = &w->style->sheet[key];
-		if( ss->sheet[key].is_valid == s->is_valid &&
+		if( key < ss->length &&
+		    ss->sheet[key].is_valid == s->is_valid &&
 		    ss->sheet[key].type == s->type &&
 		    ss->sheet[key].value == s->value ) {
 			continue;
@@ -263,6 +428,22 @@ void Widget_ExecUpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all )
 	StyleSheet_Delete( ss );
 }
 
+void Widget_DestroyStyle( LCUI_Widget w )
+{
+	Widget_CountSharedStyle( w, FALSE );
+	StyleSheet_Delete( w->inherited_style );
+	StyleSheet_Delete( w->custom_style );
+	StyleSheet_Delete( w->style );
+	w->inherited_style = NULL;
+	w->custom_style = NULL;
+	w->style = NULL;
+}
+
+void LCUIWidget_GetStyleStats( LCUI_WidgetStyleStats stats )
+{
+	*stats = style_stats;
+}
+
 void LCUIWidget_InitStyle( void )
 {
 
@@ -41,6 +41,7 @@
 #include <stdlib.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/display.h>
 #include <LCUI/gui/widget.h>
 
 /** 部件任务模块数据 */
@@ -48,6 +49,7 @@ static struct WidgetTaskModule {
 	size_t count;					/**< 当前已处理的部件数量 */
 	int64_t timeout;				/**< 超时时间点 */
 	LCUI_BOOL is_timeout;				/**< 是否已经超时 */
+	int64_t layout_time;				/**< 布局耗时（纳秒） */
 	LinkedList trash;				/**< 待删除的部件列表 */
 	LCUI_WidgetFunction handlers[WTT_TOTAL_NUM];	/**< 任务处理器 */
 } self;
@@ -118,6 +120,7 @@ void Widget_AddTask( LCUI_Widget widget, int task )
 		widget->task.for_children = TRUE;
 		widget = widget->parent;
 	}
+	LCUIDisplay_RequestUpdate();
 }
 
 /** 映射任务处理器 */
@@ -187,7 +190,14 @@ int Widget_UpdateEx( LCUI_Widget w, LCUI_BOOL has_timeout )
 	for( i = 0; i < WTT_USER; ++i ) {
 		if( buffer[i] ) {
 			buffer[i] = FALSE;
-			if( self.handlers[i] ) {
+			if( !self.handlers[i] ) {
+				continue;
+			}
+			if( i == WTT_LAYOUT ) {
+				int64_t t = LCUI_GetTimeNS();
+				self.handlers[i]( w );
+				self.layout_time += LCUI_GetTimeDeltaNS( t );
+			} else {
 				self.handlers[i]( w );
 			}
 		} else {
@@ -250,6 +260,7 @@ void LCUIWidget_StepTask( void )
 	LinkedListNode *node;
 	self.is_timeout = FALSE;
 	self.timeout = LCUI_GetTime() + 20;
+	self.layout_time = 0;
 	root = LCUIWidget_GetRoot();
 	while( !self.is_timeout && Widget_UpdateEx( root, TRUE ) );
 	/* 删除无用部件 */
@@ -261,3 +272,8 @@ void LCUIWidget_StepTask( void )
 		node = next;
 	}
 }
+
+int64_t LCUIWidget_GetLayoutTime( void )
+{
+	return self.layout_time;
+}
@@ -58,6 +58,27 @@
 #define STATE_ACTIVE 1
 #define STATE_KILLED 0
 
+#define TASK_QUEUE_SIZE		1024
+#define TASK_QUEUE_MASK		(TASK_QUEUE_SIZE - 1)
+/** 每次分发任务的时间预算（单位：纳秒），超出后留到下次再处理 */
+#define TASK_DISPATCH_TIME	10000000
+
+#ifdef LCUI_BUILD_IN_WIN32
+#include <Windows.h>
+#define AtomicLoad(P) InterlockedCompareExchange( (P), 0, 0 )
+#define AtomicStore(P, V) InterlockedExchange( (P), (V) )
+#define AtomicExchange(P, V) InterlockedExchange( (P), (V) )
+#define AtomicAdd(P, V) InterlockedExchangeAdd( (P), (V) )
+#define AtomicCAS(P, OLD, V) \
+	(InterlockedCompareExchange( (P), (V), (OLD) ) == (OLD))
+#else
+#define AtomicLoad(P) __atomic_load_n( (P), __ATOMIC_SEQ_CST )
+#define AtomicStore(P, V) __atomic_store_n( (P), (V), __ATOMIC_SEQ_CST )
+#define AtomicExchange(P, V) __atomic_exchange_n( (P), (V), __ATOMIC_SEQ_CST )
+#define AtomicAdd(P, V) __atomic_fetch_add( (P), (V), __ATOMIC_SEQ_CST )
+#define AtomicCAS(P, OLD, V) __sync_bool_compare_and_swap( (P), (OLD), (V) )
+#endif
+
 /** 主循环的状态 */
 enum MainLoopState {
 	STATE_PAUSED,
@@ -76,6 +97,13 @@ typedef struct SysEventPackRec_ {
 	void *arg;
 } SysEventPackRec, *SysEventPack;
 
+/** 任务队列中的单元 */
+typedef struct TaskCellRec_ {
+	volatile long sequence;		/**< 序号，用于判断单元是否可读写 */
+	int64_t time;			/**< 任务被添加时的时间 */
+	LCUI_AppTaskRec task;		/**< 任务数据 */
+} TaskCellRec, *TaskCell;
+
 /** LCUI 系统相关数据 */
 static struct LCUI_System {
 	LCUI_BOOL is_inited;		/**< 标志，指示LCUI是否初始化过 */
@@ -97,10 +125,22 @@ static struct LCUI_App {
 	LCUI_AppDriver driver;		/**< 程序事件驱动支持 */
 	LCUI_BOOL driver_ready;		/**< 事件驱动支持是否已经准备就绪 */
 	struct LCUI_AppTaskAgent {
-		int state;		/**< 状态 */
-		LinkedList tasks;	/**< 任务队列 */
-		LCUI_Mutex mutex;	/**< 互斥锁 */
-		LCUI_Cond cond;		/**< 条件变量 */
+		int state;			/**< 状态 */
+		TaskCell cells;			/**< 任务队列的环形缓冲区 */
+		volatile long enqueue_pos;	/**< 下一个写入位置 */
+		volatile long dequeue_pos;	/**< 下一个读取位置 */
+		volatile long n_overflow;	/**< 溢出列表中的任务数量 */
+		volatile long is_waiting;	/**< 主循环是否在等待任务 */
+		volatile long is_notified;	/**< 是否已经通知过事件驱动 */
+		volatile long posted;		/**< 已添加的任务数量 */
+		volatile long overflows;	/**< 进入过溢出列表的任务数量 */
+		unsigned long dispatched;	/**< 已执行的任务数量 */
+		size_t max_depth;		/**< 观察到的最大排队数量 */
+		int64_t total_latency;		/**< 任务的累计等待时间 */
+		int64_t max_latency;		/**< 任务的最大等待时间 */
+		LinkedList overflow;		/**< 缓冲区已满时暂存任务的列表 */
+		LCUI_Mutex mutex;		/**< 互斥锁 */
+		LCUI_Cond cond;			/**< 条件变量 */
 	} agent;
 } MainApp = { 0 };
 
@@ -208,23 +248,187 @@ void LCUI_DestroyEvent( LCUI_SysEvent e )
 
 /*--------------------------- system event <END> ----------------------------*/
 
-void LCUI_DispatchEvent( void )
+/*---------------------------- task queue <START> ---------------------------*/
+
+/**
+ * 初始化任务队列
+ * 任务队列是一个有界的多生产者环形缓冲区，每个单元都有一个序号，写入者和读取
+ * 者通过比较序号与自己领取到的位置来判断单元是否可用，不需要加锁。缓冲区满了
+ * 之后，新任务会暂存到溢出列表中，直到溢出列表被清空为止，以保证任务的顺序。
+ */
+static void TaskQueue_Init( void )
+{
+	long i;
+	if( MainApp.agent.cells ) {
+		return;
+	}
+	MainApp.agent.cells = NEW( TaskCellRec, TASK_QUEUE_SIZE );
+	for( i = 0; i < TASK_QUEUE_SIZE; ++i ) {
+		MainApp.agent.cells[i].sequence = i;
+	}
+	MainApp.agent.enqueue_pos = 0;
+	MainApp.agent.dequeue_pos = 0;
+	MainApp.agent.n_overflow = 0;
+	MainApp.agent.is_waiting = 0;
+	MainApp.agent.is_notified = 0;
+	LinkedList_Init( &MainApp.agent.overflow );
+	LCUIMutex_Init( &MainApp.agent.mutex );
+	LCUICond_Init( &MainApp.agent.cond );
+}
+
+/** 计算序号之差，按无符号数相减以免序号回绕后比较出错 */
+static long TaskQueue_Diff( long a, long b )
+{
+	return (long)((unsigned long)a - (unsigned long)b);
+}
+
+static LCUI_BOOL TaskQueue_Push( LCUI_AppTask task )
+{
+	long pos, seq;
+	TaskCell cell;
+
+	/* 溢出列表中还有任务时，新任务需要排在它们后面 */
+	if( AtomicLoad( &MainApp.agent.n_overflow ) == 0 ) {
+		pos = AtomicLoad( &MainApp.agent.enqueue_pos );
+		while( 1 ) {
+			cell = &MainApp.agent.cells[pos & TASK_QUEUE_MASK];
+			seq = AtomicLoad( &cell->sequence );
+			if( seq == pos ) {
+				if( AtomicCAS( &MainApp.agent.enqueue_pos,
+					       pos, pos + 1 ) ) {
+					cell->task = *task;
+					cell->time = LCUI_GetTimeNS();
+					AtomicStore( &cell->sequence, pos + 1 );
+					return TRUE;
+				}
+			} else if( TaskQueue_Diff( seq, pos ) < 0 ) {
+				/* 该单元还没被读取，说明缓冲区已满 */
+				break;
+			}
+			pos = AtomicLoad( &MainApp.agent.enqueue_pos );
+		}
+	}
+	cell = NEW( TaskCellRec, 1 );
+	if( !cell ) {
+		return FALSE;
+	}
+	cell->task = *task;
+	cell->time = LCUI_GetTimeNS();
+	LCUIMutex_Lock( &MainApp.agent.mutex );
+	LinkedList_Append( &MainApp.agent.overflow, cell );
+	AtomicAdd( &MainApp.agent.n_overflow, 1 );
+	AtomicAdd( &MainApp.agent.overflows, 1 );
+	LCUIMutex_Unlock( &MainApp.agent.mutex );
+	return TRUE;
+}
+
+static LCUI_BOOL TaskQueue_Pop( TaskCell out )
 {
-	LCUI_AppTask task;
+	long pos, seq;
+	TaskCell cell;
 	LinkedListNode *node;
+
+	pos = AtomicLoad( &MainApp.agent.dequeue_pos );
+	while( 1 ) {
+		cell = &MainApp.agent.cells[pos & TASK_QUEUE_MASK];
+		seq = AtomicLoad( &cell->sequence );
+		if( seq == pos + 1 ) {
+			if( AtomicCAS( &MainApp.agent.dequeue_pos,
+				       pos, pos + 1 ) ) {
+				*out = *cell;
+				AtomicStore( &cell->sequence,
+					     pos + TASK_QUEUE_SIZE );
+				return TRUE;
+			}
+		} else if( TaskQueue_Diff( seq, pos + 1 ) < 0 ) {
+			/* 缓冲区是空的 */
+			break;
+		}
+		pos = AtomicLoad( &MainApp.agent.dequeue_pos );
+	}
+	if( AtomicLoad( &MainApp.agent.n_overflow ) == 0 ) {
+		return FALSE;
+	}
 	LCUIMutex_Lock( &MainApp.agent.mutex );
-	node = LinkedList_GetNode( &MainApp.agent.tasks, 0 );
-	if( node ) {
-		task = node->data;
-		LinkedList_Unlink( &MainApp.agent.tasks, node );
+	node = LinkedList_GetNode( &MainApp.agent.overflow, 0 );
+	if( !node ) {
 		LCUIMutex_Unlock( &MainApp.agent.mutex );
-		LCUI_RunTask( task );
-		LCUI_DeleteTask( task );
-		free( task );
-		free( node );
+		return FALSE;
+	}
+	LinkedList_Unlink( &MainApp.agent.overflow, node );
+	AtomicAdd( &MainApp.agent.n_overflow, -1 );
+	LCUIMutex_Unlock( &MainApp.agent.mutex );
+	cell = node->data;
+	*out = *cell;
+	free( cell );
+	free( node );
+	return TRUE;
+}
+
+static LCUI_BOOL TaskQueue_IsEmpty( void )
+{
+	long pos;
+	TaskCell cell;
+	pos = AtomicLoad( &MainApp.agent.dequeue_pos );
+	cell = &MainApp.agent.cells[pos & TASK_QUEUE_MASK];
+	if( AtomicLoad( &cell->sequence ) == pos + 1 ) {
+		return FALSE;
+	}
+	return AtomicLoad( &MainApp.agent.n_overflow ) == 0;
+}
+
+/** 获取当前排队中的任务数量 */
+static size_t TaskQueue_GetDepth( void )
+{
+	long n;
+	n = AtomicLoad( &MainApp.agent.enqueue_pos );
+	n -= AtomicLoad( &MainApp.agent.dequeue_pos );
+	n += AtomicLoad( &MainApp.agent.n_overflow );
+	return n > 0 ? (size_t)n : 0;
+}
+
+static void TaskQueue_Destroy( void )
+{
+	TaskCellRec cell;
+	if( !MainApp.agent.cells ) {
 		return;
-	} else {
-		LCUIMutex_Unlock( &MainApp.agent.mutex );
+	}
+	while( TaskQueue_Pop( &cell ) ) {
+		LCUI_DeleteTask( &cell.task );
+	}
+	free( MainApp.agent.cells );
+	MainApp.agent.cells = NULL;
+	LCUIMutex_Destroy( &MainApp.agent.mutex );
+	LCUICond_Destroy( &MainApp.agent.cond );
+}
+
+void LCUI_DispatchEvent( void )
+{
+	size_t depth;
+	int64_t start, latency;
+	TaskCellRec cell;
+
+	if( MainApp.agent.cells ) {
+		depth = TaskQueue_GetDepth();
+		if( depth > MainApp.agent.max_depth ) {
+			MainApp.agent.max_depth = depth;
+		}
+		/* 处理所有已就绪的任务，超出时间预算后留给下一轮，以免系统
+		 * 事件得不到处理 */
+		start = LCUI_GetTimeNS();
+		while( TaskQueue_Pop( &cell ) ) {
+			latency = start - cell.time;
+			if( latency > MainApp.agent.max_latency ) {
+				MainApp.agent.max_latency = latency;
+			}
+			MainApp.agent.total_latency += latency > 0 ? latency : 0;
+			MainApp.agent.dispatched += 1;
+			LCUI_RunTask( &cell.task );
+			LCUI_DeleteTask( &cell.task );
+			if( LCUI_GetTimeDeltaNS( start ) >= TASK_DISPATCH_TIME ) {
+				break;
+			}
+		}
 	}
 	if( MainApp.agent.state == STATE_RUNNING ) {
 		return;
@@ -236,19 +440,54 @@ void LCUI_DispatchEvent( void )
 
 LCUI_BOOL LCUI_PostTask( LCUI_AppTask task )
 {
-	LCUI_AppTask newtask;
-	newtask = NEW( LCUI_AppTaskRec, 1 );
-	*newtask = *task;
+	if( !MainApp.agent.cells || !TaskQueue_Push( task ) ) {
+		return FALSE;
+	}
+	AtomicAdd( &MainApp.agent.posted, 1 );
+	/* 只在主循环等待任务时才需要唤醒它 */
+	if( AtomicLoad( &MainApp.agent.is_waiting ) ) {
+		LCUIMutex_Lock( &MainApp.agent.mutex );
+		LCUICond_Signal( &MainApp.agent.cond );
+		LCUIMutex_Unlock( &MainApp.agent.mutex );
+	}
+	/* 事件驱动只需要在队列由空变为非空时唤醒一次，标记会在主循环再次
+	 * 等待事件时清除 */
+	if( MainApp.driver_ready &&
+	    AtomicExchange( &MainApp.agent.is_notified, 1 ) == 0 ) {
+		return MainApp.driver->PostTask( task );
+	}
+	return TRUE;
+}
+
+/** 唤醒正在等待事件的主循环，让它能及时检查自己的状态 */
+static void LCUIApp_Wakeup( void )
+{
+	if( !MainApp.agent.cells ) {
+		return;
+	}
 	LCUIMutex_Lock( &MainApp.agent.mutex );
-	LinkedList_Append( &MainApp.agent.tasks, newtask );
-	LCUICond_Signal( &MainApp.agent.cond );
+	LCUICond_Broadcast( &MainApp.agent.cond );
 	LCUIMutex_Unlock( &MainApp.agent.mutex );
 	if( MainApp.driver_ready ) {
-		return MainApp.driver->PostTask( newtask );
+		AtomicStore( &MainApp.agent.is_notified, 1 );
+		MainApp.driver->PostTask( NULL );
 	}
-	return TRUE;
 }
 
+void LCUI_GetTaskQueueStats( LCUI_TaskQueueStats stats )
+{
+	stats->capacity = TASK_QUEUE_SIZE;
+	stats->depth = MainApp.agent.cells ? TaskQueue_GetDepth() : 0;
+	stats->max_depth = MainApp.agent.max_depth;
+	stats->posted = (unsigned long)MainApp.agent.posted;
+	stats->overflows = (unsigned long)MainApp.agent.overflows;
+	stats->dispatched = MainApp.agent.dispatched;
+	stats->total_latency = MainApp.agent.total_latency;
+	stats->max_latency = MainApp.agent.max_latency;
+}
+
+/*----------------------------- task queue <END> ----------------------------*/
+
 void LCUI_DeleteTask( LCUI_AppTask task )
 {
 	if( task->destroy_arg[0] && task->arg[0] ) {
@@ -313,12 +552,10 @@ int LCUI_MainLoop_Run( LCUI_MainLoop loop )
 	}
 	loop->state = STATE_EXITED;
 	LinkedList_Delete( &MainApp.loops, 0 );
-	/* 获取处于列表表头的主循环 */
+	/* 改变当前运行的主循环为处于列表表头的主循环，没有的话置为空，以免
+	 * 在该主循环被释放后还引用它 */
 	loop = LinkedList_Get( &MainApp.loops, 0 );
-	if( loop ) {
-		/* 改变当前运行的主循环 */
-		MainApp.loop = loop;
-	}
+	MainApp.loop = loop;
 	DEBUG_MSG("loop: %p, exit\n", loop);
 	LCUICond_Broadcast( &MainApp.loop_changed );
 	return 0;
@@ -328,6 +565,7 @@ int LCUI_MainLoop_Run( LCUI_MainLoop loop )
 void LCUI_MainLoop_Quit( LCUI_MainLoop loop )
 {
 	loop->state = STATE_EXITED;
+	LCUIApp_Wakeup();
 }
 
 void LCUI_InitApp( LCUI_AppDriver app )
@@ -339,24 +577,17 @@ void LCUI_InitApp( LCUI_AppDriver app )
 	MainApp.agent.state = STATE_RUNNING;
 	if( !app ) {
 		app = LCUI_CreateAppDriver();
-		if( !app ) {
-			return;
-		}
 	}
-	MainApp.driver = app;
-	MainApp.driver_ready = TRUE;
+	/* 没有应用程序驱动时（例如在帧缓存上运行），仍然可以用任务队列处理
+	 * 任务，只是收不到系统事件 */
+	if( app ) {
+		MainApp.driver = app;
+		MainApp.driver_ready = TRUE;
+	}
 	LCUICond_Init( &MainApp.loop_changed );
 	LCUIMutex_Init( &MainApp.loop_mutex );
 	LinkedList_Init( &MainApp.loops );
-	LCUIMutex_Init( &MainApp.agent.mutex );
-	LCUICond_Init( &MainApp.agent.cond );
-	LinkedList_Init( &MainApp.agent.tasks );
-}
-
-static void OnDeleteTask( void *arg )
-{
-	LCUI_DeleteTask( arg );
-	free( arg );
+	TaskQueue_Init();
 }
 
 static void LCUI_ExitApp( void )
@@ -370,32 +601,42 @@ static void LCUI_ExitApp( void )
 	}
 	LCUIMutex_Destroy( &MainApp.loop_mutex );
 	LCUICond_Destroy( &MainApp.loop_changed );
-	LCUIMutex_Destroy( &MainApp.agent.mutex );
-	LCUICond_Destroy( &MainApp.agent.cond );
 	LinkedList_Clear( &MainApp.loops, free );
-	LinkedList_Clear( &MainApp.agent.tasks, OnDeleteTask );
-	LCUI_DestroyAppDriver( MainApp.driver );
+	TaskQueue_Destroy();
+	if( MainApp.driver_ready ) {
+		LCUI_DestroyAppDriver( MainApp.driver );
+	}
 	MainApp.driver_ready = FALSE;
 }
 
 LCUI_BOOL LCUI_WaitEvent( void )
 {
-	if( MainApp.agent.tasks.length > 0 ) {
+	LCUI_BOOL ret = FALSE;
+	if( !TaskQueue_IsEmpty() ) {
 		return TRUE;
 	}
-	if( MainApp.agent.state != STATE_RUNNING ) {
+	if( MainApp.agent.state != STATE_RUNNING && MainApp.driver_ready ) {
+		/* 先清除通知标记再检查队列，之后添加的任务会再次唤醒驱动 */
+		AtomicStore( &MainApp.agent.is_notified, 0 );
+		if( !TaskQueue_IsEmpty() ) {
+			return TRUE;
+		}
 		return MainApp.driver->WaitEvent();
 	}
 	LCUIMutex_Lock( &MainApp.agent.mutex );
 	while( MainApp.agent.state == STATE_RUNNING ) {
-		if( MainApp.agent.tasks.length > 0 ) {
-			LCUIMutex_Unlock( &MainApp.agent.mutex );
-			return TRUE;
+		/* 先标记为等待状态再检查队列，这样在检查之后添加的任务一定
+		 * 能唤醒这里 */
+		AtomicStore( &MainApp.agent.is_waiting, 1 );
+		if( !TaskQueue_IsEmpty() ) {
+			ret = TRUE;
+			break;
 		}
 		LCUICond_Wait( &MainApp.agent.cond, &MainApp.agent.mutex );
 	}
+	AtomicStore( &MainApp.agent.is_waiting, 0 );
 	LCUIMutex_Unlock( &MainApp.agent.mutex );
-	return FALSE;
+	return ret;
 }
 
 int LCUI_BindSysEvent( int event_id, LCUI_EventFunc func,
@@ -447,6 +688,7 @@ static void LCUIApp_QuitAllMainLoop(void)
 			loop->state = STATE_EXITED;
 		}
 	}
+	LCUIApp_Wakeup();
 }
 
 /** 打印LCUI的信息 */
@@ -524,6 +766,8 @@ void LCUI_InitBase( void )
 	LCUI_ShowCopyrightText();
 	/* 初始化各个模块 */
 	LCUI_InitEvent();
+	/* 任务队列要在其它模块添加任务之前准备好 */
+	TaskQueue_Init();
 	LCUI_InitFont();
 	LCUI_InitTimer();
 	LCUI_InitKeyboard();
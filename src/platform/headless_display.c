@@ -0,0 +1,382 @@
+/* ***************************************************************************
+ * headless_display.c -- offscreen surface support without a window system.
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * headless_display.c -- 无窗口系统的图形显示功能支持，在内存中绘制。
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+//#define DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#define LCUI_SURFACE_C
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/draw.h>
+#include <LCUI/display.h>
+#include <LCUI/platform/headless_display.h>
+
+#define MAX_PATH_LEN	1024
+
+typedef struct LCUI_SurfaceRec_ {
+	int id;				/**< 序号，用于区分保存的帧图像 */
+	int x, y;			/**< 位置 */
+	int width;			/**< 宽度 */
+	int height;			/**< 高度 */
+	LCUI_BOOL visible;		/**< 是否可见 */
+	LCUI_Graph back;		/**< 后台缓存，绘制操作都在这里进行 */
+	LCUI_Graph front;		/**< 前台缓存，存放已呈现的内容 */
+	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LCUI_RWLock fb_lock;		/**< 读写锁，绘制时共享锁定，重新分配缓存时独占锁定 */
+	LCUI_RegionRec rects;		/**< 区域，记录已绘制但还未呈现的区域 */
+	LinkedListNode node;		/**< 在 surface 列表中的结点 */
+} LCUI_SurfaceRec;
+
+static struct LCUI_HeadlessDisplayModule {
+	int width;			/**< 屏幕宽度 */
+	int height;			/**< 屏幕高度 */
+	int surface_count;		/**< 已创建的 surface 数量 */
+	char *dump_dir;			/**< 保存帧图像的目录 */
+	LinkedList surfaces;		/**< surface 列表 */
+	LCUI_EventTrigger trigger;	/**< 事件触发器 */
+	LCUI_Mutex mutex;		/**< 互斥锁，保护统计信息 */
+	LCUI_HeadlessDisplayStatsRec stats;
+	LCUI_BOOL is_inited;
+} headless;
+
+static LCUI_Surface HeadlessSurface_New( void )
+{
+	LCUI_Surface surface;
+	surface = NEW( LCUI_SurfaceRec, 1 );
+	if( !surface ) {
+		return NULL;
+	}
+	surface->id = headless.surface_count++;
+	surface->visible = FALSE;
+	surface->node.data = surface;
+	Graph_Init( &surface->back );
+	Graph_Init( &surface->front );
+	surface->back.color_type = COLOR_TYPE_ARGB;
+	surface->front.color_type = COLOR_TYPE_ARGB;
+	Region_Init( &surface->rects );
+	LCUIMutex_Init( &surface->mutex );
+	LCUIRWLock_Init( &surface->fb_lock );
+	LinkedList_AppendNode( &headless.surfaces, &surface->node );
+	return surface;
+}
+
+static void HeadlessSurface_Delete( LCUI_Surface surface )
+{
+	LinkedList_Unlink( &headless.surfaces, &surface->node );
+	LCUIMutex_Destroy( &surface->mutex );
+	LCUIRWLock_Destroy( &surface->fb_lock );
+	Region_Destroy( &surface->rects );
+	Graph_Free( &surface->back );
+	Graph_Free( &surface->front );
+	free( surface );
+}
+
+static LCUI_BOOL HeadlessSurface_IsReady( LCUI_Surface surface )
+{
+	return TRUE;
+}
+
+/** 让 surface 的全部内容在下一帧中重绘 */
+static void HeadlessSurface_Invalidate( LCUI_Surface surface )
+{
+	LCUI_DisplayEventRec e;
+	if( !surface->visible || surface->width < 1 || surface->height < 1 ) {
+		return;
+	}
+	e.type = DET_PAINT;
+	e.surface = surface;
+	e.paint.rect.x = 0;
+	e.paint.rect.y = 0;
+	e.paint.rect.width = surface->width;
+	e.paint.rect.height = surface->height;
+	EventTrigger_Trigger( headless.trigger, DET_PAINT, &e );
+}
+
+static void HeadlessSurface_Move( LCUI_Surface surface, int x, int y )
+{
+	surface->x = x;
+	surface->y = y;
+}
+
+static void HeadlessSurface_Resize( LCUI_Surface surface,
+				    int width, int height )
+{
+	if( width < 1 || height < 1 ||
+	    (surface->width == width && surface->height == height) ) {
+		return;
+	}
+	/* 等待渲染线程绘制完当前帧后再重新分配缓存 */
+	LCUIRWLock_WriteLock( &surface->fb_lock );
+	LCUIMutex_Lock( &surface->mutex );
+	Graph_Free( &surface->back );
+	Graph_Free( &surface->front );
+	surface->back.color_type = COLOR_TYPE_ARGB;
+	surface->front.color_type = COLOR_TYPE_ARGB;
+	if( Graph_Create( &surface->back, width, height ) != 0 ||
+	    Graph_Create( &surface->front, width, height ) != 0 ) {
+		Graph_Free( &surface->back );
+		surface->width = surface->height = 0;
+		LCUIMutex_Unlock( &surface->mutex );
+		LCUIRWLock_WriteUnlock( &surface->fb_lock );
+		return;
+	}
+	surface->width = width;
+	surface->height = height;
+	Region_Clear( &surface->rects );
+	LCUIMutex_Unlock( &surface->mutex );
+	LCUIRWLock_WriteUnlock( &surface->fb_lock );
+	HeadlessSurface_Invalidate( surface );
+}
+
+static void HeadlessSurface_Show( LCUI_Surface surface )
+{
+	if( surface->visible ) {
+		return;
+	}
+	surface->visible = TRUE;
+	HeadlessSurface_Invalidate( surface );
+}
+
+static void HeadlessSurface_Hide( LCUI_Surface surface )
+{
+	surface->visible = FALSE;
+}
+
+static void HeadlessSurface_SetCaptionW( LCUI_Surface surface,
+					 const wchar_t *wstr )
+{
+	return;
+}
+
+static void HeadlessSurface_SetOpacity( LCUI_Surface surface, float opacity )
+{
+	return;
+}
+
+static void HeadlessSurface_SetRenderMode( LCUI_Surface surface, int mode )
+{
+	return;
+}
+
+static void* HeadlessSurface_GetHandle( LCUI_Surface surface )
+{
+	return NULL;
+}
+
+static void HeadlessSurface_Update( LCUI_Surface surface )
+{
+	return;
+}
+
+static LCUI_PaintContext HeadlessSurface_BeginPaint( LCUI_Surface surface,
+						     LCUI_Rect *rect )
+{
+	return LCUIDisplay_BeginPaintBuffer( &surface->fb_lock,
+					     &surface->back, rect );
+}
+
+static void HeadlessSurface_EndPaint( LCUI_Surface surface,
+				      LCUI_PaintContext paint )
+{
+	LCUIDisplay_EndPaintBuffer( &surface->fb_lock, &surface->mutex,
+				    &surface->rects, paint );
+}
+
+/** 将后台缓存中已绘制的区域复制到前台缓存中，需要时保存为 PNG 文件 */
+static void HeadlessSurface_Present( LCUI_Surface surface )
+{
+	int i, pixels = 0;
+	LCUI_Rect *rect;
+	LCUI_Graph canvas;
+	char path[MAX_PATH_LEN];
+
+	LCUIMutex_Lock( &surface->mutex );
+	if( Region_IsEmpty( &surface->rects ) ) {
+		LCUIMutex_Unlock( &surface->mutex );
+		return;
+	}
+	for( i = 0; i < surface->rects.length; ++i ) {
+		rect = &surface->rects.rects[i];
+		Graph_Quote( &canvas, &surface->back, rect );
+		Graph_Replace( &surface->front, &canvas, rect->x, rect->y );
+		pixels += rect->width * rect->height;
+	}
+	LCUIMutex_Lock( &headless.mutex );
+	headless.stats.presents += 1;
+	headless.stats.rects += surface->rects.length;
+	headless.stats.pixels += pixels;
+	path[0] = 0;
+	if( headless.dump_dir ) {
+		snprintf( path, MAX_PATH_LEN, "%s/%06lu-%d.png",
+			  headless.dump_dir, headless.stats.presents,
+			  surface->id );
+		headless.stats.dumps += 1;
+	}
+	LCUIMutex_Unlock( &headless.mutex );
+	Region_Clear( &surface->rects );
+	if( path[0] ) {
+		Graph_WritePNG( path, &surface->front );
+	}
+	LCUIMutex_Unlock( &surface->mutex );
+}
+
+static int HeadlessDisplay_BindEvent( int event_id, LCUI_EventFunc func,
+				      void *data, void( *destroy_data )(void*) )
+{
+	return EventTrigger_Bind( headless.trigger, event_id, func,
+				  data, destroy_data );
+}
+
+static int HeadlessDisplay_GetWidth( void )
+{
+	return headless.width;
+}
+
+static int HeadlessDisplay_GetHeight( void )
+{
+	return headless.height;
+}
+
+void LCUI_SetHeadlessDisplayDumpDir( const char *dir )
+{
+	char *str = NULL;
+	if( dir ) {
+		str = malloc( strlen( dir ) + 1 );
+		if( !str ) {
+			return;
+		}
+		strcpy( str, dir );
+	}
+	LCUIMutex_Lock( &headless.mutex );
+	if( headless.dump_dir ) {
+		free( headless.dump_dir );
+	}
+	headless.dump_dir = str;
+	LCUIMutex_Unlock( &headless.mutex );
+}
+
+int LCUI_ReadHeadlessSurface( LCUI_Surface surface, LCUI_Graph *buff )
+{
+	LCUIMutex_Lock( &surface->mutex );
+	if( !Graph_IsValid( &surface->front ) ) {
+		LCUIMutex_Unlock( &surface->mutex );
+		return -1;
+	}
+	Graph_Copy( buff, &surface->front );
+	LCUIMutex_Unlock( &surface->mutex );
+	return 0;
+}
+
+int LCUI_WriteHeadlessSurfacePNG( LCUI_Surface surface, const char *filename )
+{
+	int ret;
+	LCUIMutex_Lock( &surface->mutex );
+	ret = Graph_WritePNG( filename, &surface->front );
+	LCUIMutex_Unlock( &surface->mutex );
+	return ret;
+}
+
+void LCUI_GetHeadlessDisplayStats( LCUI_HeadlessDisplayStats stats )
+{
+	LCUIMutex_Lock( &headless.mutex );
+	*stats = headless.stats;
+	LCUIMutex_Unlock( &headless.mutex );
+}
+
+LCUI_DisplayDriver LCUI_CreateHeadlessDisplay( int width, int height )
+{
+	LCUI_DisplayDriver driver;
+	if( headless.is_inited || width < 1 || height < 1 ) {
+		return NULL;
+	}
+	driver = NEW( LCUI_DisplayDriverRec, 1 );
+	if( !driver ) {
+		return NULL;
+	}
+	strcpy( driver->name, "headless" );
+	driver->getWidth = HeadlessDisplay_GetWidth;
+	driver->getHeight = HeadlessDisplay_GetHeight;
+	driver->create = HeadlessSurface_New;
+	driver->destroy = HeadlessSurface_Delete;
+	driver->isReady = HeadlessSurface_IsReady;
+	driver->show = HeadlessSurface_Show;
+	driver->hide = HeadlessSurface_Hide;
+	driver->move = HeadlessSurface_Move;
+	driver->resize = HeadlessSurface_Resize;
+	driver->update = HeadlessSurface_Update;
+	driver->present = HeadlessSurface_Present;
+	driver->setCaptionW = HeadlessSurface_SetCaptionW;
+	driver->setRenderMode = HeadlessSurface_SetRenderMode;
+	driver->setOpacity = HeadlessSurface_SetOpacity;
+	driver->getHandle = HeadlessSurface_GetHandle;
+	driver->beginPaint = HeadlessSurface_BeginPaint;
+	driver->endPaint = HeadlessSurface_EndPaint;
+	driver->bindEvent = HeadlessDisplay_BindEvent;
+	headless.width = width;
+	headless.height = height;
+	headless.surface_count = 0;
+	headless.dump_dir = NULL;
+	headless.trigger = EventTrigger();
+	memset( &headless.stats, 0, sizeof( headless.stats ) );
+	LinkedList_Init( &headless.surfaces );
+	LCUIMutex_Init( &headless.mutex );
+	headless.is_inited = TRUE;
+	LCUI_SetHeadlessDisplayDumpDir( getenv( "LCUI_HEADLESS_DUMP" ) );
+	return driver;
+}
+
+void LCUI_DestroyHeadlessDisplay( LCUI_DisplayDriver driver )
+{
+	LinkedListNode *node;
+	if( !headless.is_inited ) {
+		return;
+	}
+	while( (node = LinkedList_GetNode( &headless.surfaces, 0 )) ) {
+		HeadlessSurface_Delete( node->data );
+	}
+	LCUI_SetHeadlessDisplayDumpDir( NULL );
+	EventTrigger_Destroy( headless.trigger );
+	LCUIMutex_Destroy( &headless.mutex );
+	headless.trigger = NULL;
+	headless.is_inited = FALSE;
+	free( driver );
+}
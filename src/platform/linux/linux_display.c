@@ -7,17 +7,42 @@
 #include LCUI_EVENTS_H
 #include LCUI_DISPLAY_H
 
-int LCUI_InitLinuxDisplay( LCUI_DisplayDriver driver )
+LCUI_DisplayDriver LCUI_CreateLinuxDisplay( void )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
-		return LCUI_InitLinuxX11Display( driver );
+	switch( LCUI_GetLinuxAppMode() ) {
+#ifdef LCUI_VIDEO_DRIVER_X11
+	case LCUI_APP_MODE_X11:
+		return LCUI_CreateLinuxX11Display();
+#endif
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	case LCUI_APP_MODE_FRAMEBUFFER:
+		return LCUI_CreateLinuxFBDisplay();
+#endif
+	case LCUI_APP_MODE_HEADLESS:
+		return LCUI_CreateHeadlessDisplay( HEADLESS_DEFAULT_WIDTH,
+						   HEADLESS_DEFAULT_HEIGHT );
+	default: break;
 	}
-	return -1;
+	return NULL;
 }
 
-int LCUI_ExitLinuxDisplay( void )
+void LCUI_DestroyLinuxDisplay( LCUI_DisplayDriver driver )
 {
-	return -1;
+	switch( LCUI_GetLinuxAppMode() ) {
+#ifdef LCUI_VIDEO_DRIVER_X11
+	case LCUI_APP_MODE_X11:
+		LCUI_DestroyLinuxX11Display( driver );
+		break;
+#endif
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	case LCUI_APP_MODE_FRAMEBUFFER:
+		LCUI_DestroyLinuxFBDisplay( driver );
+		break;
+#endif
+	case LCUI_APP_MODE_HEADLESS:
+		LCUI_DestroyHeadlessDisplay( driver );
+		break;
+	default: break;
+	}
 }
 #endif
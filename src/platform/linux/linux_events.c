@@ -1,22 +1,69 @@
-
+#include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #ifdef LCUI_BUILD_IN_LINUX
+#include <unistd.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/display.h>
 #include <LCUI/platform.h>
 #include LCUI_EVENTS_H
+#include LCUI_DISPLAY_H
+
+static int app_mode = LCUI_APP_MODE_FRAMEBUFFER;
+
+int LCUI_GetLinuxAppMode( void )
+{
+	return app_mode;
+}
 
 void LCUI_PreInitLinuxApp( void *data )
 {
 	return;
 }
 
-int LCUI_InitLinuxApp( LCUI_AppDriver app )
+/**
+ * 创建应用程序驱动
+ * 优先以 X11 窗口的形式运行，连接不上 X 服务器时改用帧缓存模式，没有可用的
+ * 帧缓存设备时则改用无窗口模式。环境变量 LCUI_VIDEO_DRIVER 可以指定为 x11、
+ * framebuffer 或 headless，设置了环境变量 LCUI_FBDEV 时不再尝试 X11。
+ * 帧缓存模式和无窗口模式下没有应用程序驱动，任务由 LCUI 自己的任务队列处理，
+ * 此时返回 NULL。
+ */
+LCUI_AppDriver LCUI_CreateLinuxAppDriver( void )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
-		return LCUI_InitLinuxX11App( app );
+	const char *name = getenv( "LCUI_VIDEO_DRIVER" );
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	const char *fbdev = getenv( "LCUI_FBDEV" );
+#endif
+	if( name && strcmp( name, "headless" ) == 0 ) {
+		app_mode = LCUI_APP_MODE_HEADLESS;
+		return NULL;
 	}
-	return -1;
+#ifdef LCUI_VIDEO_DRIVER_X11
+	if( name ? strcmp( name, "x11" ) == 0 : !getenv( "LCUI_FBDEV" ) ) {
+		LCUI_AppDriver app = LCUI_CreateLinuxX11AppDriver();
+		if( app ) {
+			app_mode = LCUI_APP_MODE_X11;
+			return app;
+		}
+	}
+#endif
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	if( access( fbdev ? fbdev : LINUX_FBDEV_DEFAULT, R_OK | W_OK ) == 0 ) {
+		app_mode = LCUI_APP_MODE_FRAMEBUFFER;
+		return NULL;
+	}
+#endif
+	app_mode = LCUI_APP_MODE_HEADLESS;
+	return NULL;
+}
+
+void LCUI_DestroyLinuxAppDriver( LCUI_AppDriver app )
+{
+#ifdef LCUI_VIDEO_DRIVER_X11
+	if( app_mode == LCUI_APP_MODE_X11 ) {
+		LCUI_DestroyLinuxX11AppDriver( app );
+	}
+#endif
 }
 #endif
@@ -1 +1,510 @@
+/* ***************************************************************************
+ * linux_fbdisplay.c -- surface support for linux framebuffer.
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
 
+/* ****************************************************************************
+ * linux_fbdisplay.c -- linux 平台的图形显示功能支持，基于帧缓存(FrameBuffer)。
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+//#define DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#define LCUI_SURFACE_C
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_FRAMEBUFFER)
+#include <LCUI/LCUI.h>
+#include <LCUI/display.h>
+#include <LCUI/platform.h>
+#include LCUI_DISPLAY_H
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/fb.h>
+#include <LCUI/graph_convert.h>
+
+typedef struct LCUI_SurfaceRec_ {
+	int x, y;			/**< 在屏幕中的位置 */
+	int width;			/**< 宽度 */
+	int height;			/**< 高度 */
+	LCUI_BOOL visible;		/**< 是否可见 */
+	LCUI_Graph fb;			/**< 后台缓存，绘制操作都在这里进行 */
+	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LCUI_RWLock fb_lock;		/**< 读写锁，绘制时共享锁定，重新分配后台缓存时独占锁定 */
+	LCUI_RegionRec rects;		/**< 区域，记录已绘制但还未呈现的区域 */
+	LinkedListNode node;		/**< 在 surface 列表中的结点 */
+} LCUI_SurfaceRec;
+
+static struct LCUI_FBDisplayModule {
+	int fd;				/**< 帧缓存设备的文件描述符 */
+	LCUI_BOOL own_fd;		/**< 文件描述符是否由本模块打开 */
+	uchar_t *mem;			/**< 映射到内存中的帧缓存，即前台缓存 */
+	uchar_t *base;			/**< 可见区域在帧缓存中的起始地址 */
+	size_t mem_size;		/**< 帧缓存的字节数 */
+	LCUI_FrameBufferInfoRec info;	/**< 帧缓存的信息 */
+	int color_type;			/**< 帧缓存的色彩类型 */
+	LCUI_BOOL swap_rb;		/**< 帧缓存是否为 BGR 顺序 */
+	LCUI_BOOL dither;		/**< 是否对 16 位的帧缓存做有序抖动 */
+	LinkedList surfaces;		/**< surface 列表 */
+	LCUI_EventTrigger trigger;	/**< 事件触发器 */
+	LCUI_FBDisplayStatsRec stats;	/**< 统计信息 */
+	LCUI_BOOL is_inited;
+} fbd;
+
+/** 获取与帧缓存的像素位数对应的色彩类型 */
+static int GetColorType( int bits_per_pixel )
+{
+	switch( bits_per_pixel ) {
+	case 16: return COLOR_TYPE_RGB565;
+	case 24: return COLOR_TYPE_RGB888;
+	case 32: return COLOR_TYPE_ARGB8888;
+	default: break;
+	}
+	return -1;
+}
+
+/**
+ * 根据颜色分量的位偏移判断帧缓存是否需要交换红色和蓝色通道
+ * @returns 与 LCUI 的顺序相同时返回 0，需要交换时返回 1，不支持时返回 -1
+ */
+static int GetChannelOrder( const LCUI_FrameBufferInfoRec *info )
+{
+	int red_offset = info->bits_per_pixel == 16 ? 11 : 16;
+	int green_offset = info->bits_per_pixel == 16 ? 5 : 8;
+
+	if( info->red_offset == 0 && info->green_offset == 0 &&
+	    info->blue_offset == 0 ) {
+		return 0;
+	}
+	if( info->green_offset != green_offset ) {
+		return -1;
+	}
+	if( info->red_offset == red_offset && info->blue_offset == 0 ) {
+		return 0;
+	}
+	if( info->red_offset == 0 && info->blue_offset == red_offset ) {
+		return 1;
+	}
+	return -1;
+}
+
+/** 交换一行 16 位像素的红色和蓝色通道 */
+static void SwapRB565( uchar_t *pixels, int n )
+{
+	unsigned short px;
+	for( ; n > 0; --n, pixels += 2 ) {
+		memcpy( &px, pixels, 2 );
+		px = (unsigned short)((px & 0x07e0) | (px >> 11) |
+				      ((px & 0x1f) << 11));
+		memcpy( pixels, &px, 2 );
+	}
+}
+
+/** 将一行 ARGB 像素转换成帧缓存的像素格式 */
+static void ConvertRow( uchar_t *dst, const LCUI_ARGB *src,
+			int n, int x, int y )
+{
+	if( fbd.color_type == COLOR_TYPE_ARGB8888 && fbd.swap_rb ) {
+		Pixels_SwapRB( dst, (const uchar_t*)src,
+			       COLOR_TYPE_ARGB8888, n );
+		return;
+	}
+	if( fbd.dither ) {
+		Pixels_ConvertDither( dst, fbd.color_type, (const uchar_t*)src,
+				      COLOR_TYPE_ARGB8888, n, x, y );
+	} else {
+		Pixels_Convert( dst, fbd.color_type, (const uchar_t*)src,
+				COLOR_TYPE_ARGB8888, n );
+	}
+	if( !fbd.swap_rb ) {
+		return;
+	}
+	if( fbd.color_type == COLOR_TYPE_RGB565 ) {
+		SwapRB565( dst, n );
+	} else {
+		Pixels_SwapRB( dst, dst, fbd.color_type, n );
+	}
+}
+
+static LCUI_Surface FBSurface_New( void )
+{
+	LCUI_Surface surface;
+	surface = NEW( LCUI_SurfaceRec, 1 );
+	if( !surface ) {
+		return NULL;
+	}
+	surface->x = 0;
+	surface->y = 0;
+	surface->width = 0;
+	surface->height = 0;
+	surface->visible = FALSE;
+	surface->node.data = surface;
+	Graph_Init( &surface->fb );
+	surface->fb.color_type = COLOR_TYPE_ARGB;
+	Region_Init( &surface->rects );
+	LCUIMutex_Init( &surface->mutex );
+	LCUIRWLock_Init( &surface->fb_lock );
+	LinkedList_AppendNode( &fbd.surfaces, &surface->node );
+	return surface;
+}
+
+static void FBSurface_Delete( LCUI_Surface surface )
+{
+	LinkedList_Unlink( &fbd.surfaces, &surface->node );
+	LCUIMutex_Destroy( &surface->mutex );
+	LCUIRWLock_Destroy( &surface->fb_lock );
+	Region_Destroy( &surface->rects );
+	Graph_Free( &surface->fb );
+	free( surface );
+}
+
+static LCUI_BOOL FBSurface_IsReady( LCUI_Surface surface )
+{
+	return TRUE;
+}
+
+/** 让 surface 的全部内容在下一帧中重绘 */
+static void FBSurface_Invalidate( LCUI_Surface surface )
+{
+	LCUI_DisplayEventRec e;
+	if( !surface->visible || surface->width < 1 || surface->height < 1 ) {
+		return;
+	}
+	e.type = DET_PAINT;
+	e.surface = surface;
+	e.paint.rect.x = 0;
+	e.paint.rect.y = 0;
+	e.paint.rect.width = surface->width;
+	e.paint.rect.height = surface->height;
+	EventTrigger_Trigger( fbd.trigger, DET_PAINT, &e );
+}
+
+static void FBSurface_Move( LCUI_Surface surface, int x, int y )
+{
+	if( surface->x == x && surface->y == y ) {
+		return;
+	}
+	surface->x = x;
+	surface->y = y;
+	FBSurface_Invalidate( surface );
+}
+
+static void FBSurface_Resize( LCUI_Surface surface, int width, int height )
+{
+	if( width < 1 || height < 1 ||
+	    (surface->width == width && surface->height == height) ) {
+		return;
+	}
+	/* 等待渲染线程绘制完当前帧后再重新分配后台缓存 */
+	LCUIRWLock_WriteLock( &surface->fb_lock );
+	LCUIMutex_Lock( &surface->mutex );
+	Graph_Free( &surface->fb );
+	surface->fb.color_type = COLOR_TYPE_ARGB;
+	if( Graph_Create( &surface->fb, width, height ) != 0 ) {
+		surface->width = surface->height = 0;
+		LCUIMutex_Unlock( &surface->mutex );
+		LCUIRWLock_WriteUnlock( &surface->fb_lock );
+		return;
+	}
+	surface->width = width;
+	surface->height = height;
+	Region_Clear( &surface->rects );
+	LCUIMutex_Unlock( &surface->mutex );
+	LCUIRWLock_WriteUnlock( &surface->fb_lock );
+	FBSurface_Invalidate( surface );
+}
+
+static void FBSurface_Show( LCUI_Surface surface )
+{
+	if( surface->visible ) {
+		return;
+	}
+	surface->visible = TRUE;
+	FBSurface_Invalidate( surface );
+}
+
+static void FBSurface_Hide( LCUI_Surface surface )
+{
+	surface->visible = FALSE;
+}
+
+static void FBSurface_SetCaptionW( LCUI_Surface surface, const wchar_t *wstr )
+{
+	return;
+}
+
+static void FBSurface_SetOpacity( LCUI_Surface surface, float opacity )
+{
+	return;
+}
+
+static void FBSurface_SetRenderMode( LCUI_Surface surface, int mode )
+{
+	return;
+}
+
+static void* FBSurface_GetHandle( LCUI_Surface surface )
+{
+	return NULL;
+}
+
+static void FBSurface_Update( LCUI_Surface surface )
+{
+	return;
+}
+
+static LCUI_PaintContext FBSurface_BeginPaint( LCUI_Surface surface,
+					       LCUI_Rect *rect )
+{
+	return LCUIDisplay_BeginPaintBuffer( &surface->fb_lock,
+					     &surface->fb, rect );
+}
+
+static void FBSurface_EndPaint( LCUI_Surface surface, LCUI_PaintContext paint )
+{
+	LCUIDisplay_EndPaintBuffer( &surface->fb_lock, &surface->mutex,
+				    &surface->rects, paint );
+}
+
+/**
+ * 将后台缓存中已绘制的区域转换成帧缓存的像素格式，并复制到帧缓存中
+ * 未改变的区域不会被复制，超出屏幕的部分会被裁剪掉
+ */
+static void FBSurface_Present( LCUI_Surface surface )
+{
+	int i, y, bytes_per_pixel;
+	LCUI_Rect rect, screen;
+	const LCUI_ARGB *src;
+	uchar_t *dst;
+
+	bytes_per_pixel = fbd.info.bits_per_pixel / 8;
+	screen.x = screen.y = 0;
+	screen.width = fbd.info.width;
+	screen.height = fbd.info.height;
+	LCUIMutex_Lock( &surface->mutex );
+	if( !surface->visible || !fbd.mem ) {
+		Region_Clear( &surface->rects );
+		LCUIMutex_Unlock( &surface->mutex );
+		return;
+	}
+	for( i = 0; i < surface->rects.length; ++i ) {
+		rect = surface->rects.rects[i];
+		rect.x += surface->x;
+		rect.y += surface->y;
+		if( !LCUIRect_GetOverlayRect( &rect, &screen, &rect ) ) {
+			continue;
+		}
+		src = surface->fb.argb + (rect.y - surface->y) * surface->width;
+		src += rect.x - surface->x;
+		dst = fbd.base + rect.y * fbd.info.line_length;
+		dst += rect.x * bytes_per_pixel;
+		for( y = 0; y < rect.height; ++y ) {
+			ConvertRow( dst, src, rect.width, rect.x, rect.y + y );
+			src += surface->width;
+			dst += fbd.info.line_length;
+		}
+		fbd.stats.rects += 1;
+		fbd.stats.pixels += rect.width * rect.height;
+	}
+	fbd.stats.presents += 1;
+	Region_Clear( &surface->rects );
+	LCUIMutex_Unlock( &surface->mutex );
+}
+
+static int FBDisplay_BindEvent( int event_id, LCUI_EventFunc func,
+				void *data, void (*destroy_data)(void*) )
+{
+	return EventTrigger_Bind( fbd.trigger, event_id, func,
+				  data, destroy_data );
+}
+
+static int FBDisplay_GetWidth( void )
+{
+	return fbd.info.width;
+}
+
+static int FBDisplay_GetHeight( void )
+{
+	return fbd.info.height;
+}
+
+/** 将帧缓存映射到内存中，并创建驱动 */
+static LCUI_DisplayDriver FBDisplay_Create( int fd, LCUI_BOOL own_fd,
+					    const LCUI_FrameBufferInfoRec *info )
+{
+	void *mem;
+	size_t size;
+	const char *dither;
+	LCUI_DisplayDriver driver;
+	int bytes_per_pixel = info->bits_per_pixel / 8;
+
+	if( fbd.is_inited || GetColorType( info->bits_per_pixel ) < 0 ||
+	    GetChannelOrder( info ) < 0 ||
+	    info->width < 1 || info->height < 1 ||
+	    info->xoffset < 0 || info->yoffset < 0 ||
+	    info->line_length < (info->xoffset + info->width) *
+				bytes_per_pixel ) {
+		return NULL;
+	}
+	size = (size_t)info->line_length * (info->yoffset + info->height);
+	mem = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	if( mem == MAP_FAILED ) {
+		return NULL;
+	}
+	driver = NEW( LCUI_DisplayDriverRec, 1 );
+	if( !driver ) {
+		munmap( mem, size );
+		return NULL;
+	}
+	strcpy( driver->name, "framebuffer" );
+	driver->getWidth = FBDisplay_GetWidth;
+	driver->getHeight = FBDisplay_GetHeight;
+	driver->create = FBSurface_New;
+	driver->destroy = FBSurface_Delete;
+	driver->isReady = FBSurface_IsReady;
+	driver->show = FBSurface_Show;
+	driver->hide = FBSurface_Hide;
+	driver->move = FBSurface_Move;
+	driver->resize = FBSurface_Resize;
+	driver->update = FBSurface_Update;
+	driver->present = FBSurface_Present;
+	driver->setCaptionW = FBSurface_SetCaptionW;
+	driver->setRenderMode = FBSurface_SetRenderMode;
+	driver->setOpacity = FBSurface_SetOpacity;
+	driver->getHandle = FBSurface_GetHandle;
+	driver->beginPaint = FBSurface_BeginPaint;
+	driver->endPaint = FBSurface_EndPaint;
+	driver->bindEvent = FBDisplay_BindEvent;
+	fbd.fd = fd;
+	fbd.own_fd = own_fd;
+	fbd.mem = mem;
+	fbd.mem_size = size;
+	fbd.info = *info;
+	fbd.base = fbd.mem + (size_t)info->yoffset * info->line_length;
+	fbd.base += info->xoffset * bytes_per_pixel;
+	fbd.color_type = GetColorType( info->bits_per_pixel );
+	fbd.swap_rb = GetChannelOrder( info ) == 1;
+	/* 16 位的屏幕上渐变色会出现明显的色带，可以设置 LCUI_FB_DITHER=1 缓解 */
+	dither = getenv( "LCUI_FB_DITHER" );
+	fbd.dither = dither && strcmp( dither, "0" ) != 0 &&
+		     fbd.color_type == COLOR_TYPE_RGB565;
+	fbd.trigger = EventTrigger();
+	memset( &fbd.stats, 0, sizeof( fbd.stats ) );
+	LinkedList_Init( &fbd.surfaces );
+	fbd.is_inited = TRUE;
+	return driver;
+}
+
+LCUI_DisplayDriver LCUI_CreateLinuxFBDisplay( void )
+{
+	int fd;
+	const char *path;
+	LCUI_DisplayDriver driver;
+	LCUI_FrameBufferInfoRec info;
+	struct fb_var_screeninfo vinfo;
+	struct fb_fix_screeninfo finfo;
+
+	path = getenv( "LCUI_FBDEV" );
+	if( !path ) {
+		path = LINUX_FBDEV_DEFAULT;
+	}
+	fd = open( path, O_RDWR );
+	if( fd == -1 ) {
+		LOG( "[display] cannot open framebuffer device: %s\n", path );
+		return NULL;
+	}
+	if( ioctl( fd, FBIOGET_FSCREENINFO, &finfo ) == -1 ||
+	    ioctl( fd, FBIOGET_VSCREENINFO, &vinfo ) == -1 ) {
+		LOG( "[display] cannot read framebuffer information\n" );
+		close( fd );
+		return NULL;
+	}
+	info.width = vinfo.xres;
+	info.height = vinfo.yres;
+	info.bits_per_pixel = vinfo.bits_per_pixel;
+	info.line_length = finfo.line_length;
+	info.xoffset = vinfo.xoffset;
+	info.yoffset = vinfo.yoffset;
+	info.red_offset = vinfo.red.offset;
+	info.green_offset = vinfo.green.offset;
+	info.blue_offset = vinfo.blue.offset;
+	driver = FBDisplay_Create( fd, TRUE, &info );
+	if( !driver ) {
+		LOG( "[display] unsupported framebuffer: %dx%d, %d bpp, "
+		     "rgb offset: %d/%d/%d\n", info.width, info.height,
+		     info.bits_per_pixel, info.red_offset,
+		     info.green_offset, info.blue_offset );
+		close( fd );
+		return NULL;
+	}
+	LOG( "[display] framebuffer: %s, %dx%d, %d bpp\n", path,
+	     info.width, info.height, info.bits_per_pixel );
+	return driver;
+}
+
+LCUI_DisplayDriver LCUI_CreateLinuxFBDisplayByFile( int fd,
+				const LCUI_FrameBufferInfoRec *info )
+{
+	return FBDisplay_Create( fd, FALSE, info );
+}
+
+void LCUI_GetLinuxFBDisplayStats( LCUI_FBDisplayStats stats )
+{
+	*stats = fbd.stats;
+}
+
+void LCUI_DestroyLinuxFBDisplay( LCUI_DisplayDriver driver )
+{
+	LinkedListNode *node;
+	if( !fbd.is_inited ) {
+		return;
+	}
+	while( (node = LinkedList_GetNode( &fbd.surfaces, 0 )) ) {
+		FBSurface_Delete( node->data );
+	}
+	munmap( fbd.mem, fbd.mem_size );
+	if( fbd.own_fd ) {
+		close( fbd.fd );
+	}
+	EventTrigger_Destroy( fbd.trigger );
+	fbd.mem = NULL;
+	fbd.base = NULL;
+	fbd.trigger = NULL;
+	fbd.is_inited = FALSE;
+	free( driver );
+}
+
+#endif
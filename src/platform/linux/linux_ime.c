@@ -68,8 +68,7 @@ static LCUI_BOOL X11IME_Close( void )
 int LCUI_RegisterLinuxIME( void )
 {
 	LCUI_IMEHandlerRec handler;
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
+	if( LCUI_GetLinuxAppMode() == LCUI_APP_MODE_X11 ) {
 		handler.gettarget = X11IME_GetTarget;
 		handler.settarget = X11IME_SetTarget;
 		handler.cleartarget = X11IME_ClearTarget;
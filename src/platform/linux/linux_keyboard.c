@@ -8,10 +8,11 @@
 
 void LCUI_InitLinuxKeyboard( void )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
+#ifdef LCUI_VIDEO_DRIVER_X11
+	if( LCUI_GetLinuxAppMode() == LCUI_APP_MODE_X11 ) {
 		LCUI_InitLinuxX11Keyboard();
 	}
+#endif
 }
 
 void LCUI_ExitLinuxKeyboard( void )
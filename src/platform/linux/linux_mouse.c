@@ -46,10 +46,11 @@
 
 void LCUI_InitLinuxMouse( void )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
+#ifdef LCUI_VIDEO_DRIVER_X11
+	if( LCUI_GetLinuxAppMode() == LCUI_APP_MODE_X11 ) {
 		LCUI_InitLinuxX11Mouse();
 	}
+#endif
 }
 
 void LCUI_ExitLinuxMouse( void )
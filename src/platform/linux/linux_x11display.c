@@ -40,18 +40,26 @@
 //#define DEBUG
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #define LCUI_SURFACE_C
-#ifdef LCUI_BUILD_IN_LINUX
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_X11)
 #include <LCUI/LCUI.h>
 #include <LCUI/display.h>
 #include <LCUI/platform.h>
 #include <LCUI/font/charset.h>
 #include LCUI_DISPLAY_H
 #include LCUI_EVENTS_H
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif
 
 #define MIN_WIDTH	320
 #define MIN_HEIGHT	240
+/** 等待 X 服务器读取完共享内存中的帧缓存的最长时间，单位为毫秒 */
+#define SHM_WAIT_TIMEOUT	100
 
 enum SurfaceTaskType {
 	TASK_CREATE,
@@ -59,7 +67,6 @@ enum SurfaceTaskType {
 	TASK_RESIZE,
 	TASK_SHOW,
 	TASK_SET_CAPTION,
-	TASK_PRESENT,
 	TASK_DELETE,
 	TASK_TOTAL_NUM
 };
@@ -95,17 +102,29 @@ typedef struct LCUI_SurfaceRec_ {
 	LCUI_BOOL is_ready;		/**< 标志，标识当前的表面是否已经准备好 */
 	LCUI_Graph fb;			/**< 帧缓存，它里面的数据会映射到窗口中 */
 	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LCUI_RWLock fb_lock;		/**< 读写锁，绘制时共享锁定，重新分配帧缓存时独占锁定 */
 	int64_t timestamp;		/**< 时间戳，记录上次清空 ignored_size 时的时间 */
 	LinkedList ignored_size;	/**< 列表，记录被忽略的尺寸，用于屏蔽重复的窗口尺寸更改操作 */
-	LinkedList rects;		/**< 列表，记录当前需要重绘的区域 */
+	LCUI_RegionRec rects;		/**< 区域，记录当前需要重绘的区域 */
+	LCUI_RegionRec upload;		/**< 区域，记录合并后需要上传的区域 */
+	LCUI_BOOL present_pending;	/**< 标志，是否已投递了尚未处理的呈现任务 */
+	LCUI_BOOL use_shm;		/**< 标志，帧缓存是否在共享内存中 */
+	LCUI_BOOL shm_busy;		/**< 标志，X 服务器是否还在读取帧缓存 */
+	LCUI_Cond shm_cond;		/**< 条件变量，在 X 服务器读取完帧缓存时通知 */
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	XShmSegmentInfo shminfo;	/**< 共享内存段的信息 */
+#endif
 	LinkedListNode node;		/**< 在表面列表中的结点 */
 } LCUI_SurfaceRec;
 
 static struct X11_Display {
 	LCUI_BOOL is_inited;		/**< 标记，标识当前模块是否已经初始化 */
+	LCUI_BOOL has_shm;		/**< 标记，X 服务器是否支持 MIT-SHM 扩展 */
+	int shm_completion;		/**< ShmCompletion 事件的类型 */
 	LinkedList surfaces;		/**< 表面列表 */
 	LCUI_X11AppDriver app;		/**< X11 应用驱动 */
 	LCUI_EventTrigger trigger;	/**< 事件触发器 */
+	LCUI_X11DisplayStatsRec stats;	/**< 呈现操作的统计信息 */
 } x11 = {0};
 
 /** 添加需要忽略的尺寸 */
@@ -160,6 +179,101 @@ static LCUI_Surface GetSurfaceByWindow( Window win )
 	return NULL;
 }
 
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+static LCUI_BOOL shm_error = FALSE;
+
+static int OnShmError( Display *dpy, XErrorEvent *ev )
+{
+	shm_error = TRUE;
+	return 0;
+}
+
+/** 创建位于共享内存中的 XImage，X 服务器可以直接读取它的数据 */
+static LCUI_BOOL X11Surface_CreateShmImage( LCUI_Surface s, Visual *visual,
+					    int depth, int width, int height )
+{
+	size_t size;
+	XErrorHandler handler;
+	Display *dpy = x11.app->display;
+
+	s->ximage = XShmCreateImage( dpy, visual, depth, ZPixmap, NULL,
+				     &s->shminfo, width, height );
+	if( !s->ximage ) {
+		return FALSE;
+	}
+	/* 帧缓存的每一行之间不能有填充字节 */
+	if( s->ximage->bytes_per_line != width * 4 ) {
+		goto failed;
+	}
+	size = (size_t)s->ximage->bytes_per_line * height;
+	s->shminfo.shmid = shmget( IPC_PRIVATE, size, IPC_CREAT | 0600 );
+	if( s->shminfo.shmid < 0 ) {
+		goto failed;
+	}
+	s->shminfo.shmaddr = shmat( s->shminfo.shmid, NULL, 0 );
+	if( s->shminfo.shmaddr == (char*)-1 ) {
+		shmctl( s->shminfo.shmid, IPC_RMID, NULL );
+		goto failed;
+	}
+	s->shminfo.readOnly = False;
+	/* 远程的 X 服务器无法访问共享内存，XShmAttach() 的错误是异步返回的，
+	 * 所以需要同步一次，确认附加成功后才能使用 */
+	shm_error = FALSE;
+	handler = XSetErrorHandler( OnShmError );
+	XShmAttach( dpy, &s->shminfo );
+	XSync( dpy, False );
+	XSetErrorHandler( handler );
+	/* 标记删除共享内存段，双方都分离后由系统回收 */
+	shmctl( s->shminfo.shmid, IPC_RMID, NULL );
+	if( shm_error ) {
+		shmdt( s->shminfo.shmaddr );
+		x11.has_shm = FALSE;
+		printf("[x11display] MIT-SHM is unavailable, fallback to "
+		       "XPutImage.\n");
+		goto failed;
+	}
+	s->ximage->data = s->shminfo.shmaddr;
+	s->fb.w = width;
+	s->fb.h = height;
+	s->fb.bytes_per_pixel = 4;
+	s->fb.bytes_per_row = s->ximage->bytes_per_line;
+	s->fb.mem_size = size;
+	s->fb.bytes = (uchar_t*)s->shminfo.shmaddr;
+	memset( s->fb.bytes, 0, size );
+	s->use_shm = TRUE;
+	return TRUE;
+
+failed:
+	XDestroyImage( s->ximage );
+	s->ximage = NULL;
+	return FALSE;
+}
+#endif
+
+static void X11Surface_FreeImage( LCUI_Surface s )
+{
+	if( !s->ximage ) {
+		return;
+	}
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	if( s->use_shm ) {
+		XShmDetach( x11.app->display, &s->shminfo );
+		/* 数据在共享内存中，不能被 XDestroyImage() 释放 */
+		s->ximage->data = NULL;
+		XDestroyImage( s->ximage );
+		shmdt( s->shminfo.shmaddr );
+		s->ximage = NULL;
+		s->use_shm = FALSE;
+		s->shm_busy = FALSE;
+		LCUICond_Broadcast( &s->shm_cond );
+		return;
+	}
+#endif
+	/* 帧缓存的内存会随 XImage 一起释放 */
+	XDestroyImage( s->ximage );
+	s->ximage = NULL;
+}
+
 static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 {
 	int depth;
@@ -168,10 +282,7 @@ static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 	if( width == s->width && height == s->height ) {
 		return;
 	}
-	if( s->ximage ) {
-		XDestroyImage( s->ximage );
-		s->ximage = NULL;
-	}
+	X11Surface_FreeImage( s );
 	if( s->gc ) {
 		XFreeGC( x11.app->display, s->gc );
 		s->gc = NULL;
@@ -189,11 +300,17 @@ static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 		printf("[x11display] unsupport depth: %d.\n", depth);
 		break;
 	}
-	Graph_Create( &s->fb, width, height );
 	visual = DefaultVisual( x11.app->display, x11.app->screen );
-    	s->ximage = XCreateImage( x11.app->display, visual, depth, ZPixmap, 
-    				  0, (char *)(s->fb.bytes),
-                      		  width, height, 32, 0 );
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	if( !x11.has_shm || s->fb.color_type != COLOR_TYPE_ARGB ||
+	    !X11Surface_CreateShmImage( s, visual, depth, width, height ) )
+#endif
+	{
+		Graph_Create( &s->fb, width, height );
+		s->ximage = XCreateImage( x11.app->display, visual, depth, 
+					  ZPixmap, 0, (char *)(s->fb.bytes),
+					  width, height, 32, 0 );
+	}
 	if( !s->ximage ) {
 		Graph_Free( &s->fb );
 		printf("[x11display] create XImage faild.\n");
@@ -216,7 +333,10 @@ static void X11Surface_OnCreate( LCUI_Surface s )
 					 0, 100, MIN_WIDTH, MIN_HEIGHT, 1, 
 					 bdcolor, bgcolor );
 	LCUIMutex_Init( &s->mutex );
-	LinkedList_Init( &s->rects );
+	LCUIRWLock_Init( &s->fb_lock );
+	LCUICond_Init( &s->shm_cond );
+	Region_Init( &s->rects );
+	Region_Init( &s->upload );
 	LinkedList_Init( &s->ignored_size );
 	LCUI_SetLinuxX11MainWindow( s->window );
 }
@@ -234,6 +354,8 @@ static void X11Surface_OnTask( LCUI_Surface surface, LCUI_SurfaceTask task )
 		int w = task->width , h = task->height;
 		w = MIN_WIDTH > w ? MIN_WIDTH: w;
 		h = MIN_HEIGHT > h ? MIN_HEIGHT: h;
+		/* 等待渲染线程绘制完当前帧后再重新分配帧缓存 */
+		LCUIRWLock_WriteLock( &surface->fb_lock );
 		LCUIMutex_Lock( &surface->mutex );
 		X11Surface_OnResize( surface, w, h );
 		/* 如果当前尺寸没有被忽略，则修改 x11 窗口的尺寸 */
@@ -241,6 +363,7 @@ static void X11Surface_OnTask( LCUI_Surface surface, LCUI_SurfaceTask task )
 			XResizeWindow( dpy, win, w, h );
 		}
 		LCUIMutex_Unlock( &surface->mutex );
+		LCUIRWLock_WriteUnlock( &surface->fb_lock );
 		break;
 	}
 	case TASK_MOVE: 
@@ -262,25 +385,79 @@ static void X11Surface_OnTask( LCUI_Surface surface, LCUI_SurfaceTask task )
         	XSetWMName( dpy, win, &name );
         	break;
         }
-        case TASK_PRESENT: {
-		LinkedListNode *node;
-		LCUIMutex_Lock( &surface->mutex );
-		LinkedList_ForEach( node, &surface->rects ) {
-			LCUI_Rect *rect = node->data;
-			XPutImage( x11.app->display, surface->window, 
-				   surface->gc, surface->ximage, 
-				   rect->x, rect->y, rect->x, rect->y, 
-				   rect->width, rect->height );
-		}
-		LinkedList_Clear( &surface->rects, free );
-		LCUIMutex_Unlock( &surface->mutex );
-		break;
-        }
 	case TASK_DELETE:
 	default: break;
 	}
 }
 
+/**
+ * 将帧缓存中的无效区域上传至窗口
+ * 只发送请求而不等待 X 服务器处理完，以便与下一帧的绘制并行进行
+ */
+static void X11Surface_OnPresent( void *arg1, void *arg2 )
+{
+	int i;
+	LCUI_Rect *rect;
+	LCUI_Surface s = arg1;
+	Display *dpy = x11.app->display;
+
+	LCUIMutex_Lock( &s->mutex );
+	s->present_pending = FALSE;
+	if( !s->ximage || !s->gc ) {
+		Region_Clear( &s->rects );
+		LCUIMutex_Unlock( &s->mutex );
+		return;
+	}
+	/* 用外接矩形代替浪费面积较小的相邻矩形，以减少上传请求的数量 */
+	Region_Clear( &s->upload );
+	for( i = 0; i < s->rects.length; ++i ) {
+		Region_AddRect( &s->upload, &s->rects.rects[i] );
+	}
+	Region_Clear( &s->rects );
+	for( i = 0; i < s->upload.length; ++i ) {
+		rect = &s->upload.rects[i];
+		x11.stats.pixels += rect->width * rect->height;
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+		if( s->use_shm ) {
+			/* 只有最后一个请求需要在完成后发送通知，X 服务器按顺序
+			 * 处理请求，收到它时整个帧缓存都已读取完毕 */
+			XShmPutImage( dpy, s->window, s->gc, s->ximage, 
+				      rect->x, rect->y, rect->x, rect->y,
+				      rect->width, rect->height, 
+				      i == s->upload.length - 1 );
+			continue;
+		}
+#endif
+		XPutImage( dpy, s->window, s->gc, s->ximage, 
+			   rect->x, rect->y, rect->x, rect->y, 
+			   rect->width, rect->height );
+	}
+	if( s->use_shm && s->upload.length > 0 ) {
+		s->shm_busy = TRUE;
+	}
+	x11.stats.presents += 1;
+	x11.stats.rects += s->upload.length;
+	LCUIMutex_Unlock( &s->mutex );
+	XFlush( dpy );
+}
+
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+/** 响应 ShmCompletion 事件，此时 X 服务器已经读取完帧缓存 */
+static void OnShmCompletion( LCUI_Event e, void *arg )
+{
+	XEvent *ev = arg;
+	XShmCompletionEvent *ce = (XShmCompletionEvent*)ev;
+	LCUI_Surface s = GetSurfaceByWindow( ce->drawable );
+	if( !s ) {
+		return;
+	}
+	LCUIMutex_Lock( &s->mutex );
+	s->shm_busy = FALSE;
+	LCUICond_Broadcast( &s->shm_cond );
+	LCUIMutex_Unlock( &s->mutex );
+}
+#endif
+
 static void X11Surface_SendTask( LCUI_Surface surface, LCUI_SurfaceTask task )
 {
 	LCUI_AppTaskRec apptask;
@@ -311,6 +488,9 @@ static LCUI_Surface X11Surface_New( void )
 	surface = NEW( LCUI_SurfaceRec, 1 );
 	surface->gc = NULL;
 	surface->ximage = NULL;
+	surface->use_shm = FALSE;
+	surface->shm_busy = FALSE;
+	surface->present_pending = FALSE;
 	surface->is_ready = FALSE;
 	surface->node.data = surface;
 	surface->timestamp = LCUI_GetTime();
@@ -401,36 +581,46 @@ static void X11Surface_SetRenderMode( LCUI_Surface surface, int mode )
 static LCUI_PaintContext X11Surface_BeginPaint( LCUI_Surface surface, 
 						LCUI_Rect *rect )
 {
-	LCUI_PaintContext paint;
-	paint = malloc(sizeof(LCUI_PaintContextRec));
-	paint->rect = *rect;
-	paint->with_alpha = FALSE;
-	Graph_Init( &paint->canvas );
-	LCUIMutex_Lock( &surface->mutex );
-	LCUIRect_ValidateArea( &paint->rect, surface->width, surface->height );
-	Graph_Quote( &paint->canvas, &surface->fb, &paint->rect );
-	Graph_FillRect( &paint->canvas, RGB( 255, 255, 255 ), NULL, TRUE );
-	return paint;
+	/* 共享内存中的帧缓存在 X 服务器读取完之前不能修改，否则会出现画面撕裂。
+	 * 读取完的通知由主线程处理，而主线程调整尺寸时会等待绘制结束，所以要
+	 * 在锁定帧缓存之前等待 */
+	if( surface->shm_busy ) {
+		LCUIMutex_Lock( &surface->mutex );
+		if( surface->shm_busy ) {
+			x11.stats.waits += 1;
+			LCUICond_TimedWait( &surface->shm_cond, &surface->mutex,
+					    SHM_WAIT_TIMEOUT );
+		}
+		LCUIMutex_Unlock( &surface->mutex );
+	}
+	return LCUIDisplay_BeginPaintBuffer( &surface->fb_lock,
+					     &surface->fb, rect );
 }
 
 static void X11Surface_EndPaint( LCUI_Surface surface, 
 				LCUI_PaintContext paint )
 {
-	LCUI_Rect *r;
-	r = NEW( LCUI_Rect, 1 );
-	*r = paint->rect;
-	LinkedList_Append( &surface->rects, r );
-	free( paint );
-	LCUIMutex_Unlock( &surface->mutex );
+	LCUIDisplay_EndPaintBuffer( &surface->fb_lock, &surface->mutex,
+				    &surface->rects, paint );
 }
 
-/** 将帧缓存中的数据呈现至Surface的窗口内 */
+/**
+ * 将帧缓存中的数据呈现至Surface的窗口内
+ * 在呈现任务被处理前，多次呈现的无效区域会合并到一起，只需投递一次任务
+ */
 static void X11Surface_Present( LCUI_Surface surface )
 {
-
-	LCUI_SurfaceTaskRec task;
-	task.type = TASK_PRESENT;
-	X11Surface_SendTask( surface, &task );
+	LCUI_AppTaskRec task = { 0 };
+	LCUIMutex_Lock( &surface->mutex );
+	if( surface->present_pending || Region_IsEmpty( &surface->rects ) ) {
+		LCUIMutex_Unlock( &surface->mutex );
+		return;
+	}
+	surface->present_pending = TRUE;
+	LCUIMutex_Unlock( &surface->mutex );
+	task.func = X11Surface_OnPresent;
+	task.arg[0] = surface;
+	LCUI_PostTask( &task );
 }
 
 /** 更新 surface，应用缓存的变更 */
@@ -509,12 +699,14 @@ static void OnConfigureNotify( LCUI_Event e, void *arg )
 
 }
 
-int LCUI_InitLinuxX11Display( LCUI_DisplayDriver driver )
+LCUI_DisplayDriver LCUI_CreateLinuxX11Display( void )
 {
+	ASSIGN( driver, LCUI_DisplayDriver );
 	strcpy( driver->name, "x11" );
 	x11.app = LCUI_GetAppData();
 	if( !x11.app ) {
-		return -1;
+		free( driver );
+		return NULL;
 	}
 	driver->getWidth = X11Display_GetWidth;
 	driver->getHeight = X11Display_GetHeight;
@@ -535,17 +727,44 @@ int LCUI_InitLinuxX11Display( LCUI_DisplayDriver driver )
 	driver->endPaint = X11Surface_EndPaint;
 	driver->bindEvent = WinDisplay_BindEvent;
 	LinkedList_Init( &x11.surfaces );
+	memset( &x11.stats, 0, sizeof( x11.stats ) );
+	x11.has_shm = FALSE;
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	/* 设置环境变量 LCUI_X11_NO_SHM 可禁用 MIT-SHM，便于对比性能 */
+	if( !getenv( "LCUI_X11_NO_SHM" ) && 
+	    XShmQueryExtension( x11.app->display ) ) {
+		x11.has_shm = TRUE;
+		x11.shm_completion = XShmGetEventBase( x11.app->display );
+		x11.shm_completion += ShmCompletion;
+		LCUI_BindSysEvent( x11.shm_completion, OnShmCompletion, 
+				   NULL, NULL );
+	}
+#endif
 	LCUI_BindSysEvent( Expose, OnExpose, NULL, NULL );
 	LCUI_BindSysEvent( ConfigureNotify, OnConfigureNotify, NULL, NULL );
 	x11.trigger = EventTrigger();
 	x11.is_inited = TRUE;
-	return 0;
+	return driver;
 }
 
-int LCUI_ExitLinuxX11Display( void )
+void LCUI_GetLinuxX11DisplayStats( LCUI_X11DisplayStats stats )
 {
-	// ...
-	return 0;
+	LinkedListNode *node;
+	*stats = x11.stats;
+	stats->use_shm = FALSE;
+	for( LinkedList_Each( node, &x11.surfaces ) ) {
+		if( ((LCUI_Surface)node->data)->use_shm ) {
+			stats->use_shm = TRUE;
+		}
+	}
+}
+
+void LCUI_DestroyLinuxX11Display( LCUI_DisplayDriver driver )
+{
+	EventTrigger_Destroy( x11.trigger );
+	x11.is_inited = FALSE;
+	x11.trigger = NULL;
+	free( driver );
 }
 
 #endif
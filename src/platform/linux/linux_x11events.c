@@ -39,13 +39,29 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
-#ifdef LCUI_BUILD_IN_LINUX
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_X11)
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
 #include <LCUI/LCUI.h>
 #include <LCUI/display.h>
 #include <LCUI/platform.h>
 #include LCUI_EVENTS_H
 
+/**
+ * 等待事件的最长时间，单位为毫秒
+ * 检查完事件队列之后、开始等待之前，其它线程调用的 Xlib 函数可能会把事件
+ * 读入队列，此时连接不再可读，需要超时后再检查一次，以免事件一直得不到处理
+ */
+#define WAIT_TIMEOUT	50
+
 static LCUI_X11AppDriverRec x11;
 
 void LCUI_SetLinuxX11MainWindow( Window win )
@@ -59,34 +75,107 @@ void LCUI_SetLinuxX11MainWindow( Window win )
 	LCUI_SetTaskAgent( FALSE );
 }
 
+/**
+ * 创建用于唤醒事件循环的文件描述符
+ * 优先使用 eventfd，不支持时用管道代替
+ */
+static int X11_CreateWakeupFd( void )
+{
+	int i;
+#ifdef HAVE_SYS_EVENTFD_H
+	int fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	if( fd >= 0 ) {
+		x11.wakeup_fd[0] = x11.wakeup_fd[1] = fd;
+		return 0;
+	}
+#endif
+	if( pipe( x11.wakeup_fd ) != 0 ) {
+		x11.wakeup_fd[0] = x11.wakeup_fd[1] = -1;
+		return -1;
+	}
+	for( i = 0; i < 2; ++i ) {
+		fcntl( x11.wakeup_fd[i], F_SETFL, O_NONBLOCK );
+		fcntl( x11.wakeup_fd[i], F_SETFD, FD_CLOEXEC );
+	}
+	return 0;
+}
+
+static void X11_DestroyWakeupFd( void )
+{
+	if( x11.wakeup_fd[0] < 0 ) {
+		return;
+	}
+	close( x11.wakeup_fd[0] );
+	if( x11.wakeup_fd[1] != x11.wakeup_fd[0] ) {
+		close( x11.wakeup_fd[1] );
+	}
+	x11.wakeup_fd[0] = x11.wakeup_fd[1] = -1;
+}
+
+/** 读出唤醒文件描述符中的所有数据，让它恢复为不可读的状态 */
+static void X11_ClearWakeup( void )
+{
+	uint64_t buf[8];
+	while( read( x11.wakeup_fd[0], buf, sizeof( buf ) ) > 0 );
+}
+
+/**
+ * 唤醒事件循环
+ * 任务队列只在从空变为非空时调用它，所以连续添加多个任务只需要唤醒一次，
+ * 也不需要再经过 X 服务器转发消息
+ */
 static LCUI_BOOL X11_PostTask( LCUI_AppTask task )
 {
+	uint64_t value = 1;
 	XEvent ev;
+	if( x11.wakeup_fd[1] >= 0 ) {
+		/* 写满时说明已经有未处理的唤醒，同样算是成功 */
+		if( write( x11.wakeup_fd[1], &value, sizeof( value ) ) > 0 ) {
+			return TRUE;
+		}
+		return errno == EAGAIN;
+	}
 	memset( &ev, 0, sizeof (ev) );
 	ev.xclient.type = ClientMessage;
 	ev.xclient.window = x11.win_main;
 	ev.xclient.format = 32;
 	ev.xclient.message_type = x11.wm_lcui;
 	XSendEvent( x11.display, x11.win_main, FALSE, NoEventMask, &ev );
+	XFlush( x11.display );
 	return TRUE;
 }
 
 static LCUI_BOOL X11_WaitEvent( void )
 {
-	int fd;
-	fd_set fdset;
-	struct timeval tv;
-	XFlush( x11.display );
-	fd = ConnectionNumber( x11.display );
-	if( XEventsQueued(x11.display, QueuedAlready) ) {
+	int n = 1;
+	struct pollfd fds[2];
+	/* 读出连接中已到达的事件，锁定后其它线程不会同时读取 */
+	XLockDisplay( x11.display );
+	if( XEventsQueued(x11.display, QueuedAfterFlush) ) {
+		XUnlockDisplay( x11.display );
+		return TRUE;
+	}
+	XUnlockDisplay( x11.display );
+	fds[0].fd = ConnectionNumber( x11.display );
+	fds[0].events = POLLIN;
+	fds[0].revents = 0;
+	if( x11.wakeup_fd[0] >= 0 ) {
+		fds[1].fd = x11.wakeup_fd[0];
+		fds[1].events = POLLIN;
+		fds[1].revents = 0;
+		n = 2;
+	}
+	/* 没有待处理的事件和任务时等待，直到 X 服务器发来事件、被添加任务的
+	 * 线程唤醒或者超时 */
+	if( poll( fds, n, n > 1 ? WAIT_TIMEOUT : 10 ) <= 0 ) {
+		return FALSE;
+	}
+	if( n > 1 && (fds[1].revents & POLLIN) ) {
+		X11_ClearWakeup();
 		return TRUE;
 	}
-	FD_ZERO( &fdset );
-	FD_SET( fd, &fdset );
-	tv.tv_sec = 0;
-	tv.tv_usec = 10000;
-	if( select(fd + 1, &fdset, NULL, NULL, &tv) == 1 ) {
-	    return XPending( x11.display );
+	if( fds[0].revents & POLLIN ) {
+		return XPending( x11.display );
 	}
 	return FALSE;
 }
@@ -131,17 +220,22 @@ void LCUI_PreInitLinuxX11App( void *data )
 	return;
 }
 
-int LCUI_InitLinuxX11App( LCUI_AppDriver app )
+LCUI_AppDriver LCUI_CreateLinuxX11AppDriver( void )
 {
+	ASSIGN( app, LCUI_AppDriver );
+	/* 显示驱动和其它线程也会使用同一个连接，需要让 Xlib 支持多线程 */
+	XInitThreads();
 	x11.display = XOpenDisplay( NULL );
 	if( !x11.display ) {
-		return -1;
+		free( app );
+		return NULL;
 	}
 	x11.screen = DefaultScreen( x11.display );
 	x11.win_root = RootWindow( x11.display, x11.screen );
 	x11.cmap = DefaultColormap( x11.display, x11.screen );
 	x11.wm_lcui = XInternAtom( x11.display, "WM_LCUI", FALSE );
 	XSetWMProtocols( x11.display, x11.win_root, &x11.wm_lcui, 1 );
+	X11_CreateWakeupFd();
 	app->WaitEvent = X11_WaitEvent;
 	app->DispatchEvent = X11_DispatchEvent;
 	app->PostTask = X11_PostTask;
@@ -150,7 +244,17 @@ int LCUI_InitLinuxX11App( LCUI_AppDriver app )
 	app->UnbindSysEvent2 = X11_UnbindSysEvent2;
 	app->GetData = X11_GetData;
 	x11.trigger = EventTrigger();
-	return 0;
+	return app;
+}
+
+void LCUI_DestroyLinuxX11AppDriver( LCUI_AppDriver app )
+{
+	EventTrigger_Destroy( x11.trigger );
+	X11_DestroyWakeupFd();
+	XCloseDisplay( x11.display );
+	x11.trigger = NULL;
+	x11.display = NULL;
+	free( app );
 }
 
 #endif
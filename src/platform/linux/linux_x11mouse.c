@@ -40,7 +40,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <LCUI_Build.h>
-#ifdef LCUI_BUILD_IN_LINUX
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_X11)
 #include <LCUI/LCUI.h>
 #include <LCUI/platform.h>
 #include LCUI_EVENTS_H
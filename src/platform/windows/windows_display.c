@@ -303,10 +303,10 @@ static void WinSurface_SetRenderMode( LCUI_Surface surface, int mode )
 static LCUI_PaintContext WinSurface_BeginPaint( LCUI_Surface surface, LCUI_Rect *rect )
 {
 	LCUI_PaintContext paint;
-	paint = malloc(sizeof(LCUI_PaintContextRec));
-	paint->rect = *rect;
-	paint->with_alpha = FALSE;
-	Graph_Init( &paint->canvas );
+	paint = LCUIDisplay_NewPaintContext( rect );
+	if( !paint ) {
+		return NULL;
+	}
 	LCUIRect_ValidateArea( &paint->rect, surface->w, surface->h );
 	Graph_Quote( &paint->canvas, &surface->fb, &paint->rect );
 	Graph_FillRect( &paint->canvas, RGB( 255, 255, 255 ), NULL, TRUE );
@@ -320,7 +320,7 @@ static LCUI_PaintContext WinSurface_BeginPaint( LCUI_Surface surface, LCUI_Rect
 */
 static void WinSurface_EndPaint( LCUI_Surface surface, LCUI_PaintContext paint_ctx )
 {
-	free( paint_ctx );
+	LCUIDisplay_FreePaintContext( paint_ctx );
 }
 
 /** 将帧缓存中的数据呈现至Surface的窗口内 */
@@ -43,12 +43,19 @@
 
 #ifdef LCUI_BUILD_IN_LINUX
 #include <errno.h>
-#include <sys/time.h>
+#include <time.h>
 
 /** 初始化一个条件变量 */
 int LCUICond_Init( LCUI_Cond *cond )
 {
-	return pthread_cond_init( cond, NULL );
+	int ret;
+	pthread_condattr_t attr;
+	pthread_condattr_init( &attr );
+	/* 按单调时钟计算超时，以免系统时间被修改后等待时间出错 */
+	pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+	ret = pthread_cond_init( cond, &attr );
+	pthread_condattr_destroy( &attr );
+	return ret;
 }
 
 /** 销毁一个条件变量 */
@@ -67,14 +74,15 @@ int LCUICond_Wait( LCUI_Cond *cond, LCUI_Mutex *mutex )
 int LCUICond_TimedWait( LCUI_Cond *cond, LCUI_Mutex *mutex, unsigned int ms )
 {
 	int ret;
-	long int out_usec;
-	struct timeval now;
 	struct timespec outtime;
 
-	gettimeofday(&now, NULL);
-	out_usec = now.tv_usec + ms*1000;
-	outtime.tv_sec = now.tv_sec + out_usec / 1000000;
-	outtime.tv_nsec = (out_usec % 1000000) *1000;
+	clock_gettime( CLOCK_MONOTONIC, &outtime );
+	outtime.tv_sec += ms / 1000;
+	outtime.tv_nsec += (long)(ms % 1000) * 1000000;
+	if( outtime.tv_nsec >= 1000000000 ) {
+		outtime.tv_sec += 1;
+		outtime.tv_nsec -= 1000000000;
+	}
 	DEBUG_MSG("wait, ms = %u, outtime.tv_nsec: %ld\n", ms, outtime.tv_nsec);
 	ret = pthread_cond_timedwait( cond, mutex, &outtime );
 	DEBUG_MSG("ret: %d, ETIMEDOUT = %d, EINVAL = %d\n", ret, ETIMEDOUT, EINVAL);
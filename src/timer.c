@@ -40,6 +40,7 @@
 //#define DEBUG
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/thread.h>
@@ -47,6 +48,7 @@
 
 #define STATE_RUN	1
 #define STATE_PAUSE	0
+#define HEAP_MIN_SIZE	16
 
 /*----------------------------- Timer --------------------------------*/
 
@@ -54,18 +56,22 @@ typedef struct TimerRec_ {
 	int state;			/**< 状态 */
 	LCUI_BOOL reuse;		/**< 是否重复使用该定时器 */
 	long int id;			/**< 定时器ID */
-	int64_t start_time;		/**< 定时器启动时的时间 */
-	int64_t pause_time;		/**< 定时器暂停时的时间 */
+	int64_t deadline;		/**< 到期时间（单位：毫秒） */
+	int64_t remain_ms;		/**< 暂停时剩余的定时时长（单位：毫秒） */
 	long int total_ms;		/**< 定时时间（单位：毫秒） */
-	long int pause_ms;		/**< 定时器处于暂停状态的时长（单位：毫秒） */
+	int index;			/**< 在定时器堆中的位置，暂停时为 -1 */
 	void (*func)(void*);		/**< 回调函数 */
 	void *arg;			/**< 函数的参数 */
-	LinkedListNode node;		/**< 位于定时器列表中的节点 */
 } TimerRec, *Timer;
 
 static struct TimerModule {
 	int id_count;			/**< 定时器ID计数 */
-	LinkedList timer_list;		/**< 定时器数据记录 */
+	RBTree timers;			/**< 以ID为索引的定时器记录 */
+	struct {
+		Timer *timers;		/**< 按到期时间排列的最小堆 */
+		int length;		/**< 堆中的定时器数量 */
+		int size;		/**< 堆的容量 */
+	} heap;
 	LCUI_BOOL is_running;		/**< 定时器线程是否正在运行 */
 	LCUI_Cond sleep_cond;		/**< 用于控制定时器睡眠的条件变量 */
 	LCUI_Mutex mutex;		/**< 定时器记录操作互斥锁 */
@@ -74,91 +80,156 @@ static struct TimerModule {
 
 /*----------------------------- Private ------------------------------*/
 
-/** 更新定时器在定时器列表中的位置 */
-static void TimerList_AddNode( LinkedListNode *node )
+/** 比较两个定时器的到期顺序，到期时间相同时先设置的先到期 */
+static LCUI_BOOL Timer_IsBefore( Timer a, Timer b )
 {
-	Timer timer;
-	int64_t t, tt;
-	LinkedListNode *cur;
-	/* 计算该定时器的剩余定时时长 */
-	timer = node->data;
-	t = LCUI_GetTimeDelta( timer->start_time );
-	t = timer->total_ms - t + timer->pause_ms;
-	for( LinkedList_Each( cur, &self.timer_list ) ) {
-		timer = cur->data;
-		tt = LCUI_GetTimeDelta( timer->start_time );
-		tt = timer->total_ms - tt + timer->pause_ms;
-		if( t <= tt ) {
-			LinkedList_Link( &self.timer_list, cur->prev, node );
-			return;
+	if( a->deadline != b->deadline ) {
+		return a->deadline < b->deadline;
+	}
+	return a->id < b->id;
+}
+
+static void TimerHeap_Set( int i, Timer timer )
+{
+	self.heap.timers[i] = timer;
+	timer->index = i;
+}
+
+static void TimerHeap_SiftUp( int i )
+{
+	int parent;
+	Timer timer = self.heap.timers[i];
+	while( i > 0 ) {
+		parent = (i - 1) / 2;
+		if( !Timer_IsBefore( timer, self.heap.timers[parent] ) ) {
+			break;
 		}
+		TimerHeap_Set( i, self.heap.timers[parent] );
+		i = parent;
 	}
-	LinkedList_AppendNode( &self.timer_list, node );
+	TimerHeap_Set( i, timer );
+}
+
+static void TimerHeap_SiftDown( int i )
+{
+	int child;
+	Timer timer = self.heap.timers[i];
+	while( (child = i * 2 + 1) < self.heap.length ) {
+		if( child + 1 < self.heap.length &&
+		    Timer_IsBefore( self.heap.timers[child + 1],
+				    self.heap.timers[child] ) ) {
+			++child;
+		}
+		if( !Timer_IsBefore( self.heap.timers[child], timer ) ) {
+			break;
+		}
+		TimerHeap_Set( i, self.heap.timers[child] );
+		i = child;
+	}
+	TimerHeap_Set( i, timer );
+}
+
+/** 在到期时间改变后调整定时器在堆中的位置 */
+static void TimerHeap_Update( Timer timer )
+{
+	int i = timer->index;
+	if( i > 0 && Timer_IsBefore( timer, self.heap.timers[(i - 1) / 2] ) ) {
+		TimerHeap_SiftUp( i );
+	} else {
+		TimerHeap_SiftDown( i );
+	}
+}
+
+static int TimerHeap_Push( Timer timer )
+{
+	int size;
+	Timer *timers;
+	if( self.heap.length >= self.heap.size ) {
+		size = self.heap.size * 2;
+		if( size < HEAP_MIN_SIZE ) {
+			size = HEAP_MIN_SIZE;
+		}
+		timers = realloc( self.heap.timers, sizeof( Timer ) * size );
+		if( !timers ) {
+			return -ENOMEM;
+		}
+		self.heap.timers = timers;
+		self.heap.size = size;
+	}
+	TimerHeap_Set( self.heap.length, timer );
+	self.heap.length += 1;
+	TimerHeap_SiftUp( timer->index );
+	return 0;
+}
+
+static void TimerHeap_Remove( Timer timer )
+{
+	int i = timer->index;
+	if( i < 0 ) {
+		return;
+	}
+	timer->index = -1;
+	self.heap.length -= 1;
+	if( i == self.heap.length ) {
+		return;
+	}
+	TimerHeap_Set( i, self.heap.timers[self.heap.length] );
+	TimerHeap_Update( self.heap.timers[i] );
 }
 
 //#define DEBUG_TIMER
 #ifdef DEBUG_TIMER
-/** 打印列表中的定时器信息 */
-static void TimerList_Print( void )
+/** 打印堆中的定时器信息 */
+static void TimerHeap_Print( void )
 {
-	int i = 0;
+	int i;
 	Timer timer;
-	LinkedListNode *node;
-	_DEBUG_MSG("timer list(%d) start:\n", self.timer_list.length);
-	for( LinkedList_Each( node, &self.timer_list ) {
-		timer = node->data;
-		_DEBUG_MSG("[%02d] %ld, func: %p, cur_ms: %ldms, total_ms: %ldms\n",
-			i++, timer->id, timer->func, timer->total_ms - (long int)LCUI_GetTimeDelta(timer->start_time), timer->total_ms );
+	int64_t now = LCUI_GetTime();
+	_DEBUG_MSG("timer heap(%d) start:\n", self.heap.length);
+	for( i = 0; i < self.heap.length; ++i ) {
+		timer = self.heap.timers[i];
+		_DEBUG_MSG("[%02d] %ld, func: %p, remain_ms: %ldms, total_ms: %ldms\n",
+			i, timer->id, timer->func, (long int)(timer->deadline - now), timer->total_ms );
 	}
-	_DEBUG_MSG("timer list end\n\n");
+	_DEBUG_MSG("timer heap end\n\n");
 }
 #endif
 
-
-/** 定时器线程，用于处理列表中各个定时器 */
+/** 定时器线程，用于处理堆中已到期的定时器 */
 static void TimerThread( void *arg )
 {
-	long int n_ms;
-	int64_t lost_ms;
-	LinkedListNode *node;
+	Timer timer;
+	int64_t now;
 	LCUI_AppTaskRec task = {0};
 	LCUIMutex_Lock( &self.mutex );
 	while( self.is_running ) {
-		Timer timer = NULL;
-		for( LinkedList_Each( node, &self.timer_list ) ) {
-			timer = node->data;
-			if( timer && timer->state == STATE_RUN ) {
-				break;
-			}
-		}
-		/* 没有要处理的定时器，停留一段时间再进行下次循环 */
-		if( !node ) {
-			LCUIMutex_Unlock( &self.mutex );
-			LCUI_MSleep( 10 );
-			LCUIMutex_Lock( &self.mutex );
+		/* 没有要处理的定时器，等到有新的定时器时再继续 */
+		if( self.heap.length < 1 ) {
+			LCUICond_Wait( &self.sleep_cond, &self.mutex );
 			continue;
 		}
-		lost_ms = LCUI_GetTimeDelta( timer->start_time );
-		/* 减去处于暂停状态的时长 */
-		lost_ms -= timer->pause_ms;
-		/* 若流失的时间未达到总定时时长，则睡眠一段时间 */
-		if( lost_ms < timer->total_ms ) {
-			n_ms = timer->total_ms - lost_ms;
-			LCUICond_TimedWait( &self.sleep_cond,
-					    &self.mutex, n_ms );
+		timer = self.heap.timers[0];
+		now = LCUI_GetTime();
+		/* 若最早到期的定时器还未到期，则睡眠到它的到期时间 */
+		if( timer->deadline > now ) {
+			LCUICond_TimedWait( &self.sleep_cond, &self.mutex,
+					    (unsigned int)(timer->deadline - now) );
 			continue;
 		}
 		/* 准备任务数据 */
 		task.func = (LCUI_AppTaskFunc)timer->func;
 		task.arg[0] = timer->arg;
-		/* 若需要重复使用，则重置剩余等待时间 */
-		LinkedList_Unlink( &self.timer_list, node );
+		/* 若需要重复使用，则从上次的到期时间开始计算下次的到期时间，
+		 * 以免误差累积，但处理不过来时不补发错过的次数 */
 		if( timer->reuse ) {
-			timer->pause_ms = 0;
-			timer->start_time = LCUI_GetTime();
-			TimerList_AddNode( node );
+			timer->deadline += timer->total_ms;
+			if( timer->deadline <= now ) {
+				timer->deadline = now + timer->total_ms;
+			}
+			TimerHeap_SiftDown( 0 );
 		} else {
-			free( timer );
+			TimerHeap_Remove( timer );
+			RBTree_Erase( &self.timers, timer->id );
 		}
 		/* 添加该任务至指定程序的任务队列 */
 		LCUI_PostTask( &task );
@@ -166,19 +237,6 @@ static void TimerThread( void *arg )
 	LCUIMutex_Unlock( &self.mutex );
 	LCUIThread_Exit( NULL );
 }
-
-static Timer TimerList_Find( int timer_id )
-{
-	Timer timer;
-	LinkedListNode *node;
-	for( LinkedList_Each( node, &self.timer_list ) ) {
-		timer = node->data;
-		if( timer && timer->id == timer_id ) {
-			return timer;
-		}
-	}
-	return NULL;
-}
 /*--------------------------- End Private ----------------------------*/
 
 /*----------------------------- Public -------------------------------*/
@@ -186,28 +244,38 @@ static Timer TimerList_Find( int timer_id )
 int LCUITimer_Set( long int n_ms, void (*func)(void*),
 		   void *arg, LCUI_BOOL reuse )
 {
+	int id;
 	Timer timer;
 	if( !self.is_running ) {
 		return -1;
 	}
-	LCUIMutex_Lock( &self.mutex );
 	timer = malloc( sizeof(TimerRec) );
+	if( !timer ) {
+		return -1;
+	}
+	LCUIMutex_Lock( &self.mutex );
 	timer->arg = arg;
 	timer->func = func;
 	timer->reuse = reuse;
-	timer->pause_ms = 0;
+	timer->remain_ms = 0;
 	timer->total_ms = n_ms;
 	timer->state = STATE_RUN;
 	timer->id = ++self.id_count;
-	timer->start_time = LCUI_GetTime();
-	timer->node.next = NULL;
-	timer->node.prev = NULL;
-	timer->node.data = timer;
-	TimerList_AddNode( &timer->node );
-	LCUICond_Signal( &self.sleep_cond );
+	timer->deadline = LCUI_GetTime() + n_ms;
+	if( TimerHeap_Push( timer ) != 0 ) {
+		LCUIMutex_Unlock( &self.mutex );
+		free( timer );
+		return -1;
+	}
+	RBTree_Insert( &self.timers, timer->id, timer );
+	id = timer->id;
+	/* 只有新的定时器最先到期时才需要唤醒定时器线程 */
+	if( timer->index == 0 ) {
+		LCUICond_Signal( &self.sleep_cond );
+	}
 	LCUIMutex_Unlock( &self.mutex );
-	DEBUG_MSG("set timer, id: %ld, total_ms: %ld\n", timer->id, timer->total_ms);
-	return timer->id;
+	DEBUG_MSG("set timer, id: %d, total_ms: %ld\n", id, n_ms);
+	return id;
 }
 
 int LCUITimer_Free( int timer_id )
@@ -217,14 +285,13 @@ int LCUITimer_Free( int timer_id )
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
+	timer = RBTree_GetData( &self.timers, timer_id );
 	if( !timer ) {
 		LCUIMutex_Unlock( &self.mutex );
 		return -1;
 	}
-	LinkedList_Unlink( &self.timer_list, &timer->node );
-	free( timer );
-	LCUICond_Signal( &self.sleep_cond );
+	TimerHeap_Remove( timer );
+	RBTree_Erase( &self.timers, timer_id );
 	LCUIMutex_Unlock( &self.mutex );
 	return 0;
 }
@@ -236,33 +303,41 @@ int LCUITimer_Pause( int timer_id )
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
-	if( timer ) {
-		/* 记录暂停时的时间 */
-		timer->pause_time = LCUI_GetTime();
+	timer = RBTree_GetData( &self.timers, timer_id );
+	if( timer && timer->state == STATE_RUN ) {
+		/* 记录剩余的定时时长，并移出堆，以免它阻碍其它定时器 */
+		timer->remain_ms = timer->deadline - LCUI_GetTime();
+		if( timer->remain_ms < 0 ) {
+			timer->remain_ms = 0;
+		}
 		timer->state = STATE_PAUSE;
+		TimerHeap_Remove( timer );
 	}
-	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
 	return timer ? 0:-1;
 }
 
 int LCUITimer_Continue( int timer_id )
 {
+	int ret = 0;
 	Timer timer;
 	if( !self.is_running ) {
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
-	if( timer ) {
-		/* 计算处于暂停状态的时长 */
-		timer->pause_ms += (long int)LCUI_GetTimeDelta( timer->pause_time );
+	timer = RBTree_GetData( &self.timers, timer_id );
+	if( !timer ) {
+		ret = -1;
+	} else if( timer->state == STATE_PAUSE ) {
+		timer->deadline = LCUI_GetTime() + timer->remain_ms;
 		timer->state = STATE_RUN;
+		ret = TimerHeap_Push( timer );
+		if( ret == 0 && timer->index == 0 ) {
+			LCUICond_Signal( &self.sleep_cond );
+		}
 	}
-	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
-	return timer ? 0:-1;
+	return ret == 0 ? 0:-1;
 }
 
 int LCUITimer_Reset( int timer_id, long int n_ms )
@@ -272,13 +347,16 @@ int LCUITimer_Reset( int timer_id, long int n_ms )
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
+	timer = RBTree_GetData( &self.timers, timer_id );
 	if( timer ) {
-		timer->pause_ms = 0;
 		timer->total_ms = n_ms;
-		timer->start_time = LCUI_GetTime();
+		timer->remain_ms = n_ms;
+		timer->deadline = LCUI_GetTime() + n_ms;
+		if( timer->state == STATE_RUN ) {
+			TimerHeap_Update( timer );
+			LCUICond_Signal( &self.sleep_cond );
+		}
 	}
-	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
 	return timer ? 0:-1;
 }
@@ -288,19 +366,27 @@ void LCUI_InitTimer( void )
 	LCUITime_Init();
 	LCUIMutex_Init( &self.mutex );
 	LCUICond_Init( &self.sleep_cond );
-	LinkedList_Init( &self.timer_list );
-	LCUIThread_Create( &self.tid, TimerThread, NULL );
+	RBTree_Init( &self.timers );
+	RBTree_OnDestroy( &self.timers, free );
+	self.heap.timers = NULL;
+	self.heap.length = 0;
+	self.heap.size = 0;
 	self.is_running = TRUE;
+	LCUIThread_Create( &self.tid, TimerThread, NULL );
 }
 
 void LCUI_ExitTimer( void )
 {
-	self.is_running = FALSE;
 	LCUIMutex_Lock( &self.mutex );
+	self.is_running = FALSE;
 	LCUICond_Broadcast( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
 	LCUIThread_Join( self.tid, NULL );
-	LinkedList_ClearData( &self.timer_list, free );
+	RBTree_Destroy( &self.timers );
+	free( self.heap.timers );
+	self.heap.timers = NULL;
+	self.heap.length = 0;
+	self.heap.size = 0;
 	LCUICond_Destroy( &self.sleep_cond );
 	LCUIMutex_Destroy( &self.mutex );
 }
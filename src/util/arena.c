@@ -0,0 +1,187 @@
+/* ***************************************************************************
+ * arena.c -- bump allocator for short-lived memory
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * arena.c -- 用于短期内存的线性分配器
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/util/arena.h>
+
+/** 内存块的默认最小容量 */
+#define ARENA_BLOCK_SIZE	(256 * 1024)
+/** 分配的内存的对齐字节数，满足 SSE 指令的对齐要求 */
+#define ARENA_ALIGN		16
+
+#define AlignSize(S) (((S) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+struct LCUI_ArenaBlockRec_ {
+	LCUI_ArenaBlock next;		/**< 下一个内存块 */
+	size_t size;			/**< 可用的容量 */
+	size_t used;			/**< 已分配的字节数 */
+};
+
+/** 内存块头部所占的空间，数据区紧随其后 */
+#define BLOCK_HEADER_SIZE AlignSize( sizeof( LCUI_ArenaBlockRec ) )
+#define BlockData(B) ((uchar_t*)(B) + BLOCK_HEADER_SIZE)
+
+static LCUI_ArenaBlock Arena_NewBlock( LCUI_Arena arena, size_t size )
+{
+	LCUI_ArenaBlock block;
+	if( size < arena->block_size ) {
+		size = arena->block_size;
+	}
+	block = malloc( BLOCK_HEADER_SIZE + size );
+	if( !block ) {
+		return NULL;
+	}
+	block->size = size;
+	block->used = 0;
+	block->next = arena->blocks;
+	arena->blocks = block;
+	arena->capacity += size;
+	arena->blocks_created += 1;
+	return block;
+}
+
+static void Arena_FreeBlocks( LCUI_Arena arena )
+{
+	LCUI_ArenaBlock block, next;
+	for( block = arena->blocks; block; block = next ) {
+		next = block->next;
+		free( block );
+	}
+	arena->blocks = NULL;
+	arena->capacity = 0;
+}
+
+void Arena_Init( LCUI_Arena arena, size_t block_size )
+{
+	arena->blocks = NULL;
+	arena->block_size = block_size > 0 ? block_size : ARENA_BLOCK_SIZE;
+	arena->used = 0;
+	arena->peak = 0;
+	arena->capacity = 0;
+	arena->frames = 0;
+	arena->allocs = 0;
+	arena->blocks_created = 0;
+	arena->trims = 0;
+}
+
+void Arena_Destroy( LCUI_Arena arena )
+{
+	Arena_FreeBlocks( arena );
+	arena->used = 0;
+}
+
+void *Arena_Alloc( LCUI_Arena arena, size_t size )
+{
+	void *ptr;
+	LCUI_ArenaBlock block = arena->blocks;
+
+	size = AlignSize( size > 0 ? size : 1 );
+	if( !block || block->size - block->used < size ) {
+		/* 当前块的剩余空间不会再被使用，直到下次重置 */
+		block = Arena_NewBlock( arena, size );
+		if( !block ) {
+			return NULL;
+		}
+	}
+	ptr = BlockData( block ) + block->used;
+	block->used += size;
+	arena->used += size;
+	arena->allocs += 1;
+	if( arena->used > arena->peak ) {
+		arena->peak = arena->used;
+	}
+	return ptr;
+}
+
+/**
+ * 计算回收周期结束时应保留的容量
+ * 峰值不到容量的一半时缩小到峰值，否则保持不变，以免用量波动时反复申请内存
+ */
+static size_t Arena_GetTrimmedCapacity( LCUI_Arena arena )
+{
+	size_t size = arena->peak;
+	if( size < arena->block_size ) {
+		size = arena->block_size;
+	}
+	if( size * 2 > arena->capacity ) {
+		return arena->capacity;
+	}
+	return size;
+}
+
+void Arena_Reset( LCUI_Arena arena )
+{
+	size_t capacity = arena->capacity;
+	LCUI_BOOL trim = FALSE;
+
+	arena->frames += 1;
+	if( arena->frames >= ARENA_TRIM_FRAMES ) {
+		capacity = Arena_GetTrimmedCapacity( arena );
+		trim = capacity < arena->capacity;
+		arena->frames = 0;
+		arena->peak = 0;
+	}
+	if( arena->blocks && (arena->blocks->next || trim) ) {
+		/* 合并成一个块，以便下次能容纳同样多的数据 */
+		Arena_FreeBlocks( arena );
+		Arena_NewBlock( arena, capacity );
+		if( trim ) {
+			arena->trims += 1;
+		}
+	} else if( arena->blocks ) {
+		arena->blocks->used = 0;
+	}
+	arena->used = 0;
+}
+
+LCUI_BOOL Arena_Contains( LCUI_Arena arena, const void *ptr )
+{
+	LCUI_ArenaBlock block;
+	const uchar_t *p = ptr;
+	for( block = arena->blocks; block; block = block->next ) {
+		if( p >= BlockData( block ) &&
+		    p < BlockData( block ) + block->size ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
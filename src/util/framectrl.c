@@ -55,12 +55,22 @@ typedef struct FrameControlRec_ {
 	int state;
 	LCUI_Cond cond;
 	LCUI_Mutex mutex;
+	unsigned int max_fps;
 	unsigned int temp_fps;
 	unsigned int current_fps;
-	unsigned int one_frame_remain_time;
 	unsigned int pause_time;
+	int64_t one_frame_time;		/**< 一帧的时长（单位：纳秒） */
+	unsigned int one_frame_error;	/**< 一帧的时长中不足一纳秒的部分 */
+	unsigned int frame_error;	/**< 累积的误差，单位为 1/max_fps 纳秒 */
+	int64_t frame_deadline;		/**< 下一帧的开始时间 */
 	int64_t prev_frame_start_time;
 	int64_t prev_fps_update_time;
+	int64_t stage_time[FRAME_STAGE_TOTAL_NUM];	/**< 当前帧各阶段的耗时 */
+	LCUI_BOOL on_demand;		/**< 是否只在收到请求时才开始下一帧 */
+	LCUI_BOOL is_requested;		/**< 是否有开始下一帧的请求 */
+	int64_t idle_start_time;	/**< 开始等待请求的时间，不在等待时为 0 */
+	int64_t period_idle_time;	/**< 当前统计周期内的空闲时长 */
+	LCUI_FrameStatsRec stats;
 } FrameControlRec;
 
 FrameControl FrameControl_Create( void )
@@ -70,9 +80,11 @@ FrameControl FrameControl_Create( void )
 	ctx->temp_fps = 0;
 	ctx->current_fps = 0;
 	ctx->pause_time = 0;
-	ctx->one_frame_remain_time = 10;
-	ctx->prev_frame_start_time = LCUI_GetTime();
-	ctx->prev_fps_update_time = LCUI_GetTime();
+	ctx->prev_frame_start_time = LCUI_GetTimeNS();
+	ctx->prev_fps_update_time = ctx->prev_frame_start_time;
+	ctx->frame_deadline = ctx->prev_frame_start_time;
+	ctx->is_requested = TRUE;
+	FrameControl_SetMaxFPS( ctx, 100 );
 	LCUICond_Init( &ctx->cond );
 	LCUIMutex_Init( &ctx->mutex );
 	return ctx;
@@ -88,7 +100,10 @@ void FrameControl_Destroy( FrameControl ctx )
 
 void FrameControl_SetMaxFPS( FrameControl ctx, unsigned int fps )
 {
-	ctx->one_frame_remain_time = (int)(1000.0/fps);
+	ctx->max_fps = fps;
+	ctx->one_frame_time = 1000000000 / fps;
+	ctx->one_frame_error = 1000000000 % fps;
+	ctx->frame_error = 0;
 }
 
 int FrameControl_GetFPS( FrameControl ctx )
@@ -96,56 +111,131 @@ int FrameControl_GetFPS( FrameControl ctx )
 	return ctx->current_fps;
 }
 
+/** 将当前帧各阶段的耗时计入统计 */
+static void FrameControl_UpdateStats( FrameControl ctx )
+{
+	int i;
+	LCUI_FrameStats stats = &ctx->stats;
+	for( i = 0; i < FRAME_STAGE_TOTAL_NUM; ++i ) {
+		stats->last[i] = ctx->stage_time[i];
+		stats->total[i] += ctx->stage_time[i];
+		if( stats->max[i] < ctx->stage_time[i] ) {
+			stats->max[i] = ctx->stage_time[i];
+		}
+		ctx->stage_time[i] = 0;
+	}
+	stats->frames += 1;
+}
+
+/** 记录空闲的时长，睡眠和等待请求的时间都算作空闲 */
+static void FrameControl_AddIdleTime( FrameControl ctx, int64_t time )
+{
+	ctx->stats.idle_time += time;
+	ctx->period_idle_time += time;
+}
+
 void FrameControl_Remain( FrameControl ctx )
 {
-	int64_t current_time;
-	unsigned int n_ms, lost_ms;
+	int64_t current_time, remain_time;
 
 	if( ctx->state == STATE_QUIT ) {
 		return;
 	}
-	lost_ms = 0;
-	current_time = LCUI_GetTime();
 	LCUIMutex_Lock( &ctx->mutex );
-	n_ms = (unsigned int)(current_time - ctx->prev_frame_start_time);
-	if( n_ms > ctx->one_frame_remain_time ) {
-		goto normal_exit;
+	FrameControl_UpdateStats( ctx );
+	/* 每一帧的开始时间都从上一帧的开始时间推算，而不是从上一帧结束的
+	 * 时间开始计算，整除后余下的误差累积够一纳秒时再补上 */
+	ctx->frame_deadline += ctx->one_frame_time;
+	ctx->frame_error += ctx->one_frame_error;
+	if( ctx->frame_error >= ctx->max_fps ) {
+		ctx->frame_error -= ctx->max_fps;
+		ctx->frame_deadline += 1;
 	}
-	n_ms = ctx->one_frame_remain_time - n_ms;
-	if( n_ms < 1 ) {
-		goto normal_exit;
+	current_time = LCUI_GetTimeNS();
+	if( current_time > ctx->frame_deadline ) {
+		ctx->stats.missed_frames += 1;
+		/* 落后超过一帧时不再追赶，从现在开始重新计时 */
+		if( current_time - ctx->frame_deadline >= ctx->one_frame_time ) {
+			ctx->frame_deadline = current_time;
+		}
 	}
-	/* 睡眠一段时间 */
-	while( lost_ms < n_ms && ctx->state == STATE_RUN ) {
-		LCUICond_TimedWait( &ctx->cond, &ctx->mutex, n_ms - lost_ms );
-		lost_ms = (unsigned int)LCUI_GetTimeDelta( current_time );
+	/* 睡眠到下一帧的开始时间 */
+	while( current_time < ctx->frame_deadline && ctx->state == STATE_RUN ) {
+		remain_time = ctx->frame_deadline - current_time;
+		/* 等待时间的单位是毫秒，向上取整以免在最后一毫秒内空转 */
+		LCUICond_TimedWait( &ctx->cond, &ctx->mutex,
+				    (unsigned int)((remain_time + 999999) /
+						   1000000) );
+		remain_time = current_time;
+		current_time = LCUI_GetTimeNS();
+		FrameControl_AddIdleTime( ctx, current_time - remain_time );
 	}
+	/* 按需更新时，没有请求就一直等下去，最大帧率的限制仍然有效 */
+	if( ctx->on_demand && !ctx->is_requested &&
+	    ctx->state == STATE_RUN ) {
+		ctx->idle_start_time = current_time;
+		while( ctx->on_demand && !ctx->is_requested &&
+		       ctx->state == STATE_RUN ) {
+			LCUICond_Wait( &ctx->cond, &ctx->mutex );
+		}
+		ctx->idle_start_time = 0;
+		remain_time = LCUI_GetTimeDeltaNS( current_time );
+		FrameControl_AddIdleTime( ctx, remain_time );
+		/* 等待的时长不算作落后，下一帧从现在开始计时 */
+		current_time += remain_time;
+		ctx->frame_deadline = current_time;
+	}
+	/* 在这之后收到的请求由下一帧处理 */
+	ctx->is_requested = FALSE;
 	/* 睡眠结束后，如果当前状态为 PAUSE，则说明睡眠是因为要暂停而终止的 */
 	if( ctx->state == STATE_PAUSE ) {
-		current_time = LCUI_GetTime();
 		/* 等待状态改为“继续” */
 		while( ctx->state == STATE_PAUSE ) {
 			LCUICond_Wait( &ctx->cond, &ctx->mutex );
 		}
-		lost_ms = (unsigned int)LCUI_GetTimeDelta( current_time );
-		ctx->pause_time = lost_ms;
-		ctx->prev_frame_start_time += lost_ms;
+		remain_time = LCUI_GetTimeDeltaNS( current_time );
+		ctx->pause_time = (unsigned int)(remain_time / 1000000);
+		/* 暂停的时长不计入帧的时长 */
+		current_time += remain_time;
+		ctx->frame_deadline = current_time;
+		ctx->prev_frame_start_time = current_time;
 		LCUIMutex_Unlock( &ctx->mutex );
 		return;
 	}
-
-normal_exit:;
-	current_time = LCUI_GetTime();
-	if( current_time - ctx->prev_fps_update_time >= 1000 ) {
+	remain_time = current_time - ctx->prev_fps_update_time;
+	if( remain_time >= 1000000000 ) {
 		ctx->current_fps = ctx->temp_fps;
+		ctx->stats.idle_percent = (unsigned int)
+			(ctx->period_idle_time * 100 / remain_time);
 		ctx->prev_fps_update_time = current_time;
+		ctx->period_idle_time = 0;
 		ctx->temp_fps = 0;
 	}
+	ctx->stats.frame_time = current_time - ctx->prev_frame_start_time;
 	ctx->prev_frame_start_time = current_time;
 	++ctx->temp_fps;
 	LCUIMutex_Unlock( &ctx->mutex );
 }
 
+void FrameControl_SetOnDemand( FrameControl ctx, LCUI_BOOL enabled )
+{
+	LCUIMutex_Lock( &ctx->mutex );
+	ctx->on_demand = enabled;
+	LCUICond_Signal( &ctx->cond );
+	LCUIMutex_Unlock( &ctx->mutex );
+}
+
+void FrameControl_Request( FrameControl ctx )
+{
+	/* 加锁后再设置标志，以确保请求者在这之前所做的修改对下一帧可见 */
+	LCUIMutex_Lock( &ctx->mutex );
+	if( !ctx->is_requested ) {
+		ctx->is_requested = TRUE;
+		LCUICond_Signal( &ctx->cond );
+	}
+	LCUIMutex_Unlock( &ctx->mutex );
+}
+
 void FrameControl_Pause( FrameControl ctx, LCUI_BOOL need_pause )
 {
 	if( ctx->state == STATE_RUN && need_pause ) {
@@ -160,3 +250,32 @@ void FrameControl_Pause( FrameControl ctx, LCUI_BOOL need_pause )
 		LCUIMutex_Unlock( &ctx->mutex );
 	}
 }
+
+void FrameControl_AddStageTime( FrameControl ctx,
+				LCUI_FrameStage stage, int64_t ns )
+{
+	LCUIMutex_Lock( &ctx->mutex );
+	ctx->stage_time[stage] += ns;
+	LCUIMutex_Unlock( &ctx->mutex );
+}
+
+void FrameControl_GetStats( FrameControl ctx, LCUI_FrameStats stats )
+{
+	int64_t now, idle_time, period;
+	LCUIMutex_Lock( &ctx->mutex );
+	*stats = ctx->stats;
+	/* 正在等待请求时，把已经等待的时长也算进去，否则长时间空闲时得到
+	 * 的一直是开始等待前的数据 */
+	if( ctx->idle_start_time > 0 ) {
+		now = LCUI_GetTimeNS();
+		idle_time = now - ctx->idle_start_time;
+		period = now - ctx->prev_fps_update_time;
+		stats->idle_time += idle_time;
+		if( period >= 1000000000 ) {
+			idle_time += ctx->period_idle_time;
+			stats->idle_percent = (unsigned int)
+				(idle_time * 100 / period);
+		}
+	}
+	LCUIMutex_Unlock( &ctx->mutex );
+}
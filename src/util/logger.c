@@ -39,6 +39,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <wchar.h>
 #include <LCUI_Build.h>
 #include <LCUI/util/logger.h>
 
@@ -0,0 +1,231 @@
+/* ***************************************************************************
+ * lrucache.c -- reference-counted LRU cache
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * lrucache.c -- 带引用计数的最近最少使用缓存
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#define LCUI_UTIL_LRUCACHE_C
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+
+typedef struct LRUCacheRec_ {
+	RBTree entries;			/**< 按索引查找的缓存项 */
+	LinkedList lru;			/**< 缓存项列表，最近使用的排在末尾 */
+	size_t key_size;		/**< 索引的字节数 */
+	size_t used_bytes;		/**< 缓存中的对象占用的内存 */
+	size_t max_bytes;		/**< 内存预算 */
+	unsigned long hits;		/**< 命中次数 */
+	unsigned long misses;		/**< 未命中次数 */
+	void (*destroy)(void*);		/**< 销毁对象的函数 */
+	LCUI_Mutex mutex;
+} LRUCacheRec;
+
+/** 查找时使用的索引，红黑树的比较函数无法访问缓存，所以带上索引的字节数 */
+typedef struct LRUCacheKeyRec_ {
+	const void *data;
+	size_t size;
+} LRUCacheKeyRec;
+
+static int OnCompareEntry( void *data, const void *keydata )
+{
+	const LRUCacheKeyRec *key = keydata;
+	return memcmp( ((LCUI_LRUCacheEntry)data)->key, key->data, key->size );
+}
+
+/** 将缓存项移出缓存，正在使用的对象会在释放后销毁，调用前需锁定缓存 */
+static void LRUCache_Remove( LRUCache cache, LCUI_LRUCacheEntry entry )
+{
+	LRUCacheKeyRec key = { entry->key, cache->key_size };
+	LinkedList_Unlink( &cache->lru, &entry->node );
+	RBTree_CustomErase( &cache->entries, &key );
+	cache->used_bytes -= entry->size;
+	entry->is_cached = FALSE;
+	if( entry->refs <= 0 ) {
+		cache->destroy( entry->data );
+	}
+}
+
+/** 淘汰最久未使用的对象，直到占用的内存不超过预算，调用前需锁定缓存 */
+static void LRUCache_Shrink( LRUCache cache )
+{
+	LCUI_LRUCacheEntry entry;
+	LinkedListNode *node, *next;
+	for( node = cache->lru.head.next; node; node = next ) {
+		if( cache->used_bytes <= cache->max_bytes ) {
+			break;
+		}
+		next = node->next;
+		entry = node->data;
+		if( entry->refs > 0 ) {
+			continue;
+		}
+		LRUCache_Remove( cache, entry );
+	}
+}
+
+LRUCache LRUCache_Create( size_t key_size, size_t max_bytes,
+			  void (*destroy)(void*) )
+{
+	LRUCache cache = NEW( LRUCacheRec, 1 );
+	if( !cache ) {
+		return NULL;
+	}
+	RBTree_Init( &cache->entries );
+	RBTree_OnCompare( &cache->entries, OnCompareEntry );
+	LinkedList_Init( &cache->lru );
+	LCUIMutex_Init( &cache->mutex );
+	cache->key_size = key_size;
+	cache->max_bytes = max_bytes;
+	cache->used_bytes = 0;
+	cache->hits = 0;
+	cache->misses = 0;
+	cache->destroy = destroy;
+	return cache;
+}
+
+void LRUCache_Destroy( LRUCache cache )
+{
+	LinkedListNode *node, *next;
+	for( node = cache->lru.head.next; node; node = next ) {
+		next = node->next;
+		cache->destroy( ((LCUI_LRUCacheEntry)node->data)->data );
+	}
+	LinkedList_Init( &cache->lru );
+	RBTree_Destroy( &cache->entries );
+	LCUIMutex_Destroy( &cache->mutex );
+	free( cache );
+}
+
+void *LRUCache_Get( LRUCache cache, const void *key )
+{
+	LCUI_LRUCacheEntry entry;
+	LRUCacheKeyRec keyrec = { key, cache->key_size };
+
+	LCUIMutex_Lock( &cache->mutex );
+	entry = RBTree_CustomGetData( &cache->entries, &keyrec );
+	if( !entry ) {
+		cache->misses += 1;
+		LCUIMutex_Unlock( &cache->mutex );
+		return NULL;
+	}
+	cache->hits += 1;
+	entry->refs += 1;
+	LinkedList_Unlink( &cache->lru, &entry->node );
+	LinkedList_AppendNode( &cache->lru, &entry->node );
+	LCUIMutex_Unlock( &cache->mutex );
+	return entry->data;
+}
+
+void *LRUCache_Add( LRUCache cache, LCUI_LRUCacheEntry entry )
+{
+	LCUI_LRUCacheEntry exist;
+	LRUCacheKeyRec key = { entry->key, cache->key_size };
+
+	entry->refs = 1;
+	entry->is_cached = FALSE;
+	entry->node.data = entry;
+	LCUIMutex_Lock( &cache->mutex );
+	exist = RBTree_CustomGetData( &cache->entries, &key );
+	if( exist ) {
+		/* 其它线程已经添加了相同的对象 */
+		exist->refs += 1;
+		LCUIMutex_Unlock( &cache->mutex );
+		cache->destroy( entry->data );
+		return exist->data;
+	}
+	if( entry->size <= cache->max_bytes ) {
+		entry->is_cached = TRUE;
+		cache->used_bytes += entry->size;
+		RBTree_CustomInsert( &cache->entries, &key, entry );
+		LinkedList_AppendNode( &cache->lru, &entry->node );
+		LRUCache_Shrink( cache );
+	}
+	LCUIMutex_Unlock( &cache->mutex );
+	return entry->data;
+}
+
+void LRUCache_Release( LRUCache cache, LCUI_LRUCacheEntry entry )
+{
+	LCUI_BOOL is_unused;
+	LCUIMutex_Lock( &cache->mutex );
+	entry->refs -= 1;
+	is_unused = !entry->is_cached && entry->refs <= 0;
+	LCUIMutex_Unlock( &cache->mutex );
+	if( is_unused ) {
+		cache->destroy( entry->data );
+	}
+}
+
+void LRUCache_RemoveIf( LRUCache cache,
+			LCUI_BOOL (*match)(void*, const void*),
+			const void *arg )
+{
+	LCUI_LRUCacheEntry entry;
+	LinkedListNode *node, *next;
+
+	LCUIMutex_Lock( &cache->mutex );
+	for( node = cache->lru.head.next; node; node = next ) {
+		next = node->next;
+		entry = node->data;
+		if( match( entry->data, arg ) ) {
+			LRUCache_Remove( cache, entry );
+		}
+	}
+	LCUIMutex_Unlock( &cache->mutex );
+}
+
+void LRUCache_SetMaxBytes( LRUCache cache, size_t max_bytes )
+{
+	LCUIMutex_Lock( &cache->mutex );
+	cache->max_bytes = max_bytes;
+	LRUCache_Shrink( cache );
+	LCUIMutex_Unlock( &cache->mutex );
+}
+
+void LRUCache_GetStats( LRUCache cache, LCUI_LRUCacheStats stats )
+{
+	LCUIMutex_Lock( &cache->mutex );
+	stats->hits = cache->hits;
+	stats->misses = cache->misses;
+	stats->used_bytes = cache->used_bytes;
+	stats->max_bytes = cache->max_bytes;
+	stats->count = (int)cache->lru.length;
+	LCUIMutex_Unlock( &cache->mutex );
+}
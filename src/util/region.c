@@ -0,0 +1,429 @@
+/* ***************************************************************************
+ * region.c -- banded rectangle region for dirty area tracking
+ *
+ * Copyright (C) 2016 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * region.c -- 用于记录无效区域的带状矩形区域
+ *
+ * 版权所有 (C) 2016 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+
+/** 用外接矩形代替多个矩形时，允许浪费的面积占外接矩形面积的比例 */
+#define REGION_MERGE_WASTE	0.25
+/** 查找可合并的矩形时，向四周扩展的距离 */
+#define REGION_MERGE_MARGIN	8
+
+#define RectRight(R) ((R)->x + (R)->width)
+#define RectBottom(R) ((R)->y + (R)->height)
+
+enum RegionOp {
+	REGION_OP_UNION,
+	REGION_OP_SUBTRACT
+};
+
+void Region_Init( LCUI_Region region )
+{
+	region->rects = NULL;
+	region->length = 0;
+	region->capacity = 0;
+	region->buffer = NULL;
+	region->buffer_capacity = 0;
+}
+
+void Region_Clear( LCUI_Region region )
+{
+	region->length = 0;
+}
+
+void Region_Destroy( LCUI_Region region )
+{
+	if( region->rects ) {
+		free( region->rects );
+	}
+	if( region->buffer ) {
+		free( region->buffer );
+	}
+	Region_Init( region );
+}
+
+/** 确保矩形数组至少能容纳 n 个矩形 */
+static int Region_Reserve( LCUI_Rect **rects, int *capacity, int n )
+{
+	int size;
+	LCUI_Rect *new_rects;
+	if( n <= *capacity ) {
+		return 0;
+	}
+	size = *capacity > 0 ? *capacity : 16;
+	while( size < n ) {
+		size *= 2;
+	}
+	new_rects = realloc( *rects, sizeof( LCUI_Rect ) * size );
+	if( !new_rects ) {
+		return -1;
+	}
+	*rects = new_rects;
+	*capacity = size;
+	return 0;
+}
+
+/** 查找第一个底边低于 y 的矩形，由于各个带互不重叠，它总是某个带的开头 */
+static int Region_FindBottom( LCUI_Region region, int y )
+{
+	int low = 0, high = region->length, mid;
+	while( low < high ) {
+		mid = (low + high) / 2;
+		if( RectBottom( &region->rects[mid] ) > y ) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+	return low;
+}
+
+/** 查找第一个顶边不高于 y 的矩形 */
+static int Region_FindTop( LCUI_Region region, int y )
+{
+	int low = 0, high = region->length, mid;
+	while( low < high ) {
+		mid = (low + high) / 2;
+		if( region->rects[mid].y >= y ) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+	return low;
+}
+
+/** 获取带的开头 */
+static int Region_BandStart( const LCUI_Rect *rects, int i )
+{
+	int y = rects[i].y;
+	while( i > 0 && rects[i - 1].y == y ) {
+		--i;
+	}
+	return i;
+}
+
+/** 获取带的末尾（不包括） */
+static int Region_BandEnd( const LCUI_Rect *rects, int n, int i )
+{
+	int y = rects[i].y;
+	while( ++i < n && rects[i].y == y );
+	return i;
+}
+
+/**
+ * 计算一个带中的水平线段与矩形的水平线段的运算结果
+ * @param[out] out	输出的线段，只设置 x 和 width
+ * @param[in] spans	带中的线段
+ * @param[in] n	线段数量
+ * @param[in] rect	矩形，为 NULL 时表示矩形未覆盖这个带
+ * @returns 输出的线段数量
+ */
+static int Region_CombineSpans( LCUI_Rect *out, const LCUI_Rect *spans,
+				int n, const LCUI_Rect *rect, int op )
+{
+	int i = 0, k = 0, x1, x2;
+	if( !rect ) {
+		for( ; i < n; ++i, ++k ) {
+			out[k] = spans[i];
+		}
+		return k;
+	}
+	x1 = rect->x;
+	x2 = RectRight( rect );
+	if( op == REGION_OP_UNION ) {
+		for( ; i < n && RectRight( &spans[i] ) < x1; ++i, ++k ) {
+			out[k] = spans[i];
+		}
+		/* 合并与矩形重叠或相接的线段 */
+		for( ; i < n && spans[i].x <= x2; ++i ) {
+			if( spans[i].x < x1 ) {
+				x1 = spans[i].x;
+			}
+			if( RectRight( &spans[i] ) > x2 ) {
+				x2 = RectRight( &spans[i] );
+			}
+		}
+		out[k].x = x1;
+		out[k].width = x2 - x1;
+		++k;
+		for( ; i < n; ++i, ++k ) {
+			out[k] = spans[i];
+		}
+		return k;
+	}
+	for( ; i < n; ++i ) {
+		if( RectRight( &spans[i] ) <= x1 || spans[i].x >= x2 ) {
+			out[k++] = spans[i];
+			continue;
+		}
+		if( spans[i].x < x1 ) {
+			out[k].x = spans[i].x;
+			out[k].width = x1 - spans[i].x;
+			++k;
+		}
+		if( RectRight( &spans[i] ) > x2 ) {
+			out[k].x = x2;
+			out[k].width = RectRight( &spans[i] ) - x2;
+			++k;
+		}
+	}
+	return k;
+}
+
+/**
+ * 将 buf[n] 开始的 k 条线段作为一个新的带，并设置它的垂直范围
+ * 如果它与上一个带垂直相接且线段相同，则直接增加上一个带的高度
+ * @returns 输出后的矩形数量
+ */
+static int Region_PushBand( LCUI_Rect *buf, int n, int k, int *last_band,
+			    int y1, int y2 )
+{
+	int i, prev = *last_band;
+	if( k <= 0 ) {
+		return n;
+	}
+	if( prev >= 0 && n - prev == k && RectBottom( &buf[prev] ) == y1 ) {
+		for( i = 0; i < k; ++i ) {
+			if( buf[prev + i].x != buf[n + i].x ||
+			    buf[prev + i].width != buf[n + i].width ) {
+				break;
+			}
+		}
+		if( i == k ) {
+			for( i = 0; i < k; ++i ) {
+				buf[prev + i].height += y2 - y1;
+			}
+			return n;
+		}
+	}
+	for( i = 0; i < k; ++i ) {
+		buf[n + i].y = y1;
+		buf[n + i].height = y2 - y1;
+	}
+	*last_band = n;
+	return n + k;
+}
+
+/**
+ * 对区域和矩形进行运算
+ * 先用二分查找定位与矩形在垂直方向上重叠的带，然后只重建这些带以及与它们相邻
+ * 的带，其余的带保持不变。
+ */
+static int Region_Op( LCUI_Region region, const LCUI_Rect *rect, int op )
+{
+	LCUI_Rect *rects;
+	int i0, i1, n = 0, m, k, last_band = -1;
+	int y, next_y, y_end, band, band_end = 0;
+
+	if( rect->width <= 0 || rect->height <= 0 ) {
+		return -1;
+	}
+	i0 = Region_FindBottom( region, rect->y );
+	i1 = Region_FindTop( region, RectBottom( rect ) );
+	if( op == REGION_OP_SUBTRACT && i0 >= i1 ) {
+		return 0;
+	}
+	rects = region->rects;
+	if( i0 > 0 ) {
+		i0 = Region_BandStart( rects, i0 - 1 );
+	}
+	if( i1 < region->length ) {
+		i1 = Region_BandEnd( rects, region->length, i1 );
+	}
+	y = rect->y;
+	y_end = RectBottom( rect );
+	if( i0 < i1 ) {
+		if( rects[i0].y < y ) {
+			y = rects[i0].y;
+		}
+		if( RectBottom( &rects[i1 - 1] ) > y_end ) {
+			y_end = RectBottom( &rects[i1 - 1] );
+		}
+	}
+	band = i0;
+	while( y < y_end ) {
+		const LCUI_Rect *spans = NULL, *span_rect = NULL;
+		m = 0;
+		if( band < i1 && rects[band].y <= y ) {
+			band_end = Region_BandEnd( rects, i1, band );
+			spans = rects + band;
+			m = band_end - band;
+			next_y = RectBottom( &rects[band] );
+		} else {
+			next_y = band < i1 ? rects[band].y : y_end;
+		}
+		/* 在矩形的上下边界处切分 */
+		if( y < rect->y ) {
+			if( next_y > rect->y ) {
+				next_y = rect->y;
+			}
+		} else if( y < RectBottom( rect ) ) {
+			span_rect = rect;
+			if( next_y > RectBottom( rect ) ) {
+				next_y = RectBottom( rect );
+			}
+		}
+		if( m > 0 || (span_rect && op == REGION_OP_UNION) ) {
+			if( Region_Reserve( &region->buffer,
+					    &region->buffer_capacity,
+					    n + m + 1 ) != 0 ) {
+				return -2;
+			}
+			k = Region_CombineSpans( region->buffer + n, spans,
+						 m, span_rect, op );
+			n = Region_PushBand( region->buffer, n, k,
+					     &last_band, y, next_y );
+		}
+		y = next_y;
+		if( m > 0 && y >= RectBottom( &rects[band] ) ) {
+			band = band_end;
+		}
+	}
+	m = region->length - (i1 - i0) + n;
+	if( Region_Reserve( &region->rects, &region->capacity, m ) != 0 ) {
+		return -2;
+	}
+	rects = region->rects;
+	memmove( rects + i0 + n, rects + i1,
+		 sizeof( LCUI_Rect ) * (region->length - i1) );
+	if( n > 0 ) {
+		memcpy( rects + i0, region->buffer, sizeof( LCUI_Rect ) * n );
+	}
+	region->length = m;
+	return 0;
+}
+
+int Region_Union( LCUI_Region region, const LCUI_Rect *rect )
+{
+	return Region_Op( region, rect, REGION_OP_UNION );
+}
+
+int Region_Subtract( LCUI_Region region, const LCUI_Rect *rect )
+{
+	return Region_Op( region, rect, REGION_OP_SUBTRACT );
+}
+
+int Region_GetAreaIn( LCUI_Region region, const LCUI_Rect *rect )
+{
+	LCUI_Rect overlay;
+	int i, area = 0, bottom = RectBottom( rect );
+	i = Region_FindBottom( region, rect->y );
+	for( ; i < region->length && region->rects[i].y < bottom; ++i ) {
+		if( LCUIRect_GetOverlayRect( &region->rects[i], rect,
+					     &overlay ) ) {
+			area += overlay.width * overlay.height;
+		}
+	}
+	return area;
+}
+
+int Region_AddRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	double area, covered;
+	LCUI_Rect box, range, *r;
+	int i, x2, y2, bottom, n_near = 0;
+
+	if( rect->width <= 0 || rect->height <= 0 ) {
+		return -1;
+	}
+	box = *rect;
+	x2 = RectRight( rect );
+	y2 = RectBottom( rect );
+	range.x = rect->x - REGION_MERGE_MARGIN;
+	range.y = rect->y - REGION_MERGE_MARGIN;
+	range.width = rect->width + REGION_MERGE_MARGIN * 2;
+	range.height = rect->height + REGION_MERGE_MARGIN * 2;
+	bottom = RectBottom( &range );
+	/* 计算矩形与附近的矩形的外接矩形 */
+	i = Region_FindBottom( region, range.y );
+	for( ; i < region->length && region->rects[i].y < bottom; ++i ) {
+		r = &region->rects[i];
+		if( RectRight( r ) <= range.x || r->x >= RectRight( &range ) ) {
+			continue;
+		}
+		box.x = r->x < box.x ? r->x : box.x;
+		box.y = r->y < box.y ? r->y : box.y;
+		x2 = RectRight( r ) > x2 ? RectRight( r ) : x2;
+		y2 = RectBottom( r ) > y2 ? RectBottom( r ) : y2;
+		++n_near;
+	}
+	if( n_near < 1 ) {
+		return Region_Union( region, rect );
+	}
+	box.width = x2 - box.x;
+	box.height = y2 - box.y;
+	/* 若用外接矩形代替所浪费的面积足够小，则添加外接矩形 */
+	area = 1.0 * box.width * box.height;
+	covered = 1.0 * rect->width * rect->height;
+	covered += Region_GetAreaIn( region, &box );
+	covered -= Region_GetAreaIn( region, rect );
+	if( area - covered <= area * REGION_MERGE_WASTE ) {
+		return Region_Union( region, &box );
+	}
+	return Region_Union( region, rect );
+}
+
+void Region_GetExtents( LCUI_Region region, LCUI_Rect *extents )
+{
+	int i, x1, x2;
+	if( region->length < 1 ) {
+		extents->x = extents->y = 0;
+		extents->width = extents->height = 0;
+		return;
+	}
+	x1 = region->rects[0].x;
+	x2 = RectRight( &region->rects[0] );
+	for( i = 1; i < region->length; ++i ) {
+		if( region->rects[i].x < x1 ) {
+			x1 = region->rects[i].x;
+		}
+		if( RectRight( &region->rects[i] ) > x2 ) {
+			x2 = RectRight( &region->rects[i] );
+		}
+	}
+	extents->x = x1;
+	extents->width = x2 - x1;
+	extents->y = region->rects[0].y;
+	extents->height = RectBottom( &region->rects[region->length - 1] )
+			  - extents->y;
+}
@@ -50,7 +50,7 @@
 #pragma comment(lib, "Winmm.lib")
 
 static int hires_timer_available;	/**< 标志，指示高精度计数器是否可用 */
-static double hires_ticks_per_second;	/**< 高精度计数器每秒的滴答数 */
+static int64_t hires_ticks_per_second;	/**< 高精度计数器每秒的滴答数 */
 
 void LCUITime_Init( void )
 {
@@ -64,6 +64,21 @@ void LCUITime_Init( void )
 	}
 }
 
+int64_t LCUI_GetTimeNS( void )
+{
+	int64_t ticks;
+	LARGE_INTEGER hires_now;
+	if( hires_timer_available ) {
+		QueryPerformanceCounter( &hires_now );
+		ticks = hires_now.QuadPart;
+		/* 分开计算整秒和余下的部分，以免乘法溢出 */
+		return ticks / hires_ticks_per_second * 1000000000 +
+			ticks % hires_ticks_per_second * 1000000000 /
+			hires_ticks_per_second;
+	}
+	return (int64_t)timeGetTime() * 1000000;
+}
+
 int64_t LCUI_GetTime( void )
 {
 	LARGE_INTEGER hires_now;
@@ -78,7 +93,6 @@ int64_t LCUI_GetTime( void )
 
 #elif defined LCUI_BUILD_IN_LINUX
 #include <unistd.h>
-#include <sys/time.h>
 
 
 void LCUITime_Init( void )
@@ -86,14 +100,17 @@ void LCUITime_Init( void )
 	return;
 }
 
-int64_t LCUI_GetTime( void )
+int64_t LCUI_GetTimeNS( void )
 {
-	int64_t t;
-	struct timeval tv;
+	struct timespec ts;
 
-	gettimeofday( &tv, NULL );
-	t = tv.tv_sec*1000 + tv.tv_usec/1000;
-	return t;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int64_t LCUI_GetTime( void )
+{
+	return LCUI_GetTimeNS() / 1000000;
 }
 
 #endif
@@ -107,6 +124,11 @@ int64_t LCUI_GetTimeDelta( int64_t start )
 	return now - start;
 }
 
+int64_t LCUI_GetTimeDeltaNS( int64_t start )
+{
+	return LCUI_GetTimeNS() - start;
+}
+
 void LCUI_Sleep( unsigned int s )
 {
 #ifdef LCUI_BUILD_IN_WIN32
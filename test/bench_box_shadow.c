@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+
+#define BOX_WIDTH	320
+#define BOX_HEIGHT	200
+#define TILE_SIZE	64
+#define N_DRAWS		2000
+
+/**
+ * 绘制卡片阴影
+ * @param tiled 是否像渲染线程那样按小块分别绘制
+ */
+static void DrawShadow( LCUI_Graph *canvas, LCUI_BoxShadow *shadow,
+			LCUI_BOOL tiled )
+{
+	LCUI_Rect box;
+	LCUI_PaintContextRec paint;
+	box.x = box.y = 0;
+	box.width = canvas->width;
+	box.height = canvas->height;
+	paint.with_alpha = TRUE;
+	paint.arena = NULL;
+	if( !tiled ) {
+		paint.rect = box;
+		Graph_Quote( &paint.canvas, canvas, &paint.rect );
+		Graph_DrawBoxShadow( &paint, &box, shadow );
+		return;
+	}
+	for( paint.rect.y = 0; paint.rect.y < box.height;
+	     paint.rect.y += TILE_SIZE ) {
+		for( paint.rect.x = 0; paint.rect.x < box.width;
+		     paint.rect.x += TILE_SIZE ) {
+			paint.rect.width = TILE_SIZE;
+			paint.rect.height = TILE_SIZE;
+			LCUIRect_GetOverlayRect( &paint.rect, &box, &paint.rect );
+			Graph_Quote( &paint.canvas, canvas, &paint.rect );
+			Graph_DrawBoxShadow( &paint, &box, shadow );
+		}
+	}
+}
+
+static void Benchmark( int blur, int spread, LCUI_BOOL tiled )
+{
+	int i;
+	int64_t start, t;
+	LCUI_Graph canvas;
+	LCUI_BoxShadow shadow;
+
+	BoxShadow_Init( &shadow );
+	shadow.x = 2;
+	shadow.y = 4;
+	shadow.blur = blur;
+	shadow.spread = spread;
+	shadow.color = ARGB( 100, 0, 0, 0 );
+	Graph_Init( &canvas );
+	canvas.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &canvas, BoxShadow_GetWidth( &shadow, BOX_WIDTH ),
+		      BoxShadow_GetHeight( &shadow, BOX_HEIGHT ) );
+	start = LCUI_GetTime();
+	for( i = 0; i < N_DRAWS; ++i ) {
+		DrawShadow( &canvas, &shadow, tiled );
+	}
+	t = LCUI_GetTimeDelta( start );
+	printf( "blur %3dpx, spread %2dpx, %-6s%10.2f ms%12.1f us/draw\n",
+		blur, spread, tiled ? "tiled" : "whole", (double)t,
+		1000.0 * t / N_DRAWS );
+	Graph_Free( &canvas );
+}
+
+int main( void )
+{
+	LCUI_InitBase();
+	printf( "drawing the shadow of a %dx%d box %d times:\n",
+		BOX_WIDTH, BOX_HEIGHT, N_DRAWS );
+	Benchmark( 4, 0, FALSE );
+	Benchmark( 12, 2, FALSE );
+	Benchmark( 32, 4, FALSE );
+	Benchmark( 12, 2, TRUE );
+	Benchmark( 32, 4, TRUE );
+	/* 不缓存遮罩时，每次绘制都需要重新生成遮罩 */
+	printf( "without the mask cache:\n" );
+	BoxShadow_SetCacheSize( 0 );
+	Benchmark( 12, 2, FALSE );
+	Benchmark( 32, 4, FALSE );
+	return 0;
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+
+#define WIDTH		1920
+#define HEIGHT		1080
+#define MIN_TIME	500
+
+typedef struct BenchContext {
+	LCUI_Graph back;	/**< ARGB 背景 */
+	LCUI_Graph back_rgb;	/**< RGB 背景 */
+	LCUI_Graph fore;	/**< ARGB 前景 */
+} BenchContext;
+
+typedef void( *BenchFunc )(BenchContext*);
+
+static void BenchMixOpaque( BenchContext *ctx )
+{
+	Graph_FillAlpha( &ctx->back, 255 );
+	Graph_Mix( &ctx->back, &ctx->fore, 0, 0, TRUE );
+}
+
+static void BenchMixAlpha( BenchContext *ctx )
+{
+	Graph_FillAlpha( &ctx->back, 128 );
+	Graph_Mix( &ctx->back, &ctx->fore, 0, 0, TRUE );
+}
+
+static void BenchBlend( BenchContext *ctx )
+{
+	Graph_Mix( &ctx->back, &ctx->fore, 0, 0, FALSE );
+}
+
+static void BenchBlendRGB( BenchContext *ctx )
+{
+	Graph_Mix( &ctx->back_rgb, &ctx->fore, 0, 0, FALSE );
+}
+
+static void BenchMixOpacity( BenchContext *ctx )
+{
+	ctx->fore.opacity = 0.5;
+	Graph_Mix( &ctx->back, &ctx->fore, 0, 0, FALSE );
+	ctx->fore.opacity = 1.0;
+}
+
+static void BenchReplace( BenchContext *ctx )
+{
+	ctx->fore.opacity = 0.5;
+	Graph_Replace( &ctx->back, &ctx->fore, 0, 0 );
+	ctx->fore.opacity = 1.0;
+}
+
+static void BenchFillRect( BenchContext *ctx )
+{
+	Graph_FillRect( &ctx->back, ARGB( 128, 10, 20, 30 ), NULL, FALSE );
+}
+
+static struct BenchCase {
+	const char *name;
+	BenchFunc func;
+	LCUI_BOOL fill_alpha;	/**< 计时是否包含 Graph_FillAlpha() 的耗时 */
+} cases[] = {
+	{ "mix (opaque back)", BenchMixOpaque, TRUE },
+	{ "mix (alpha back)", BenchMixAlpha, TRUE },
+	{ "blend", BenchBlend, FALSE },
+	{ "blend (rgb back)", BenchBlendRGB, FALSE },
+	{ "blend (opacity)", BenchMixOpacity, FALSE },
+	{ "replace (opacity)", BenchReplace, FALSE },
+	{ "fill rect", BenchFillRect, FALSE }
+};
+
+static double RunCase( BenchContext *ctx, struct BenchCase *c )
+{
+	int64_t start, t;
+	int64_t count = 0, overhead = 0;
+	start = LCUI_GetTime();
+	do {
+		c->func( ctx );
+		if( c->fill_alpha ) {
+			t = LCUI_GetTime();
+			Graph_FillAlpha( &ctx->back, 255 );
+			overhead += LCUI_GetTimeDelta( t );
+		}
+		++count;
+	} while( LCUI_GetTimeDelta( start ) < MIN_TIME );
+	t = LCUI_GetTimeDelta( start ) - overhead;
+	if( t <= 0 ) {
+		t = 1;
+	}
+	return 1.0 * WIDTH * HEIGHT * count / t / 1000.0;
+}
+
+int main( void )
+{
+	int type;
+	size_t i;
+	BenchContext ctx;
+	LCUI_BlendKernel kernel;
+
+	Graph_Init( &ctx.back );
+	Graph_Init( &ctx.fore );
+	Graph_Init( &ctx.back_rgb );
+	ctx.back.color_type = COLOR_TYPE_ARGB;
+	ctx.fore.color_type = COLOR_TYPE_ARGB;
+	ctx.back_rgb.color_type = COLOR_TYPE_RGB;
+	Graph_Create( &ctx.back, WIDTH, HEIGHT );
+	Graph_Create( &ctx.fore, WIDTH, HEIGHT );
+	Graph_Create( &ctx.back_rgb, WIDTH, HEIGHT );
+	for( i = 0; i < (size_t)(WIDTH * HEIGHT); ++i ) {
+		ctx.fore.argb[i].value = rand() ^ (rand() << 16);
+		ctx.back.argb[i].value = rand() ^ (rand() << 16);
+	}
+	printf( "%-20s", "kernel" );
+	for( i = 0; i < sizeof( cases ) / sizeof( cases[0] ); ++i ) {
+		printf( "%20s", cases[i].name );
+	}
+	printf( "\n" );
+	for( type = BLEND_KERNEL_REFERENCE; 
+	     type < BLEND_KERNEL_TOTAL_NUM; ++type ) {
+		kernel = Graph_GetBlendKernel( type );
+		if( !kernel ) {
+			continue;
+		}
+		Graph_SetBlendKernel( type );
+		printf( "%-20s", kernel->name );
+		for( i = 0; i < sizeof( cases ) / sizeof( cases[0] ); ++i ) {
+			printf( "%13.1f Mpx/s", RunCase( &ctx, &cases[i] ) );
+			fflush( stdout );
+		}
+		printf( "\n" );
+	}
+	Graph_Free( &ctx.back );
+	Graph_Free( &ctx.fore );
+	Graph_Free( &ctx.back_rgb );
+	return 0;
+}
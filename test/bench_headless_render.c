@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/platform/headless_display.h>
+
+#define N_BOXES		48
+#define BOX_SIZE	96
+#define DURATION	5000
+
+/**
+ * 在无窗口模式下运行完整的显示线程，持续更新一组方块，统计帧率和每帧的
+ * 绘制量。帧率受显示模块的最大帧率限制，每帧的 CPU 时间更能反映渲染开销。
+ * 设置环境变量 LCUI_HEADLESS_DUMP=<目录> 可保存每一帧的图像。
+ */
+static struct {
+	int frame;
+	int64_t start;
+	clock_t clock_start;
+	LCUI_Widget boxes[N_BOXES];
+} bench;
+
+static void OnFrame( void *arg )
+{
+	int i;
+	double cpu_ms;
+	LCUI_Color color;
+	LCUI_HeadlessDisplayStatsRec stats;
+
+	for( i = 0; i < N_BOXES; ++i ) {
+		color = RGB( (uchar_t)(bench.frame * 7), (uchar_t)(i * 5),
+			     (uchar_t)(255 - bench.frame) );
+		Widget_SetStyle( bench.boxes[i], key_background_color,
+				 color, color );
+		Widget_UpdateStyle( bench.boxes[i], FALSE );
+	}
+	bench.frame += 1;
+	if( LCUI_GetTimeDelta( bench.start ) < DURATION ) {
+		return;
+	}
+	LCUI_GetHeadlessDisplayStats( &stats );
+	cpu_ms = 1000.0 * (clock() - bench.clock_start) / CLOCKS_PER_SEC;
+	printf( "%lu frames in %d ms, %.1f fps\n", stats.presents,
+		DURATION, 1000.0 * stats.presents / DURATION );
+	if( stats.presents > 0 ) {
+		printf( "%.1f rects/frame, %.0f pixels/frame\n",
+			1.0 * stats.rects / stats.presents,
+			1.0 * stats.pixels / stats.presents );
+		printf( "%.2f ms cpu time/frame\n", cpu_ms / stats.presents );
+	}
+	LCUI_Quit();
+}
+
+int main( void )
+{
+	int i;
+	LCUI_Widget root;
+
+#ifdef LCUI_BUILD_IN_LINUX
+	setenv( "LCUI_VIDEO_DRIVER", "headless", 1 );
+#endif
+	LCUI_Init();
+	LCUIDisplay_SetMode( LCDM_FULLSCREEN );
+	root = LCUIWidget_GetRoot();
+	for( i = 0; i < N_BOXES; ++i ) {
+		bench.boxes[i] = LCUIWidget_New( NULL );
+		Widget_SetStyle( bench.boxes[i], key_position,
+				 SV_ABSOLUTE, style );
+		Widget_Resize( bench.boxes[i], BOX_SIZE, BOX_SIZE );
+		Widget_Move( bench.boxes[i], (i % 8) * 150 + 20,
+			     (i / 8) * 115 + 20 );
+		Widget_Append( root, bench.boxes[i] );
+	}
+	bench.frame = 0;
+	bench.start = LCUI_GetTime();
+	bench.clock_start = clock();
+	LCUITimer_Set( 5, OnFrame, NULL, TRUE );
+	return LCUI_Main();
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <wchar.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/font.h>
+
+#define TEXT_LENGTH	50000
+#define PARAGRAPH_LENGTH	500
+#define N_KEYS		1000
+#define LAYER_WIDTH	480
+#define LAYER_HEIGHT	320
+#define N_LINES		20000
+
+/** 创建一个包含 5 万个字符、启用了自动换行的文本图层 */
+static LCUI_TextLayer CreateDocument( void )
+{
+	int i;
+	LCUI_TextLayer layer;
+	wchar_t *text = malloc( sizeof( wchar_t ) * (TEXT_LENGTH + 1) );
+
+	for( i = 0; i < TEXT_LENGTH; ++i ) {
+		if( i % PARAGRAPH_LENGTH == PARAGRAPH_LENGTH - 1 ) {
+			text[i] = L'\n';
+		} else if( i % 7 == 6 ) {
+			text[i] = L' ';
+		} else {
+			text[i] = L'a' + i % 26;
+		}
+	}
+	text[TEXT_LENGTH] = 0;
+	layer = TextLayer_New();
+	TextLayer_SetMultiline( layer, TRUE );
+	TextLayer_SetAutoWrap( layer, TRUE );
+	TextLayer_SetMaxSize( layer, LAYER_WIDTH, LAYER_HEIGHT );
+	TextLayer_AppendTextW( layer, text, NULL );
+	TextLayer_Update( layer, NULL );
+	free( text );
+	return layer;
+}
+
+/**
+ * 在文档开头的段落中逐字输入，每输入一个字符就更新一次排版
+ * @param full_typeset 是否每次都从输入的行开始对后面的所有文本行重新排版
+ */
+static double TypeKeys( LCUI_TextLayer layer, LCUI_BOOL full_typeset )
+{
+	int i, n_rects = 0;
+	int64_t start, t;
+	LinkedList rects;
+	wchar_t ch[2] = { 0 };
+
+	LinkedList_Init( &rects );
+	TextLayer_SetCaretPos( layer, 1, 10 );
+	start = LCUI_GetTime();
+	for( i = 0; i < N_KEYS; ++i ) {
+		ch[0] = L'A' + i % 26;
+		TextLayer_InsertTextW( layer, ch, NULL );
+		if( full_typeset ) {
+			TextLayer_AddUpdateTypeset( layer, layer->insert_y );
+		}
+		TextLayer_Update( layer, &rects );
+		n_rects += rects.length;
+		RectList_Clear( &rects );
+	}
+	t = LCUI_GetTimeDelta( start );
+	printf( "%-14s%10.2f ms%12.1f us/key%10d rects\n",
+		full_typeset ? "full" : "incremental", (double)t,
+		1000.0 * t / N_KEYS, n_rects );
+	return 1.0 * t / N_KEYS;
+}
+
+/** 模拟日志面板，逐行向文本末尾追加内容 */
+static void AppendLines( void )
+{
+	int i;
+	int64_t start, t;
+	wchar_t line[128];
+	LCUI_TextLayer layer = TextLayer_New();
+
+	TextLayer_SetMultiline( layer, TRUE );
+	TextLayer_SetAutoWrap( layer, TRUE );
+	TextLayer_SetMaxSize( layer, LAYER_WIDTH, LAYER_HEIGHT );
+	start = LCUI_GetTime();
+	for( i = 0; i < N_LINES; ++i ) {
+		swprintf( line, 128, L"[%05d] request finished in %d ms\n",
+			  i, i % 1000 );
+		TextLayer_AppendTextW( layer, line, NULL );
+		if( i % 100 == 99 ) {
+			TextLayer_Update( layer, NULL );
+			TextLayer_ClearInvalidRect( layer );
+		}
+	}
+	TextLayer_Update( layer, NULL );
+	t = LCUI_GetTimeDelta( start );
+	printf( "appending %d lines: %.2f ms, %.2f us/line\n", N_LINES,
+		(double)t, 1000.0 * t / N_LINES );
+	TextLayer_Destroy( layer );
+}
+
+int main( void )
+{
+	double full, incremental;
+	LCUI_TextLayer layer;
+
+	LCUI_InitBase();
+	printf( "typing %d keys into a %d-character document:\n",
+		N_KEYS, TEXT_LENGTH );
+	layer = CreateDocument();
+	printf( "%d rows\n", TextLayer_GetRowTotal( layer ) );
+	full = TypeKeys( layer, TRUE );
+	TextLayer_Destroy( layer );
+	layer = CreateDocument();
+	incremental = TypeKeys( layer, FALSE );
+	TextLayer_Destroy( layer );
+	if( incremental > 0 ) {
+		printf( "speedup: %.1fx\n", full / incremental );
+	}
+	AppendLines();
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+#include <LCUI/display.h>
+#include <LCUI/gui/widget.h>
+
+#ifdef LCUI_VIDEO_DRIVER_X11
+#include <LCUI/platform.h>
+#include LCUI_EVENTS_H
+#include LCUI_DISPLAY_H
+
+#define N_BOXES		24
+#define BOX_SIZE	64
+#define DURATION	5000
+
+/**
+ * 在 X11 窗口中持续更新一组分散的方块，统计帧率和每帧上传的矩形数量
+ * 可以在 Xvfb 中运行：xvfb-run ./bench_x11_present，设置环境变量
+ * LCUI_X11_NO_SHM=1 则使用 XPutImage 上传，便于对比。
+ */
+static struct {
+	int frame;
+	int64_t start;
+	LCUI_Widget boxes[N_BOXES];
+} bench;
+
+static void OnFrame( void *arg )
+{
+	int i;
+	LCUI_Color color;
+	LCUI_X11DisplayStatsRec stats;
+
+	for( i = 0; i < N_BOXES; ++i ) {
+		color = RGB( (uchar_t)(bench.frame * 7), (uchar_t)(i * 10),
+			     (uchar_t)(255 - bench.frame) );
+		Widget_SetStyle( bench.boxes[i], key_background_color,
+				 color, color );
+		Widget_UpdateStyle( bench.boxes[i], FALSE );
+	}
+	bench.frame += 1;
+	if( LCUI_GetTimeDelta( bench.start ) < DURATION ) {
+		return;
+	}
+	LCUI_GetLinuxX11DisplayStats( &stats );
+	printf( "MIT-SHM: %s\n", stats.use_shm ? "yes" : "no" );
+	printf( "%lu presents in %d ms, %.2f ms/present\n", stats.presents,
+		DURATION, 1.0 * DURATION / (stats.presents ? stats.presents:1) );
+	if( stats.presents > 0 ) {
+		printf( "%.1f rects/present, %.0f pixels/present\n",
+			1.0 * stats.rects / stats.presents,
+			1.0 * stats.pixels / stats.presents );
+	}
+	printf( "%lu waits for the X server\n", stats.waits );
+	LCUI_Quit();
+}
+
+int main( void )
+{
+	int i;
+	LCUI_Widget root;
+
+	if( !getenv( "DISPLAY" ) ) {
+		printf( "DISPLAY is not set, try: xvfb-run %s\n",
+			"./bench_x11_present" );
+		return 0;
+	}
+	LCUI_Init();
+	root = LCUIWidget_GetRoot();
+	Widget_Resize( root, 800, 600 );
+	for( i = 0; i < N_BOXES; ++i ) {
+		bench.boxes[i] = LCUIWidget_New( NULL );
+		Widget_SetStyle( bench.boxes[i], key_position,
+				 SV_ABSOLUTE, style );
+		Widget_Resize( bench.boxes[i], BOX_SIZE, BOX_SIZE );
+		Widget_Move( bench.boxes[i], (i % 6) * 130 + 10,
+			     (i / 6) * 140 + 20 );
+		Widget_Append( root, bench.boxes[i] );
+	}
+	bench.frame = 0;
+	bench.start = LCUI_GetTime();
+	LCUITimer_Set( 5, OnFrame, NULL, TRUE );
+	return LCUI_Main();
+}
+
+#else
+
+int main( void )
+{
+	printf( "X11 video driver is not enabled.\n" );
+	return 0;
+}
+
+#endif
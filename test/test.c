@@ -30,7 +30,28 @@ int main(void)
 	_wchdir( L"../test/" );
 	InitConsoleWindow();
 #endif
-	ret |= test_string();/*
+	ret |= test_string();
+	ret |= test_graph_blend();
+	ret |= test_region();
+	ret |= test_widget_layer();
+	ret |= test_font_cache();
+	ret |= test_text_layer();
+	ret |= test_style_cache();
+	ret |= test_style_share();
+	ret |= test_box_shadow();
+	ret |= test_graph_smooth();
+	ret |= test_graph_zoom();
+	ret |= test_fb_display();
+	ret |= test_headless_display();
+	ret |= test_graph_convert();
+	ret |= test_widget_occlusion();
+	ret |= test_paint_arena();
+	ret |= test_border_mask();
+	ret |= test_timer_heap();
+	ret |= test_frame_control();
+	ret |= test_task_queue();
+	ret |= test_app_wakeup();
+	ret |= test_lru_cache();/*
 	ret |= test_css_parser();
 	ret |= test_widget_render();
 	ret |= test_char_render();
@@ -6,3 +6,24 @@ int test_css_parser( void );
 int test_char_render( void );
 int test_string_render( void );
 int test_widget_render( void );
+int test_graph_blend( void );
+int test_widget_layer( void );
+int test_region( void );
+int test_font_cache( void );
+int test_text_layer( void );
+int test_style_cache( void );
+int test_style_share( void );
+int test_box_shadow( void );
+int test_graph_smooth( void );
+int test_graph_zoom( void );
+int test_fb_display( void );
+int test_headless_display( void );
+int test_graph_convert( void );
+int test_widget_occlusion( void );
+int test_paint_arena( void );
+int test_border_mask( void );
+int test_timer_heap( void );
+int test_frame_control( void );
+int test_task_queue( void );
+int test_app_wakeup( void );
+int test_lru_cache( void );
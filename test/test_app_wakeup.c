@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include "test.h"
+
+#define N_TASKS	100
+
+/** 模拟一个没有超时的事件驱动，只有被通知后才会结束等待 */
+static struct {
+	int notified;
+	LCUI_BOOL is_pending;
+	LCUI_Cond cond;
+	LCUI_Mutex mutex;
+	LCUI_AppDriverRec app;
+} driver;
+
+static int count;
+
+static LCUI_BOOL Driver_PostTask( LCUI_AppTask task )
+{
+	LCUIMutex_Lock( &driver.mutex );
+	driver.notified += 1;
+	driver.is_pending = TRUE;
+	LCUICond_Signal( &driver.cond );
+	LCUIMutex_Unlock( &driver.mutex );
+	return TRUE;
+}
+
+static LCUI_BOOL Driver_WaitEvent( void )
+{
+	LCUIMutex_Lock( &driver.mutex );
+	while( !driver.is_pending ) {
+		LCUICond_Wait( &driver.cond, &driver.mutex );
+	}
+	driver.is_pending = FALSE;
+	LCUIMutex_Unlock( &driver.mutex );
+	return TRUE;
+}
+
+static void Driver_DispatchEvent( void )
+{
+	return;
+}
+
+static int Driver_BindSysEvent( int event_id, LCUI_EventFunc func,
+				void *data, void( *destroy_data )(void*) )
+{
+	return -1;
+}
+
+static int Driver_UnbindSysEvent( int event_id, LCUI_EventFunc func )
+{
+	return -1;
+}
+
+static int Driver_UnbindSysEvent2( int handler_id )
+{
+	return -1;
+}
+
+static void *Driver_GetData( void )
+{
+	return NULL;
+}
+
+static void OnTask( void *arg1, void *arg2 )
+{
+	count += 1;
+}
+
+static void QuitThread( void *arg )
+{
+	LCUI_MSleep( 20 );
+	LCUI_MainLoop_Quit( arg );
+	LCUIThread_Exit( NULL );
+}
+
+static int GetNotifiedCount( void )
+{
+	int n;
+	LCUIMutex_Lock( &driver.mutex );
+	n = driver.notified;
+	LCUIMutex_Unlock( &driver.mutex );
+	return n;
+}
+
+int test_app_wakeup( void )
+{
+	int i, n;
+	LCUI_Thread tid;
+	LCUI_MainLoop loop;
+	LCUI_AppTaskRec task = { 0 };
+
+	LCUICond_Init( &driver.cond );
+	LCUIMutex_Init( &driver.mutex );
+	driver.app.PostTask = Driver_PostTask;
+	driver.app.WaitEvent = Driver_WaitEvent;
+	driver.app.DispatchEvent = Driver_DispatchEvent;
+	driver.app.BindSysEvent = Driver_BindSysEvent;
+	driver.app.UnbindSysEvent = Driver_UnbindSysEvent;
+	driver.app.UnbindSysEvent2 = Driver_UnbindSysEvent2;
+	driver.app.GetData = Driver_GetData;
+	LCUI_InitBase();
+	LCUI_InitApp( &driver.app );
+	/* 由事件驱动负责等待事件，并先处理掉之前的测试留下的任务 */
+	LCUI_SetTaskAgent( FALSE );
+	LCUI_DispatchEvent();
+	/* 连续添加的多个任务只需要通知一次 */
+	count = 0;
+	n = GetNotifiedCount();
+	task.func = OnTask;
+	for( i = 0; i < N_TASKS; ++i ) {
+		assert( LCUI_PostTask( &task ) );
+	}
+	assert( GetNotifiedCount() == n + 1 );
+	assert( LCUI_WaitEvent() );
+	LCUI_DispatchEvent();
+	assert( count == N_TASKS );
+	/* 主循环再次等待之后添加的任务需要重新通知 */
+	assert( LCUI_WaitEvent() );
+	LCUI_PostTask( &task );
+	assert( GetNotifiedCount() == n + 2 );
+	LCUI_DispatchEvent();
+	assert( count == N_TASKS + 1 );
+	/* 驱动没有超时，其它线程退出主循环时需要唤醒它 */
+	loop = LCUI_MainLoop_New();
+	LCUIThread_Create( &tid, QuitThread, loop );
+	LCUI_MainLoop_Run( loop );
+	LCUIThread_Join( tid, NULL );
+	free( loop );
+	LCUI_SetTaskAgent( TRUE );
+	return 0;
+}
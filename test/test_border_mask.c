@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/draw.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+
+#define BOX_WIDTH	40
+#define BOX_HEIGHT	30
+#define RADIUS		10
+#define TILE_SIZE	7
+
+static LCUI_ARGB GetPixel( LCUI_Graph *graph, int x, int y )
+{
+	return graph->argb[y * graph->width + x];
+}
+
+static void DrawBorder( LCUI_Graph *canvas, LCUI_Rect *rect,
+			LCUI_Border *border )
+{
+	LCUI_PaintContextRec paint;
+	LCUI_Rect box = { {0}, {0}, {BOX_WIDTH}, {BOX_HEIGHT} };
+	paint.rect = *rect;
+	paint.with_alpha = TRUE;
+	paint.arena = NULL;
+	Graph_Quote( &paint.canvas, canvas, rect );
+	Graph_DrawBorder( &paint, &box, border );
+}
+
+/** 检查圆角边框的形状，以及分块绘制的结果是否与整体绘制的一致 */
+static int CheckDrawBorder( void )
+{
+	int x, y;
+	LCUI_Rect rect;
+	LCUI_Border border;
+	LCUI_Graph full, tiled;
+	LCUI_ARGB px;
+	LCUI_BorderCacheStatsRec stats;
+
+	border = Border( 2, SV_SOLID, RGB( 0, 0, 255 ) );
+	Border_Radius( &border, RADIUS );
+	Graph_Init( &full );
+	Graph_Init( &tiled );
+	full.color_type = tiled.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &full, BOX_WIDTH, BOX_HEIGHT );
+	Graph_Create( &tiled, BOX_WIDTH, BOX_HEIGHT );
+	Border_GetCacheStats( &stats );
+	assert( stats.count == 0 && stats.misses == 0 );
+	rect.x = rect.y = 0;
+	rect.width = BOX_WIDTH;
+	rect.height = BOX_HEIGHT;
+	DrawBorder( &full, &rect, &border );
+	/* 圆角外是透明的，直线边框是不透明的，边框内是空的 */
+	assert( GetPixel( &full, 0, 0 ).alpha == 0 );
+	assert( GetPixel( &full, BOX_WIDTH - 1, BOX_HEIGHT - 1 ).alpha == 0 );
+	assert( GetPixel( &full, BOX_WIDTH / 2, 0 ).alpha == 255 );
+	assert( GetPixel( &full, 0, BOX_HEIGHT / 2 ).alpha == 255 );
+	assert( GetPixel( &full, BOX_WIDTH / 2, 2 ).alpha == 0 );
+	assert( GetPixel( &full, BOX_WIDTH / 2, BOX_HEIGHT / 2 ).alpha == 0 );
+	/* 圆弧经过的像素应该是半透明的 */
+	px = GetPixel( &full, 0, 6 );
+	assert( px.alpha > 0 && px.alpha < 255 && px.blue == 255 );
+	/* 四个角是对称的 */
+	for( y = 0; y < RADIUS; ++y ) {
+		for( x = 0; x < RADIUS; ++x ) {
+			px = GetPixel( &full, x, y );
+			assert( px.value == GetPixel( &full, BOX_WIDTH - 1 - x,
+						      y ).value );
+			assert( px.value == GetPixel( &full, x, BOX_HEIGHT -
+						      1 - y ).value );
+		}
+	}
+	for( rect.y = 0; rect.y < BOX_HEIGHT; rect.y += TILE_SIZE ) {
+		for( rect.x = 0; rect.x < BOX_WIDTH; rect.x += TILE_SIZE ) {
+			rect.width = TILE_SIZE;
+			rect.height = TILE_SIZE;
+			LCUIRect_ValidateArea( &rect, BOX_WIDTH, BOX_HEIGHT );
+			DrawBorder( &tiled, &rect, &border );
+		}
+	}
+	assert( memcmp( full.bytes, tiled.bytes, full.mem_size ) == 0 );
+	/* 相同的圆角和边框只需要生成一次遮罩 */
+	Border_GetCacheStats( &stats );
+	assert( stats.count == 1 && stats.misses == 1 );
+	assert( stats.hits > 1 && stats.used_bytes > 0 );
+	Graph_Free( &full );
+	Graph_Free( &tiled );
+	return 0;
+}
+
+/** 子部件的内容应该被父部件的圆角裁剪 */
+static int CheckClipContent( void )
+{
+	int i;
+	LCUI_ARGB px;
+	LCUI_Graph canvas;
+	LCUI_PaintContextRec paint;
+	LCUI_Widget root, card, child;
+
+	root = LCUIWidget_New( NULL );
+	Widget_Resize( root, 100, 80 );
+	Widget_SetStyle( root, key_background_color,
+			 RGB( 200, 200, 200 ), color );
+	card = LCUIWidget_New( NULL );
+	Widget_SetStyle( card, key_position, SV_ABSOLUTE, style );
+	Widget_SetStyle( card, key_background_color,
+			 RGB( 255, 255, 255 ), color );
+	Widget_SetStyle( card, key_border_top_left_radius, RADIUS, px );
+	Widget_SetStyle( card, key_border_top_right_radius, RADIUS, px );
+	Widget_SetStyle( card, key_border_bottom_left_radius, RADIUS, px );
+	Widget_SetStyle( card, key_border_bottom_right_radius, RADIUS, px );
+	Widget_Move( card, 10, 10 );
+	Widget_Resize( card, 60, 40 );
+	child = LCUIWidget_New( NULL );
+	Widget_SetStyle( child, key_background_color,
+			 RGB( 255, 0, 0 ), color );
+	Widget_Resize( child, 60, 40 );
+	Widget_Append( root, card );
+	Widget_Append( card, child );
+	Widget_UpdateStyle( child, TRUE );
+	Widget_UpdateStyle( card, TRUE );
+	Widget_UpdateStyle( root, TRUE );
+	for( i = 0; i < 10 && Widget_Update( root ); ++i );
+	assert( card->computed_style.border.top_left_radius == RADIUS );
+
+	Graph_Init( &canvas );
+	canvas.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &canvas, 100, 80 );
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = 100;
+	paint.rect.height = 80;
+	Graph_Quote( &paint.canvas, &canvas, &paint.rect );
+	Widget_Render( root, &paint );
+	/* 圆角外露出的是根部件的背景 */
+	px = GetPixel( &canvas, 10, 10 );
+	assert( px.red == 200 && px.green == 200 && px.blue == 200 );
+	px = GetPixel( &canvas, 69, 49 );
+	assert( px.red == 200 && px.green == 200 && px.blue == 200 );
+	/* 圆弧上的像素混合了两者的颜色 */
+	px = GetPixel( &canvas, 10, 16 );
+	assert( px.red > 200 && px.green < 200 && px.green > 0 );
+	/* 圆角以内的内容不受影响 */
+	px = GetPixel( &canvas, 40, 10 );
+	assert( px.red == 255 && px.green == 0 );
+	px = GetPixel( &canvas, 13, 13 );
+	assert( px.red == 255 && px.green == 0 );
+	Graph_Free( &canvas );
+	Widget_Destroy( root );
+	return 0;
+}
+
+int test_border_mask( void )
+{
+	int ret = 0;
+	LCUI_InitBase();
+	ret |= CheckDrawBorder();
+	ret |= CheckClipContent();
+	return ret;
+}
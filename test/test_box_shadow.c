@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+
+#define BOX_WIDTH	60
+#define BOX_HEIGHT	40
+#define TILE_SIZE	16
+
+/** 逐个像素计算阴影的透明度，作为参考结果 */
+static uchar_t GetShadowAlpha( LCUI_BoxShadow *shadow, int x, int y )
+{
+	LCUI_Rect rb;
+	int t, dx = 0, dy = 0;
+	int sx, sy, ix, iy, iw, ih;
+	float d, v, a, alpha;
+
+	rb.x = BoxShadow_GetBoxX( shadow );
+	rb.y = BoxShadow_GetBoxY( shadow );
+	rb.w = BOX_WIDTH;
+	rb.h = BOX_HEIGHT;
+	if( x >= rb.x && x < rb.x + rb.w && y >= rb.y && y < rb.y + rb.h ) {
+		return 0;
+	}
+	t = (int)(shadow->blur * 1.5);
+	sx = BoxShadow_GetX( shadow );
+	sy = BoxShadow_GetY( shadow );
+	ix = sx + t;
+	iy = sy + t;
+	iw = BOX_WIDTH + (shadow->blur + shadow->spread - t) * 2;
+	ih = BOX_HEIGHT + (shadow->blur + shadow->spread - t) * 2;
+	if( x < sx || y < sy || x >= ix + iw + t || y >= iy + ih + t ) {
+		return 0;
+	}
+	if( x < ix ) {
+		dx = ix - x;
+	} else if( x >= ix + iw ) {
+		dx = x - ix - iw;
+	}
+	if( y < iy ) {
+		dy = iy - y;
+	} else if( y >= iy + ih ) {
+		dy = y - iy - ih;
+	}
+	d = (float)floor( sqrt( 1.0 * (dx * dx + dy * dy) ) + 0.5 );
+	if( d >= t && t > 0 ) {
+		return 0;
+	}
+	if( t > 0 ) {
+		v = 512.0f / t;
+		a = 2 * (v * t - 255) / (t * t);
+		alpha = 255 - (v * d - (a * d * d) / 2);
+	} else {
+		alpha = 255;
+	}
+	return (uchar_t)(alpha < 0 ? 0 : alpha * shadow->color.alpha / 255);
+}
+
+/** 绘制阴影，tile_size 大于 0 时按小块分别绘制 */
+static void DrawShadow( LCUI_Graph *canvas, LCUI_BoxShadow *shadow,
+			int tile_size )
+{
+	LCUI_Rect box;
+	LCUI_PaintContextRec paint;
+
+	box.x = box.y = 0;
+	box.width = BoxShadow_GetWidth( shadow, BOX_WIDTH );
+	box.height = BoxShadow_GetHeight( shadow, BOX_HEIGHT );
+	Graph_Init( canvas );
+	canvas->color_type = COLOR_TYPE_ARGB;
+	Graph_Create( canvas, box.width, box.height );
+	paint.with_alpha = TRUE;
+	paint.arena = NULL;
+	if( tile_size <= 0 ) {
+		paint.rect = box;
+		Graph_Quote( &paint.canvas, canvas, &paint.rect );
+		Graph_DrawBoxShadow( &paint, &box, shadow );
+		return;
+	}
+	for( paint.rect.y = 0; paint.rect.y < box.height;
+	     paint.rect.y += tile_size ) {
+		for( paint.rect.x = 0; paint.rect.x < box.width;
+		     paint.rect.x += tile_size ) {
+			paint.rect.width = tile_size;
+			paint.rect.height = tile_size;
+			LCUIRect_GetOverlayRect( &paint.rect, &box, &paint.rect );
+			Graph_Quote( &paint.canvas, canvas, &paint.rect );
+			Graph_DrawBoxShadow( &paint, &box, shadow );
+		}
+	}
+}
+
+/** 检查阴影的绘制结果，允许有一个单位的舍入误差 */
+static int CheckShadow( LCUI_BoxShadow *shadow, int tile_size )
+{
+	int x, y;
+	LCUI_ARGB *px;
+	LCUI_Graph canvas;
+
+	DrawShadow( &canvas, shadow, tile_size );
+	for( y = 0; y < canvas.height; ++y ) {
+		px = canvas.argb + y * canvas.width;
+		for( x = 0; x < canvas.width; ++x, ++px ) {
+			assert( abs( px->alpha -
+				     GetShadowAlpha( shadow, x, y ) ) <= 1 );
+			assert( px->alpha == 0 ||
+				(px->red == shadow->color.red &&
+				 px->blue == shadow->color.blue) );
+		}
+	}
+	Graph_Free( &canvas );
+	return 0;
+}
+
+int test_box_shadow( void )
+{
+	int i;
+	LCUI_BoxShadow shadow;
+	LCUI_BoxShadowCacheStatsRec stats, stats2;
+	int params[][4] = {
+		/* x, y, blur, spread */
+		{ 0, 0, 0, 4 },
+		{ 0, 0, 6, 0 },
+		{ 2, 4, 8, 2 },
+		{ -3, 5, 10, 1 },
+		{ 30, 20, 4, 0 }
+	};
+
+	LCUI_InitBase();
+	BoxShadow_Init( &shadow );
+	shadow.color = ARGB( 200, 20, 40, 60 );
+	for( i = 0; i < sizeof( params ) / sizeof( params[0] ); ++i ) {
+		shadow.x = params[i][0];
+		shadow.y = params[i][1];
+		shadow.blur = params[i][2];
+		shadow.spread = params[i][3];
+		assert( CheckShadow( &shadow, 0 ) == 0 );
+		/* 分块绘制的结果应该与整体绘制的一致 */
+		assert( CheckShadow( &shadow, TILE_SIZE ) == 0 );
+	}
+	/* 模糊宽度相同的阴影共用同一张遮罩 */
+	BoxShadow_GetCacheStats( &stats );
+	shadow.spread = 5;
+	shadow.color = ARGB( 255, 0, 0, 0 );
+	assert( CheckShadow( &shadow, 0 ) == 0 );
+	BoxShadow_GetCacheStats( &stats2 );
+	assert( stats2.misses == stats.misses );
+	assert( stats2.hits == stats.hits + 1 );
+	assert( stats2.count == stats.count && stats.used_bytes > 0 );
+	/* 超出内存预算的遮罩不会被缓存，但依然能正常绘制 */
+	BoxShadow_SetCacheSize( 0 );
+	BoxShadow_GetCacheStats( &stats );
+	assert( stats.count == 0 && stats.used_bytes == 0 );
+	assert( CheckShadow( &shadow, TILE_SIZE ) == 0 );
+	BoxShadow_GetCacheStats( &stats );
+	assert( stats.count == 0 );
+	BoxShadow_SetCacheSize( 512 * 1024 );
+	return 0;
+}
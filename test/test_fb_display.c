@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/display.h>
+#include "test.h"
+
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_FRAMEBUFFER)
+#include <LCUI/platform.h>
+#include LCUI_DISPLAY_H
+
+#define SCREEN_WIDTH	64
+#define SCREEN_HEIGHT	48
+#define LINE_PADDING	16
+#define FILL_BYTE	0x5a
+
+/** 读取帧缓存中的一个像素，并转换为 RGB 颜色 */
+static LCUI_Color ReadPixel( const uchar_t *mem,
+			     LCUI_FrameBufferInfo info, int x, int y )
+{
+	uchar_t t;
+	LCUI_Color color;
+	unsigned short px;
+	const uchar_t *p = mem + (info->yoffset + y) * info->line_length;
+
+	x += info->xoffset;
+	color.alpha = 255;
+	switch( info->bits_per_pixel ) {
+	case 16:
+		memcpy( &px, p + x * 2, 2 );
+		RGB_FROM_RGB565( px, color.r, color.g, color.b );
+		break;
+	case 24:
+		p += x * 3;
+		color.b = p[0], color.g = p[1], color.r = p[2];
+		break;
+	default:
+		p += x * 4;
+		color.b = p[0], color.g = p[1], color.r = p[2];
+		break;
+	}
+	if( info->red_offset == 0 && info->blue_offset != 0 ) {
+		t = color.r, color.r = color.b, color.b = t;
+	}
+	return color;
+}
+
+/** 检查帧缓存中的颜色，16 位的像素格式会丢弃颜色的低位 */
+static int CheckPixel( const uchar_t *mem, LCUI_FrameBufferInfo info,
+		       int x, int y, LCUI_Color expected )
+{
+	int mask_r = 0xff, mask_g = 0xff, mask_b = 0xff;
+	LCUI_Color color = ReadPixel( mem, info, x, y );
+	if( info->bits_per_pixel == 16 ) {
+		mask_r = mask_b = 0xf8;
+		mask_g = 0xfc;
+	}
+	if( color.r != (expected.r & mask_r) ||
+	    color.g != (expected.g & mask_g) ||
+	    color.b != (expected.b & mask_b) ) {
+		return -1;
+	}
+	return 0;
+}
+
+/** 在 surface 的一块区域中绘制渐变色 */
+static void PaintGradient( LCUI_DisplayDriver driver, LCUI_Surface surface,
+			   int x, int y, int width, int height )
+{
+	int i, j;
+	LCUI_Rect rect;
+	LCUI_Color color;
+	LCUI_Graph *fb;
+	LCUI_PaintContext paint;
+
+	rect.x = x;
+	rect.y = y;
+	rect.width = width;
+	rect.height = height;
+	paint = driver->beginPaint( surface, &rect );
+	fb = Graph_GetQuote( &paint->canvas );
+	for( j = 0; j < paint->rect.height; ++j ) {
+		for( i = 0; i < paint->rect.width; ++i ) {
+			color.r = (uchar_t)((x + i) * 4);
+			color.g = (uchar_t)((y + j) * 5);
+			color.b = (uchar_t)((x + i) * (y + j));
+			color.alpha = 255;
+			fb->argb[(y + j) * fb->width + x + i] = color;
+		}
+	}
+	driver->endPaint( surface, paint );
+}
+
+/** 检查帧缓存中可见区域以外的字节是否未被修改 */
+static int CheckPadding( const uchar_t *mem, LCUI_FrameBufferInfo info )
+{
+	int x, y, left, right;
+	int bytes_per_pixel = info->bits_per_pixel / 8;
+	const uchar_t *p;
+
+	left = info->xoffset * bytes_per_pixel;
+	right = left + info->width * bytes_per_pixel;
+	for( y = 0; y < info->yoffset + info->height; ++y ) {
+		p = mem + y * info->line_length;
+		for( x = 0; x < info->line_length; ++x ) {
+			if( y >= info->yoffset && x >= left && x < right ) {
+				continue;
+			}
+			if( p[x] != FILL_BYTE ) {
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * 测试帧缓存显示驱动对一种像素格式的支持
+ * @param[in] bgr 帧缓存是否为 BGR 顺序
+ * @param[in] xoffset 可见区域在虚拟屏幕中的横坐标
+ * @param[in] yoffset 可见区域在虚拟屏幕中的纵坐标
+ */
+static int TestFormat( int bits_per_pixel, LCUI_BOOL bgr,
+		       int xoffset, int yoffset )
+{
+	int x, y, ret = 0;
+	uchar_t t;
+	FILE *file;
+	size_t size;
+	uchar_t *mem;
+	LCUI_Color color;
+	LCUI_Surface surface;
+	LCUI_DisplayDriver driver;
+	LCUI_FrameBufferInfoRec info;
+	LCUI_FBDisplayStatsRec stats;
+
+	memset( &info, 0, sizeof( info ) );
+	info.width = SCREEN_WIDTH;
+	info.height = SCREEN_HEIGHT;
+	info.bits_per_pixel = bits_per_pixel;
+	info.xoffset = xoffset;
+	info.yoffset = yoffset;
+	info.line_length = (xoffset + SCREEN_WIDTH) * bits_per_pixel / 8;
+	info.line_length += LINE_PADDING;
+	if( bgr ) {
+		info.blue_offset = bits_per_pixel == 16 ? 11 : 16;
+		info.green_offset = bits_per_pixel == 16 ? 5 : 8;
+	}
+	size = info.line_length * (info.yoffset + info.height);
+	mem = malloc( size );
+	memset( mem, FILL_BYTE, size );
+	file = tmpfile();
+	fwrite( mem, 1, size, file );
+	fflush( file );
+	driver = LCUI_CreateLinuxFBDisplayByFile( fileno( file ), &info );
+	assert( driver != NULL );
+	assert( driver->getWidth() == SCREEN_WIDTH );
+	assert( driver->getHeight() == SCREEN_HEIGHT );
+	surface = driver->create();
+	driver->resize( surface, 40, 30 );
+	driver->move( surface, 10, 8 );
+	driver->show( surface );
+	PaintGradient( driver, surface, 0, 0, 40, 30 );
+	driver->present( surface );
+	/* 只重绘一小块区域，呈现时只复制这块区域 */
+	PaintGradient( driver, surface, 4, 4, 8, 8 );
+	/* surface 超出屏幕的部分会被裁剪掉 */
+	driver->move( surface, 40, 30 );
+	PaintGradient( driver, surface, 20, 12, 20, 18 );
+	driver->present( surface );
+	LCUI_GetLinuxFBDisplayStats( &stats );
+	assert( stats.presents == 2 && stats.rects == 3 );
+	assert( stats.pixels == 40 * 30 + 8 * 8 + 4 * 6 );
+	fseek( file, 0, SEEK_SET );
+	assert( fread( mem, 1, size, file ) == size );
+	for( y = 0; y < SCREEN_HEIGHT && ret == 0; ++y ) {
+		for( x = 0; x < SCREEN_WIDTH; ++x ) {
+			if( (x >= 44 && x < 52 && y >= 34 && y < 42) ||
+			    (x >= 60 && y >= 42) ) {
+				color.r = (uchar_t)((x - 40) * 4);
+				color.g = (uchar_t)((y - 30) * 5);
+				color.b = (uchar_t)((x - 40) * (y - 30));
+			} else if( x >= 10 && x < 50 && y >= 8 && y < 38 ) {
+				color.r = (uchar_t)((x - 10) * 4);
+				color.g = (uchar_t)((y - 8) * 5);
+				color.b = (uchar_t)((x - 10) * (y - 8));
+			} else {
+				color.r = color.g = color.b = FILL_BYTE;
+				if( bits_per_pixel == 16 ) {
+					RGB_FROM_RGB565( 0x5a5a, color.r,
+							 color.g, color.b );
+				}
+				if( bgr ) {
+					t = color.r;
+					color.r = color.b;
+					color.b = t;
+				}
+			}
+			if( CheckPixel( mem, &info, x, y, color ) != 0 ) {
+				ret = -1;
+				break;
+			}
+		}
+	}
+	/* 可见区域以外的字节和行尾的填充字节不应被修改 */
+	if( CheckPadding( mem, &info ) != 0 ) {
+		ret = -1;
+	}
+	LCUI_DestroyLinuxFBDisplay( driver );
+	fclose( file );
+	free( mem );
+	assert( ret == 0 );
+	return 0;
+}
+
+/** 不支持的颜色分量顺序应被拒绝 */
+static int TestUnsupportedOrder( void )
+{
+	FILE *file;
+	LCUI_FrameBufferInfoRec info;
+
+	memset( &info, 0, sizeof( info ) );
+	info.width = SCREEN_WIDTH;
+	info.height = SCREEN_HEIGHT;
+	info.bits_per_pixel = 32;
+	info.line_length = SCREEN_WIDTH * 4;
+	info.red_offset = 8;
+	info.green_offset = 16;
+	info.blue_offset = 24;
+	file = tmpfile();
+	assert( LCUI_CreateLinuxFBDisplayByFile( fileno( file ),
+						 &info ) == NULL );
+	fclose( file );
+	return 0;
+}
+
+int test_fb_display( void )
+{
+	int ret = 0;
+	LCUI_InitBase();
+	ret |= TestFormat( 16, FALSE, 0, 0 );
+	ret |= TestFormat( 24, FALSE, 0, 0 );
+	ret |= TestFormat( 32, FALSE, 0, 0 );
+	ret |= TestFormat( 16, TRUE, 0, 0 );
+	ret |= TestFormat( 24, TRUE, 3, 5 );
+	ret |= TestFormat( 32, TRUE, 7, 2 );
+	ret |= TestFormat( 16, FALSE, 5, 9 );
+	ret |= TestUnsupportedOrder();
+	return ret;
+}
+
+#else
+
+int test_fb_display( void )
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/font.h>
+#include "test.h"
+
+#define N_GLYPHS	64
+
+/** 比较缓存的字体位图与直接载入的字体位图 */
+static int CompareBitmap( const LCUI_FontBitmap *a, const LCUI_FontBitmap *b )
+{
+	if( a->width != b->width || a->rows != b->rows ||
+	    a->top != b->top || a->left != b->left ||
+	    a->advance.x != b->advance.x ) {
+		return -1;
+	}
+	if( !a->buffer || !b->buffer ) {
+		return -2;
+	}
+	return memcmp( a->buffer, b->buffer, a->width * a->rows );
+}
+
+/** 没有被引用的缓存项在位图数据被淘汰时移除 */
+static int CheckRelease( void )
+{
+	int i, n;
+	LCUI_TextLayer layer;
+	LCUI_TextStyle style;
+	const LCUI_FontBitmap *bmps[N_GLYPHS];
+	LCUI_FontCacheStatsRec stats;
+
+	/* 先移除之前的测试留下的、没有被引用的缓存项 */
+	LCUIFont_SetCacheSize( 0 );
+	LCUIFont_TrimCache();
+	LCUIFont_SetCacheSize( 4 * 1024 * 1024 );
+	LCUIFont_GetCacheStats( &stats );
+	n = stats.entries;
+	/* 内置字体中没有的字符会显示为方框，它们也有位图数据 */
+	for( i = 0; i < N_GLYPHS; ++i ) {
+		LCUIFont_GetBitmap( 0x4e00 + i, -1, 17, &bmps[i] );
+	}
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.entries == n + N_GLYPHS );
+	for( i = 0; i < N_GLYPHS; ++i ) {
+		LCUIFont_ReleaseBitmap( bmps[i] );
+	}
+	/* 没有超出预算时，不再被引用的字形仍然缓存着 */
+	LCUIFont_TrimCache();
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.entries == n + N_GLYPHS );
+	LCUIFont_SetCacheSize( 0 );
+	LCUIFont_TrimCache();
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.entries == n );
+	/* 文本图层销毁后，它引用的字形也可以被移除 */
+	TextStyle_Init( &style );
+	style.pixel_size = 15;
+	layer = TextLayer_New();
+	TextLayer_SetTextStyle( layer, &style );
+	TextLayer_AppendTextW( layer, L"\x4e00\x4e01\x4e02", NULL );
+	TextLayer_Update( layer, NULL );
+	LCUIFont_TrimCache();
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.entries > n );
+	TextLayer_Destroy( layer );
+	LCUIFont_TrimCache();
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.entries == n );
+	LCUIFont_SetCacheSize( 4 * 1024 * 1024 );
+	return 0;
+}
+
+int test_font_cache( void )
+{
+	int size;
+	wchar_t ch;
+	LCUI_FontBitmap bmp;
+	const LCUI_FontBitmap *cached, *first;
+	LCUI_FontCacheStatsRec stats;
+
+	LCUI_InitBase();
+	LCUIFont_ResetCacheStats();
+	/* 第一次获取时需要载入字体位图 */
+	for( ch = '!'; ch <= '~'; ++ch ) {
+		LCUIFont_GetBitmap( ch, -1, 16, &cached );
+	}
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.misses == 94 && stats.hits == 0 );
+	/* 再次获取时直接使用缓存 */
+	LCUIFont_GetBitmap( 'A', -1, 16, &first );
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.misses == 94 && stats.hits == 1 );
+	FontBitmap_Init( &bmp );
+	FontBitmap_Load( &bmp, 'A', LCUIFont_GetDefault(), 16 );
+	assert( CompareBitmap( first, &bmp ) == 0 );
+	/* 超出预算时淘汰位图数据，但保留尺寸信息 */
+	LCUIFont_SetCacheSize( 0 );
+	LCUIFont_TrimCache();
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.used_bytes == 0 && stats.count == 0 );
+	assert( stats.evictions > 0 );
+	assert( !first->buffer && first->width == bmp.width );
+	/* 绘制前重新载入被淘汰的位图数据 */
+	LCUIFont_UseBitmap( first );
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.misses == 95 && stats.count == 1 );
+	assert( CompareBitmap( first, &bmp ) == 0 );
+	/* 最久未使用的位图先被淘汰 */
+	LCUIFont_SetCacheSize( 4 * 1024 * 1024 );
+	for( size = 12; size <= 18; ++size ) {
+		for( ch = '!'; ch <= '~'; ++ch ) {
+			LCUIFont_GetBitmap( ch, -1, size, &cached );
+		}
+	}
+	LCUIFont_TrimCache();
+	LCUIFont_UseBitmap( first );
+	LCUIFont_GetCacheStats( &stats );
+	LCUIFont_SetCacheSize( stats.used_bytes / 2 );
+	LCUIFont_TrimCache();
+	LCUIFont_GetCacheStats( &stats );
+	assert( stats.used_bytes <= stats.max_bytes );
+	assert( CompareBitmap( first, &bmp ) == 0 );
+	FontBitmap_Free( &bmp );
+	LCUIFont_SetCacheSize( 4 * 1024 * 1024 );
+	return CheckRelease();
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include "test.h"
+
+#define MAX_FPS		60
+#define N_FRAMES	30
+
+/** 高精度时间应该是单调递增的，并且与毫秒时间一致 */
+static int CheckTime( void )
+{
+	int i;
+	int64_t ns, prev_ns, ms;
+
+	ms = LCUI_GetTime();
+	prev_ns = LCUI_GetTimeNS();
+	for( i = 0; i < 1000; ++i ) {
+		ns = LCUI_GetTimeNS();
+		assert( ns >= prev_ns );
+		prev_ns = ns;
+	}
+	LCUI_MSleep( 20 );
+	ns = LCUI_GetTimeDeltaNS( prev_ns );
+	ms = LCUI_GetTimeDelta( ms );
+	assert( ns >= 20000000 );
+	assert( ms >= 19 && ms <= ns / 1000000 + 1 );
+	return 0;
+}
+
+/** 帧的开始时间按预定时间推算，多帧之后不会累积误差 */
+static int CheckPacing( void )
+{
+	int i;
+	int64_t t, expected;
+	FrameControl ctx;
+	LCUI_FrameStatsRec stats;
+
+	ctx = FrameControl_Create();
+	FrameControl_SetMaxFPS( ctx, MAX_FPS );
+	FrameControl_Remain( ctx );
+	t = LCUI_GetTimeNS();
+	for( i = 0; i < N_FRAMES; ++i ) {
+		FrameControl_AddStageTime( ctx, FRAME_STAGE_UPDATE, 100 );
+		FrameControl_AddStageTime( ctx, FRAME_STAGE_RENDER, i + 1 );
+		FrameControl_AddStageTime( ctx, FRAME_STAGE_RENDER, i + 1 );
+		FrameControl_Remain( ctx );
+	}
+	t = LCUI_GetTimeDeltaNS( t );
+	expected = (int64_t)1000000000 * N_FRAMES / MAX_FPS;
+	/* 帧不会早于预定时间开始，晚多少取决于系统调度，不做检查 */
+	assert( t >= expected - 5000000 );
+	FrameControl_GetStats( ctx, &stats );
+	assert( stats.frames == N_FRAMES + 1 );
+	assert( stats.last[FRAME_STAGE_UPDATE] == 100 );
+	assert( stats.total[FRAME_STAGE_UPDATE] == 100 * N_FRAMES );
+	assert( stats.last[FRAME_STAGE_RENDER] == N_FRAMES * 2 );
+	assert( stats.max[FRAME_STAGE_RENDER] == N_FRAMES * 2 );
+	assert( stats.total[FRAME_STAGE_RENDER] ==
+		N_FRAMES * (N_FRAMES + 1) );
+	assert( stats.total[FRAME_STAGE_LAYOUT] == 0 );
+	assert( stats.frame_time > 0 );
+	FrameControl_Destroy( ctx );
+	return 0;
+}
+
+static LCUI_BOOL frame_thread_active;
+
+static void FrameThread( void *arg )
+{
+	FrameControl ctx = arg;
+	while( frame_thread_active ) {
+		FrameControl_Remain( ctx );
+	}
+	LCUIThread_Exit( NULL );
+}
+
+static unsigned long GetFrames( FrameControl ctx )
+{
+	LCUI_FrameStatsRec stats;
+	FrameControl_GetStats( ctx, &stats );
+	return stats.frames;
+}
+
+/** 等待帧数超过 frames，超时返回 FALSE */
+static LCUI_BOOL WaitFrames( FrameControl ctx, unsigned long frames,
+			     int timeout_ms )
+{
+	for( ; timeout_ms > 0; --timeout_ms ) {
+		if( GetFrames( ctx ) > frames ) {
+			return TRUE;
+		}
+		LCUI_MSleep( 1 );
+	}
+	return GetFrames( ctx ) > frames;
+}
+
+/**
+ * 按需更新时，没有请求就不更新，请求再多也不会超过最大帧率
+ * 线程何时被调度取决于系统负载，所以只检查先后顺序和上限，不检查等待的时长
+ */
+static int CheckOnDemand( void )
+{
+	int i;
+	int64_t t;
+	unsigned long frames, max_frames;
+	LCUI_Thread thread;
+	FrameControl ctx;
+	LCUI_FrameStatsRec stats;
+
+	ctx = FrameControl_Create();
+	FrameControl_SetMaxFPS( ctx, MAX_FPS );
+	FrameControl_SetOnDemand( ctx, TRUE );
+	frame_thread_active = TRUE;
+	assert( LCUIThread_Create( &thread, FrameThread, ctx ) == 0 );
+	/* 第一帧总是会更新，之后一直等待 */
+	LCUI_MSleep( 100 );
+	frames = GetFrames( ctx );
+	assert( frames <= 2 );
+	LCUI_MSleep( 100 );
+	assert( GetFrames( ctx ) == frames );
+	/* 请求会触发更新，更新的帧数不会超过请求的次数 */
+	FrameControl_Request( ctx );
+	FrameControl_Request( ctx );
+	assert( WaitFrames( ctx, frames, 5000 ) );
+	LCUI_MSleep( 100 );
+	assert( GetFrames( ctx ) <= frames + 2 );
+	frames = GetFrames( ctx );
+	t = LCUI_GetTimeNS();
+	for( i = 0; i < 500; ++i ) {
+		FrameControl_Request( ctx );
+		LCUI_MSleep( 1 );
+	}
+	t = LCUI_GetTimeDeltaNS( t );
+	frames = GetFrames( ctx ) - frames;
+	/* 按实际经过的时间计算帧数的上限，加上最后一个请求触发的帧 */
+	max_frames = (unsigned long)(t * MAX_FPS / 1000000000) + 2;
+	assert( frames >= 1 );
+	assert( frames <= max_frames );
+	/* 等待请求的时间也算作空闲 */
+	LCUI_MSleep( 1100 );
+	FrameControl_GetStats( ctx, &stats );
+	assert( stats.idle_percent >= 90 );
+	assert( stats.idle_time >= 1000000000 );
+	frame_thread_active = FALSE;
+	FrameControl_SetOnDemand( ctx, FALSE );
+	LCUIThread_Join( thread, NULL );
+	FrameControl_Destroy( ctx );
+	return 0;
+}
+
+int test_frame_control( void )
+{
+	int ret = 0;
+	ret |= CheckTime();
+	ret |= CheckPacing();
+	ret |= CheckOnDemand();
+	return ret;
+}
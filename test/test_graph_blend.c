@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+#include "test.h"
+
+#define MAX_PIXELS 67
+
+static void RandPixels( LCUI_ARGB *pixels, int n, LCUI_BOOL opaque )
+{
+	int i;
+	for( i = 0; i < n; ++i ) {
+		pixels[i].value = rand() ^ (rand() << 16);
+		switch( rand() % 4 ) {
+		case 0: pixels[i].alpha = 0; break;
+		case 1: pixels[i].alpha = 255; break;
+		default: break;
+		}
+		if( opaque ) {
+			pixels[i].alpha = 255;
+		}
+	}
+}
+
+/** 检查内核的输出结果是否与参考实现一致 */
+static int CheckKernel( LCUI_BlendKernel ref, LCUI_BlendKernel k,
+			int n, int opacity, LCUI_BOOL opaque )
+{
+	LCUI_ARGB src[MAX_PIXELS], dst1[MAX_PIXELS], dst2[MAX_PIXELS];
+	uchar_t rgb1[MAX_PIXELS * 3], rgb2[MAX_PIXELS * 3];
+	RandPixels( src, n, FALSE );
+	RandPixels( dst1, n, opaque );
+	memcpy( dst2, dst1, sizeof( dst1 ) );
+	ref->mix( dst1, src, n, opacity );
+	k->mix( dst2, src, n, opacity );
+	assert( memcmp( dst1, dst2, sizeof( LCUI_ARGB ) * n ) == 0 );
+	ref->blend( dst1, src, n, opacity );
+	k->blend( dst2, src, n, opacity );
+	assert( memcmp( dst1, dst2, sizeof( LCUI_ARGB ) * n ) == 0 );
+	ref->copy( dst1, src, n, opacity );
+	k->copy( dst2, src, n, opacity );
+	assert( memcmp( dst1, dst2, sizeof( LCUI_ARGB ) * n ) == 0 );
+	ref->fill( dst1, src[0], n, opaque );
+	k->fill( dst2, src[0], n, opaque );
+	assert( memcmp( dst1, dst2, sizeof( LCUI_ARGB ) * n ) == 0 );
+	memcpy( rgb1, dst1, sizeof( rgb1 ) );
+	memcpy( rgb2, dst1, sizeof( rgb2 ) );
+	ref->blend_rgb( rgb1, src, n, opacity );
+	k->blend_rgb( rgb2, src, n, opacity );
+	assert( memcmp( rgb1, rgb2, 3 * n ) == 0 );
+	return 0;
+}
+
+/** 检查合成结果是否接近浮点运算的结果 */
+static int CheckMixAccuracy( LCUI_BlendKernel ref )
+{
+	int sa, da;
+	double a, out_a;
+	LCUI_ARGB src, dst;
+	for( sa = 0; sa < 256; sa += 5 ) {
+		for( da = 0; da < 256; da += 5 ) {
+			src = ARGB( sa, 200, 100, 0 );
+			dst = ARGB( da, 0, 100, 200 );
+			ref->mix( &dst, &src, 1, 255 );
+			a = (1.0 - sa / 255.0) * da / 255.0;
+			out_a = sa / 255.0 + a;
+			assert( abs( dst.alpha - (int)(255.0 * out_a + 0.5) ) <= 1 );
+			if( out_a <= 0 ) {
+				continue;
+			}
+			assert( abs( dst.red - (int)(200 * sa / 255.0 / out_a + 0.5) ) <= 1 );
+			assert( abs( dst.blue - (int)(200 * a / out_a + 0.5) ) <= 1 );
+		}
+	}
+	return 0;
+}
+
+int test_graph_blend( void )
+{
+	int type, n, i;
+	int opacities[] = { 255, 254, 128, 1, 0 };
+	LCUI_BlendKernel ref, k;
+
+	srand( 1 );
+	ref = Graph_GetBlendKernel( BLEND_KERNEL_REFERENCE );
+	assert( ref != NULL );
+	assert( CheckMixAccuracy( ref ) == 0 );
+	for( type = BLEND_KERNEL_REFERENCE + 1;
+	     type < BLEND_KERNEL_TOTAL_NUM; ++type ) {
+		k = Graph_GetBlendKernel( type );
+		if( !k ) {
+			continue;
+		}
+		for( n = 1; n <= MAX_PIXELS; ++n ) {
+			for( i = 0; i < 5; ++i ) {
+				assert( CheckKernel( ref, k, n, opacities[i], TRUE ) == 0 );
+				assert( CheckKernel( ref, k, n, opacities[i], FALSE ) == 0 );
+			}
+		}
+		_DEBUG_MSG( "kernel %s: pass\n", k->name );
+	}
+	return 0;
+}
@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+#include <LCUI/graph_convert.h>
+#include "test.h"
+
+#define MAX_PIXELS	67
+#define LONG_ROW	1000
+
+static void RandBytes( uchar_t *bytes, int n )
+{
+	int i;
+	for( i = 0; i < n; ++i ) {
+		bytes[i] = (uchar_t)(rand() & 0xff);
+	}
+}
+
+/** 检查内核的输出结果是否与参考实现一致 */
+static int CheckKernel( LCUI_ConvertKernel ref, LCUI_ConvertKernel k, int n )
+{
+	uchar_t bias[16];
+	LCUI_ARGB src[MAX_PIXELS], dst1[MAX_PIXELS], dst2[MAX_PIXELS];
+	uchar_t out1[MAX_PIXELS * 4], out2[MAX_PIXELS * 4];
+
+	RandBytes( (uchar_t*)src, n * 4 );
+	RandBytes( bias, 16 );
+	ref->to_rgb565( out1, src, n, NULL );
+	k->to_rgb565( out2, src, n, NULL );
+	assert( memcmp( out1, out2, n * 2 ) == 0 );
+	ref->to_rgb565( out1, src, n, bias );
+	k->to_rgb565( out2, src, n, bias );
+	assert( memcmp( out1, out2, n * 2 ) == 0 );
+	ref->to_rgb555( out1, src, n, bias );
+	k->to_rgb555( out2, src, n, bias );
+	assert( memcmp( out1, out2, n * 2 ) == 0 );
+	ref->to_rgb888( out1, src, n );
+	k->to_rgb888( out2, src, n );
+	assert( memcmp( out1, out2, n * 3 ) == 0 );
+	ref->swap_rb( out1, (uchar_t*)src, n );
+	k->swap_rb( out2, (uchar_t*)src, n );
+	assert( memcmp( out1, out2, n * 4 ) == 0 );
+	RandBytes( out1, n * 3 );
+	ref->from_rgb565( dst1, out1, n );
+	k->from_rgb565( dst2, out1, n );
+	assert( memcmp( dst1, dst2, n * 4 ) == 0 );
+	ref->from_rgb555( dst1, out1, n );
+	k->from_rgb555( dst2, out1, n );
+	assert( memcmp( dst1, dst2, n * 4 ) == 0 );
+	ref->from_rgb888( dst1, out1, n );
+	k->from_rgb888( dst2, out1, n );
+	assert( memcmp( dst1, dst2, n * 4 ) == 0 );
+	return 0;
+}
+
+/** 低位深的像素转换为 ARGB 后再转换回来，结果应该不变 */
+static int CheckRoundTrip( int color_type, int bytes_per_pixel )
+{
+	int i, n = 1 << (bytes_per_pixel * 8);
+	uchar_t *in = malloc( n * bytes_per_pixel );
+	uchar_t *out = malloc( n * bytes_per_pixel );
+	LCUI_ARGB *argb = malloc( n * sizeof( LCUI_ARGB ) );
+
+	for( i = 0; i < n; ++i ) {
+		if( bytes_per_pixel == 2 ) {
+			unsigned short px = (unsigned short)i;
+			/* RGB555 的最高位没有使用 */
+			if( color_type == COLOR_TYPE_RGB555 ) {
+				px &= 0x7fff;
+			}
+			memcpy( in + i * 2, &px, 2 );
+		} else {
+			in[i] = (uchar_t)i;
+		}
+	}
+	assert( Pixels_Convert( (uchar_t*)argb, COLOR_TYPE_ARGB,
+				in, color_type, n ) == 0 );
+	assert( Pixels_Convert( out, color_type, (uchar_t*)argb,
+				COLOR_TYPE_ARGB, n ) == 0 );
+	assert( memcmp( in, out, n * bytes_per_pixel ) == 0 );
+	/* 每个颜色分量的最大值都应该扩展为 255 */
+	if( color_type != COLOR_TYPE_GRAY8 ) {
+		assert( argb[n - 1].r == 255 && argb[n - 1].b == 255 );
+	}
+	free( argb );
+	free( out );
+	free( in );
+	return 0;
+}
+
+/** 非 ARGB 格式之间的转换，结果应该与分两步转换的一致 */
+static int CheckIndirect( void )
+{
+	uchar_t in[LONG_ROW * 2], out1[LONG_ROW * 3], out2[LONG_ROW * 3];
+	LCUI_ARGB argb[LONG_ROW];
+
+	RandBytes( in, sizeof( in ) );
+	assert( Pixels_Convert( out1, COLOR_TYPE_RGB888, in,
+				COLOR_TYPE_RGB565, LONG_ROW ) == 0 );
+	Pixels_Convert( (uchar_t*)argb, COLOR_TYPE_ARGB,
+			in, COLOR_TYPE_RGB565, LONG_ROW );
+	Pixels_Convert( out2, COLOR_TYPE_RGB888, (uchar_t*)argb,
+			COLOR_TYPE_ARGB, LONG_ROW );
+	assert( memcmp( out1, out2, LONG_ROW * 3 ) == 0 );
+	assert( Pixels_ConvertDither( out1, COLOR_TYPE_RGB555, out2,
+				      COLOR_TYPE_RGB888, LONG_ROW,
+				      3, 5 ) == 0 );
+	Pixels_Convert( (uchar_t*)argb, COLOR_TYPE_ARGB,
+			out2, COLOR_TYPE_RGB888, LONG_ROW );
+	Pixels_ConvertDither( out2, COLOR_TYPE_RGB555, (uchar_t*)argb,
+			      COLOR_TYPE_ARGB, LONG_ROW, 3, 5 );
+	assert( memcmp( out1, out2, LONG_ROW * 2 ) == 0 );
+	/* 没有调色板，不支持索引色 */
+	assert( Pixels_Convert( out1, COLOR_TYPE_INDEX8, in,
+				COLOR_TYPE_RGB565, 1 ) == -1 );
+	return 0;
+}
+
+/**
+ * 纯色区域经过抖动后，4x4 块内颜色的平均值应该接近原来的颜色，而不抖动时
+ * 低位会被直接截断
+ */
+static int CheckDither( void )
+{
+	int x, y, sum = 0, sum_plain = 0;
+	LCUI_ARGB row[4], out[4];
+	uchar_t px[8];
+
+	for( x = 0; x < 4; ++x ) {
+		row[x].value = 0xff000000;
+		row[x].r = 100;
+		row[x].g = 100;
+		row[x].b = 100;
+	}
+	for( y = 0; y < 4; ++y ) {
+		Pixels_ConvertDither( px, COLOR_TYPE_RGB565, (uchar_t*)row,
+				      COLOR_TYPE_ARGB, 4, 0, y );
+		Pixels_Convert( (uchar_t*)out, COLOR_TYPE_ARGB,
+				px, COLOR_TYPE_RGB565, 4 );
+		for( x = 0; x < 4; ++x ) {
+			sum += out[x].r;
+		}
+		Pixels_Convert( px, COLOR_TYPE_RGB565, (uchar_t*)row,
+				COLOR_TYPE_ARGB, 4 );
+		Pixels_Convert( (uchar_t*)out, COLOR_TYPE_ARGB,
+				px, COLOR_TYPE_RGB565, 4 );
+		for( x = 0; x < 4; ++x ) {
+			sum_plain += out[x].r;
+		}
+	}
+	assert( abs( sum - 100 * 16 ) <= 16 );
+	assert( abs( sum_plain - 100 * 16 ) > abs( sum - 100 * 16 ) );
+	/* 不需要抖动的格式，结果与不抖动的一致 */
+	Pixels_ConvertDither( px, COLOR_TYPE_RGB888, (uchar_t*)row,
+			      COLOR_TYPE_ARGB, 2, 1, 1 );
+	assert( px[0] == 100 && px[3] == 100 && px[5] == 100 );
+	return 0;
+}
+
+static int CheckSetColorType( void )
+{
+	int x, y;
+	LCUI_Graph graph;
+	LCUI_Color color;
+
+	Graph_Init( &graph );
+	graph.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &graph, 7, 5 );
+	for( y = 0; y < graph.h; ++y ) {
+		for( x = 0; x < graph.w; ++x ) {
+			color = RGB( (uchar_t)(x * 32), (uchar_t)(y * 60), 200 );
+			graph.argb[y * graph.w + x] = color;
+		}
+	}
+	assert( Graph_SetColorType( &graph, COLOR_TYPE_ARGB ) == -1 );
+	assert( Graph_SetColorType( &graph, COLOR_TYPE_INDEX8 ) == -2 );
+	assert( Graph_SetColorType( &graph, COLOR_TYPE_RGB ) == 0 );
+	assert( graph.bytes_per_pixel == 3 && graph.bytes_per_row == 21 );
+	for( y = 0; y < graph.h; ++y ) {
+		for( x = 0; x < graph.w; ++x ) {
+			uchar_t *p = graph.bytes + y * graph.bytes_per_row + x * 3;
+			assert( p[0] == 200 && p[1] == y * 60 && p[2] == x * 32 );
+		}
+	}
+	assert( Graph_SetColorType( &graph, COLOR_TYPE_RGB565 ) == 0 );
+	assert( graph.bytes_per_row == 14 );
+	assert( Graph_SetColorType( &graph, COLOR_TYPE_ARGB ) == 0 );
+	color = graph.argb[4 * graph.w + 6];
+	assert( color.alpha == 255 );
+	assert( color.r >> 3 == 192 >> 3 && color.g >> 2 == 240 >> 2 );
+	Graph_Free( &graph );
+	return 0;
+}
+
+static int CheckSwapRB( void )
+{
+	uchar_t rgba[MAX_PIXELS * 4], bgra[MAX_PIXELS * 4];
+
+	RandBytes( rgba, sizeof( rgba ) );
+	memcpy( bgra, rgba, sizeof( rgba ) );
+	assert( Pixels_SwapRB( bgra, bgra, COLOR_TYPE_ARGB, MAX_PIXELS ) == 0 );
+	assert( bgra[0] == rgba[2] && bgra[2] == rgba[0] );
+	assert( bgra[3] == rgba[3] && bgra[265] == rgba[265] );
+	Pixels_SwapRB( bgra, bgra, COLOR_TYPE_ARGB, MAX_PIXELS );
+	assert( memcmp( bgra, rgba, sizeof( rgba ) ) == 0 );
+	Pixels_SwapRB( bgra, rgba, COLOR_TYPE_RGB, 5 );
+	assert( bgra[12] == rgba[14] && bgra[13] == rgba[13] );
+	assert( Pixels_SwapRB( bgra, rgba, COLOR_TYPE_RGB565, 5 ) == -1 );
+	return 0;
+}
+
+int test_graph_convert( void )
+{
+	int n, type, ret = 0;
+	LCUI_ConvertKernel ref, k;
+
+	ref = Graph_GetConvertKernel( BLEND_KERNEL_REFERENCE );
+	assert( ref != NULL );
+	for( type = BLEND_KERNEL_REFERENCE + 1;
+	     type < BLEND_KERNEL_TOTAL_NUM; ++type ) {
+		k = Graph_GetConvertKernel( type );
+		if( !k ) {
+			continue;
+		}
+		for( n = 1; n <= MAX_PIXELS; ++n ) {
+			ret |= CheckKernel( ref, k, n );
+		}
+	}
+	ret |= CheckRoundTrip( COLOR_TYPE_RGB565, 2 );
+	ret |= CheckRoundTrip( COLOR_TYPE_RGB555, 2 );
+	ret |= CheckRoundTrip( COLOR_TYPE_RGB323, 1 );
+	ret |= CheckRoundTrip( COLOR_TYPE_ARGB2222, 1 );
+	ret |= CheckRoundTrip( COLOR_TYPE_GRAY8, 1 );
+	ret |= CheckIndirect();
+	ret |= CheckDither();
+	ret |= CheckSetColorType();
+	ret |= CheckSwapRB();
+	/* 切换到参考实现后再检查一次 */
+	Graph_SetConvertKernel( BLEND_KERNEL_REFERENCE );
+	ret |= CheckRoundTrip( COLOR_TYPE_RGB565, 2 );
+	ret |= CheckDither();
+	Graph_SetConvertKernel( BLEND_KERNEL_AUTO );
+	return ret;
+}
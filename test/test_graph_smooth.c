@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/draw.h>
+#include "test.h"
+
+#define IMAGE_WIDTH	97
+#define IMAGE_HEIGHT	61
+
+/** 生成一张由色块和噪点组成的图像 */
+static void CreateImage( LCUI_Graph *graph )
+{
+	int x, y;
+	LCUI_ARGB *px;
+	Graph_Init( graph );
+	graph->color_type = COLOR_TYPE_ARGB;
+	Graph_Create( graph, IMAGE_WIDTH, IMAGE_HEIGHT );
+	px = graph->argb;
+	for( y = 0; y < IMAGE_HEIGHT; ++y ) {
+		for( x = 0; x < IMAGE_WIDTH; ++x, ++px ) {
+			px->r = (x / 16 + y / 16) % 2 ? 240 : 20;
+			px->g = (uchar_t)(x * 255 / IMAGE_WIDTH);
+			px->b = (uchar_t)(rand() % 256);
+			px->a = (uchar_t)(y < IMAGE_HEIGHT / 2 ? 255 : 128);
+		}
+	}
+}
+
+/** 用浮点数计算的高斯模糊作为参考结果，超出边界的像素取边缘像素的值 */
+static void GaussianBlurChannel( const double *src, double *dst,
+				 int width, int height, double sigma )
+{
+	int i, x, y, k, r = (int)ceil( sigma * 3 );
+	double sum, *kernel = malloc( sizeof( double ) * (2 * r + 1) );
+	double *temp = malloc( sizeof( double ) * width * height );
+
+	for( sum = 0, i = -r; i <= r; ++i ) {
+		kernel[i + r] = exp( -i * i / (2 * sigma * sigma) );
+		sum += kernel[i + r];
+	}
+	for( i = 0; i <= 2 * r; ++i ) {
+		kernel[i] /= sum;
+	}
+	for( y = 0; y < height; ++y ) {
+		for( x = 0; x < width; ++x ) {
+			for( sum = 0, i = -r; i <= r; ++i ) {
+				k = x + i < 0 ? 0 : x + i >= width ? width - 1 : x + i;
+				sum += src[y * width + k] * kernel[i + r];
+			}
+			temp[y * width + x] = sum;
+		}
+	}
+	for( y = 0; y < height; ++y ) {
+		for( x = 0; x < width; ++x ) {
+			for( sum = 0, i = -r; i <= r; ++i ) {
+				k = y + i < 0 ? 0 : y + i >= height ? height - 1 : y + i;
+				sum += temp[k * width + x] * kernel[i + r];
+			}
+			dst[y * width + x] = sum;
+		}
+	}
+	free( kernel );
+	free( temp );
+}
+
+/**
+ * 检查模糊结果与高斯模糊的差距，返回平均误差
+ * 多次盒式模糊在每次模糊时都会重复边缘像素，所以边缘附近的误差较大，最大
+ * 误差只统计离边缘足够远的像素
+ */
+static double CompareWithGaussian( LCUI_Graph *src, LCUI_Graph *des,
+				   double sigma, int *max_error )
+{
+	int i, c, x, y, n = src->w * src->h, margin = (int)(sigma * 3);
+	double error = 0, *in = malloc( sizeof( double ) * n );
+	double *out = malloc( sizeof( double ) * n );
+
+	*max_error = 0;
+	for( c = 0; c < 4; ++c ) {
+		for( i = 0; i < n; ++i ) {
+			in[i] = ((uchar_t*)&src->argb[i])[c];
+		}
+		GaussianBlurChannel( in, out, src->w, src->h, sigma );
+		for( i = 0; i < n; ++i ) {
+			int d = abs( ((uchar_t*)&des->argb[i])[c] -
+				     (int)(out[i] + 0.5) );
+			x = i % src->w;
+			y = i / src->w;
+			if( x >= margin && x < src->w - margin &&
+			    y >= margin && y < src->h - margin &&
+			    d > *max_error ) {
+				*max_error = d;
+			}
+			error += d;
+		}
+	}
+	free( in );
+	free( out );
+	return error / n / 4;
+}
+
+int test_graph_smooth( void )
+{
+	int i, max_error;
+	LCUI_Rect rect;
+	LCUI_Graph image, quote, part, out, out2;
+	double sigmas[] = { 1.0, 2.5, 6.0, 12.0 };
+
+	CreateImage( &image );
+	Graph_Init( &out );
+	Graph_Init( &out2 );
+	/* 三次盒式模糊的结果应该与高斯模糊相近 */
+	for( i = 0; i < sizeof( sigmas ) / sizeof( double ); ++i ) {
+		assert( Graph_Smooth( &image, &out, sigmas[i] ) == 0 );
+		assert( out.w == image.w && out.h == image.h );
+		assert( CompareWithGaussian( &image, &out, sigmas[i],
+					     &max_error ) < 2.0 );
+		assert( max_error <= 4 );
+		/* 多线程处理的结果与单线程的一致 */
+		assert( Graph_SmoothEx( &image, &out2, sigmas[i], 4 ) == 0 );
+		assert( memcmp( out.argb, out2.argb, sizeof( LCUI_ARGB ) * out.w * out.h ) == 0 );
+	}
+	/* 纯色的图像模糊后不变，半径较大时也一样 */
+	Graph_FillRect( &image, ARGB( 200, 10, 100, 250 ), NULL, TRUE );
+	assert( Graph_Smooth( &image, &out, 8.0 ) == 0 );
+	for( i = 0; i < out.w * out.h; ++i ) {
+		assert( out.argb[i].value == image.argb[i].value );
+	}
+	Graph_FillRect( &image, ARGB( 255, 255, 200, 190 ), NULL, TRUE );
+	assert( Graph_Smooth( &image, &out, 200.0 ) == 0 );
+	for( i = 0; i < out.w * out.h; ++i ) {
+		assert( out.argb[i].value == image.argb[i].value );
+	}
+	/* 模糊引用的图像区域，应该与模糊该区域的副本一致 */
+	CreateImage( &image );
+	rect.x = 10, rect.y = 5, rect.w = 40, rect.h = 33;
+	Graph_Quote( &quote, &image, &rect );
+	Graph_Init( &part );
+	Graph_Cut( &image, rect, &part );
+	assert( Graph_Smooth( &quote, &out, 3.0 ) == 0 );
+	assert( Graph_Smooth( &part, &out2, 3.0 ) == 0 );
+	assert( out.w == rect.w && out.h == rect.h );
+	assert( memcmp( out.argb, out2.argb, sizeof( LCUI_ARGB ) * out.w * out.h ) == 0 );
+	Graph_Free( &part );
+	Graph_Free( &out );
+	Graph_Free( &out2 );
+	Graph_Free( &image );
+	return 0;
+}
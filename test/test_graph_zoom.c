@@ -0,0 +1,360 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/graph_blend.h>
+#include "test.h"
+
+#define SRC_WIDTH	67
+#define SRC_HEIGHT	41
+
+/** 生成一张带有渐变和噪点的测试图像 */
+static void CreateImage( LCUI_Graph *graph, int color_type )
+{
+	int x, y;
+	uchar_t *p;
+	Graph_Init( graph );
+	graph->color_type = color_type;
+	Graph_Create( graph, SRC_WIDTH, SRC_HEIGHT );
+	for( y = 0; y < SRC_HEIGHT; ++y ) {
+		p = graph->bytes + y * graph->bytes_per_row;
+		for( x = 0; x < SRC_WIDTH; ++x ) {
+			*p++ = (uchar_t)(rand() % 256);
+			*p++ = (uchar_t)(y * 255 / SRC_HEIGHT);
+			*p++ = (uchar_t)(x * 255 / SRC_WIDTH);
+			if( color_type == COLOR_TYPE_ARGB ) {
+				*p++ = (uchar_t)(128 + rand() % 128);
+			}
+		}
+	}
+}
+
+/** 获取像素的第 c 个通道的值，ARGB 像素的第 3 个通道为 alpha */
+static double GetChannel( const LCUI_Graph *graph, int x, int y, int c )
+{
+	LCUI_Rect rect;
+	Graph_GetValidRect( graph, &rect );
+	graph = Graph_GetQuote( graph );
+	x += rect.x;
+	y += rect.y;
+	return graph->bytes[y * graph->bytes_per_row +
+			    x * graph->bytes_per_pixel + c];
+}
+
+/** 双线性插值的参考实现，像素中心对齐，超出边界的坐标取边界上的像素 */
+static double Bilinear( const LCUI_Graph *graph, double fx, double fy, int c )
+{
+	int x0, y0, x1, y1;
+	double wx, wy, top, bottom;
+	fx = fx < 0 ? 0 : fx > graph->width - 1 ? graph->width - 1 : fx;
+	fy = fy < 0 ? 0 : fy > graph->height - 1 ? graph->height - 1 : fy;
+	x0 = (int)fx, y0 = (int)fy;
+	x1 = x0 + 1 < graph->width ? x0 + 1 : x0;
+	y1 = y0 + 1 < graph->height ? y0 + 1 : y0;
+	wx = fx - x0, wy = fy - y0;
+	top = GetChannel( graph, x0, y0, c ) * (1 - wx) +
+	      GetChannel( graph, x1, y0, c ) * wx;
+	bottom = GetChannel( graph, x0, y1, c ) * (1 - wx) +
+		 GetChannel( graph, x1, y1, c ) * wx;
+	return top * (1 - wy) + bottom * wy;
+}
+
+/** 区域平均的参考实现，按覆盖面积计算源像素的权重 */
+static double BoxAverage( const LCUI_Graph *graph, int x, int y,
+			  double sx, double sy, int c )
+{
+	int i, j;
+	double x0 = x * sx, x1 = x0 + sx, y0 = y * sy, y1 = y0 + sy;
+	double w, wx, wy, sum = 0, total = 0;
+	for( j = (int)y0; j < y1 && j < graph->height; ++j ) {
+		wy = (j + 1 < y1 ? j + 1 : y1) - (j > y0 ? j : y0);
+		for( i = (int)x0; i < x1 && i < graph->width; ++i ) {
+			wx = (i + 1 < x1 ? i + 1 : x1) - (i > x0 ? i : x0);
+			w = wx * wy;
+			sum += GetChannel( graph, i, j, c ) * w;
+			total += w;
+		}
+	}
+	return sum / total;
+}
+
+/** 检查各个混合内核的插值函数的结果是否与参考实现一致 */
+static int test_lerp_kernels( void )
+{
+	int i, type, weight;
+	uchar_t a[100], b[100], expected[100], actual[100];
+	LCUI_BlendKernel ref = Graph_GetBlendKernel( BLEND_KERNEL_REFERENCE );
+
+	for( i = 0; i < 100; ++i ) {
+		a[i] = (uchar_t)(rand() % 256);
+		b[i] = (uchar_t)(i % 2 ? 255 : rand() % 256);
+	}
+	for( type = BLEND_KERNEL_SSE2; type < BLEND_KERNEL_TOTAL_NUM; ++type ) {
+		LCUI_BlendKernel kernel = Graph_GetBlendKernel( type );
+		if( !kernel ) {
+			continue;
+		}
+		for( weight = 0; weight <= 256; weight += 16 ) {
+			ref->lerp( expected, a, b, 100, weight );
+			kernel->lerp( actual, a, b, 100, weight );
+			for( i = 0; i < 100; ++i ) {
+				assert( expected[i] == actual[i] );
+			}
+		}
+	}
+	ref->lerp( actual, a, b, 100, 256 );
+	for( i = 0; i < 100; ++i ) {
+		assert( actual[i] == b[i] );
+	}
+	return 0;
+}
+
+static int test_zoom_nearest( int color_type )
+{
+	int x, y, c;
+	LCUI_Rect rect = { {5}, {3}, {50}, {30} };
+	LCUI_Graph src, quote, buff, cut;
+
+	CreateImage( &src, color_type );
+	Graph_Quote( &quote, &src, &rect );
+	Graph_Init( &cut );
+	Graph_Cut( &src, rect, &cut );
+	Graph_Init( &buff );
+	assert( Graph_Zoom( &quote, &buff, FALSE, 120, 17 ) == 0 );
+	assert( buff.width == 120 && buff.height == 17 );
+	for( y = 0; y < buff.height; ++y ) {
+		for( x = 0; x < buff.width; ++x ) {
+			for( c = 0; c < 3; ++c ) {
+				assert( GetChannel( &buff, x, y, c ) ==
+					GetChannel( &cut, x * 50 / 120,
+						    y * 30 / 17, c ) );
+			}
+		}
+	}
+	/* 高度为 0 时按宽度的缩放比例计算 */
+	Graph_Free( &buff );
+	assert( Graph_Zoom( &quote, &buff, FALSE, 100, 0 ) == 0 );
+	assert( buff.width == 100 && buff.height == 60 );
+	Graph_Free( &buff );
+	Graph_Free( &cut );
+	Graph_Free( &src );
+	return 0;
+}
+
+static int test_zoom_bilinear( void )
+{
+	int x, y, c, width = 150, height = 97;
+	double sx, sy, v;
+	LCUI_Graph src, buff;
+
+	CreateImage( &src, COLOR_TYPE_ARGB );
+	Graph_Init( &buff );
+	assert( Graph_ZoomEx( &src, &buff, FALSE, width, height,
+			      ZOOM_FILTER_BILINEAR ) == 0 );
+	sx = 1.0 * SRC_WIDTH / width;
+	sy = 1.0 * SRC_HEIGHT / height;
+	for( y = 0; y < height; ++y ) {
+		for( x = 0; x < width; ++x ) {
+			for( c = 0; c < 4; ++c ) {
+				v = Bilinear( &src, (x + 0.5) * sx - 0.5,
+					      (y + 0.5) * sy - 0.5, c );
+				assert( fabs( GetChannel( &buff, x, y, c ) -
+					      v ) <= 2 );
+			}
+		}
+	}
+	/* 尺寸不变时结果与源图像完全一致 */
+	Graph_Free( &buff );
+	assert( Graph_ZoomEx( &src, &buff, FALSE, SRC_WIDTH, SRC_HEIGHT,
+			      ZOOM_FILTER_BILINEAR ) == 0 );
+	for( y = 0; y < SRC_HEIGHT; ++y ) {
+		for( x = 0; x < SRC_WIDTH; ++x ) {
+			assert( buff.argb[y * SRC_WIDTH + x].value ==
+				src.argb[y * SRC_WIDTH + x].value );
+		}
+	}
+	Graph_Free( &buff );
+	Graph_Free( &src );
+	return 0;
+}
+
+static int test_zoom_box( int color_type )
+{
+	int x, y, c, width = 23, height = 10;
+	double sx, sy, v;
+	LCUI_Graph src, quote, buff;
+	LCUI_Rect rect = { {0}, {0}, {40}, {40} };
+
+	CreateImage( &src, color_type );
+	Graph_Init( &buff );
+	assert( Graph_ZoomEx( &src, &buff, FALSE, width, height,
+			      ZOOM_FILTER_AUTO ) == 0 );
+	sx = 1.0 * SRC_WIDTH / width;
+	sy = 1.0 * SRC_HEIGHT / height;
+	for( y = 0; y < height; ++y ) {
+		for( x = 0; x < width; ++x ) {
+			for( c = 0; c < 3; ++c ) {
+				v = BoxAverage( &src, x, y, sx, sy, c );
+				assert( fabs( GetChannel( &buff, x, y, c ) -
+					      v ) <= 1 );
+			}
+		}
+	}
+	/* 纯色图像缩小后颜色不变 */
+	Graph_Free( &buff );
+	Graph_FillRect( &src, RGB( 12, 34, 56 ), &rect, TRUE );
+	Graph_Quote( &quote, &src, &rect );
+	assert( Graph_ZoomEx( &quote, &buff, FALSE, 7, 13,
+			      ZOOM_FILTER_BOX ) == 0 );
+	for( y = 0; y < buff.height; ++y ) {
+		for( x = 0; x < buff.width; ++x ) {
+			assert( GetChannel( &buff, x, y, 0 ) == 56 );
+			assert( GetChannel( &buff, x, y, 1 ) == 34 );
+			assert( GetChannel( &buff, x, y, 2 ) == 12 );
+		}
+	}
+	Graph_Free( &buff );
+	Graph_Free( &src );
+	return 0;
+}
+
+/** 分块绘制缩放后的背景，每块都引用缓存中的同一张图像 */
+static int test_background_cache( void )
+{
+	int i, n;
+	LCUI_Rect box = { {0}, {0}, {90}, {60} };
+	LCUI_Graph src, canvas, expected;
+	LCUI_Background bg;
+	LCUI_PaintContextRec paint;
+	LCUI_BackgroundCacheStatsRec stats;
+
+	CreateImage( &src, COLOR_TYPE_ARGB );
+	Background_Init( &bg );
+	Graph_Quote( &bg.image, &src, NULL );
+	bg.color = RGB( 0, 0, 0 );
+	bg.size.using_value = FALSE;
+	bg.size.w.type = SVT_PX;
+	bg.size.w.px = box.width;
+	bg.size.h.type = SVT_PX;
+	bg.size.h.px = box.height;
+	Graph_Init( &expected );
+	Graph_Init( &canvas );
+	canvas.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &canvas, box.width, box.height );
+	Graph_ZoomEx( &src, &expected, FALSE, box.width,
+		      box.height, ZOOM_FILTER_AUTO );
+	Background_ReleaseImageCache( &src );
+	Background_GetCacheStats( &stats );
+	n = stats.count;
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	for( i = 0; i < 2; ++i ) {
+		for( paint.rect.y = 0; paint.rect.y < box.height;
+		     paint.rect.y += 32 ) {
+			for( paint.rect.x = 0; paint.rect.x < box.width;
+			     paint.rect.x += 32 ) {
+				paint.rect.width = 32;
+				paint.rect.height = 32;
+				LCUIRect_GetOverlayRect( &paint.rect, &box,
+							 &paint.rect );
+				Graph_Quote( &paint.canvas, &canvas,
+					     &paint.rect );
+				Graph_DrawBackground( &paint, &box, &bg );
+			}
+		}
+	}
+	Background_GetCacheStats( &stats );
+	assert( stats.count == n + 1 );
+	for( i = 0; i < box.width * box.height; ++i ) {
+		LCUI_ARGB c = expected.argb[i], p = canvas.argb[i];
+		/* 背景图像是混合到黑色背景色上的 */
+		assert( p.r == c.r * c.a / 255 || p.r == c.r * c.a / 255 + 1 );
+		assert( p.g == c.g * c.a / 255 || p.g == c.g * c.a / 255 + 1 );
+	}
+	/* 释放源图像后，由它缩放得到的缓存也要释放 */
+	Background_ReleaseImageCache( &bg.image );
+	Background_GetCacheStats( &stats );
+	assert( stats.count == n );
+	Graph_Free( &expected );
+	Graph_Free( &canvas );
+	Graph_Free( &src );
+	return 0;
+}
+
+/** 在原地重新创建源图像后，不应再使用由旧内容缩放得到的缓存 */
+static int test_background_regenerate( void )
+{
+	int i, n;
+	uchar_t *bytes;
+	unsigned long generation;
+	LCUI_Rect box = { {0}, {0}, {90}, {60} };
+	LCUI_Graph src, canvas;
+	LCUI_Background bg;
+	LCUI_PaintContextRec paint;
+	LCUI_BackgroundCacheStatsRec stats, stats2;
+
+	CreateImage( &src, COLOR_TYPE_ARGB );
+	Background_Init( &bg );
+	Graph_Quote( &bg.image, &src, NULL );
+	bg.color = RGB( 0, 0, 0 );
+	bg.size.using_value = FALSE;
+	bg.size.w.type = SVT_PX;
+	bg.size.w.px = box.width;
+	bg.size.h.type = SVT_PX;
+	bg.size.h.px = box.height;
+	Graph_Init( &canvas );
+	canvas.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &canvas, box.width, box.height );
+	Background_GetCacheStats( &stats );
+	n = stats.count;
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.rect = box;
+	Graph_Quote( &paint.canvas, &canvas, &paint.rect );
+	Graph_DrawBackground( &paint, &box, &bg );
+	/* 尺寸不变时重新创建会复用原来的像素数据，但代数会更新 */
+	bytes = src.bytes;
+	generation = src.generation;
+	Graph_Create( &src, SRC_WIDTH, SRC_HEIGHT );
+	assert( src.bytes == bytes && src.generation != generation );
+	Graph_FillRect( &src, RGB( 10, 20, 30 ), NULL, TRUE );
+	Graph_DrawBackground( &paint, &box, &bg );
+	Background_GetCacheStats( &stats2 );
+	assert( stats2.misses - stats.misses == 2 );
+	assert( stats2.count == n + 2 );
+	for( i = 0; i < box.width * box.height; ++i ) {
+		assert( canvas.argb[i].r == 10 && canvas.argb[i].g == 20 );
+		assert( canvas.argb[i].b == 30 );
+	}
+	/* 同一地址的新旧缓存都会被释放 */
+	Background_ReleaseImageCache( &bg.image );
+	Background_GetCacheStats( &stats2 );
+	assert( stats2.count == n );
+	Graph_Free( &canvas );
+	Graph_Free( &src );
+	return 0;
+}
+
+int test_graph_zoom( void )
+{
+	int ret = 0;
+	LCUI_BackgroundCacheStatsRec stats, stats2;
+
+	LCUI_InitBase();
+	ret |= test_lerp_kernels();
+	ret |= test_zoom_nearest( COLOR_TYPE_ARGB );
+	ret |= test_zoom_nearest( COLOR_TYPE_RGB );
+	ret |= test_zoom_bilinear();
+	ret |= test_zoom_box( COLOR_TYPE_ARGB );
+	ret |= test_zoom_box( COLOR_TYPE_RGB );
+	Background_GetCacheStats( &stats );
+	ret |= test_background_cache();
+	Background_GetCacheStats( &stats2 );
+	/* 每块绘制区域都会查询一次缓存，只有第一次需要缩放图像 */
+	assert( stats2.misses - stats.misses == 1 );
+	assert( stats2.hits - stats.hits == 11 );
+	ret |= test_background_regenerate();
+	return ret;
+}
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/draw.h>
+#include <LCUI/display.h>
+#include <LCUI/timer.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/platform/headless_display.h>
+#include "test.h"
+
+#define SCREEN_WIDTH	320
+#define SCREEN_HEIGHT	240
+#define WAIT_TIMEOUT	5000
+
+/** 检查图像中的像素颜色 */
+static LCUI_BOOL CheckColor( LCUI_Graph *graph, int x, int y, LCUI_Color c )
+{
+	uchar_t *px;
+	if( x >= graph->width || y >= graph->height ) {
+		return FALSE;
+	}
+	if( graph->color_type == COLOR_TYPE_ARGB ) {
+		px = (uchar_t*)&graph->argb[y * graph->width + x];
+	} else {
+		px = graph->bytes + (y * graph->width + x) * 3;
+	}
+	return px[0] == c.b && px[1] == c.g && px[2] == c.r;
+}
+
+static struct {
+	int step;
+	int ticks;
+	int ret;
+	int idle_ticks;
+	unsigned long frames;
+	unsigned long pixels;
+	LCUI_Graph frame;
+	LCUI_Widget box;
+	LCUI_Surface surface;
+	LCUI_MainLoop loop;
+	LCUI_DisplayDriver driver;
+	LCUI_BOOL resized;
+} test;
+
+/** 保存为 PNG 文件后再读取，内容应该与呈现的一致 */
+static int CheckPNG( void )
+{
+	int ret = 0;
+	char file[256];
+	LCUI_Graph image;
+
+	snprintf( file, sizeof( file ), "test_headless_display_%d.png",
+		  (int)(LCUI_GetTime() % 10000) );
+	if( LCUI_WriteHeadlessSurfacePNG( test.surface, file ) != 0 ) {
+		/* 编译时未启用 libpng */
+		return 0;
+	}
+	Graph_Init( &image );
+	ret |= Graph_LoadPNG( file, &image );
+	ret |= CheckColor( &image, 20, 20, RGB( 0, 255, 0 ) ) ? 0 : -1;
+	ret |= CheckColor( &image, 5, 5, RGB( 255, 0, 0 ) ) ? 0 : -1;
+	Graph_Free( &image );
+	remove( file );
+	return ret;
+}
+
+/**
+ * 在主循环中检查显示线程呈现的内容
+ * 部件的 surface 事件需要在主循环中处理，所以不能在测试函数中直接等待
+ */
+static void OnCheckFrame( void *arg )
+{
+	LCUI_FrameStatsRec frame_stats;
+	LCUI_HeadlessDisplayStatsRec stats;
+
+	if( ++test.ticks > WAIT_TIMEOUT / 10 ) {
+		test.ret = -1;
+		LCUI_MainLoop_Quit( test.loop );
+		return;
+	}
+	if( !test.surface ) {
+		test.surface = LCUIDisplay_GetSurfaceOwner( LCUIWidget_GetRoot() );
+		return;
+	}
+	if( LCUI_ReadHeadlessSurface( test.surface, &test.frame ) != 0 ) {
+		return;
+	}
+	LCUI_GetHeadlessDisplayStats( &stats );
+	switch( test.step ) {
+	case 0:
+		if( !CheckColor( &test.frame, 20, 20, RGB( 0, 0, 255 ) ) ) {
+			return;
+		}
+		test.ret |= CheckColor( &test.frame, 5, 5,
+					RGB( 255, 0, 0 ) ) ? 0 : -1;
+		test.ret |= CheckColor( &test.frame, 70, 60,
+					RGB( 255, 0, 0 ) ) ? 0 : -1;
+		test.ret |= test.frame.width == SCREEN_WIDTH ? 0 : -1;
+		test.ret |= test.frame.height == SCREEN_HEIGHT ? 0 : -1;
+		test.pixels = stats.pixels;
+		Widget_SetStyle( test.box, key_background_color,
+				 RGB( 0, 255, 0 ), color );
+		Widget_UpdateStyle( test.box, FALSE );
+		test.step = 1;
+		break;
+	case 1:
+		if( !CheckColor( &test.frame, 20, 20, RGB( 0, 255, 0 ) ) ) {
+			return;
+		}
+		/* 只有改变了的区域会被重绘和呈现 */
+		test.ret |= stats.pixels - test.pixels <
+			    SCREEN_WIDTH * SCREEN_HEIGHT ? 0 : -1;
+		test.ret |= CheckPNG();
+		/* 显示线程记录了每一帧的渲染和呈现耗时 */
+		LCUIDisplay_GetFrameStats( &frame_stats );
+		test.ret |= frame_stats.frames > 0 ? 0 : -1;
+		test.ret |= frame_stats.total[FRAME_STAGE_RENDER] > 0 ? 0 : -1;
+		test.ret |= frame_stats.total[FRAME_STAGE_PRESENT] > 0 ? 0 : -1;
+		test.frames = frame_stats.frames;
+		test.step = 2;
+		break;
+	case 2:
+		if( ++test.idle_ticks < 20 ) {
+			return;
+		}
+		/* 界面没有变化时，显示线程不再更新画面 */
+		LCUIDisplay_GetFrameStats( &frame_stats );
+		test.ret |= frame_stats.frames - test.frames <= 2 ? 0 : -1;
+		LCUI_MainLoop_Quit( test.loop );
+		break;
+	default: break;
+	}
+}
+
+static void ResizeThread( void *arg )
+{
+	test.driver->resize( arg, SCREEN_WIDTH, SCREEN_HEIGHT );
+	test.resized = TRUE;
+	LCUIThread_Exit( NULL );
+}
+
+/** 调整尺寸时需要等待正在进行的绘制结束，不能释放正在绘制的缓存 */
+static int CheckResizeWhilePainting( void )
+{
+	LCUI_Rect rect;
+	LCUI_Thread tid;
+	LCUI_Surface surface;
+	LCUI_PaintContext paint;
+
+	test.driver = LCUI_CreateHeadlessDisplay( SCREEN_WIDTH, SCREEN_HEIGHT );
+	assert( test.driver != NULL );
+	surface = test.driver->create();
+	test.driver->resize( surface, 40, 30 );
+	rect.x = rect.y = 0;
+	rect.width = 40;
+	rect.height = 30;
+	paint = test.driver->beginPaint( surface, &rect );
+	assert( paint != NULL );
+	test.resized = FALSE;
+	assert( LCUIThread_Create( &tid, ResizeThread, surface ) == 0 );
+	LCUI_MSleep( 50 );
+	assert( !test.resized );
+	Graph_FillRect( &paint->canvas, RGB( 0, 0, 255 ), NULL, TRUE );
+	test.driver->endPaint( surface, paint );
+	LCUIThread_Join( tid, NULL );
+	assert( test.resized );
+	LCUI_DestroyHeadlessDisplay( test.driver );
+	test.driver = NULL;
+	return 0;
+}
+
+int test_headless_display( void )
+{
+	int timer;
+	LCUI_Widget root;
+	LCUI_DisplayDriver driver;
+
+	assert( CheckResizeWhilePainting() == 0 );
+	LCUI_InitBase();
+#ifdef LCUI_BUILD_IN_LINUX
+	/* 不连接 X 服务器，任务由 LCUI 自己的任务队列处理 */
+	setenv( "LCUI_VIDEO_DRIVER", "headless", 1 );
+#endif
+	LCUI_InitApp( NULL );
+	root = LCUIWidget_GetRoot();
+	test.box = LCUIWidget_New( NULL );
+	Widget_SetStyle( root, key_background_color, RGB( 255, 0, 0 ), color );
+	Widget_SetStyle( test.box, key_background_color,
+			 RGB( 0, 0, 255 ), color );
+	Widget_SetStyle( test.box, key_position, SV_ABSOLUTE, style );
+	Widget_Move( test.box, 10, 10 );
+	Widget_Resize( test.box, 50, 40 );
+	Widget_Append( root, test.box );
+	Widget_UpdateStyle( test.box, FALSE );
+	Widget_UpdateStyle( root, FALSE );
+
+	driver = LCUI_CreateHeadlessDisplay( SCREEN_WIDTH, SCREEN_HEIGHT );
+	assert( driver != NULL );
+	/* 由真正的显示线程完成更新和渲染 */
+	assert( LCUI_InitDisplay( driver ) == 0 );
+	LCUIDisplay_SetMode( LCDM_FULLSCREEN );
+	Graph_Init( &test.frame );
+	test.loop = LCUI_MainLoop_New();
+	timer = LCUITimer_Set( 10, OnCheckFrame, NULL, TRUE );
+	LCUI_MainLoop_Run( test.loop );
+	LCUITimer_Free( timer );
+	LCUI_ExitDisplay();
+	LCUI_DestroyHeadlessDisplay( driver );
+	Graph_Free( &test.frame );
+	free( test.loop );
+	assert( test.ret == 0 );
+	return 0;
+}
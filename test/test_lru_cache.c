@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+
+#define ITEM_SIZE	100
+
+typedef struct ItemRec_ {
+	int key;
+	LCUI_LRUCacheEntryRec entry;
+} ItemRec, *Item;
+
+/** 尚未销毁的对象数量 */
+static int n_items;
+
+static Item Item_New( int key, size_t size )
+{
+	Item item = NEW( ItemRec, 1 );
+	item->key = key;
+	item->entry.data = item;
+	item->entry.key = &item->key;
+	item->entry.size = size;
+	n_items += 1;
+	return item;
+}
+
+static void Item_Delete( void *arg )
+{
+	free( arg );
+	n_items -= 1;
+}
+
+static Item GetItem( LRUCache cache, int key )
+{
+	return LRUCache_Get( cache, &key );
+}
+
+static void AddItem( LRUCache cache, int key )
+{
+	Item item = Item_New( key, ITEM_SIZE );
+	item = LRUCache_Add( cache, &item->entry );
+	LRUCache_Release( cache, &item->entry );
+}
+
+static LCUI_BOOL IsOddItem( void *data, const void *arg )
+{
+	return ((Item)data)->key % 2 == 1;
+}
+
+/** 淘汰最久未使用的对象，正在使用的对象不会被淘汰 */
+static int CheckEvict( void )
+{
+	Item item;
+	LRUCache cache;
+	LCUI_LRUCacheStatsRec stats;
+
+	n_items = 0;
+	cache = LRUCache_Create( sizeof( int ), ITEM_SIZE * 3, Item_Delete );
+	assert( GetItem( cache, 1 ) == NULL );
+	AddItem( cache, 1 );
+	AddItem( cache, 2 );
+	AddItem( cache, 3 );
+	item = GetItem( cache, 1 );
+	assert( item != NULL && item->key == 1 );
+	LRUCache_Release( cache, &item->entry );
+	/* 2 是最久未使用的 */
+	AddItem( cache, 4 );
+	assert( GetItem( cache, 2 ) == NULL );
+	LRUCache_GetStats( cache, &stats );
+	assert( stats.count == 3 && stats.used_bytes == ITEM_SIZE * 3 );
+	assert( stats.hits == 1 && stats.misses == 2 );
+	assert( n_items == 3 );
+	/* 缩小预算后只留下正在使用的对象 */
+	item = GetItem( cache, 3 );
+	LRUCache_SetMaxBytes( cache, ITEM_SIZE );
+	LRUCache_GetStats( cache, &stats );
+	assert( stats.count == 1 && n_items == 1 );
+	LRUCache_Release( cache, &item->entry );
+	assert( GetItem( cache, 3 ) == item );
+	LRUCache_Release( cache, &item->entry );
+	LRUCache_Destroy( cache );
+	assert( n_items == 0 );
+	return 0;
+}
+
+/** 重复添加、超出预算和移除正在使用的对象 */
+static int CheckOwnership( void )
+{
+	Item item, dup, big;
+	LRUCache cache;
+	LCUI_LRUCacheStatsRec stats;
+
+	n_items = 0;
+	cache = LRUCache_Create( sizeof( int ), ITEM_SIZE * 4, Item_Delete );
+	AddItem( cache, 1 );
+	AddItem( cache, 2 );
+	/* 已有相同索引的对象时，新对象被销毁，改为引用已有的对象 */
+	item = GetItem( cache, 1 );
+	dup = Item_New( 1, ITEM_SIZE );
+	assert( LRUCache_Add( cache, &dup->entry ) == item );
+	assert( n_items == 2 );
+	LRUCache_Release( cache, &item->entry );
+	LRUCache_Release( cache, &item->entry );
+	/* 超出预算的对象不缓存，释放后销毁 */
+	big = Item_New( 3, ITEM_SIZE * 5 );
+	assert( LRUCache_Add( cache, &big->entry ) == big );
+	assert( GetItem( cache, 3 ) == NULL && n_items == 3 );
+	LRUCache_Release( cache, &big->entry );
+	assert( n_items == 2 );
+	/* 移除的对象如果正在使用，则在释放后销毁 */
+	LRUCache_RemoveIf( cache, IsOddItem, NULL );
+	LRUCache_GetStats( cache, &stats );
+	assert( stats.count == 1 && n_items == 1 );
+	AddItem( cache, 1 );
+	item = GetItem( cache, 1 );
+	LRUCache_RemoveIf( cache, IsOddItem, NULL );
+	assert( GetItem( cache, 1 ) == NULL && n_items == 2 );
+	LRUCache_Release( cache, &item->entry );
+	assert( n_items == 1 );
+	LRUCache_Destroy( cache );
+	assert( n_items == 0 );
+	return 0;
+}
+
+int test_lru_cache( void )
+{
+	int ret = 0;
+	ret |= CheckEvict();
+	ret |= CheckOwnership();
+	return ret;
+}
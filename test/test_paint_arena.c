@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+
+#define BLOCK_SIZE	1024
+#define CANVAS_WIDTH	160
+#define CANVAS_HEIGHT	120
+#define N_BOXES		80
+
+static int CheckArena( void )
+{
+	int i;
+	size_t capacity;
+	void *ptrs[8];
+	LCUI_ArenaRec arena;
+
+	Arena_Init( &arena, BLOCK_SIZE );
+	for( i = 0; i < 8; ++i ) {
+		ptrs[i] = Arena_Alloc( &arena, 1 + i * 7 );
+		assert( ptrs[i] != NULL );
+		assert( ((size_t)ptrs[i] & 15) == 0 );
+		assert( Arena_Contains( &arena, ptrs[i] ) );
+	}
+	assert( arena.blocks_created == 1 );
+	assert( !Arena_Contains( &arena, &arena ) );
+	/* 超出块容量的分配会创建新的块 */
+	ptrs[0] = Arena_Alloc( &arena, BLOCK_SIZE * 3 );
+	assert( ptrs[0] != NULL && Arena_Contains( &arena, ptrs[0] ) );
+	assert( arena.blocks_created == 2 );
+	memset( ptrs[0], 0xff, BLOCK_SIZE * 3 );
+	capacity = arena.capacity;
+	assert( arena.peak == arena.used && arena.peak > BLOCK_SIZE * 3 );
+	/* 重置后合并成一个块，再次分配同样多的内存不需要新的块 */
+	Arena_Reset( &arena );
+	assert( arena.used == 0 && arena.capacity == capacity );
+	assert( arena.blocks_created == 3 );
+	for( i = 0; i < 8; ++i ) {
+		Arena_Alloc( &arena, 1 + i * 7 );
+	}
+	Arena_Alloc( &arena, BLOCK_SIZE * 3 );
+	assert( arena.blocks_created == 3 );
+	assert( arena.allocs == 18 );
+	Arena_Destroy( &arena );
+	assert( arena.capacity == 0 && arena.blocks == NULL );
+	return 0;
+}
+
+/** 用量回落后，容量应在回收周期结束时缩小，峰值也应随之清零 */
+static int CheckTrim( void )
+{
+	int i;
+	size_t capacity;
+	LCUI_ArenaRec arena;
+
+	Arena_Init( &arena, BLOCK_SIZE );
+	Arena_Alloc( &arena, BLOCK_SIZE * 8 );
+	capacity = arena.capacity;
+	assert( capacity >= BLOCK_SIZE * 8 );
+	/* 第一个周期内出现过大量分配，容量保持不变 */
+	for( i = 0; i < ARENA_TRIM_FRAMES; ++i ) {
+		Arena_Reset( &arena );
+		assert( arena.capacity == capacity );
+		Arena_Alloc( &arena, 100 );
+	}
+	assert( arena.trims == 0 );
+	assert( arena.peak == arena.used && arena.peak < BLOCK_SIZE );
+	/* 第二个周期内只有少量分配，周期结束时缩小到块的最小容量 */
+	for( i = 1; i < ARENA_TRIM_FRAMES; ++i ) {
+		Arena_Reset( &arena );
+		assert( arena.capacity == capacity );
+		Arena_Alloc( &arena, 100 );
+	}
+	Arena_Reset( &arena );
+	assert( arena.trims == 1 && arena.peak == 0 );
+	assert( arena.capacity == BLOCK_SIZE );
+	assert( Arena_Alloc( &arena, BLOCK_SIZE ) != NULL );
+	Arena_Destroy( &arena );
+	return 0;
+}
+
+/** 将部件渲染到画板上 */
+static void RenderWidget( LCUI_Widget w, LCUI_Graph *canvas,
+			  LCUI_Arena arena )
+{
+	LCUI_PaintContextRec paint;
+	Graph_Init( canvas );
+	canvas->color_type = COLOR_TYPE_ARGB;
+	Graph_Create( canvas, CANVAS_WIDTH, CANVAS_HEIGHT );
+	paint.with_alpha = FALSE;
+	paint.arena = arena;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = w->box.graph.width;
+	paint.rect.height = w->box.graph.height;
+	Graph_Quote( &paint.canvas, canvas, &paint.rect );
+	Widget_Render( w, &paint );
+}
+
+/** 使用临时内存绘制的结果应该与使用 malloc() 绘制的一致 */
+static int CheckRender( void )
+{
+	int i;
+	LCUI_ArenaRec arena;
+	LCUI_Widget root, box;
+	LCUI_Graph expected, actual;
+
+	LCUI_InitBase();
+	root = LCUIWidget_New( NULL );
+	Widget_Resize( root, CANVAS_WIDTH, CANVAS_HEIGHT );
+	Widget_SetStyle( root, key_background_color,
+			 RGB( 240, 240, 240 ), color );
+	/* 半透明的部件需要临时的自身位图、内容位图和图层位图 */
+	Widget_SetStyle( root, key_opacity, 0.8, scale );
+	/* 子部件较多时，遮挡标记也需要临时内存 */
+	for( i = 0; i < N_BOXES; ++i ) {
+		box = LCUIWidget_New( NULL );
+		Widget_SetStyle( box, key_position, SV_ABSOLUTE, style );
+		Widget_SetStyle( box, key_background_color,
+				 ARGB( 200, (uchar_t)(i * 3), 100, 200 ),
+				 color );
+		Widget_SetStyle( box, key_opacity, 0.9, scale );
+		Widget_Move( box, (i % 10) * 15, (i / 10) * 14 );
+		Widget_Resize( box, 20, 18 );
+		Widget_Append( root, box );
+		Widget_UpdateStyle( box, TRUE );
+	}
+	Widget_UpdateStyle( root, TRUE );
+	for( i = 0; i < 10 && Widget_Update( root ); ++i );
+	Arena_Init( &arena, 0 );
+	RenderWidget( root, &expected, NULL );
+	RenderWidget( root, &actual, &arena );
+	assert( arena.allocs > N_BOXES );
+	assert( arena.peak > 0 && arena.used == arena.peak );
+	assert( memcmp( expected.bytes, actual.bytes,
+			expected.mem_size ) == 0 );
+	/* 重置后再绘制一次，不需要再申请内存块 */
+	Arena_Reset( &arena );
+	Graph_Free( &actual );
+	i = (int)arena.blocks_created;
+	RenderWidget( root, &actual, &arena );
+	assert( arena.blocks_created == (unsigned long)i );
+	assert( memcmp( expected.bytes, actual.bytes,
+			expected.mem_size ) == 0 );
+	Arena_Destroy( &arena );
+	Graph_Free( &expected );
+	Graph_Free( &actual );
+	Widget_Destroy( root );
+	return 0;
+}
+
+int test_paint_arena( void )
+{
+	int ret = 0;
+	ret |= CheckArena();
+	ret |= CheckTrim();
+	ret |= CheckRender();
+	return ret;
+}
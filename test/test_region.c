@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/util/region.h>
+#include "test.h"
+
+#define MAP_SIZE 64
+
+/** 用位图记录每个像素是否在区域内，作为参考结果 */
+static unsigned char map[MAP_SIZE][MAP_SIZE];
+
+static void RandRect( LCUI_Rect *rect )
+{
+	rect->x = rand() % MAP_SIZE;
+	rect->y = rand() % MAP_SIZE;
+	rect->width = 1 + rand() % (MAP_SIZE - rect->x);
+	rect->height = 1 + rand() % (MAP_SIZE - rect->y);
+}
+
+static void FillMap( const LCUI_Rect *rect, unsigned char value )
+{
+	int x, y;
+	for( y = rect->y; y < rect->y + rect->height; ++y ) {
+		for( x = rect->x; x < rect->x + rect->width; ++x ) {
+			map[y][x] = value;
+		}
+	}
+}
+
+/** 检查区域中的矩形是否有序、互不重叠，并且与参考结果一致 */
+static int CheckRegion( LCUI_Region region, LCUI_BOOL exact )
+{
+	int i, x, y;
+	LCUI_Rect *a, *b;
+	static unsigned char cover[MAP_SIZE][MAP_SIZE];
+	memset( cover, 0, sizeof( cover ) );
+	for( i = 0; i < region->length; ++i ) {
+		a = &region->rects[i];
+		assert( a->width > 0 && a->height > 0 );
+		if( i > 0 ) {
+			b = &region->rects[i - 1];
+			if( a->y == b->y ) {
+				/* 同一个带中的矩形高度相同，且不相接 */
+				assert( a->height == b->height );
+				assert( b->x + b->width < a->x );
+			} else {
+				assert( b->y + b->height <= a->y );
+			}
+		}
+		for( y = a->y; y < a->y + a->height; ++y ) {
+			for( x = a->x; x < a->x + a->width; ++x ) {
+				assert( !cover[y][x] );
+				cover[y][x] = 1;
+			}
+		}
+	}
+	for( y = 0; y < MAP_SIZE; ++y ) {
+		for( x = 0; x < MAP_SIZE; ++x ) {
+			if( exact ) {
+				assert( cover[y][x] == map[y][x] );
+			} else if( map[y][x] ) {
+				assert( cover[y][x] );
+			}
+		}
+	}
+	return 0;
+}
+
+int test_region( void )
+{
+	int i, round;
+	LCUI_Rect rect;
+	LCUI_RegionRec region;
+
+	Region_Init( &region );
+	for( round = 0; round < 20; ++round ) {
+		memset( map, 0, sizeof( map ) );
+		Region_Clear( &region );
+		for( i = 0; i < 50; ++i ) {
+			RandRect( &rect );
+			if( rand() % 3 == 0 ) {
+				Region_Subtract( &region, &rect );
+				FillMap( &rect, 0 );
+			} else {
+				Region_Union( &region, &rect );
+				FillMap( &rect, 1 );
+			}
+			if( CheckRegion( &region, TRUE ) != 0 ) {
+				return -1;
+			}
+		}
+	}
+	/* 添加无效区域时允许合并，但必须覆盖所有添加的矩形 */
+	memset( map, 0, sizeof( map ) );
+	Region_Clear( &region );
+	for( i = 0; i < 200; ++i ) {
+		rect.x = rand() % (MAP_SIZE - 4);
+		rect.y = rand() % (MAP_SIZE - 4);
+		rect.width = 1 + rand() % 4;
+		rect.height = 1 + rand() % 4;
+		Region_AddRect( &region, &rect );
+		FillMap( &rect, 1 );
+		if( CheckRegion( &region, FALSE ) != 0 ) {
+			return -1;
+		}
+	}
+	/* 两个重叠的矩形合并后没有浪费面积，应该得到一个矩形 */
+	Region_Clear( &region );
+	rect.x = 0, rect.y = 0, rect.width = 20, rect.height = 20;
+	Region_AddRect( &region, &rect );
+	rect.x = 10, rect.width = 30;
+	Region_AddRect( &region, &rect );
+	assert( region.length == 1 && region.rects[0].width == 40 );
+	assert( Region_GetAreaIn( &region, &rect ) == 30 * 20 );
+	Region_Destroy( &region );
+	return 0;
+}
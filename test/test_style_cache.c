@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+
+#define GetWidth(W) (W)->style->sheet[key_width].val_px
+
+int test_style_cache( void )
+{
+	unsigned int fa, fb;
+	LCUI_Widget panel, a, b;
+
+	LCUI_InitBase();
+	panel = LCUIWidget_New( NULL );
+	a = LCUIWidget_New( NULL );
+	b = LCUIWidget_New( NULL );
+	Widget_AddClass( panel, "sc-panel" );
+	Widget_AddClass( a, "sc-a" );
+	Widget_AddClass( b, "sc-b" );
+	Widget_Append( panel, a );
+	Widget_Append( panel, b );
+	Widget_ExecUpdateStyle( a, TRUE );
+	Widget_ExecUpdateStyle( b, TRUE );
+	fa = a->style_fingerprint;
+	fb = b->style_fingerprint;
+	assert( fa != 0 && fb != 0 && fa != fb );
+	/* 样式没有变化时，指纹也不变 */
+	Widget_ExecUpdateStyle( a, TRUE );
+	assert( a->style_fingerprint == fa );
+	/* 新增的样式规则只影响匹配它的部件的缓存 */
+	LCUI_LoadCSSString( ".sc-a { width: 10px; }", NULL );
+	Widget_ExecUpdateStyle( a, TRUE );
+	Widget_ExecUpdateStyle( b, TRUE );
+	assert( a->style_fingerprint != fa && GetWidth( a ) == 10 );
+	assert( b->style_fingerprint == fb );
+	fa = a->style_fingerprint;
+	LCUI_LoadCSSString( ".sc-panel .sc-b { width: 20px; }", NULL );
+	Widget_ExecUpdateStyle( a, TRUE );
+	Widget_ExecUpdateStyle( b, TRUE );
+	assert( a->style_fingerprint == fa && GetWidth( a ) == 10 );
+	assert( b->style_fingerprint != fb && GetWidth( b ) == 20 );
+	/* 部件的类名有变化时，需要用新的选择器获取样式表 */
+	Widget_AddClass( b, "sc-a" );
+	Widget_ExecUpdateStyle( b, TRUE );
+	assert( GetWidth( b ) == 20 );
+	Widget_RemoveClass( b, "sc-b" );
+	Widget_ExecUpdateStyle( b, TRUE );
+	assert( GetWidth( b ) == 10 );
+	Widget_ExecDestroy( panel );
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+
+#define N_ITEMS	20
+#define GetWidth(W) (W)->style->sheet[key_width].val_px
+
+int test_style_share( void )
+{
+	int i;
+	size_t saved_bytes;
+	LCUI_Widget list, items[N_ITEMS];
+	LCUI_WidgetStyleStatsRec base, stats;
+
+	LCUI_InitBase();
+	LCUIWidget_GetStyleStats( &base );
+	/* 没有获取过继承样式的部件，样式表是私有的，不算作共享 */
+	list = LCUIWidget_New( NULL );
+	Widget_ExecUpdateStyle( list, FALSE );
+	assert( list->style == list->inherited_style );
+	LCUIWidget_GetStyleStats( &stats );
+	assert( stats.shared == base.shared );
+	assert( stats.saved_bytes == base.saved_bytes );
+	Widget_ExecDestroy( list );
+	LCUI_LoadCSSString( ".ss-list .ss-item { width: 30px; }", NULL );
+	list = LCUIWidget_New( NULL );
+	Widget_AddClass( list, "ss-list" );
+	for( i = 0; i < N_ITEMS; ++i ) {
+		items[i] = LCUIWidget_New( NULL );
+		Widget_AddClass( items[i], "ss-item" );
+		Widget_Append( list, items[i] );
+	}
+	for( i = 0; i < N_ITEMS; ++i ) {
+		Widget_ExecUpdateStyle( items[i], TRUE );
+	}
+	/**
+	 * 选择器路径相同的兄弟部件共用同一份样式表，首尾两个部件因为有
+	 * :first-child 和 :last-child 状态而不在此列
+	 */
+	for( i = 2; i < N_ITEMS - 1; ++i ) {
+		assert( items[i]->style == items[1]->style );
+		assert( items[i]->inherited_style == items[1]->style );
+	}
+	assert( items[0]->style != items[1]->style );
+	assert( GetWidth( items[0] ) == 30 && GetWidth( items[1] ) == 30 );
+	LCUIWidget_GetStyleStats( &stats );
+	assert( stats.shared - base.shared >= 2 * N_ITEMS );
+	saved_bytes = 2 * N_ITEMS * sizeof( LCUI_StyleSheetRec );
+	assert( stats.saved_bytes - base.saved_bytes >= saved_bytes );
+	saved_bytes = stats.saved_bytes;
+	/* 设置自定义样式后，部件会得到一份独立的样式表，其它部件不受影响 */
+	Widget_SetStyle( items[2], key_width, 50, px );
+	Widget_ExecUpdateStyle( items[2], FALSE );
+	assert( items[2]->style != items[1]->style );
+	assert( items[2]->inherited_style == items[1]->style );
+	assert( GetWidth( items[2] ) == 50 && GetWidth( items[1] ) == 30 );
+	LCUIWidget_GetStyleStats( &stats );
+	assert( stats.saved_bytes < saved_bytes );
+	/* 样式规则变化后，共享的样式表会被替换，旧的仍由未更新的部件持有 */
+	LCUI_LoadCSSString( ".ss-list .ss-item { width: 40px; }", NULL );
+	Widget_ExecUpdateStyle( items[1], TRUE );
+	Widget_ExecUpdateStyle( items[2], TRUE );
+	assert( GetWidth( items[1] ) == 40 && GetWidth( items[3] ) == 30 );
+	assert( GetWidth( items[2] ) == 50 );
+	assert( items[2]->inherited_style == items[1]->style );
+	Widget_ExecDestroy( list );
+	LCUIWidget_GetStyleStats( &stats );
+	assert( stats.shared == base.shared );
+	assert( stats.saved_bytes == base.saved_bytes );
+	return 0;
+}
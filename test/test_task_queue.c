@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include "test.h"
+
+#define N_TASKS		1500
+#define N_PRODUCERS	4
+#define N_THREAD_TASKS	5000
+
+static struct {
+	int count;
+	int deleted;
+	int order[N_TASKS];
+	int last[N_PRODUCERS];
+	LCUI_BOOL in_order;
+} test;
+
+static void OnTask( void *arg1, void *arg2 )
+{
+	test.order[test.count++] = (int)(size_t)arg1;
+}
+
+static void OnThreadTask( void *arg1, void *arg2 )
+{
+	int i = (int)(size_t)arg1;
+	int n = (int)(size_t)arg2;
+	if( n != test.last[i] + 1 ) {
+		test.in_order = FALSE;
+	}
+	test.last[i] = n;
+	test.count += 1;
+}
+
+static void OnDeleteArg( void *arg )
+{
+	test.deleted += 1;
+}
+
+static void ProducerThread( void *arg )
+{
+	int i;
+	LCUI_AppTaskRec task = { 0 };
+	task.func = OnThreadTask;
+	task.arg[0] = arg;
+	for( i = 0; i < N_THREAD_TASKS; ++i ) {
+		task.arg[1] = (void*)(size_t)i;
+		LCUI_PostTask( &task );
+	}
+	LCUIThread_Exit( NULL );
+}
+
+static void WaitTasks( int n )
+{
+	while( test.count < n ) {
+		LCUI_WaitEvent();
+		LCUI_DispatchEvent();
+	}
+}
+
+/** 超出缓冲区容量的任务也应该按添加顺序执行 */
+static int CheckOrder( void )
+{
+	int i;
+	LCUI_AppTaskRec task = { 0 };
+	LCUI_TaskQueueStatsRec stats, old_stats;
+
+	LCUI_GetTaskQueueStats( &old_stats );
+	test.count = 0;
+	task.func = OnTask;
+	for( i = 0; i < N_TASKS; ++i ) {
+		task.arg[0] = (void*)(size_t)i;
+		assert( LCUI_PostTask( &task ) );
+	}
+	LCUI_GetTaskQueueStats( &stats );
+	assert( stats.depth >= N_TASKS );
+	assert( stats.posted - old_stats.posted == N_TASKS );
+	assert( stats.overflows - old_stats.overflows >=
+		N_TASKS - stats.capacity );
+	WaitTasks( N_TASKS );
+	for( i = 0; i < N_TASKS; ++i ) {
+		assert( test.order[i] == i );
+	}
+	LCUI_GetTaskQueueStats( &stats );
+	assert( stats.depth == 0 );
+	assert( stats.max_depth >= N_TASKS );
+	assert( stats.dispatched - old_stats.dispatched >= N_TASKS );
+	assert( stats.max_latency > 0 && stats.total_latency > 0 );
+	/* 一次分发就能处理完所有已就绪的任务，并销毁任务的参数 */
+	test.count = 0;
+	task.destroy_arg[0] = OnDeleteArg;
+	for( i = 0; i < 100; ++i ) {
+		task.arg[0] = (void*)(size_t)(i + 1);
+		LCUI_PostTask( &task );
+	}
+	LCUI_DispatchEvent();
+	assert( test.count == 100 && test.deleted == 100 );
+	return 0;
+}
+
+/** 多个线程同时添加任务时，每个线程的任务都应该按顺序执行 */
+static int CheckProducers( void )
+{
+	int i;
+	LCUI_Thread threads[N_PRODUCERS];
+
+	test.count = 0;
+	test.in_order = TRUE;
+	for( i = 0; i < N_PRODUCERS; ++i ) {
+		test.last[i] = -1;
+		LCUIThread_Create( &threads[i], ProducerThread,
+				   (void*)(size_t)i );
+	}
+	WaitTasks( N_PRODUCERS * N_THREAD_TASKS );
+	for( i = 0; i < N_PRODUCERS; ++i ) {
+		LCUIThread_Join( threads[i], NULL );
+		assert( test.last[i] == N_THREAD_TASKS - 1 );
+	}
+	assert( test.in_order );
+	assert( test.count == N_PRODUCERS * N_THREAD_TASKS );
+	return 0;
+}
+
+int test_task_queue( void )
+{
+	int ret = 0;
+	LCUI_InitBase();
+#ifdef LCUI_BUILD_IN_LINUX
+	setenv( "LCUI_VIDEO_DRIVER", "headless", 1 );
+#endif
+	LCUI_InitApp( NULL );
+	ret |= CheckOrder();
+	ret |= CheckProducers();
+	return ret;
+}
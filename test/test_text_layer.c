@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <wchar.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/font.h>
+#include "test.h"
+
+#define LAYER_WIDTH	320
+#define LAYER_HEIGHT	240
+
+static void CreateCanvas( LCUI_Graph *canvas )
+{
+	Graph_Init( canvas );
+	canvas->color_type = COLOR_TYPE_ARGB;
+	Graph_Create( canvas, LAYER_WIDTH, LAYER_HEIGHT );
+	Graph_FillRect( canvas, ARGB( 255, 255, 255, 255 ), NULL, TRUE );
+}
+
+/** 统计区域内被绘制过的像素 */
+static int CountPixels( LCUI_Graph *canvas, LCUI_Rect *rect )
+{
+	int x, y, n = 0;
+	for( y = rect->y; y < rect->y + rect->height; ++y ) {
+		for( x = rect->x; x < rect->x + rect->width; ++x ) {
+			if( canvas->argb[y * canvas->width + x].value != -1 ) {
+				++n;
+			}
+		}
+	}
+	return n;
+}
+
+/** 比较两块画板在指定区域内的内容 */
+static int CompareArea( LCUI_Graph *a, LCUI_Graph *b, LCUI_Rect *rect )
+{
+	int x, y, i;
+	for( y = rect->y; y < rect->y + rect->height; ++y ) {
+		for( x = rect->x; x < rect->x + rect->width; ++x ) {
+			i = y * a->width + x;
+			if( a->argb[i].value != b->argb[i].value ) {
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+/** 比较两个文本图层的排版结果 */
+static int CompareTypeset( LCUI_TextLayer layer, LCUI_TextLayer ref )
+{
+	int i, n = TextLayer_GetRowTotal( ref );
+	assert( TextLayer_GetRowTotal( layer ) == n );
+	for( i = 0; i < n; ++i ) {
+		assert( TextLayer_GetRowTextLength( layer, i ) ==
+			TextLayer_GetRowTextLength( ref, i ) );
+	}
+	assert( TextLayer_GetHeight( layer ) == TextLayer_GetHeight( ref ) );
+	return 0;
+}
+
+/** 检查增量排版的结果是否与重新完整排版的结果一致 */
+static int CheckTypeset( LCUI_TextLayer layer, const wchar_t *text )
+{
+	int ret;
+	LCUI_TextLayer ref = TextLayer_New();
+	TextLayer_SetMultiline( ref, TRUE );
+	TextLayer_SetAutoWrap( ref, TRUE );
+	TextLayer_SetMaxSize( ref, LAYER_WIDTH, LAYER_HEIGHT );
+	TextLayer_AppendTextW( ref, text, NULL );
+	TextLayer_Update( ref, NULL );
+	ret = CompareTypeset( layer, ref );
+	TextLayer_Destroy( ref );
+	return ret;
+}
+
+/** 根据文字在文本中的位置设置插入点 */
+static void SetCaretByPos( LCUI_TextLayer layer, const wchar_t *text, int pos )
+{
+	int row, len, i = 0, n = TextLayer_GetRowTotal( layer );
+	for( row = 0; row < n; ++row ) {
+		len = TextLayer_GetRowTextLength( layer, row );
+		if( pos < i + len || (pos == i + len &&
+		    (row == n - 1 || text[pos] == L'\n')) ) {
+			break;
+		}
+		i += len;
+		if( text[i] == L'\n' ) {
+			++i;
+		}
+	}
+	TextLayer_SetCaretPos( layer, row, pos - i );
+}
+
+/** 获取插入点在文本中的位置，换行符也算作一个字 */
+static int GetCaretPos( LCUI_TextLayer layer )
+{
+	int row, pos = 0;
+	for( row = 0; row < layer->insert_y; ++row ) {
+		pos += layer->rowlist.rows[row]->length;
+		if( layer->rowlist.rows[row]->eol != EOL_NONE ) {
+			++pos;
+		}
+	}
+	return pos + layer->insert_x;
+}
+
+/** 在自动换行的文本中逐字输入和删除，每次修改后都进行排版 */
+static int test_text_layer_typing( void )
+{
+	int i, len, pos = 5;
+	wchar_t text[2048], ch[2] = { 0 };
+	LCUI_TextLayer layer = TextLayer_New();
+
+	TextLayer_SetMultiline( layer, TRUE );
+	TextLayer_SetAutoWrap( layer, TRUE );
+	TextLayer_SetMaxSize( layer, LAYER_WIDTH, LAYER_HEIGHT );
+	for( i = 0, len = 0; i < 1200; ++i ) {
+		text[len++] = i % 97 == 96 ? L'\n' : L'a' + i % 26;
+	}
+	text[len] = 0;
+	TextLayer_AppendTextW( layer, text, NULL );
+	TextLayer_Update( layer, NULL );
+	assert( CheckTypeset( layer, text ) == 0 );
+	for( i = 0; i < 120; ++i ) {
+		SetCaretByPos( layer, text, pos );
+		ch[0] = i % 40 == 39 ? L'\n' : L'A' + i % 26;
+		TextLayer_InsertTextW( layer, ch, NULL );
+		wmemmove( text + pos + 1, text + pos, len - pos + 1 );
+		text[pos++] = ch[0];
+		++len;
+		TextLayer_Update( layer, NULL );
+		assert( CheckTypeset( layer, text ) == 0 );
+		/* 下一行的文字被拉上来时，插入点也要跟着移动 */
+		assert( GetCaretPos( layer ) == pos );
+	}
+	/* 删除插入点右边的文字，让下面的文字回流到当前行 */
+	for( i = 0; i < 60; ++i ) {
+		SetCaretByPos( layer, text, pos );
+		TextLayer_TextDelete( layer, 1 );
+		wmemmove( text + pos, text + pos + 1, len - pos );
+		--len;
+		TextLayer_Update( layer, NULL );
+		assert( CheckTypeset( layer, text ) == 0 );
+		assert( GetCaretPos( layer ) == pos );
+	}
+	TextLayer_Destroy( layer );
+	return 0;
+}
+
+/** 下一行的文字全部被拉到当前行时，在那一行末尾的插入点也要跟着移动 */
+static int test_text_layer_caret( void )
+{
+	int i, len;
+	wchar_t text[256];
+	LCUI_TextLayer layer = TextLayer_New();
+
+	TextLayer_SetMultiline( layer, TRUE );
+	TextLayer_SetAutoWrap( layer, TRUE );
+	TextLayer_SetMaxSize( layer, LAYER_WIDTH / 2, LAYER_HEIGHT );
+	for( i = 0; i < 255; ++i ) {
+		text[i] = L'a';
+	}
+	text[i] = 0;
+	TextLayer_AppendTextW( layer, text, NULL );
+	TextLayer_Update( layer, NULL );
+	/* 让第二行只剩两个字 */
+	len = TextLayer_GetRowTextLength( layer, 0 ) + 2;
+	TextLayer_ClearText( layer );
+	text[len] = 0;
+	TextLayer_AppendTextW( layer, text, NULL );
+	TextLayer_Update( layer, NULL );
+	assert( TextLayer_GetRowTotal( layer ) == 2 );
+	TextLayer_SetCaretPos( layer, 1, 2 );
+	TextLayer_SetMaxSize( layer, LAYER_WIDTH, LAYER_HEIGHT );
+	TextLayer_Update( layer, NULL );
+	assert( TextLayer_GetRowTotal( layer ) == 1 );
+	assert( layer->insert_y == 0 && layer->insert_x == len );
+	TextLayer_Destroy( layer );
+	return 0;
+}
+
+/** 将文本图层的内容转换成字符串，用 | 表示换行符 */
+static void GetLayerText( LCUI_TextLayer layer, wchar_t *buff )
+{
+	int row, col;
+	TextRow txtrow;
+	for( row = 0; row < layer->rowlist.length; ++row ) {
+		txtrow = layer->rowlist.rows[row];
+		for( col = 0; col < txtrow->length; ++col ) {
+			*buff++ = txtrow->string[col].char_code;
+		}
+		if( txtrow->eol != EOL_NONE ) {
+			*buff++ = L'|';
+		}
+	}
+	*buff = 0;
+}
+
+/** 检查删除文字后的文本内容和插入点 */
+static int CheckDelete( int row, int col, int n, LCUI_BOOL backspace,
+			const wchar_t *expected, int caret_pos )
+{
+	wchar_t buff[64];
+	LCUI_TextLayer layer = TextLayer_New();
+	TextLayer_SetMultiline( layer, TRUE );
+	TextLayer_AppendTextW( layer, L"abc\ndef\nghi", NULL );
+	TextLayer_Update( layer, NULL );
+	TextLayer_SetCaretPos( layer, row, col );
+	if( backspace ) {
+		TextLayer_TextBackspace( layer, n );
+	} else {
+		TextLayer_TextDelete( layer, n );
+	}
+	TextLayer_Update( layer, NULL );
+	GetLayerText( layer, buff );
+	n = GetCaretPos( layer );
+	TextLayer_Destroy( layer );
+	assert( wcscmp( buff, expected ) == 0 );
+	assert( n == caret_pos );
+	return 0;
+}
+
+/** 删除的文字跨越多行时，结束行剩下的文字应该拼接到起始行 */
+static int test_text_layer_delete( void )
+{
+	int ret = 0;
+	ret |= CheckDelete( 1, 1, 1, FALSE, L"abc|df|ghi", 5 );
+	ret |= CheckDelete( 0, 3, 1, FALSE, L"abcdef|ghi", 3 );
+	ret |= CheckDelete( 0, 1, 3, FALSE, L"adef|ghi", 1 );
+	ret |= CheckDelete( 0, 1, 5, FALSE, L"af|ghi", 1 );
+	ret |= CheckDelete( 0, 0, 100, FALSE, L"", 0 );
+	ret |= CheckDelete( 1, 0, 1, TRUE, L"abcdef|ghi", 3 );
+	ret |= CheckDelete( 2, 1, 6, TRUE, L"abchi", 3 );
+	/* 删空一行后，它的换行符仍然保留 */
+	ret |= CheckDelete( 1, 0, 3, FALSE, L"abc||ghi", 4 );
+	return ret;
+}
+
+int test_text_layer( void )
+{
+	int i, height;
+	wchar_t line[64];
+	LCUI_Rect area;
+	LCUI_TextLayer layer;
+	LCUI_Graph full, part;
+	LCUI_Pos pos = { 0, 0 };
+
+	LCUI_InitBase();
+	layer = TextLayer_New();
+	TextLayer_SetMultiline( layer, TRUE );
+	TextLayer_SetUsingStyleTags( layer, TRUE );
+	for( i = 0; i < 200; ++i ) {
+		swprintf( line, 64, L"line %d: [color=#f00]red[/color] "
+			  L"[color=#00f]blue[/color] text\n", i );
+		TextLayer_AppendTextW( layer, line, NULL );
+	}
+	TextLayer_Update( layer, NULL );
+	for( i = 0, height = 0; i < TextLayer_GetRowTotal( layer ); ++i ) {
+		height += TextLayer_GetRowHeight( layer, i );
+	}
+	assert( TextLayer_GetHeight( layer ) == height );
+	/* 向上滚动，让可见的文本行位于文本中间 */
+	TextLayer_SetOffset( layer, 0, -height / 2 );
+	TextLayer_Update( layer, NULL );
+	CreateCanvas( &full );
+	CreateCanvas( &part );
+	area.x = 0;
+	area.y = 0;
+	area.width = LAYER_WIDTH;
+	area.height = LAYER_HEIGHT;
+	TextLayer_DrawToGraph( layer, area, pos, &full );
+	/* 只绘制部分区域，结果应与完整绘制的结果一致 */
+	area.x = 40;
+	area.y = 50;
+	area.width = 100;
+	area.height = 60;
+	TextLayer_DrawToGraph( layer, area, pos, &part );
+	assert( CountPixels( &full, &area ) > 0 );
+	assert( CompareArea( &full, &part, &area ) == 0 );
+	Graph_Free( &full );
+	Graph_Free( &part );
+	TextLayer_Destroy( layer );
+	assert( test_text_layer_delete() == 0 );
+	assert( test_text_layer_caret() == 0 );
+	return test_text_layer_typing();
+}
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/timer.h>
+#include "test.h"
+
+#define N_TIMERS	32
+#define WAIT_TIMEOUT	3000
+
+static struct {
+	int count;
+	int order[N_TIMERS];
+	int ticks;
+	int paused_count;
+	int reset_count;
+	int freed_count;
+} test;
+
+static void OnTimeout( void *arg )
+{
+	test.order[test.count++] = *(int*)arg;
+}
+
+static void OnTick( void *arg )
+{
+	test.ticks += 1;
+}
+
+static void OnCount( void *arg )
+{
+	*(int*)arg += 1;
+}
+
+/** 处理定时器发出的任务，直到条件成立或超时 */
+static void WaitUntil( int *value, int expected )
+{
+	int ticks = test.ticks;
+	while( *value < expected && test.ticks - ticks < WAIT_TIMEOUT / 10 ) {
+		LCUI_WaitEvent();
+		LCUI_DispatchEvent();
+	}
+}
+
+/** 条件变量的等待时长按单调时钟计算，不会提前结束 */
+static int CheckCondTimedWait( void )
+{
+	int64_t t;
+	LCUI_Cond cond;
+	LCUI_Mutex mutex;
+
+	LCUIMutex_Init( &mutex );
+	LCUICond_Init( &cond );
+	LCUIMutex_Lock( &mutex );
+	t = LCUI_GetTimeNS();
+	LCUICond_TimedWait( &cond, &mutex, 50 );
+	t = LCUI_GetTimeDeltaNS( t );
+	LCUIMutex_Unlock( &mutex );
+	LCUICond_Destroy( &cond );
+	LCUIMutex_Destroy( &mutex );
+	assert( t >= 50000000 );
+	return 0;
+}
+
+int test_timer_heap( void )
+{
+	int i, tick_timer, paused_timer, reset_timer, freed_timer;
+	static int delays[N_TIMERS];
+
+	assert( CheckCondTimedWait() == 0 );
+	LCUI_InitBase();
+#ifdef LCUI_BUILD_IN_LINUX
+	setenv( "LCUI_VIDEO_DRIVER", "headless", 1 );
+#endif
+	LCUI_InitApp( NULL );
+	test.count = 0;
+	/* 用于在等待超时后结束等待 */
+	tick_timer = LCUITimer_Set( 10, OnTick, NULL, TRUE );
+	/* 打乱设置顺序，定时器应该按到期时间的先后触发 */
+	for( i = 0; i < N_TIMERS; ++i ) {
+		delays[i] = 5 + (i * 13 % N_TIMERS) * 3;
+		assert( LCUITimer_Set( delays[i], OnTimeout,
+				       &delays[i], FALSE ) > 0 );
+	}
+	freed_timer = LCUITimer_Set( 20, OnCount, &test.freed_count, FALSE );
+	paused_timer = LCUITimer_Set( 20, OnCount, &test.paused_count, FALSE );
+	reset_timer = LCUITimer_Set( 60000, OnCount, &test.reset_count, FALSE );
+	assert( LCUITimer_Free( freed_timer ) == 0 );
+	assert( LCUITimer_Free( freed_timer ) == -1 );
+	assert( LCUITimer_Pause( paused_timer ) == 0 );
+	assert( LCUITimer_Reset( reset_timer, 30 ) == 0 );
+	WaitUntil( &test.count, N_TIMERS );
+	assert( test.count == N_TIMERS );
+	for( i = 1; i < N_TIMERS; ++i ) {
+		assert( test.order[i - 1] < test.order[i] );
+	}
+	WaitUntil( &test.reset_count, 1 );
+	assert( test.reset_count == 1 );
+	/* 触发后的一次性定时器已被释放 */
+	assert( LCUITimer_Free( reset_timer ) == -1 );
+	/* 暂停的定时器在继续之前不会触发 */
+	assert( test.freed_count == 0 && test.paused_count == 0 );
+	assert( LCUITimer_Continue( paused_timer ) == 0 );
+	WaitUntil( &test.paused_count, 1 );
+	assert( test.paused_count == 1 );
+	assert( test.freed_count == 0 );
+	assert( LCUITimer_Free( tick_timer ) == 0 );
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+
+#define CANVAS_WIDTH	120
+#define CANVAS_HEIGHT	100
+
+/** 将部件渲染到一块灰色的画板上 */
+static void RenderWidget( LCUI_Widget w, LCUI_Graph *canvas )
+{
+	LCUI_PaintContextRec paint;
+	Graph_Init( canvas );
+	canvas->color_type = COLOR_TYPE_ARGB;
+	Graph_Create( canvas, CANVAS_WIDTH, CANVAS_HEIGHT );
+	Graph_FillRect( canvas, RGB( 240, 240, 240 ), NULL, FALSE );
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = w->box.graph.width;
+	paint.rect.height = w->box.graph.height;
+	Graph_Quote( &paint.canvas, canvas, &paint.rect );
+	Widget_Render( w, &paint );
+}
+
+/** 比较两块画板的内容，允许有一个单位的舍入误差 */
+static int CompareGraph( LCUI_Graph *a, LCUI_Graph *b )
+{
+	int i, n = a->width * a->height;
+	for( i = 0; i < n; ++i ) {
+		if( abs( a->argb[i].r - b->argb[i].r ) > 1 ||
+		    abs( a->argb[i].g - b->argb[i].g ) > 1 ||
+		    abs( a->argb[i].b - b->argb[i].b ) > 1 ) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int test_widget_layer( void )
+{
+	int i;
+	LCUI_RegionRec region;
+	LCUI_Graph expected, actual;
+	LCUI_Widget root, box, child;
+	LCUI_WidgetLayerStatsRec stats;
+
+	LCUI_InitBase();
+	root = LCUIWidget_New( NULL );
+	box = LCUIWidget_New( NULL );
+	child = LCUIWidget_New( NULL );
+	Widget_Resize( root, CANVAS_WIDTH, CANVAS_HEIGHT );
+	Widget_Resize( box, 100, 80 );
+	Widget_Resize( child, 40, 30 );
+	Widget_SetPadding( box, 10, 10, 10, 10 );
+	Widget_SetStyle( box, key_background_color, RGB( 0, 122, 204 ), color );
+	Widget_SetStyle( box, key_opacity, 0.5, scale );
+	Widget_SetStyle( child, key_background_color, RGB( 255, 0, 0 ), color );
+	Widget_Append( box, child );
+	Widget_Append( root, box );
+	Widget_UpdateStyle( child, TRUE );
+	Widget_UpdateStyle( box, TRUE );
+	Widget_UpdateStyle( root, TRUE );
+	/* 更新部件，直到所有任务都已处理完 */
+	for( i = 0; i < 10 && Widget_Update( root ); ++i );
+	assert( box->box.graph.width == 120 && box->box.graph.height == 100 );
+
+	RenderWidget( box, &expected );
+	LCUIWidget_ResetLayerStats();
+	Widget_SetLayerMode( box, WLM_TREE );
+	/* 第一次渲染时需要创建并绘制图层 */
+	RenderWidget( box, &actual );
+	LCUIWidget_GetLayerStats( &stats );
+	assert( stats.misses == 1 && stats.hits == 0 && stats.count == 1 );
+	assert( CompareGraph( &expected, &actual ) == 0 );
+	/* 部件没有变化，直接使用缓存的图层 */
+	Graph_Free( &actual );
+	RenderWidget( box, &actual );
+	LCUIWidget_GetLayerStats( &stats );
+	assert( stats.misses == 1 && stats.hits == 1 );
+	assert( CompareGraph( &expected, &actual ) == 0 );
+	/* 子部件的无效区域会使图层需要重绘 */
+	Widget_InvalidateArea( child, NULL, SV_GRAPH_BOX );
+	Graph_Free( &actual );
+	RenderWidget( box, &actual );
+	LCUIWidget_GetLayerStats( &stats );
+	assert( stats.misses == 2 && stats.hits == 1 );
+	assert( CompareGraph( &expected, &actual ) == 0 );
+	/* 超出内存预算的图层会被释放，并且不再缓存 */
+	LCUIWidget_SetLayerCacheSize( 1024 );
+	Region_Init( &region );
+	Widget_ProcInvalidArea( root, &region );
+	Region_Destroy( &region );
+	LCUIWidget_GetLayerStats( &stats );
+	assert( stats.evictions == 1 && stats.count == 0 );
+	assert( stats.used_bytes == 0 );
+	Graph_Free( &actual );
+	RenderWidget( box, &actual );
+	LCUIWidget_GetLayerStats( &stats );
+	assert( stats.count == 0 && stats.misses == 3 );
+	assert( CompareGraph( &expected, &actual ) == 0 );
+
+	Graph_Free( &actual );
+	Graph_Free( &expected );
+	LCUIWidget_SetLayerCacheSize( 16 * 1024 * 1024 );
+	Widget_ExecDestroy( root );
+	return 0;
+}
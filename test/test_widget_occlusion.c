@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+
+#define CANVAS_WIDTH	120
+#define CANVAS_HEIGHT	100
+#define N_PAGES		3
+
+/** 将部件渲染到画板上 */
+static void RenderWidget( LCUI_Widget w, LCUI_Graph *canvas )
+{
+	LCUI_PaintContextRec paint;
+	Graph_Init( canvas );
+	canvas->color_type = COLOR_TYPE_ARGB;
+	Graph_Create( canvas, CANVAS_WIDTH, CANVAS_HEIGHT );
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = w->box.graph.width;
+	paint.rect.height = w->box.graph.height;
+	Graph_Quote( &paint.canvas, canvas, &paint.rect );
+	Widget_Render( w, &paint );
+}
+
+/** 分别在启用和禁用遮挡剔除时渲染，结果应该一致 */
+static int CheckRender( LCUI_Widget root, unsigned long culls )
+{
+	int ret = 0;
+	LCUI_Graph expected, actual;
+
+	LCUIWidget_SetOcclusionCulling( FALSE );
+	LCUIWidget_ResetCulledCount();
+	RenderWidget( root, &expected );
+	ret |= LCUIWidget_GetCulledCount() == 0 ? 0 : -1;
+	LCUIWidget_SetOcclusionCulling( TRUE );
+	RenderWidget( root, &actual );
+	ret |= LCUIWidget_GetCulledCount() == culls ? 0 : -1;
+	ret |= memcmp( expected.bytes, actual.bytes,
+		       expected.mem_size ) == 0 ? 0 : -1;
+	Graph_Free( &expected );
+	Graph_Free( &actual );
+	return ret;
+}
+
+int test_widget_occlusion( void )
+{
+	int i, ret = 0;
+	LCUI_Widget root, pages[N_PAGES], box;
+
+	LCUI_InitBase();
+	root = LCUIWidget_New( NULL );
+	Widget_Resize( root, CANVAS_WIDTH, CANVAS_HEIGHT );
+	Widget_SetStyle( root, key_background_color,
+			 RGB( 240, 240, 240 ), color );
+	/* 模拟视图栈，每一页都铺满根部件 */
+	for( i = 0; i < N_PAGES; ++i ) {
+		pages[i] = LCUIWidget_New( NULL );
+		Widget_SetStyle( pages[i], key_position, SV_ABSOLUTE, style );
+		Widget_SetStyle( pages[i], key_background_color,
+				 RGB( (uchar_t)(i * 80), 100, 200 ), color );
+		Widget_Move( pages[i], 0, 0 );
+		Widget_Resize( pages[i], CANVAS_WIDTH, CANVAS_HEIGHT );
+		Widget_Append( root, pages[i] );
+	}
+	box = LCUIWidget_New( NULL );
+	Widget_SetStyle( box, key_background_color, RGB( 255, 0, 0 ), color );
+	Widget_Resize( box, 30, 20 );
+	Widget_Append( pages[N_PAGES - 1], box );
+	for( i = 0; i < N_PAGES; ++i ) {
+		Widget_UpdateStyle( pages[i], TRUE );
+	}
+	Widget_UpdateStyle( box, TRUE );
+	Widget_UpdateStyle( root, TRUE );
+	for( i = 0; i < 10 && Widget_Update( root ); ++i );
+	/* 顶层页面完全覆盖了其它页面和根部件自身的背景 */
+	ret |= CheckRender( root, N_PAGES );
+	/* 半透明的页面不能遮挡下层的部件 */
+	Widget_SetStyle( pages[N_PAGES - 1], key_opacity, 0.5, scale );
+	Widget_UpdateStyle( pages[N_PAGES - 1], TRUE );
+	for( i = 0; i < 10 && Widget_Update( root ); ++i );
+	ret |= CheckRender( root, N_PAGES - 1 );
+	/* 移开后只遮挡了部分区域，所有部件都需要绘制 */
+	Widget_SetStyle( pages[N_PAGES - 1], key_opacity, 1.0, scale );
+	Widget_UpdateStyle( pages[N_PAGES - 1], TRUE );
+	for( i = 0; i < N_PAGES - 1; ++i ) {
+		Widget_Move( pages[i], 20 * (i + 1), 10 * (i + 1) );
+	}
+	Widget_Resize( pages[N_PAGES - 1], 60, 50 );
+	for( i = 0; i < 10 && Widget_Update( root ); ++i );
+	ret |= CheckRender( root, 0 );
+	Widget_Destroy( root );
+	assert( ret == 0 );
+	return ret;
+}
@@ -27,6 +27,7 @@ int test_widget_render( void )
 
 	/* 初始化一个绘制实例，绘制区域为整个画板 */
 	paint.with_alpha = FALSE;
+	paint.arena = NULL;
 	paint.rect.width = 320;
 	paint.rect.height = 320;
 	paint.rect.x = paint.rect.y = 0;